@@ -15,6 +15,7 @@
 #include "sdkconfig.h"
 #include "nvs_flash.h"
 #include "nvs.h"
+#include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "CONFIG";
@@ -24,9 +25,13 @@ static const char *TAG = "CONFIG";
    ========================================================================= */
 static const app_config_t default_config = {
     .dht_pin = 4,
+    .dht_extra_pins = { 0xFF, 0xFF, 0xFF }, // Not configured
+    .dht_sensor_count = 1,
     .relay_pin = 5,
+    .relay_extra_pins = { 0xFF, 0xFF, 0xFF },   // Not configured
     .fan_pin = 18,
-    .dht_type = 11,
+    .fan_extra_pins = { 0xFF, 0xFF, 0xFF },     // Not configured
+    .dht_type = 0x01,   // DHT_TYPE_DHT11
 
     .wifi_ssid = {0},
     .wifi_pass = {0},
@@ -37,6 +42,8 @@ static const app_config_t default_config = {
     .mqtt_topic_sensor = "room_1/sensors",
     .mqtt_topic_command = "room_1/commands",
     .mqtt_qos = 1,
+    .mqtt_sensor_format = 0, // JSON
+    .timezone = DEFAULT_TIMEZONE,
 
     .sensor_task_stack = 3072, // 3 KB
     .mqtt_task_stack = 4096,   // 4 KB
@@ -44,6 +51,12 @@ static const app_config_t default_config = {
     .mqtt_task_priority = 10,
 
     .sensor_read_interval_ms = 5000, // 5 seconds
+    .sensor_read_interval_max_ms = 20000, // 20 seconds while stable
+    .publish_batch_size = DEFAULT_PUBLISH_BATCH_SIZE,
+    .publish_linger_ms = DEFAULT_PUBLISH_LINGER_MS,
+    .publish_deadband_temp = DEFAULT_PUBLISH_DEADBAND_TEMP_C,
+    .publish_deadband_hum = DEFAULT_PUBLISH_DEADBAND_HUM_PCT,
+    .publish_heartbeat_ms = DEFAULT_PUBLISH_HEARTBEAT_MS,
     .mqtt_publish_timeout_ms = 5000, // 5 seconds
     .dht_read_timeout_ms = 3000      // 3 seconds
 };
@@ -181,20 +194,54 @@ app_err_t app_config_load(void) {
         g_app_config.mqtt_broker_uri,
         sizeof(g_app_config.mqtt_broker_uri),
         "");
+    config_nvs_load_string(handle, NVS_KEY_TIMEZONE,
+        g_app_config.timezone,
+        sizeof(g_app_config.timezone),
+        default_config.timezone);
     
     // Load numeric configs
     config_nvs_load_u8(handle, "dht_pin",
         &g_app_config.dht_pin,
         default_config.dht_pin);
+    config_nvs_load_u8(handle, "dht_count",
+        &g_app_config.dht_sensor_count,
+        default_config.dht_sensor_count);
+    config_nvs_load_u8(handle, "dht_type",
+        &g_app_config.dht_type,
+        default_config.dht_type);
+    for (int i = 0; i < APP_MAX_DHT_SENSORS - 1; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "dht_pin%d", i + 1);
+        config_nvs_load_u8(handle, key,
+            &g_app_config.dht_extra_pins[i],
+            default_config.dht_extra_pins[i]);
+    }
     config_nvs_load_u8(handle, "relay_pin",
         &g_app_config.relay_pin,
         default_config.relay_pin);
     config_nvs_load_u8(handle, "fan_pin",
         &g_app_config.fan_pin,
         default_config.fan_pin);
+    for (int i = 0; i < APP_MAX_RELAYS - 1; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "relay_pin%d", i + 1);
+        config_nvs_load_u8(handle, key,
+            &g_app_config.relay_extra_pins[i],
+            default_config.relay_extra_pins[i]);
+    }
+    for (int i = 0; i < APP_MAX_FANS - 1; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "fan_pin%d", i + 1);
+        config_nvs_load_u8(handle, key,
+            &g_app_config.fan_extra_pins[i],
+            default_config.fan_extra_pins[i]);
+    }
     config_nvs_load_u8(handle, "mqtt_qos",
         &g_app_config.mqtt_qos,
         default_config.mqtt_qos);
+    config_nvs_load_u8(handle, "sensor_format",
+        &g_app_config.mqtt_sensor_format,
+        default_config.mqtt_sensor_format);
     
     nvs_close(handle);
 
@@ -268,13 +315,36 @@ app_config_t* app_config_get(void) {
 void app_config_print(void) {
     APP_LOG_INFO(TAG, "=== CURRENT CONFIGURATION ===");
     APP_LOG_INFO(TAG, "DHT Pin: %d", g_app_config.dht_pin);
+    APP_LOG_INFO(TAG, "DHT Sensors: %d", g_app_config.dht_sensor_count);
+    for (int i = 1; i < g_app_config.dht_sensor_count && i < APP_MAX_DHT_SENSORS; i++) {
+        APP_LOG_INFO(TAG, "DHT Pin %d: %d", i, g_app_config.dht_extra_pins[i - 1]);
+    }
     APP_LOG_INFO(TAG, "Relay Pin: %d", g_app_config.relay_pin);
+    for (int i = 0; i < APP_MAX_RELAYS - 1; i++) {
+        if (g_app_config.relay_extra_pins[i] != DEFAULT_OUTPUT_EXTRA_PIN) {
+            APP_LOG_INFO(TAG, "Relay Pin %d: %d", i + 1, g_app_config.relay_extra_pins[i]);
+        }
+    }
     APP_LOG_INFO(TAG, "Fan Pin: %d", g_app_config.fan_pin);
+    for (int i = 0; i < APP_MAX_FANS - 1; i++) {
+        if (g_app_config.fan_extra_pins[i] != DEFAULT_OUTPUT_EXTRA_PIN) {
+            APP_LOG_INFO(TAG, "Fan Pin %d: %d", i + 1, g_app_config.fan_extra_pins[i]);
+        }
+    }
     APP_LOG_INFO(TAG, "DHT Type: %d", g_app_config.dht_type);
     APP_LOG_INFO(TAG, "WiFi SSID: %s", strlen(g_app_config.wifi_ssid) ? g_app_config.wifi_ssid : "(not set)");
     APP_LOG_INFO(TAG, "MQTT Broker URI: %s", g_app_config.mqtt_broker_uri);
     APP_LOG_INFO(TAG, "MQTT QoS: %d", g_app_config.mqtt_qos);
+    APP_LOG_INFO(TAG, "Sensor payload: %s",
+        g_app_config.mqtt_sensor_format == PAYLOAD_FORMAT_BINARY ? "binary" : "json");
+    APP_LOG_INFO(TAG, "Timezone: %s", g_app_config.timezone);
     APP_LOG_INFO(TAG, "Sensor interval (ms): %d ms", g_app_config.sensor_read_interval_ms);
+    APP_LOG_INFO(TAG, "Sensor interval max (ms): %ld ms", g_app_config.sensor_read_interval_max_ms);
+    APP_LOG_INFO(TAG, "Publish batch: %d readings, linger %ld ms",
+        g_app_config.publish_batch_size, g_app_config.publish_linger_ms);
+    APP_LOG_INFO(TAG, "Publish deadband: %.1f C, %.1f %%, heartbeat %ld ms",
+        g_app_config.publish_deadband_temp, g_app_config.publish_deadband_hum,
+        g_app_config.publish_heartbeat_ms);
     APP_LOG_INFO(TAG, "Sensor task stack: %d bytes", g_app_config.sensor_task_stack);
     APP_LOG_INFO(TAG, "MQTT task stack: %d bytes", g_app_config.mqtt_task_stack);
     APP_LOG_INFO(TAG, "=============================");
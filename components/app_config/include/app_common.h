@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include "esp_log.h"
 
 /* =========================================================================
@@ -30,10 +31,58 @@ typedef enum {
 /* =========================================================================
    LOGGING MACROS
    ========================================================================= */
+#define APP_LOG_LEVEL_NONE  0
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_WARN  2
+#define APP_LOG_LEVEL_INFO  3
+#define APP_LOG_LEVEL_DEBUG 4
+
+/**
+ * Compile-time ceiling for APP_LOG_* and APP_LOG_DEFER_* in this
+ * translation unit. Components set it in their CMakeLists.txt:
+ *
+ *   target_compile_definitions(${COMPONENT_LIB} PRIVATE APP_LOG_LEVEL=APP_LOG_LEVEL_INFO)
+ *
+ * Levels above the ceiling compile to nothing: no call, no level check,
+ * no format string in flash. Arguments are not evaluated but still
+ * type-checked against the format. The runtime level (esp_log_level_set,
+ * log_deferred_set_level) only filters what is compiled in.
+ */
+#ifndef APP_LOG_LEVEL
+#define APP_LOG_LEVEL APP_LOG_LEVEL_DEBUG
+#endif
+
+/** Stripped log statement: format checking only, no code */
+#define APP_LOG_DISCARD(tag, fmt, ...) do {     \
+        if (0) {                                \
+            printf(fmt, ##__VA_ARGS__);         \
+            (void)(tag);                        \
+        }                                       \
+    } while (0)
+
+#if APP_LOG_LEVEL >= APP_LOG_LEVEL_ERROR
 #define APP_LOG_ERROR(tag, fmt, ...) ESP_LOGE(tag, "[ERROR] " fmt, ##__VA_ARGS__)
+#else
+#define APP_LOG_ERROR(tag, fmt, ...) APP_LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if APP_LOG_LEVEL >= APP_LOG_LEVEL_WARN
 #define APP_LOG_WARN(tag, fmt, ...) ESP_LOGW(tag, "[WARN] " fmt, ##__VA_ARGS__)
+#else
+#define APP_LOG_WARN(tag, fmt, ...) APP_LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO
 #define APP_LOG_INFO(tag, fmt, ...) ESP_LOGI(tag, "[INFO] " fmt, ##__VA_ARGS__)
+#else
+#define APP_LOG_INFO(tag, fmt, ...) APP_LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if APP_LOG_LEVEL >= APP_LOG_LEVEL_DEBUG
 #define APP_LOG_DEBUG(tag, fmt, ...) ESP_LOGD(tag, "[DEBUG] " fmt, ##__VA_ARGS__)
+#else
+#define APP_LOG_DEBUG(tag, fmt, ...) APP_LOG_DISCARD(tag, fmt, ##__VA_ARGS__)
+#endif
 
 #define APP_LOG_ERR_CODE(tag, err) do { \
     if ((err) != APP_OK) { \
@@ -44,11 +93,19 @@ typedef enum {
 /* =========================================================================
    CONFIGURATION STRUCTURE
    ========================================================================= */
+#define APP_MAX_DHT_SENSORS 4   // DHT sensors per device (one GPIO each)
+#define APP_MAX_RELAYS 4        // Relay outputs per device (one GPIO each)
+#define APP_MAX_FANS 4          // PWM fan outputs per device (one LEDC channel each)
+
 typedef struct {
     // Hardware pins
-    uint8_t dht_pin;
-    uint8_t relay_pin;
-    uint8_t fan_pin;
+    uint8_t dht_pin;                                    // Sensor 0
+    uint8_t dht_extra_pins[APP_MAX_DHT_SENSORS - 1];    // Sensors 1..N-1
+    uint8_t dht_sensor_count;
+    uint8_t relay_pin;                                  // Relay 0
+    uint8_t relay_extra_pins[APP_MAX_RELAYS - 1];       // Relays 1..N-1, 0xFF = none
+    uint8_t fan_pin;                                    // Fan 0
+    uint8_t fan_extra_pins[APP_MAX_FANS - 1];           // Fans 1..N-1, 0xFF = none
 
     // DHT sensor type
     uint8_t dht_type;
@@ -64,15 +121,30 @@ typedef struct {
     char mqtt_topic_sensor[64];
     char mqtt_topic_command[64];
     uint8_t mqtt_qos;
+    uint8_t mqtt_sensor_format;     // Payload format for mqtt_topic_sensor
+
+    // POSIX TZ string, local time of daily schedules (loaded from NVS)
+    char timezone[64];
 
     // Task stack sizes
     uint16_t sensor_task_stack;
-    uint16_t mqtt_task_stack;
+    uint16_t mqtt_task_stack;       // Output task, runs MQTT commands
     uint8_t sensor_task_priority;
     uint8_t mqtt_task_priority;
 
-    // Sensor interval (ms)
+    // Sensor interval (ms), adaptive between the two while readings are stable
     uint32_t sensor_read_interval_ms;
+    uint32_t sensor_read_interval_max_ms;   // <= sensor_read_interval_ms: fixed rate
+
+    // Telemetry publishing (batching)
+    uint8_t publish_batch_size;
+    uint32_t publish_linger_ms;
+
+    // Report by exception: publish a reading only if it moved by a deadband
+    // since the last published one, or the heartbeat elapsed (0 = off)
+    float publish_deadband_temp;        // Celsius
+    float publish_deadband_hum;         // Percent
+    uint32_t publish_heartbeat_ms;
 
     // Timeouts (ms)
     uint32_t mqtt_publish_timeout_ms;
@@ -101,6 +173,7 @@ typedef struct {
     uint32_t mqtt_reconnect_count;
     uint32_t sensor_read_count;
     uint32_t sensor_error_count;
+    uint32_t publish_suppressed_count;  // Readings inside the deadband
     uint64_t uptime_ms;
 } system_status_t;
 
@@ -108,6 +181,7 @@ typedef struct {
    SENSOR DATA STRUCTURE
    ========================================================================= */
 typedef struct {
+    uint8_t sensor_id;
     float temperature;
     float humidity;
     uint64_t timestamp_ms;
@@ -33,9 +33,12 @@
  * @{
  */
 #define DEFAULT_DHT_PIN 4 /**< DHT11 data pin (GPIO4) */
+#define DEFAULT_DHT_EXTRA_PIN 0xFF /**< Additional DHT pins, not configured */
+#define DEFAULT_DHT_SENSOR_COUNT 1 /**< Number of DHT sensors */
 #define DEFAULT_RELAY_PIN 5 /**< Relay control pin (GPIO5) */
 #define DEFAULT_FAN_PIN 18 /**< Fan PWM control pin (GPIO18) */
-#define DEFAULT_DHT_TYPE 11 /**< Sensor type */
+#define DEFAULT_OUTPUT_EXTRA_PIN 0xFF /**< Additional relay/fan pins, not configured */
+#define DEFAULT_DHT_TYPE 0x01 /**< Sensor type (DHT_TYPE_DHT11, see sensor_dht.h) */
 /** @} */
 
 /* =========================================================================
@@ -49,6 +52,20 @@
 #define DEFAULT_MQTT_USERNAME "esp32_device" /**< Default MQTT Username */
 #define DEFAULT_MQTT_QOS 1 /**< Default MQTT QoS */
 #define DEFAULT_MQTT_RETAIN 0 /**< Default MQTT Retain Flag */
+#define DEFAULT_MQTT_SENSOR_FORMAT PAYLOAD_FORMAT_JSON /**< Default sensor payload format */
+#define DEFAULT_SNTP_SERVER "pool.ntp.org" /**< Time server (daily schedules need the clock) */
+#define DEFAULT_TIMEZONE "UTC0" /**< Default POSIX TZ string, local time of daily schedules */
+/** @} */
+
+/* =========================================================================
+   PAYLOAD FORMATS
+   ========================================================================= */
+/** @defgroup PAYLOAD_FORMATS Telemetry Payload Formats
+ * Values for `app_config_t.mqtt_sensor_format`
+ * @{
+ */
+#define PAYLOAD_FORMAT_JSON 0 /**< JSON object with a readings array */
+#define PAYLOAD_FORMAT_BINARY 1 /**< Delta-encoded binary frame (see telemetry_binary.h) */
 /** @} */
 
 /* =========================================================================
@@ -72,19 +89,52 @@
 /** Sensor task - reads DHT every 5 seconds */
 #define DEFAULT_SENSOR_TASK_STACK 3072 /**< Sensor task stack size in bytes */
 #define DEFAULT_SENSOR_TASK_PRIORITY 5 /**< Sensor task priority */
-#define DEFAULT_SENSOR_READ_INTERVAL_MS 5000 /**< Sensor read interval in milliseconds */
+#define DEFAULT_SENSOR_READ_INTERVAL_MS 5000 /**< Sensor read interval in milliseconds (fastest when adaptive) */
+#define DEFAULT_SENSOR_READ_INTERVAL_MAX_MS 20000 /**< Adaptive ceiling while readings are stable */
+#define DEFAULT_SENSOR_TEMP_CHANGE_C 0.2f /**< Temperature deviation that counts as changing */
+#define DEFAULT_SENSOR_HUM_CHANGE_PCT 1.0f /**< Humidity deviation that counts as changing */
+
+/** Output task - runs MQTT commands (relay, fan, settings) */
+#define DEFAULT_MQTT_TASK_STACK 4096 /**< Output task stack size in bytes */
+#define DEFAULT_MQTT_TASK_PRIORITY 10 /**< Output task priority */
 
-/** MQTT RX task - processes incoming commands */
-#define DEFAULT_MQTT_TASK_STACK 4096 /**< MQTT task stack size in bytes */
-#define DEFAULT_MQTT_TASK_PRIORITY 10 /**< MQTT task priority */
+/** Task profile and command latency reports on `<mqtt_topic_sensor>/diagnostics` */
+#define DEFAULT_DIAG_PUBLISH_INTERVAL_MS 60000 /**< Report interval (ms) */
 
-/** Output task - controls relay and fan */
-#define DEFAULT_OUTPUT_TASK_STACK 2048 /**< Output task stack size in bytes */
-#define DEFAULT_OUTPUT_TASK_PRIORITY 6 /**< Output task priority */
+/** Publisher task - batches sensor readings into MQTT messages */
+#define DEFAULT_PUBLISH_TASK_STACK 4096 /**< Publisher task stack size in bytes */
+#define DEFAULT_PUBLISH_TASK_PRIORITY 4 /**< Publisher task priority */
+#define DEFAULT_PUBLISH_BATCH_SIZE 6 /**< Readings per MQTT message */
+#define DEFAULT_PUBLISH_LINGER_MS 30000 /**< Max time a reading waits for its batch to fill */
+#define MAX_PUBLISH_BATCH_SIZE 16 /**< Upper bound for publish_batch_size */
+#define DEFAULT_PUBLISH_DEADBAND_TEMP_C 0.2f /**< Min temperature change to publish (0 = every reading) */
+#define DEFAULT_PUBLISH_DEADBAND_HUM_PCT 1.0f /**< Min humidity change to publish (0 = every reading) */
+#define DEFAULT_PUBLISH_HEARTBEAT_MS 300000 /**< Publish unchanged readings at least every 5 minutes */
+#define DEFAULT_STORE_REPLAY_INTERVAL_MS 500 /**< Min time between replayed batches after reconnect */
 
 /** Monitor task - health check */
 #define DEFAULT_MONITOR_TASK_STACK 3072 /**< Monitor task stack size in bytes */
 #define DEFAULT_MONITOR_TASK_PRIORITY 2 /**< Monitor task priority */
+
+/** Logger task - deferred log output */
+#define DEFAULT_LOG_TASK_STACK 3072 /**< Logger task stack size in bytes */
+#define DEFAULT_LOG_TASK_PRIORITY 1 /**< Logger task priority (lowest) */
+#define DEFAULT_LOG_BINARY 0 /**< 1 = binary log frames on the console (tools/log_decoder) */
+#define DEFAULT_LOG_RESYNC_INTERVAL_MS 60000 /**< FORMAT frames resent for late decoders (ms) */
+
+/** Local controller - PID on one sensor drives the fan, relay as second stage (see controller.h) */
+#define DEFAULT_CONTROL_MODE 0 /**< 0 = manual (MQTT relay/fan), 1 = humidity, 2 = temperature */
+#define DEFAULT_CONTROL_SENSOR_ID 0 /**< Sensor the loops follow */
+#define DEFAULT_CONTROL_SETPOINT_HUM 600 /**< Humidity setpoint, tenths of a percent */
+#define DEFAULT_CONTROL_SETPOINT_TEMP 250 /**< Temperature setpoint, tenths of a degree C */
+#define DEFAULT_CONTROL_HUM_KP_MILLI 2500 /**< Fan duty per 0.1 % of error, x1000 */
+#define DEFAULT_CONTROL_HUM_KI_MILLI 25 /**< Fan duty per 0.1 % of error and second, x1000 */
+#define DEFAULT_CONTROL_HUM_KD_MILLI 0 /**< Fan duty per 0.1 %/s of change, x1000 */
+#define DEFAULT_CONTROL_TEMP_KP_MILLI 4000 /**< Fan duty per 0.1 C of error, x1000 */
+#define DEFAULT_CONTROL_TEMP_KI_MILLI 40 /**< Fan duty per 0.1 C of error and second, x1000 */
+#define DEFAULT_CONTROL_TEMP_KD_MILLI 0 /**< Fan duty per 0.1 C/s of change, x1000 */
+#define DEFAULT_CONTROL_RELAY_ON_DUTY 255 /**< Relay on once the fan output reaches this */
+#define DEFAULT_CONTROL_RELAY_OFF_DUTY 160 /**< Relay off at this fan output or below */
 /** @} */
 
 /* =========================================================================
@@ -113,9 +163,16 @@
 #define NVS_KEY_MQTT_USERNAME "mqtt_username" /**< MQTT Username */
 #define NVS_KEY_MQTT_PASSWORD "mqtt_password" /**< MQTT Password */
 #define NVS_KEY_DHT_PIN "dht_pin" /**< DHT GPIO Pin */
+#define NVS_KEY_DHT_COUNT "dht_count" /**< Number of DHT sensors */
+#define NVS_KEY_DHT_TYPE "dht_type" /**< DHT sensor model (DHT_TYPE_*) */
+#define NVS_KEY_DHT_PIN_N "dht_pin%d" /**< GPIO Pin of DHT sensor N (1..3) */
 #define NVS_KEY_RELAY_PIN "relay_pin" /**< Relay GPIO Pin */
+#define NVS_KEY_RELAY_PIN_N "relay_pin%d" /**< GPIO Pin of relay N (1..3) */
 #define NVS_KEY_FAN_PIN "fan_pin" /**< Fan GPIO Pin */
+#define NVS_KEY_FAN_PIN_N "fan_pin%d" /**< GPIO Pin of fan N (1..3) */
 #define NVS_KEY_SENSOR_INTERVAL "sensor_interval" /**< Sensor read interval */
+#define NVS_KEY_SENSOR_FORMAT "sensor_format" /**< Sensor payload format */
+#define NVS_KEY_TIMEZONE "timezone" /**< POSIX TZ string */
 /** @} */
 
 /* =========================================================================
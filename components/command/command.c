@@ -0,0 +1,342 @@
+/**
+ * @file command.c
+ * @brief Command registry - interned command types and handler dispatch
+ * @version 2.0
+ *
+ * Name lookup:
+ * - FNV-1a hash of the name, open addressing with linear probing in a
+ *   table of at least twice as many slots as commands
+ * - The table is filled on first use from COMMAND_LIST (startup, single
+ *   task); afterwards it is read-only
+ *
+ * Timestamps are 32-bit microseconds, differences stay correct across the
+ * wrap (every 71 minutes) as long as a command lives less than that.
+ *
+ * Group pool: COMMAND_GROUP_SLOTS slots and a bitmask of used ones. A slot
+ * is taken with a compare-and-swap on the mask and given back with an
+ * atomic AND, so producers (MQTT, scheduler) and the dispatching task
+ * never wait on each other. The slot contents are written before the
+ * command is queued and read after it is dequeued; the queue orders them.
+ */
+
+#include "command.h"
+#include "metrics.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "COMMAND";
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+#define COMMAND_TABLE_SIZE 32
+
+_Static_assert(COMMAND_COUNT * 2 <= COMMAND_TABLE_SIZE, "grow COMMAND_TABLE_SIZE");
+_Static_assert((COMMAND_TABLE_SIZE & (COMMAND_TABLE_SIZE - 1)) == 0, "table size must be a power of two");
+_Static_assert(COMMAND_GROUP_SLOTS <= 32, "group pool is a 32-bit mask");
+
+static const char *const g_command_names[COMMAND_COUNT] = {
+#define COMMAND_NAME_ENTRY(id, name) [COMMAND_##id] = name,
+    COMMAND_LIST(COMMAND_NAME_ENTRY)
+#undef COMMAND_NAME_ENTRY
+};
+
+typedef struct {
+    command_handler_t handler;
+    void *ctx;
+    int32_t min_value;
+    int32_t max_value;
+} command_entry_t;
+
+typedef struct {
+    command_entry_t entries[COMMAND_COUNT];
+    uint8_t table[COMMAND_TABLE_SIZE];      // command_id_t per slot, COMMAND_INVALID = empty
+    atomic_bool table_ready;
+    command_stage_stats_t latency[COMMAND_STAGE_COUNT];    // Protected by g_command_lock
+    atomic_bool dispatching;                // Set around the handler call
+    atomic_uint actuated_us;                // command_mark_actuated() during dispatch
+    command_group_t groups[COMMAND_GROUP_SLOTS];
+    atomic_uint groups_used;                // Bit n set: groups[n] taken
+} command_context_t;
+
+static command_context_t g_command_ctx = {0};
+static portMUX_TYPE g_command_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Exported totals (metrics registry), the stage histograms above stay finer
+static metrics_counter_t g_commands_dispatched;
+static metrics_counter_t g_commands_failed;
+static metrics_counter_t g_commands_not_actuated;  // Stamped, but wrote no output
+METRICS_HISTOGRAM_DEFINE(g_command_latency_us, 100, 500, 1000, 5000, 20000, 100000);
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+
+static uint32_t command_hash(const char *name, size_t len)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Fill the lookup table once
+ */
+static void command_table_ensure(void)
+{
+    if (atomic_load_explicit(&g_command_ctx.table_ready, memory_order_acquire)) {
+        return;
+    }
+
+    portENTER_CRITICAL(&g_command_lock);
+    if (!atomic_load_explicit(&g_command_ctx.table_ready, memory_order_relaxed)) {
+        memset(g_command_ctx.table, COMMAND_INVALID, sizeof(g_command_ctx.table));
+        for (uint8_t id = 0; id < COMMAND_COUNT; id++) {
+            const char *name = g_command_names[id];
+            uint32_t slot = command_hash(name, strlen(name)) & (COMMAND_TABLE_SIZE - 1);
+            while (g_command_ctx.table[slot] != COMMAND_INVALID) {
+                slot = (slot + 1) & (COMMAND_TABLE_SIZE - 1);
+            }
+            g_command_ctx.table[slot] = id;
+        }
+        atomic_store_explicit(&g_command_ctx.table_ready, true, memory_order_release);
+    }
+    portEXIT_CRITICAL(&g_command_lock);
+}
+
+static void command_stage_record(command_stage_t stage, uint32_t from_us, uint32_t to_us)
+{
+    command_stage_stats_t *stats = &g_command_ctx.latency[stage];
+    uint32_t us = to_us - from_us;
+    stats->last_us = us;
+    latency_hist_record(&stats->hist, us);
+}
+
+static void command_latency_record(const command_stamps_t *stamps)
+{
+    portENTER_CRITICAL(&g_command_lock);
+    if (stamps->queued_us) {
+        command_stage_record(COMMAND_STAGE_PARSE, stamps->received_us, stamps->queued_us);
+        command_stage_record(COMMAND_STAGE_QUEUE, stamps->queued_us, stamps->dequeued_us);
+    }
+    command_stage_record(COMMAND_STAGE_ACTUATE, stamps->dequeued_us, stamps->actuated_us);
+    command_stage_record(COMMAND_STAGE_TOTAL, stamps->received_us, stamps->actuated_us);
+    portEXIT_CRITICAL(&g_command_lock);
+
+    metrics_histogram_observe(&g_command_latency_us, stamps->actuated_us - stamps->received_us);
+}
+
+/**
+ * @brief Take a free group slot
+ * @return Slot index, -1 if all are in use
+ */
+static int command_group_alloc(void)
+{
+    unsigned used = atomic_load_explicit(&g_command_ctx.groups_used, memory_order_relaxed);
+    for (;;) {
+        unsigned free_slots = ~used & (unsigned)(((uint64_t)1 << COMMAND_GROUP_SLOTS) - 1);
+        if (free_slots == 0) {
+            return -1;
+        }
+        int slot = __builtin_ctz(free_slots);
+        if (atomic_compare_exchange_weak_explicit(&g_command_ctx.groups_used, &used,
+                                                  used | (1u << slot),
+                                                  memory_order_acquire, memory_order_relaxed)) {
+            return slot;
+        }
+    }
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+app_err_t command_register(command_id_t id, int32_t min_value, int32_t max_value,
+                           command_handler_t handler, void *ctx)
+{
+    if (id >= COMMAND_COUNT || !handler || min_value > max_value) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    command_entry_t *entry = &g_command_ctx.entries[id];
+    entry->handler = handler;
+    entry->ctx = ctx;
+    entry->min_value = min_value;
+    entry->max_value = max_value;
+
+    metrics_register_counter(&g_commands_dispatched, "commands_dispatched_total");
+    metrics_register_counter(&g_commands_failed, "commands_failed_total");
+    metrics_register_counter(&g_commands_not_actuated, "commands_not_actuated_total");
+    metrics_register_histogram(&g_command_latency_us, "command_latency_us");
+
+    APP_LOG_DEBUG(TAG, "Registered %s (%ld..%ld)", g_command_names[id], min_value, max_value);
+    return APP_OK;
+}
+
+command_id_t command_lookup(const char *name, size_t len)
+{
+    if (!name) {
+        return COMMAND_INVALID;
+    }
+
+    command_table_ensure();
+
+    uint32_t slot = command_hash(name, len) & (COMMAND_TABLE_SIZE - 1);
+    while (g_command_ctx.table[slot] != COMMAND_INVALID) {
+        uint8_t id = g_command_ctx.table[slot];
+        const char *candidate = g_command_names[id];
+        if (strncmp(candidate, name, len) == 0 && candidate[len] == '\0') {
+            return (command_id_t)id;
+        }
+        slot = (slot + 1) & (COMMAND_TABLE_SIZE - 1);
+    }
+    return COMMAND_INVALID;
+}
+
+app_err_t command_set_group(command_t *cmd, const command_change_t *changes, size_t count)
+{
+    if (!cmd || !changes || count == 0 || count > COMMAND_MAX_CHANGES) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    int slot = command_group_alloc();
+    if (slot < 0) {
+        APP_LOG_WARN(TAG, "No free group slot for %s", command_to_string((command_id_t)cmd->id));
+        return APP_ERR_NO_MEMORY;
+    }
+
+    command_group_t *group = &g_command_ctx.groups[slot];
+    group->count = (uint8_t)count;
+    memcpy(group->changes, changes, count * sizeof(changes[0]));
+    cmd->group = (uint8_t)(slot + 1);
+    return APP_OK;
+}
+
+const command_group_t *command_get_group(const command_t *cmd)
+{
+    if (!cmd || cmd->group == COMMAND_GROUP_NONE || cmd->group > COMMAND_GROUP_SLOTS) {
+        return NULL;
+    }
+    return &g_command_ctx.groups[cmd->group - 1];
+}
+
+void command_release(const command_t *cmd)
+{
+    if (command_get_group(cmd)) {
+        atomic_fetch_and_explicit(&g_command_ctx.groups_used, ~(1u << (cmd->group - 1)),
+                                  memory_order_release);
+    }
+}
+
+/**
+ * @brief Check and run a command (command_dispatch() without the release)
+ */
+static app_err_t command_run(const command_t *cmd)
+{
+    if (cmd->id >= COMMAND_COUNT) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    const command_entry_t *entry = &g_command_ctx.entries[cmd->id];
+    if (!entry->handler) {
+        APP_LOG_WARN(TAG, "No handler for command %s", g_command_names[cmd->id]);
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (cmd->value < entry->min_value || cmd->value > entry->max_value) {
+        APP_LOG_WARN(TAG, "Invalid %s value: %ld (%ld-%ld)", g_command_names[cmd->id],
+                    cmd->value, entry->min_value, entry->max_value);
+        return APP_ERR_INVALID_VALUE;
+    }
+
+    const command_group_t *group = command_get_group(cmd);
+    for (uint8_t i = 0; group && i < group->count; i++) {
+        int32_t value = group->changes[i].value;
+        if (value < entry->min_value || value > entry->max_value) {
+            APP_LOG_WARN(TAG, "Invalid %s value for channel %d: %ld (%ld-%ld)",
+                        g_command_names[cmd->id], group->changes[i].channel,
+                        value, entry->min_value, entry->max_value);
+            return APP_ERR_INVALID_VALUE;
+        }
+    }
+
+    command_stamps_t stamps = cmd->stamps;
+    if (stamps.received_us && !stamps.dequeued_us) {
+        stamps.dequeued_us = command_now_us();
+    }
+
+    atomic_store_explicit(&g_command_ctx.actuated_us, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_command_ctx.dispatching, true, memory_order_relaxed);
+    app_err_t ret = entry->handler(cmd, entry->ctx);
+    atomic_store_explicit(&g_command_ctx.dispatching, false, memory_order_relaxed);
+    metrics_counter_inc(ret == APP_OK ? &g_commands_dispatched : &g_commands_failed);
+
+    // Only commands that wrote an output count as command-to-actuation
+    // latency (settings, queries, rejected writes do not)
+    if (stamps.received_us) {
+        stamps.actuated_us = atomic_load_explicit(&g_command_ctx.actuated_us, memory_order_relaxed);
+        if (stamps.actuated_us) {
+            command_latency_record(&stamps);
+        } else {
+            metrics_counter_inc(&g_commands_not_actuated);
+        }
+    }
+    return ret;
+}
+
+app_err_t command_dispatch(const command_t *cmd)
+{
+    if (!cmd) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    app_err_t ret = command_run(cmd);
+    command_release(cmd);
+    return ret;
+}
+
+uint32_t command_now_us(void)
+{
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    return now ? now : 1;
+}
+
+void command_mark_actuated(void)
+{
+    if (atomic_load_explicit(&g_command_ctx.dispatching, memory_order_relaxed)) {
+        atomic_store_explicit(&g_command_ctx.actuated_us, command_now_us(), memory_order_relaxed);
+    }
+}
+
+app_err_t command_get_stage_latency(command_stage_t stage, command_stage_stats_t *stats)
+{
+    if (stage >= COMMAND_STAGE_COUNT || !stats) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    portENTER_CRITICAL(&g_command_lock);
+    *stats = g_command_ctx.latency[stage];
+    portEXIT_CRITICAL(&g_command_lock);
+    return APP_OK;
+}
+
+const char *command_stage_to_string(command_stage_t stage)
+{
+    switch (stage) {
+        case COMMAND_STAGE_PARSE: return "parse";
+        case COMMAND_STAGE_QUEUE: return "queue";
+        case COMMAND_STAGE_ACTUATE: return "actuate";
+        case COMMAND_STAGE_TOTAL: return "total";
+        default: return "unknown";
+    }
+}
+
+const char *command_to_string(command_id_t id)
+{
+    return (id < COMMAND_COUNT) ? g_command_names[id] : "unknown";
+}
@@ -0,0 +1,311 @@
+/**
+ * @file command.h
+ * @brief Command registry - interned command types and handler dispatch
+ * @version 2.0
+ *
+ * Every command type is listed once in COMMAND_LIST and becomes a
+ * command_id_t at compile time. Command names are only looked at once, at
+ * the edge (MQTT parser), with a hash table lookup; from there on commands
+ * travel between tasks as a small fixed-size command_t.
+ *
+ * Components register the handlers of the commands they own, with the
+ * accepted value range. command_dispatch() checks the range and calls the
+ * handler, so handlers only see valid values.
+ *
+ * Besides its value, a command can address a channel ("output") or carry
+ * a group of channel changes ("outputs") that its handler applies as one
+ * unit. The range check covers the value of every change. Scheduled
+ * commands ("output_for", "output_daily") also carry their timing, and
+ * queries ("history") a time range, in a union selected by the id.
+ *
+ * Groups do not travel in the command: they sit in a small pool
+ * (COMMAND_GROUP_SLOTS) and the command holds the slot index, so every
+ * queued command stays 32 bytes. The slot is taken with
+ * command_set_group() and given back by command_dispatch(), or by
+ * command_release() for a command that is never dispatched.
+ *
+ * Latency: a command carries the time it was received, queued and
+ * dequeued. Handlers that drive hardware call command_mark_actuated() right
+ * after the GPIO/LEDC write; command_dispatch() then keeps a per-stage
+ * histogram (latency_hist.h) of those commands only, so command-to-actuation
+ * latency can be read on a running device (command_get_stage_latency()).
+ *
+ * Adding a command:
+ * 1. Add `X(NAME, "name")` to COMMAND_LIST
+ * 2. command_register(COMMAND_NAME, min, max, handler, ctx) from the
+ *    owning component's init
+ *
+ * Usage:
+    @code
+    ```c
+    static app_err_t fan_handler(const command_t *cmd, void *ctx)
+    {
+        return app_output_set_fan_speed(cmd->value);
+    }
+
+    command_register(COMMAND_FAN, 0, 255, fan_handler, NULL);
+
+    command_t cmd = {
+        .id = command_lookup("fan", 3),
+        .value = 128
+    };
+    command_dispatch(&cmd);
+    ```
+    @endcode
+ *
+ * @note Register handlers during startup, before the tasks that dispatch
+ *       commands run. Lookup and dispatch are then read-only and safe from
+ *       any task.
+ */
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "app_common.h"
+#include "latency_hist.h"
+
+/* =========================================================================
+   COMMAND TYPES
+   ========================================================================= */
+/**
+ * @brief All command types: X(ID, "mqtt name")
+ */
+#define COMMAND_LIST(X)                         \
+    X(RELAY,            "relay")                \
+    X(FAN,              "fan")                  \
+    X(HISTORY,          "history")              \
+    X(DEADBAND_TEMP,    "deadband_temp")        \
+    X(DEADBAND_HUM,     "deadband_hum")         \
+    X(HEARTBEAT,        "heartbeat")            \
+    X(CONTROL_MODE,     "mode")                 \
+    X(SETPOINT_HUM,     "setpoint_hum")         \
+    X(SETPOINT_TEMP,    "setpoint_temp")        \
+    X(OUTPUT,           "output")               \
+    X(OUTPUTS,          "outputs")              \
+    X(OUTPUT_FOR,       "output_for")           \
+    X(OUTPUT_DAILY,     "output_daily")         \
+    X(SCHEDULE_CANCEL,  "schedule_cancel")
+
+typedef enum {
+#define COMMAND_ENUM_ENTRY(id, name) COMMAND_##id,
+    COMMAND_LIST(COMMAND_ENUM_ENTRY)
+#undef COMMAND_ENUM_ENTRY
+    COMMAND_COUNT,
+    COMMAND_INVALID = 0xFF
+} command_id_t;
+
+#define COMMAND_MAX_CHANGES 8   /**< Channel changes in one group command */
+#define COMMAND_GROUP_SLOTS 16  /**< Group commands built, queued or dispatching at once */
+#define COMMAND_GROUP_NONE  0       /**< command_t.group without changes */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Pipeline timestamps (command_now_us(), 0 = not stamped)
+ */
+typedef struct {
+    uint32_t received_us;   // Payload handed to the parser
+    uint32_t queued_us;     // Parsed and queued for the dispatching task
+    uint32_t dequeued_us;   // Picked up by the dispatching task
+    uint32_t actuated_us;   // Output written (command_mark_actuated() during dispatch)
+} command_stamps_t;
+
+/**
+ * @brief One channel change of a group command
+ */
+typedef struct {
+    uint8_t channel;
+    int16_t value;          // Range checked like the command value
+} command_change_t;
+
+/**
+ * @brief Channel changes of a group command (pool slot)
+ */
+typedef struct {
+    uint8_t count;
+    command_change_t changes[COMMAND_MAX_CHANGES];
+} command_group_t;
+
+/**
+ * @brief Timing of a scheduled command (not range checked at dispatch)
+ */
+typedef struct {
+    uint32_t duration_s;    // Hold time in seconds
+    uint16_t start_min;     // Daily window start, minutes after midnight
+    uint16_t end_min;       // Daily window end, minutes after midnight
+} command_timing_t;
+
+/**
+ * @brief Time range of a query command, seconds since boot (0 = open end)
+ */
+typedef struct {
+    uint32_t from_s;
+    uint32_t to_s;
+} command_range_t;
+
+/**
+ * @brief Command as queued between tasks
+ */
+typedef struct {
+    uint8_t id;             // command_id_t, selects the union member
+    uint8_t channel;        // Channel-addressed commands, 0 otherwise
+    uint8_t group;          // Group commands: pool slot + 1, COMMAND_GROUP_NONE otherwise
+    int32_t value;          // Meaning depends on the command
+    union {
+        command_timing_t timing;    // COMMAND_OUTPUT_FOR, COMMAND_OUTPUT_DAILY
+        command_range_t range;      // COMMAND_HISTORY
+    };
+    command_stamps_t stamps;
+} command_t;
+
+_Static_assert(sizeof(command_t) <= 32, "command_t is copied through queues, keep it small");
+
+/**
+ * @brief Latency stages, between consecutive stamps
+ */
+typedef enum {
+    COMMAND_STAGE_PARSE = 0,        // received -> queued
+    COMMAND_STAGE_QUEUE,            // queued -> dequeued
+    COMMAND_STAGE_ACTUATE,          // dequeued -> actuated
+    COMMAND_STAGE_TOTAL,            // received -> actuated (SLA)
+    COMMAND_STAGE_COUNT
+} command_stage_t;
+
+/**
+ * @brief Latency of one stage since boot, in microseconds
+ */
+typedef struct {
+    uint32_t last_us;
+    latency_hist_t hist;    // count, max, mean and percentiles
+} command_stage_stats_t;
+
+/**
+ * @brief Command handler
+ * @param cmd Command, value and changes within the registered range
+ * @param ctx Context given to command_register()
+ * @return APP_OK on success, error code otherwise
+ */
+typedef app_err_t (*command_handler_t)(const command_t *cmd, void *ctx);
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Register the handler of a command (replaces a previous one)
+ *
+ * @param id Command
+ * @param min_value Smallest accepted value
+ * @param max_value Largest accepted value
+ * @param handler Handler
+ * @param ctx Passed to the handler
+ * @return `APP_OK` on success, `APP_ERR_INVALID_PARAM` on a bad id or range
+ */
+app_err_t command_register(command_id_t id, int32_t min_value, int32_t max_value,
+                           command_handler_t handler, void *ctx);
+
+/**
+ * @brief Find a command by name
+ *
+ * @param name Command name (need not be NUL-terminated)
+ * @param len Name length
+ * @return Command id, `COMMAND_INVALID` if unknown
+ */
+command_id_t command_lookup(const char *name, size_t len);
+
+/**
+ * @brief Run a command's handler
+ *
+ * Commands with a `received_us` stamp whose handler called
+ * command_mark_actuated() are added to the latency statistics; the
+ * others (settings, queries, writes the handler rejected) only count in
+ * `commands_not_actuated_total`. The command's group is released
+ * afterwards, whatever the result. The dequeue stamp defaults to the
+ * dispatch time.
+ *
+ * @note Dispatch stamped commands from one task (the output task).
+ *
+ * @param cmd Command
+ * @return Handler result, or error code
+ *
+ * @retval APP_OK Handler succeeded
+ * @retval APP_ERR_INVALID_PARAM Unknown command or no handler registered
+ * @retval APP_ERR_INVALID_VALUE Value or a change value outside the
+ *         registered range
+ */
+app_err_t command_dispatch(const command_t *cmd);
+
+/**
+ * @brief Attach channel changes to a command
+ *
+ * Copies the changes into a free pool slot (lock-free, any task) and
+ * stores its index in the command. The slot belongs to the command (and
+ * its copies) until command_dispatch() or command_release().
+ *
+ * @param cmd Command, its group must not be set yet
+ * @param changes Changes
+ * @param count Number of changes (1 to COMMAND_MAX_CHANGES)
+ * @return `APP_OK` on success, error code otherwise
+ *
+ * @retval APP_ERR_INVALID_PARAM `NULL`, bad count
+ * @retval APP_ERR_NO_MEMORY All COMMAND_GROUP_SLOTS in use
+ */
+app_err_t command_set_group(command_t *cmd, const command_change_t *changes, size_t count);
+
+/**
+ * @brief Channel changes of a command
+ * @param cmd Command
+ * @return Its group, `NULL` for commands without changes
+ */
+const command_group_t *command_get_group(const command_t *cmd);
+
+/**
+ * @brief Give back the group of a command that will not be dispatched
+ *
+ * For producers whose command was dropped (queue full, rejected).
+ * Commands without a group are ignored.
+ *
+ * @param cmd Command
+ */
+void command_release(const command_t *cmd);
+
+/**
+ * @brief Timestamp for command_stamps_t
+ * @return Microseconds since boot, truncated to 32 bits (never 0)
+ */
+uint32_t command_now_us(void);
+
+/**
+ * @brief Stamp the actuation of the command being dispatched
+ *
+ * Called by output drivers right after the GPIO/LEDC write, so the
+ * latency excludes logging and bookkeeping after it. Outside a dispatch
+ * it has no effect.
+ */
+void command_mark_actuated(void);
+
+/**
+ * @brief Snapshot of one stage's latency statistics (any task)
+ * @param stage Stage
+ * @param stats Output
+ * @return `APP_OK`, `APP_ERR_INVALID_PARAM` on a bad stage or `NULL`
+ */
+app_err_t command_get_stage_latency(command_stage_t stage, command_stage_stats_t *stats);
+
+/**
+ * @brief Stage name for reports
+ * @param stage Stage
+ * @return Name ("parse", "queue", "actuate", "total")
+ */
+const char *command_stage_to_string(command_stage_t stage);
+
+/**
+ * @brief Command name for logs
+ * @param id Command
+ * @return Name ("relay", ...), "unknown" for invalid ids
+ */
+const char *command_to_string(command_id_t id);
+
+#endif // COMMAND_H
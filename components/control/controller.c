@@ -0,0 +1,311 @@
+/**
+ * @file controller.c
+ * @brief Local closed-loop control of the fan (and relay) from one sensor
+ * @version 2.0
+ *
+ * One PID instance, configured for the active loop on every mode change.
+ * The mutex serializes the sensor task (controller_on_reading()) with the
+ * output task (commands), which are the only writers of the outputs. The
+ * loops drive the first fan and the first relay channel (app_output.h).
+ */
+
+#include "controller.h"
+#include "app_output.h"
+#include "command.h"
+#include "metrics.h"
+#include "log_deferred.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "CONTROL";
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+typedef struct {
+    control_config_t config;
+    pid_controller_t pid;
+    control_mode_t mode;
+    int32_t measurement;
+    uint64_t last_reading_ms;   // Timestamp of the previous reading used
+    uint32_t update_count;
+    SemaphoreHandle_t mutex;
+    bool initialized;
+} control_context_t;
+
+static control_context_t g_control_ctx = {0};
+
+static metrics_counter_t g_control_updates;
+static metrics_gauge_t g_control_mode;
+static metrics_gauge_t g_control_output;
+static metrics_gauge_t g_control_error;
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+
+static int32_t control_active_setpoint(void)
+{
+    return (g_control_ctx.mode == CONTROL_MODE_TEMPERATURE) ? g_control_ctx.config.setpoint_temp
+                                                            : g_control_ctx.config.setpoint_hum;
+}
+
+/**
+ * @brief Enter a mode (mutex held)
+ */
+static app_err_t control_enter_mode(control_mode_t mode)
+{
+    const pid_config_t *tuning = (mode == CONTROL_MODE_TEMPERATURE) ? &g_control_ctx.config.temperature
+                                                                     : &g_control_ctx.config.humidity;
+    pid_config_t pid_cfg = *tuning;
+    pid_cfg.out_min = FAN_SPEED_MIN;
+    pid_cfg.out_max = FAN_SPEED_MAX;
+
+    app_err_t ret = pid_init(&g_control_ctx.pid, &pid_cfg);
+    if (ret != APP_OK) {
+        return ret;
+    }
+
+    // Bumpless: continue from the duty the fan runs at
+    pid_reset(&g_control_ctx.pid, app_output_get_fan_speed());
+    g_control_ctx.mode = mode;
+    g_control_ctx.last_reading_ms = 0;
+    metrics_gauge_set(&g_control_mode, mode);
+    return APP_OK;
+}
+
+/**
+ * @brief Relay as a second stage, with hysteresis on the fan output
+ */
+static void control_drive_relay(int32_t output)
+{
+    relay_state_t relay = app_output_get_relay();
+
+    if (relay == RELAY_OFF && output >= g_control_ctx.config.relay_on_duty) {
+        app_output_set_relay(RELAY_ON);
+    } else if (relay == RELAY_ON && output <= g_control_ctx.config.relay_off_duty) {
+        app_output_set_relay(RELAY_OFF);
+    }
+}
+
+/* =========================================================================
+   COMMAND HANDLERS
+   ========================================================================= */
+
+/**
+ * @brief Whether a manual command writes the first fan or relay (the loop's outputs)
+ */
+static bool control_command_touches_loop(const command_t *cmd)
+{
+    uint8_t fan = app_output_find_channel(OUTPUT_TYPE_PWM, 0);
+    uint8_t relay = app_output_find_channel(OUTPUT_TYPE_RELAY, 0);
+
+    switch (cmd->id) {
+        case COMMAND_OUTPUT:
+            return cmd->channel == fan || cmd->channel == relay;
+        case COMMAND_OUTPUTS: {
+            const command_group_t *group = command_get_group(cmd);
+            for (uint8_t i = 0; group && i < group->count; i++) {
+                if (group->changes[i].channel == fan || group->changes[i].channel == relay) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        default:
+            return true;    // "relay", "fan"
+    }
+}
+
+/**
+ * @brief "relay"/"fan"/"output"/"outputs": manual control, rejected on the
+ *        loop's outputs while a loop runs
+ */
+static app_err_t control_command_manual(const command_t *cmd, void *ctx)
+{
+    app_err_t ret;
+
+    xSemaphoreTake(g_control_ctx.mutex, portMAX_DELAY);
+    if (g_control_ctx.mode != CONTROL_MODE_MANUAL && control_command_touches_loop(cmd)) {
+        APP_LOG_WARN(TAG, "Ignoring %s command in %s mode",
+                    command_to_string((command_id_t)cmd->id),
+                    control_mode_to_string(g_control_ctx.mode));
+        ret = APP_ERR_INVALID_VALUE;
+    } else {
+        ret = app_output_command_handler(cmd, ctx);
+    }
+    xSemaphoreGive(g_control_ctx.mutex);
+
+    return ret;
+}
+
+static app_err_t control_command_mode(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+    return controller_set_mode((control_mode_t)cmd->value);
+}
+
+static app_err_t control_command_setpoint(const command_t *cmd, void *ctx)
+{
+    return controller_set_setpoint((control_mode_t)(uintptr_t)ctx, cmd->value);
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+app_err_t controller_init(const control_config_t *config)
+{
+    if (!config || config->mode >= CONTROL_MODE_COUNT) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (g_control_ctx.initialized) {
+        APP_LOG_WARN(TAG, "Controller already initialized");
+        return APP_OK;
+    }
+
+    g_control_ctx.mutex = xSemaphoreCreateMutex();
+    if (!g_control_ctx.mutex) {
+        APP_LOG_ERROR(TAG, "Failed to create mutex");
+        return APP_ERR_NO_MEMORY;
+    }
+
+    g_control_ctx.config = *config;
+
+    metrics_register_counter(&g_control_updates, "control_updates_total");
+    metrics_register_gauge(&g_control_mode, "control_mode");
+    metrics_register_gauge(&g_control_output, "control_output");
+    metrics_register_gauge(&g_control_error, "control_error");
+
+    app_err_t ret = control_enter_mode(config->mode);
+    if (ret != APP_OK) {
+        APP_LOG_ERROR(TAG, "Invalid PID configuration");
+        vSemaphoreDelete(g_control_ctx.mutex);
+        g_control_ctx.mutex = NULL;
+        return ret;
+    }
+    g_control_ctx.initialized = true;
+
+    // Replaces app_output's handlers, so manual commands respect the mode
+    command_register(COMMAND_RELAY, RELAY_OFF, RELAY_ON, control_command_manual, NULL);
+    command_register(COMMAND_FAN, FAN_SPEED_MIN, FAN_SPEED_MAX, control_command_manual, NULL);
+    command_register(COMMAND_OUTPUT, 0, 255, control_command_manual, NULL);
+    command_register(COMMAND_OUTPUTS, 0, 255, control_command_manual, NULL);
+    command_register(COMMAND_CONTROL_MODE, 0, CONTROL_MODE_COUNT - 1, control_command_mode, NULL);
+    command_register(COMMAND_SETPOINT_HUM, 0, 1000, control_command_setpoint,
+                     (void *)(uintptr_t)CONTROL_MODE_HUMIDITY);
+    command_register(COMMAND_SETPOINT_TEMP, -400, 800, control_command_setpoint,
+                     (void *)(uintptr_t)CONTROL_MODE_TEMPERATURE);
+
+    APP_LOG_INFO(TAG, "Controller initialized: mode=%s, sensor %d, setpoints %.1f %% / %.1f C",
+                control_mode_to_string(config->mode), config->sensor_id,
+                config->setpoint_hum / 10.0f, config->setpoint_temp / 10.0f);
+    return APP_OK;
+}
+
+void controller_on_reading(const sensor_data_t *reading)
+{
+    if (!g_control_ctx.initialized || !reading || !reading->is_valid ||
+        reading->sensor_id != g_control_ctx.config.sensor_id) {
+        return;
+    }
+
+    xSemaphoreTake(g_control_ctx.mutex, portMAX_DELAY);
+    if (g_control_ctx.mode == CONTROL_MODE_MANUAL) {
+        xSemaphoreGive(g_control_ctx.mutex);
+        return;
+    }
+
+    float value = (g_control_ctx.mode == CONTROL_MODE_TEMPERATURE) ? reading->temperature
+                                                                    : reading->humidity;
+    int32_t measurement = (int32_t)lroundf(value * 10.0f);
+    int32_t setpoint = control_active_setpoint();
+
+    uint32_t dt_ms = 0;
+    if (g_control_ctx.last_reading_ms && reading->timestamp_ms > g_control_ctx.last_reading_ms) {
+        dt_ms = (uint32_t)(reading->timestamp_ms - g_control_ctx.last_reading_ms);
+    }
+    g_control_ctx.last_reading_ms = reading->timestamp_ms;
+
+    int32_t output = pid_update(&g_control_ctx.pid, setpoint, measurement, dt_ms);
+    g_control_ctx.measurement = measurement;
+    g_control_ctx.update_count++;
+
+    if (output != app_output_get_fan_speed()) {
+        app_output_set_fan_speed(output);
+    }
+    control_drive_relay(output);
+    xSemaphoreGive(g_control_ctx.mutex);
+
+    metrics_counter_inc(&g_control_updates);
+    metrics_gauge_set(&g_control_output, output);
+    metrics_gauge_set(&g_control_error, measurement - setpoint);
+    APP_LOG_DEFER_DEBUG(TAG, "PV=%ld SP=%ld -> duty %ld", measurement, setpoint, output);
+}
+
+app_err_t controller_set_mode(control_mode_t mode)
+{
+    if (!g_control_ctx.initialized || mode >= CONTROL_MODE_COUNT) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    xSemaphoreTake(g_control_ctx.mutex, portMAX_DELAY);
+    control_mode_t old_mode = g_control_ctx.mode;
+    app_err_t ret = control_enter_mode(mode);
+    xSemaphoreGive(g_control_ctx.mutex);
+
+    if (ret == APP_OK) {
+        APP_LOG_INFO(TAG, "Mode: %s → %s", control_mode_to_string(old_mode),
+                    control_mode_to_string(mode));
+    }
+    return ret;
+}
+
+app_err_t controller_set_setpoint(control_mode_t mode, int32_t setpoint)
+{
+    if (!g_control_ctx.initialized ||
+        (mode != CONTROL_MODE_HUMIDITY && mode != CONTROL_MODE_TEMPERATURE)) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    xSemaphoreTake(g_control_ctx.mutex, portMAX_DELAY);
+    if (mode == CONTROL_MODE_HUMIDITY) {
+        g_control_ctx.config.setpoint_hum = setpoint;
+    } else {
+        g_control_ctx.config.setpoint_temp = setpoint;
+    }
+    xSemaphoreGive(g_control_ctx.mutex);
+
+    APP_LOG_INFO(TAG, "%s setpoint set to %.1f", control_mode_to_string(mode), setpoint / 10.0f);
+    return APP_OK;
+}
+
+app_err_t controller_get_status(control_status_t *status)
+{
+    if (!status || !g_control_ctx.initialized) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    xSemaphoreTake(g_control_ctx.mutex, portMAX_DELAY);
+    status->mode = g_control_ctx.mode;
+    status->setpoint = control_active_setpoint();
+    status->measurement = g_control_ctx.measurement;
+    status->output = g_control_ctx.pid.output;
+    status->update_count = g_control_ctx.update_count;
+    xSemaphoreGive(g_control_ctx.mutex);
+
+    return APP_OK;
+}
+
+const char *control_mode_to_string(control_mode_t mode)
+{
+    switch (mode) {
+        case CONTROL_MODE_MANUAL:       return "manual";
+        case CONTROL_MODE_HUMIDITY:     return "humidity";
+        case CONTROL_MODE_TEMPERATURE:  return "temperature";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,149 @@
+/**
+ * @file controller.h
+ * @brief Local closed-loop control of the fan (and relay) from one sensor
+ * @version 2.0
+ *
+ * Modes:
+ * - MANUAL: relay and fan follow the MQTT "relay"/"fan" commands (default)
+ * - HUMIDITY / TEMPERATURE: a PID loop (pid.h) on the control sensor's
+ *   humidity or temperature drives the fan duty, every valid reading. The
+ *   relay is a second stage: on once the fan output reaches
+ *   relay_on_duty, off again at relay_off_duty or below (hysteresis)
+ *
+ * The loop runs in the sensor task, on the device: it needs neither the
+ * broker nor WiFi and keeps regulating during outages. MQTT only sets the
+ * mode and the setpoints:
+ *
+ *   {"type": "mode", "value": 1}              0 manual, 1 humidity, 2 temperature
+ *   {"type": "setpoint_hum", "value": 600}    tenths of a percent
+ *   {"type": "setpoint_temp", "value": 245}   tenths of a degree C
+ *
+ * While a loop is active, "relay" and "fan" commands are rejected, as are
+ * "output"/"outputs" commands that write the first fan or relay channel.
+ * Other channels stay under manual control.
+ * Switching to a loop starts from the current fan duty (bumpless);
+ * switching back to manual leaves the outputs where they are.
+ *
+ * Usage:
+    @code
+    ```c
+    // After app_output_init() (replaces the relay/fan command handlers)
+    control_config_t control_cfg = {
+        .mode = CONTROL_MODE_MANUAL,
+        .setpoint_hum = 600,
+        ...
+    };
+    controller_init(&control_cfg);
+
+    // Sensor task, every reading
+    controller_on_reading(&reading);
+    ```
+    @endcode
+ */
+
+#ifndef CONTROLLER_H
+#define CONTROLLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_common.h"
+#include "pid.h"
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Control modes ("mode" command value)
+ */
+typedef enum {
+    CONTROL_MODE_MANUAL = 0,
+    CONTROL_MODE_HUMIDITY = 1,
+    CONTROL_MODE_TEMPERATURE = 2,
+    CONTROL_MODE_COUNT
+} control_mode_t;
+
+/**
+ * @brief Controller configuration
+ *
+ * Setpoints are in tenths (60.0 % = 600, 24.5 C = 245). PID output range
+ * is the fan duty (0-255), set by controller_init().
+ */
+typedef struct {
+    control_mode_t mode;
+    uint8_t sensor_id;          // Sensor the loops follow
+    int32_t setpoint_hum;       // Tenths of a percent
+    int32_t setpoint_temp;      // Tenths of a degree C
+    pid_config_t humidity;      // Gains per 0.1 %
+    pid_config_t temperature;   // Gains per 0.1 C
+    uint8_t relay_on_duty;      // Relay on at this fan output or above
+    uint8_t relay_off_duty;     // Relay off at this fan output or below
+} control_config_t;
+
+/**
+ * @brief Controller state (for reports)
+ */
+typedef struct {
+    control_mode_t mode;
+    int32_t setpoint;           // Of the active loop, tenths
+    int32_t measurement;        // Last reading used, tenths
+    int32_t output;             // Last fan duty
+    uint32_t update_count;
+} control_status_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Initialize the controller and register its commands
+ *
+ * Registers "mode", "setpoint_hum" and "setpoint_temp", and replaces the
+ * "relay"/"fan"/"output"/"outputs" handlers with ones that are rejected on
+ * the loop's outputs while a loop runs.
+ *
+ * @param config Configuration, copied
+ * @return `APP_OK` on success, error code otherwise.
+ *
+ * @retval APP_ERR_INVALID_PARAM `NULL` config, bad mode or PID range
+ * @retval APP_ERR_NO_MEMORY Mutex creation failed
+ */
+app_err_t controller_init(const control_config_t *config);
+
+/**
+ * @brief Feed one reading (sensor task)
+ *
+ * Ignored in manual mode, for invalid readings and for other sensors.
+ *
+ * @param reading Reading
+ */
+void controller_on_reading(const sensor_data_t *reading);
+
+/**
+ * @brief Change mode
+ * @param mode Mode
+ * @return `APP_OK`, `APP_ERR_INVALID_PARAM` on a bad mode or before init
+ */
+app_err_t controller_set_mode(control_mode_t mode);
+
+/**
+ * @brief Change the setpoint of a loop
+ * @param mode CONTROL_MODE_HUMIDITY or CONTROL_MODE_TEMPERATURE
+ * @param setpoint Tenths
+ * @return `APP_OK`, `APP_ERR_INVALID_PARAM` on a bad mode or before init
+ */
+app_err_t controller_set_setpoint(control_mode_t mode, int32_t setpoint);
+
+/**
+ * @brief Snapshot of the controller state
+ * @param status Output
+ * @return `APP_OK`, `APP_ERR_INVALID_PARAM` on `NULL` or before init
+ */
+app_err_t controller_get_status(control_status_t *status);
+
+/**
+ * @brief Mode name for logs
+ * @param mode Mode
+ * @return Name ("manual", "humidity", "temperature", "unknown")
+ */
+const char *control_mode_to_string(control_mode_t mode);
+
+#endif // CONTROLLER_H
@@ -0,0 +1,129 @@
+/**
+ * @file pid.h
+ * @brief Fixed-point PID controller with anti-windup
+ * @version 2.0
+ *
+ * Integer-only PID for slow loops (humidity, temperature). Setpoint and
+ * measurement are in the caller's fixed units (tenths of a percent or of
+ * a degree), the output in actuator counts (LEDC duty). Gains are Q16.16.
+ *
+ * - Proportional on error, derivative on measurement: a setpoint change
+ *   does not kick the output
+ * - The integral is kept in output counts, clamped to the output range
+ *   and frozen while the output saturates in the direction of the error
+ *   (conditional integration), so it does not wind up during long
+ *   saturation
+ * - The time step comes from the caller, readings arrive at a variable
+ *   interval
+ *
+ * Usage:
+    @code
+    ```c
+    pid_controller_t pid;
+    pid_config_t cfg = {
+        .kp = PID_GAIN_MILLI(2500),     // 2.5 counts per 0.1 %
+        .ki = PID_GAIN_MILLI(25),       // per 0.1 % per second
+        .out_min = 0,
+        .out_max = 255,
+        .direction = PID_REVERSE        // Fan: more output when too humid
+    };
+    pid_init(&pid, &cfg);
+    pid_reset(&pid, current_duty);      // Bumpless start
+
+    int32_t duty = pid_update(&pid, 600, humidity_tenths, dt_ms);
+    ```
+    @endcode
+ *
+ * @note Not thread-safe, one instance per loop.
+ */
+
+#ifndef PID_H
+#define PID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_common.h"
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+#define PID_Q_BITS          16                      /**< Gain fraction bits */
+#define PID_GAIN_ONE        (1 << PID_Q_BITS)       /**< Gain of 1.0 */
+#define PID_MAX_DT_MS       60000                   /**< Longer steps are clamped */
+
+/** Q16.16 gain from thousandths, e.g. PID_GAIN_MILLI(2500) = 2.5 */
+#define PID_GAIN_MILLI(m)   ((int32_t)(((int64_t)(m) * PID_GAIN_ONE) / 1000))
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Sign of the process
+ */
+typedef enum {
+    PID_DIRECT = 0,     // Output raises the measurement (heater)
+    PID_REVERSE = 1     // Output lowers the measurement (fan, dehumidifier)
+} pid_direction_t;
+
+/**
+ * @brief Tuning and output range
+ */
+typedef struct {
+    int32_t kp;                 // Q16.16 counts per unit of error
+    int32_t ki;                 // Q16.16 counts per unit of error and second
+    int32_t kd;                 // Q16.16 counts per unit/s of measurement change
+    int32_t out_min;
+    int32_t out_max;
+    pid_direction_t direction;
+} pid_config_t;
+
+/**
+ * @brief Controller state
+ */
+typedef struct {
+    pid_config_t config;
+    int64_t integral;           // Q16.16 output counts
+    int32_t last_measurement;
+    int32_t output;             // Last pid_update() result
+    bool primed;                // last_measurement is valid
+} pid_controller_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Initialize a controller (output at out_min)
+ * @param pid Controller
+ * @param config Tuning, copied
+ * @return `APP_OK`, `APP_ERR_INVALID_PARAM` on `NULL` or an empty output range
+ */
+app_err_t pid_init(pid_controller_t *pid, const pid_config_t *config);
+
+/**
+ * @brief Restart from a given output (bumpless transfer)
+ *
+ * Loads the integral with the output the actuator is at, and forgets the
+ * last measurement. The next update subtracts its P term from the
+ * integral, so it returns that output (as far as the integral's range
+ * allows) and the loop continues from there.
+ *
+ * @param pid Controller
+ * @param output Current actuator output, clamped to the range
+ */
+void pid_reset(pid_controller_t *pid, int32_t output);
+
+/**
+ * @brief Run one step
+ *
+ * The first step after init/reset has no derivative term, does not
+ * integrate and returns the reset output (see pid_reset()).
+ *
+ * @param pid Controller
+ * @param setpoint Target, in measurement units
+ * @param measurement Process value
+ * @param dt_ms Time since the previous step (clamped to PID_MAX_DT_MS)
+ * @return Output, within [out_min, out_max]
+ */
+int32_t pid_update(pid_controller_t *pid, int32_t setpoint, int32_t measurement, uint32_t dt_ms);
+
+#endif // PID_H
@@ -0,0 +1,120 @@
+/**
+ * @file pid.c
+ * @brief Fixed-point PID controller with anti-windup
+ * @version 2.0
+ *
+ * Arithmetic:
+ * - Terms are Q16.16 output counts in 64 bits: gain (Q16.16) times an
+ *   error in measurement units
+ * - Integral step: ki * error * dt_ms / 1000
+ * - Derivative: kd * (change of measurement) * 1000 / dt_ms, with the
+ *   sign that opposes the change for the process direction
+ * - The sum is clamped to the output range, then rounded to counts
+ */
+
+#include "pid.h"
+#include <string.h>
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+
+static int64_t pid_clamp_q(const pid_controller_t *pid, int64_t value_q)
+{
+    int64_t min_q = (int64_t)pid->config.out_min * PID_GAIN_ONE;
+    int64_t max_q = (int64_t)pid->config.out_max * PID_GAIN_ONE;
+
+    if (value_q < min_q) {
+        return min_q;
+    }
+    if (value_q > max_q) {
+        return max_q;
+    }
+    return value_q;
+}
+
+/**
+ * @brief Q16.16 to counts, rounded half away from zero
+ */
+static int32_t pid_round_q(int64_t value_q)
+{
+    if (value_q >= 0) {
+        return (int32_t)((value_q + PID_GAIN_ONE / 2) / PID_GAIN_ONE);
+    }
+    return -(int32_t)((-value_q + PID_GAIN_ONE / 2) / PID_GAIN_ONE);
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+app_err_t pid_init(pid_controller_t *pid, const pid_config_t *config)
+{
+    if (!pid || !config || config->out_min >= config->out_max) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    memset(pid, 0, sizeof(*pid));
+    pid->config = *config;
+    pid_reset(pid, config->out_min);
+    return APP_OK;
+}
+
+void pid_reset(pid_controller_t *pid, int32_t output)
+{
+    if (!pid) {
+        return;
+    }
+
+    pid->integral = pid_clamp_q(pid, (int64_t)output * PID_GAIN_ONE);
+    pid->output = pid_round_q(pid->integral);
+    pid->primed = false;
+}
+
+int32_t pid_update(pid_controller_t *pid, int32_t setpoint, int32_t measurement, uint32_t dt_ms)
+{
+    if (!pid) {
+        return 0;
+    }
+
+    const pid_config_t *cfg = &pid->config;
+    int64_t sign = (cfg->direction == PID_REVERSE) ? -1 : 1;
+    int64_t error = sign * ((int64_t)setpoint - measurement);
+
+    if (dt_ms > PID_MAX_DT_MS) {
+        dt_ms = PID_MAX_DT_MS;
+    }
+
+    int64_t p_term = (int64_t)cfg->kp * error;
+    int64_t d_term = 0;
+    int64_t i_step = 0;
+
+    // Bumpless: the first step after init/reset keeps the output it was
+    // reset to, the integral takes up the P term
+    if (!pid->primed) {
+        pid->integral = pid_clamp_q(pid, pid->integral - p_term);
+    }
+
+    if (pid->primed && dt_ms > 0) {
+        int64_t change = (int64_t)measurement - pid->last_measurement;
+        d_term = -sign * (int64_t)cfg->kd * change * 1000 / (int64_t)dt_ms;
+        i_step = (int64_t)cfg->ki * error * (int64_t)dt_ms / 1000;
+    }
+
+    // Conditional integration: no integral step that pushes further into saturation
+    int64_t integral = pid_clamp_q(pid, pid->integral + i_step);
+    int64_t max_q = (int64_t)cfg->out_max * PID_GAIN_ONE;
+    int64_t min_q = (int64_t)cfg->out_min * PID_GAIN_ONE;
+    int64_t unclamped = p_term + integral + d_term;
+
+    if ((unclamped > max_q && i_step > 0) || (unclamped < min_q && i_step < 0)) {
+        integral = pid->integral;
+        unclamped = p_term + integral + d_term;
+    }
+
+    pid->integral = integral;
+    pid->last_measurement = measurement;
+    pid->primed = true;
+    pid->output = pid_round_q(pid_clamp_q(pid, unclamped));
+    return pid->output;
+}
@@ -0,0 +1,237 @@
+/**
+ * @file log_binary.h
+ * @brief Deferred log records - argument capture, text rendering, binary frames
+ * @version 2.0
+ *
+ * A log record is a format string plus its arguments captured by value
+ * (log_arg_t), formatted later by log_binary_render() or shipped as binary
+ * frames and formatted on Linux (tools/log_decoder).
+ *
+ * Frame layout (integers little-endian):
+ *
+ *   [0xA5][type:u8][len:u16][payload:len][checksum:u8]
+ *
+ *   FORMAT  [id:u16][level:u8][tag\0][fmt\0]          once per call site
+ *   RECORD  [id:u16][time_ms:u32][argc:u8][arg]...    per log call
+ *   TEXT    [level:u8][time_ms:u32][tag\0][line\0]    already formatted
+ *   DROPPED [count:u32]                               records lost
+ *
+ *   arg := [LOG_ARG_KIND_STRING][len:u8][bytes\0] | [kind:u8][value:u64]
+ *
+ * The checksum is the XOR of type, length and payload bytes. A decoder
+ * reading a raw UART stream skips anything that is not a valid frame, so
+ * frames and plain console text can share one line.
+ *
+ * @note This header and log_binary.c are shared with the Linux decoder in
+ *       tools/log_decoder, so keep them free of ESP-IDF includes.
+ *
+ * Usage:
+    @code
+    ```c
+    log_arg_t args[2] = { { .i = 3 }, { .d = 21.5 } };
+    char line[128];
+    log_binary_render("Sensor %d: %.1f C", args, 2, line, sizeof(line));
+
+    uint8_t frame[LOG_BINARY_MAX_FRAME];
+    int len = log_binary_encode_record(7, 1234, "Sensor %d: %.1f C", args, 2,
+                                       frame, sizeof(frame));
+    ```
+    @endcode
+ */
+
+#ifndef LOG_BINARY_H
+#define LOG_BINARY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+   FORMAT CONSTANTS
+   ============================================================================ */
+
+#define LOG_BINARY_MAX_ARGS         6       /**< Arguments per record */
+#define LOG_BINARY_MAX_STRING       63      /**< Bytes of a string argument kept */
+#define LOG_BINARY_SYNC             0xA5    /**< First byte of every frame */
+#define LOG_BINARY_HEADER_SIZE      4       /**< Sync, type, length */
+#define LOG_BINARY_MAX_FRAME        512     /**< Largest frame, checksum included */
+
+/** @defgroup LOG_BINARY_FRAMES Frame types
+ * @{
+ */
+#define LOG_BINARY_FRAME_FORMAT     1
+#define LOG_BINARY_FRAME_RECORD     2
+#define LOG_BINARY_FRAME_TEXT       3
+#define LOG_BINARY_FRAME_DROPPED    4
+/** @} */
+
+/** @defgroup LOG_BINARY_LEVELS Levels (same values as esp_log_level_t)
+ * @{
+ */
+#define LOG_BINARY_LEVEL_ERROR      1
+#define LOG_BINARY_LEVEL_WARN       2
+#define LOG_BINARY_LEVEL_INFO       3
+#define LOG_BINARY_LEVEL_DEBUG      4
+/** @} */
+
+/** @defgroup LOG_BINARY_ERRORS Codec error codes
+ * @{
+ */
+#define LOG_BINARY_ERR_PARAM        -1  /**< NULL pointer or bad argument */
+#define LOG_BINARY_ERR_NO_SPACE     -2  /**< Output buffer too small */
+#define LOG_BINARY_ERR_INCOMPLETE   -3  /**< Frame continues past the input */
+#define LOG_BINARY_ERR_MALFORMED    -4  /**< Not a valid frame */
+/** @} */
+
+/* ============================================================================
+   TYPES
+   ============================================================================ */
+
+/**
+ * @brief One captured argument; the format conversion picks the member
+ */
+typedef union {
+    int64_t i;              // Signed integers and chars
+    uint64_t u;             // Unsigned integers
+    double d;               // float and double
+    const void *p;          // %s (static strings only) and %p
+} log_arg_t;
+
+/**
+ * @brief How an argument is consumed by its conversion
+ */
+typedef enum {
+    LOG_ARG_KIND_INT = 0,   // d i u x X o c, and * width/precision
+    LOG_ARG_KIND_DOUBLE,    // f F e E g G a A
+    LOG_ARG_KIND_STRING,    // s
+    LOG_ARG_KIND_POINTER    // p
+} log_arg_kind_t;
+
+/**
+ * @brief A decoded frame; strings point into the input buffer
+ */
+typedef struct {
+    uint8_t type;           // LOG_BINARY_FRAME_*
+    uint16_t id;            // FORMAT, RECORD
+    uint8_t level;          // FORMAT, TEXT
+    uint32_t time_ms;       // RECORD, TEXT
+    uint32_t dropped;       // DROPPED
+    const char *tag;        // FORMAT, TEXT
+    const char *text;       // FORMAT (format string), TEXT (line)
+    uint8_t argc;           // RECORD
+    log_arg_t args[LOG_BINARY_MAX_ARGS];
+} log_binary_frame_t;
+
+/* ============================================================================
+   PUBLIC API - FORMATTING
+   ============================================================================ */
+
+/**
+ * @brief Argument kinds a format string consumes, in order
+ * @param fmt printf-style format
+ * @param kinds Output, may be NULL to only count
+ * @param max_kinds Capacity of `kinds`
+ * @return Number of arguments, LOG_BINARY_ERR_NO_SPACE if more than `max_kinds`
+ */
+int log_binary_arg_kinds(const char *fmt, log_arg_kind_t *kinds, size_t max_kinds);
+
+/**
+ * @brief Format captured arguments, like snprintf()
+ *
+ * Conversions without an argument print as `?`. `%s` with NULL prints
+ * `(null)`.
+ *
+ * @param fmt printf-style format
+ * @param args Arguments
+ * @param argc Number of arguments
+ * @param out Output buffer, always NUL-terminated
+ * @param size Output buffer size
+ * @return Length written (truncated to size - 1)
+ */
+size_t log_binary_render(const char *fmt, const log_arg_t *args, size_t argc,
+                         char *out, size_t size);
+
+/**
+ * @brief Level letter as printed by ESP-IDF (E, W, I, D)
+ * @param level LOG_BINARY_LEVEL_*
+ * @return Letter, `?` if unknown
+ */
+char log_binary_level_char(uint8_t level);
+
+/* ============================================================================
+   PUBLIC API - FRAMES
+   ============================================================================ */
+
+/**
+ * @brief Encode a FORMAT frame
+ * @param id Call site ID
+ * @param level LOG_BINARY_LEVEL_*
+ * @param tag Component tag
+ * @param fmt Format string
+ * @param buf Output buffer
+ * @param size Output buffer size
+ * @return Frame length in bytes, or negative LOG_BINARY_ERR_* code
+ */
+int log_binary_encode_format(uint16_t id, uint8_t level, const char *tag, const char *fmt,
+                             uint8_t *buf, size_t size);
+
+/**
+ * @brief Encode a RECORD frame
+ *
+ * Argument kinds come from `fmt`; string arguments are copied (up to
+ * LOG_BINARY_MAX_STRING bytes), so the decoder needs no device memory.
+ *
+ * @param id Call site ID from a previous FORMAT frame
+ * @param time_ms Capture time
+ * @param fmt Format string of the call site
+ * @param args Arguments
+ * @param argc Number of arguments
+ * @param buf Output buffer
+ * @param size Output buffer size, LOG_BINARY_MAX_FRAME always fits
+ * @return Frame length in bytes, or negative LOG_BINARY_ERR_* code
+ */
+int log_binary_encode_record(uint16_t id, uint32_t time_ms, const char *fmt,
+                             const log_arg_t *args, size_t argc, uint8_t *buf, size_t size);
+
+/**
+ * @brief Encode a TEXT frame
+ * @param level LOG_BINARY_LEVEL_*
+ * @param time_ms Capture time
+ * @param tag Component tag
+ * @param line Formatted message
+ * @param buf Output buffer
+ * @param size Output buffer size
+ * @return Frame length in bytes, or negative LOG_BINARY_ERR_* code
+ */
+int log_binary_encode_text(uint8_t level, uint32_t time_ms, const char *tag, const char *line,
+                           uint8_t *buf, size_t size);
+
+/**
+ * @brief Encode a DROPPED frame
+ * @param count Records lost since the previous DROPPED frame
+ * @param buf Output buffer
+ * @param size Output buffer size
+ * @return Frame length in bytes, or negative LOG_BINARY_ERR_* code
+ */
+int log_binary_encode_dropped(uint32_t count, uint8_t *buf, size_t size);
+
+/**
+ * @brief Decode the frame at the start of a buffer
+ * @param buf Input, starting with LOG_BINARY_SYNC
+ * @param len Input length
+ * @param frame Output
+ * @return Bytes consumed, or negative LOG_BINARY_ERR_* code
+ *
+ * @retval LOG_BINARY_ERR_INCOMPLETE Read more input and retry
+ * @retval LOG_BINARY_ERR_MALFORMED Skip one byte and resynchronize
+ */
+int log_binary_decode(const uint8_t *buf, size_t len, log_binary_frame_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOG_BINARY_H */
@@ -0,0 +1,196 @@
+/**
+ * @file log_deferred.h
+ * @brief Deferred logging - capture on the hot path, format in a low-priority task
+ * @version 2.0
+ *
+ * APP_LOG_DEFER_* take the same arguments as APP_LOG_*, but the calling
+ * task only stores the format pointer, the tag and the raw argument values
+ * in a lock-free multi-producer ring (a few dozen instructions, no
+ * formatting, no UART). The logger task drains the ring and either prints
+ * the lines like ESP_LOGx or ships binary frames (log_binary.h) to a sink,
+ * decoded on Linux by tools/log_decoder.
+ *
+ * Rules for call sites:
+ * - At most LOG_BINARY_MAX_ARGS arguments
+ * - `%s` arguments must be static strings (literals, *_to_string()
+ *   results): they are read when the record is formatted, not when it is
+ *   logged. Keep APP_LOG_* for buffers and `%.*s` payloads.
+ *
+ * Before log_deferred_start() records are formatted and printed on the
+ * spot, so early boot logs and host tests behave like APP_LOG_*.
+ *
+ * Usage:
+    @code
+    ```c
+    // Once, early in app_main()
+    log_deferred_config_t log_cfg = {
+        .task_stack = DEFAULT_LOG_TASK_STACK,
+        .task_priority = DEFAULT_LOG_TASK_PRIORITY
+    };
+    log_deferred_start(&log_cfg);
+
+    // Hot path
+    APP_LOG_DEFER_INFO(TAG, "Relay: %s → %s", old ? "ON" : "OFF", state ? "ON" : "OFF");
+    APP_LOG_DEFER_DEBUG(TAG, "Sensor %d: T=%.1f H=%.1f", id, temperature, humidity);
+    ```
+    @endcode
+ *
+ * @note Once started, safe from any task or ISR. A full ring drops the
+ *       record (counted in the log_dropped_total metric and reported by the
+ *       logger task).
+ */
+
+#ifndef LOG_DEFERRED_H
+#define LOG_DEFERRED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include "app_common.h"
+#include "log_binary.h"
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+#define LOG_DEFERRED_RING_SIZE      64      /**< Records in flight (power of two) */
+#define LOG_DEFERRED_MAX_FORMATS    128     /**< Call sites with a binary ID */
+#define LOG_DEFERRED_LINE_MAX       256     /**< Longest formatted line */
+#define LOG_DEFERRED_FLUSH_MS       20      /**< Logger task drain period */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Receives formatted lines (text) or frames (binary)
+ * @param data Bytes
+ * @param len Length
+ * @param ctx Context from the configuration
+ */
+typedef void (*log_deferred_sink_t)(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * @brief Logger configuration
+ */
+typedef struct {
+    bool binary;                // Ship frames instead of text lines
+    log_deferred_sink_t sink;   // NULL: text to stdout (required for binary)
+    void *sink_ctx;
+    uint32_t task_stack;
+    uint8_t task_priority;
+} log_deferred_config_t;
+
+/* =========================================================================
+   CAPTURE MACROS
+   ========================================================================= */
+#define APP_LOG_DEFER_ERROR(tag, fmt, ...) LOG_DEFERRED(LOG_BINARY_LEVEL_ERROR, tag, "[ERROR] " fmt, ##__VA_ARGS__)
+#define APP_LOG_DEFER_WARN(tag, fmt, ...) LOG_DEFERRED(LOG_BINARY_LEVEL_WARN, tag, "[WARN] " fmt, ##__VA_ARGS__)
+#define APP_LOG_DEFER_INFO(tag, fmt, ...) LOG_DEFERRED(LOG_BINARY_LEVEL_INFO, tag, "[INFO] " fmt, ##__VA_ARGS__)
+#define APP_LOG_DEFER_DEBUG(tag, fmt, ...) LOG_DEFERRED(LOG_BINARY_LEVEL_DEBUG, tag, "[DEBUG] " fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Capture a record if its level is enabled
+ *
+ * The dead printf() keeps the compiler's format checking. Levels above the
+ * translation unit's APP_LOG_LEVEL fold away at compile time (LOG_BINARY_LEVEL_*
+ * and APP_LOG_LEVEL_* share values).
+ */
+#define LOG_DEFERRED(level, tag, fmt, ...) do {                                     \
+        if (0) {                                                                    \
+            printf(fmt, ##__VA_ARGS__);                                             \
+        }                                                                           \
+        if ((level) <= APP_LOG_LEVEL && log_deferred_enabled(level)) {              \
+            _Static_assert(LOG_DEFERRED_NARGS(__VA_ARGS__) <= LOG_BINARY_MAX_ARGS,  \
+                           "too many deferred log arguments");                      \
+            const log_arg_t log_args_[] = {                                         \
+                LOG_DEFERRED_CAT(LOG_DEFERRED_ARGS_, LOG_DEFERRED_NARGS(__VA_ARGS__))(__VA_ARGS__) \
+            };                                                                      \
+            log_deferred_write(level, tag, fmt, log_args_, LOG_DEFERRED_NARGS(__VA_ARGS__)); \
+        }                                                                           \
+    } while (0)
+
+/* Argument capture: one log_arg_t per argument, member chosen by type */
+#define LOG_DEFERRED_ARG(x) _Generic((x),                                           \
+        float: log_arg_double, double: log_arg_double, long double: log_arg_double, \
+        _Bool: log_arg_uint, unsigned char: log_arg_uint,                           \
+        unsigned short: log_arg_uint, unsigned int: log_arg_uint,                   \
+        unsigned long: log_arg_uint, unsigned long long: log_arg_uint,              \
+        char: log_arg_int, signed char: log_arg_int, short: log_arg_int,            \
+        int: log_arg_int, long: log_arg_int, long long: log_arg_int,                \
+        default: log_arg_ptr)(x)
+
+#define LOG_DEFERRED_NARGS(...) LOG_DEFERRED_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_DEFERRED_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define LOG_DEFERRED_CAT(a, b) LOG_DEFERRED_CAT_(a, b)
+#define LOG_DEFERRED_CAT_(a, b) a##b
+
+#define LOG_DEFERRED_ARGS_0() { .u = 0 }
+#define LOG_DEFERRED_ARGS_1(a) LOG_DEFERRED_ARG(a)
+#define LOG_DEFERRED_ARGS_2(a, ...) LOG_DEFERRED_ARG(a), LOG_DEFERRED_ARGS_1(__VA_ARGS__)
+#define LOG_DEFERRED_ARGS_3(a, ...) LOG_DEFERRED_ARG(a), LOG_DEFERRED_ARGS_2(__VA_ARGS__)
+#define LOG_DEFERRED_ARGS_4(a, ...) LOG_DEFERRED_ARG(a), LOG_DEFERRED_ARGS_3(__VA_ARGS__)
+#define LOG_DEFERRED_ARGS_5(a, ...) LOG_DEFERRED_ARG(a), LOG_DEFERRED_ARGS_4(__VA_ARGS__)
+#define LOG_DEFERRED_ARGS_6(a, ...) LOG_DEFERRED_ARG(a), LOG_DEFERRED_ARGS_5(__VA_ARGS__)
+
+static inline log_arg_t log_arg_int(long long value) { return (log_arg_t){ .i = value }; }
+static inline log_arg_t log_arg_uint(unsigned long long value) { return (log_arg_t){ .u = value }; }
+static inline log_arg_t log_arg_double(double value) { return (log_arg_t){ .d = value }; }
+static inline log_arg_t log_arg_ptr(const void *value) { return (log_arg_t){ .p = value }; }
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+extern atomic_uint g_log_deferred_level;
+
+/**
+ * @brief Whether records of a level are captured
+ * @param level LOG_BINARY_LEVEL_*
+ * @return true if enabled
+ */
+static inline bool log_deferred_enabled(uint8_t level)
+{
+    return level <= atomic_load_explicit(&g_log_deferred_level, memory_order_relaxed);
+}
+
+/**
+ * @brief Capture one record (use the APP_LOG_DEFER_* macros)
+ * @param level LOG_BINARY_LEVEL_*
+ * @param tag Component tag (static string)
+ * @param fmt Format (static string)
+ * @param args Arguments
+ * @param argc Number of arguments, at most LOG_BINARY_MAX_ARGS
+ */
+void log_deferred_write(uint8_t level, const char *tag, const char *fmt,
+                        const log_arg_t *args, size_t argc);
+
+/**
+ * @brief Start the logger task
+ *
+ * @param config Configuration
+ * @return `APP_OK` on success, error code otherwise.
+ *
+ * @retval APP_ERR_INVALID_PARAM `NULL` config, or binary without a sink
+ * @retval APP_ERR_NO_MEMORY Task creation failed
+ */
+app_err_t log_deferred_start(const log_deferred_config_t *config);
+
+/**
+ * @brief Set the most verbose level captured
+ *
+ * Defaults to CONFIG_LOG_DEFAULT_LEVEL (INFO when not set).
+ *
+ * @param level LOG_BINARY_LEVEL_*
+ */
+void log_deferred_set_level(uint8_t level);
+
+/**
+ * @brief Send all FORMAT frames again before their next record
+ *
+ * Call when a new decoder attaches to the binary stream. The system
+ * monitor calls it every DEFAULT_LOG_RESYNC_INTERVAL_MS, so a decoder
+ * attached after boot names every call site within that time.
+ */
+void log_deferred_resync(void);
+
+#endif // LOG_DEFERRED_H
@@ -0,0 +1,625 @@
+/**
+ * @file log_binary.c
+ * @brief Deferred log records - rendering and binary frame codec
+ * @version 2.0
+ *
+ * Portable C, no ESP-IDF dependencies (also built for Linux by
+ * tools/log_decoder).
+ *
+ * Rendering walks the format once and hands every conversion, with its
+ * flags, width and precision, to snprintf() together with one argument of
+ * the matching C type. `*` widths are resolved from the arguments first.
+ */
+
+#include "log_binary.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+   PRIVATE HELPERS - FORMAT PARSING
+   ============================================================================ */
+
+typedef enum {
+    SPEC_LEN_INT = 0,       // none, hh, h
+    SPEC_LEN_LONG,          // l
+    SPEC_LEN_LONG_LONG      // ll, j, z, t
+} spec_length_t;
+
+/**
+ * @brief One conversion specification, `%` excluded
+ */
+typedef struct {
+    char flags[6];
+    char width[8];          // Digits, or "*"
+    char precision[8];      // Digits or "*", empty = none
+    bool has_precision;
+    spec_length_t length;
+    char conversion;
+} log_spec_t;
+
+static bool spec_copy_digits(const char **p, char *out, size_t size)
+{
+    size_t n = 0;
+    if (**p == '*') {
+        out[n++] = *(*p)++;
+    } else {
+        while (**p >= '0' && **p <= '9') {
+            if (n + 1 >= size) {
+                return false;
+            }
+            out[n++] = *(*p)++;
+        }
+    }
+    out[n] = '\0';
+    return true;
+}
+
+/**
+ * @brief Parse a conversion
+ * @param p First character after `%`
+ * @param spec Output
+ * @return Character after the conversion, NULL if malformed
+ */
+static const char *spec_parse(const char *p, log_spec_t *spec)
+{
+    memset(spec, 0, sizeof(*spec));
+
+    size_t n = 0;
+    while (*p && strchr("-+ #0", *p)) {
+        if (n + 1 >= sizeof(spec->flags)) {
+            return NULL;
+        }
+        spec->flags[n++] = *p++;
+    }
+
+    if (!spec_copy_digits(&p, spec->width, sizeof(spec->width))) {
+        return NULL;
+    }
+    if (*p == '.') {
+        p++;
+        spec->has_precision = true;
+        if (!spec_copy_digits(&p, spec->precision, sizeof(spec->precision))) {
+            return NULL;
+        }
+    }
+
+    if (p[0] == 'h') {
+        p += (p[1] == 'h') ? 2 : 1;
+    } else if (p[0] == 'l' && p[1] == 'l') {
+        spec->length = SPEC_LEN_LONG_LONG;
+        p += 2;
+    } else if (p[0] == 'l') {
+        spec->length = SPEC_LEN_LONG;
+        p++;
+    } else if (p[0] == 'j' || p[0] == 'z' || p[0] == 't') {
+        spec->length = SPEC_LEN_LONG_LONG;
+        p++;
+    } else if (p[0] == 'L') {
+        p++;
+    }
+
+    if (!*p || !strchr("diuoxXcfFeEgGaAspn", *p)) {
+        return NULL;
+    }
+    spec->conversion = *p++;
+    return p;
+}
+
+static log_arg_kind_t spec_kind(char conversion)
+{
+    switch (conversion) {
+        case 'f': case 'F': case 'e': case 'E':
+        case 'g': case 'G': case 'a': case 'A':
+            return LOG_ARG_KIND_DOUBLE;
+        case 's':
+            return LOG_ARG_KIND_STRING;
+        case 'p':
+            return LOG_ARG_KIND_POINTER;
+        default:
+            return LOG_ARG_KIND_INT;
+    }
+}
+
+/* ============================================================================
+   PRIVATE HELPERS - RENDERING
+   ============================================================================ */
+
+typedef struct {
+    char *out;
+    size_t size;
+    size_t len;
+} render_writer_t;
+
+static void render_append(render_writer_t *w, const char *s, size_t n)
+{
+    size_t room = w->size - 1 - w->len;
+    if (n > room) {
+        n = room;
+    }
+    memcpy(w->out + w->len, s, n);
+    w->len += n;
+    w->out[w->len] = '\0';
+}
+
+static void render_advance(render_writer_t *w, int written)
+{
+    if (written > 0) {
+        size_t room = w->size - 1 - w->len;
+        w->len += ((size_t)written < room) ? (size_t)written : room;
+    }
+}
+
+/**
+ * @brief Resolve a `*` to the digits of the next argument
+ * @return false if the argument is missing
+ */
+static bool render_star(char *field, size_t size, const log_arg_t *args, size_t argc, size_t *next)
+{
+    if (field[0] != '*') {
+        return true;
+    }
+    if (*next >= argc) {
+        return false;
+    }
+    snprintf(field, size, "%d", (int)args[(*next)++].i);
+    return true;
+}
+
+static void render_conversion(render_writer_t *w, const log_spec_t *spec, const log_arg_t *arg)
+{
+    static const char *const length_text[] = {
+        [SPEC_LEN_INT] = "",
+        [SPEC_LEN_LONG] = "l",
+        [SPEC_LEN_LONG_LONG] = "ll"
+    };
+
+    char conversion = spec->conversion;
+    const char *length = length_text[spec->length];
+    if (spec_kind(conversion) != LOG_ARG_KIND_INT || conversion == 'c') {
+        length = "";
+    }
+
+    char format[40];
+    snprintf(format, sizeof(format), "%%%s%s%s%s%s%c", spec->flags, spec->width,
+             spec->has_precision ? "." : "", spec->precision, length, conversion);
+
+    char *dst = w->out + w->len;
+    size_t room = w->size - w->len;
+    int written = 0;
+
+    switch (conversion) {
+        case 'd': case 'i':
+            if (spec->length == SPEC_LEN_LONG_LONG) {
+                written = snprintf(dst, room, format, (long long)arg->i);
+            } else if (spec->length == SPEC_LEN_LONG) {
+                written = snprintf(dst, room, format, (long)arg->i);
+            } else {
+                written = snprintf(dst, room, format, (int)arg->i);
+            }
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            if (spec->length == SPEC_LEN_LONG_LONG) {
+                written = snprintf(dst, room, format, (unsigned long long)arg->u);
+            } else if (spec->length == SPEC_LEN_LONG) {
+                written = snprintf(dst, room, format, (unsigned long)arg->u);
+            } else {
+                written = snprintf(dst, room, format, (unsigned int)arg->u);
+            }
+            break;
+        case 'c':
+            written = snprintf(dst, room, format, (int)arg->i);
+            break;
+        case 's':
+            written = snprintf(dst, room, format, arg->p ? (const char *)arg->p : "(null)");
+            break;
+        case 'p':
+            written = snprintf(dst, room, format, arg->p);
+            break;
+        case 'n':
+            break;
+        default:
+            written = snprintf(dst, room, format, arg->d);
+            break;
+    }
+    render_advance(w, written);
+}
+
+/* ============================================================================
+   PRIVATE HELPERS - FRAMES
+   ============================================================================ */
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+    bool overflow;
+} frame_writer_t;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+} frame_reader_t;
+
+static void frame_put(frame_writer_t *w, const void *data, size_t n)
+{
+    if (w->overflow || n > w->size - w->len) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buf + w->len, data, n);
+    w->len += n;
+}
+
+static void frame_put_u8(frame_writer_t *w, uint8_t value)
+{
+    frame_put(w, &value, 1);
+}
+
+static void frame_put_uint(frame_writer_t *w, uint64_t value, size_t bytes)
+{
+    uint8_t le[8];
+    for (size_t i = 0; i < bytes; i++) {
+        le[i] = (uint8_t)(value >> (8 * i));
+    }
+    frame_put(w, le, bytes);
+}
+
+static void frame_put_string(frame_writer_t *w, const char *s, size_t max_len)
+{
+    size_t n = strlen(s);
+    if (n > max_len) {
+        n = max_len;
+    }
+    frame_put(w, s, n);
+    frame_put_u8(w, 0);
+}
+
+static bool frame_begin(frame_writer_t *w, uint8_t type, uint8_t *buf, size_t size)
+{
+    if (!buf) {
+        return false;
+    }
+    *w = (frame_writer_t){ .buf = buf, .size = size };
+    frame_put_u8(w, LOG_BINARY_SYNC);
+    frame_put_u8(w, type);
+    frame_put_uint(w, 0, 2);   // Length, patched in frame_end()
+    return true;
+}
+
+static int frame_end(frame_writer_t *w)
+{
+    size_t payload = w->len - LOG_BINARY_HEADER_SIZE;
+    if (w->overflow || payload > LOG_BINARY_MAX_FRAME - LOG_BINARY_HEADER_SIZE - 1) {
+        return LOG_BINARY_ERR_NO_SPACE;
+    }
+    w->buf[2] = (uint8_t)payload;
+    w->buf[3] = (uint8_t)(payload >> 8);
+
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < w->len; i++) {
+        checksum ^= w->buf[i];
+    }
+    frame_put_u8(w, checksum);
+    return w->overflow ? LOG_BINARY_ERR_NO_SPACE : (int)w->len;
+}
+
+static bool frame_get_uint(frame_reader_t *r, size_t bytes, uint64_t *value)
+{
+    if (bytes > r->len - r->pos) {
+        return false;
+    }
+    *value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        *value |= (uint64_t)r->buf[r->pos + i] << (8 * i);
+    }
+    r->pos += bytes;
+    return true;
+}
+
+static bool frame_get_string(frame_reader_t *r, const char **s)
+{
+    const uint8_t *end = memchr(r->buf + r->pos, 0, r->len - r->pos);
+    if (!end) {
+        return false;
+    }
+    *s = (const char *)(r->buf + r->pos);
+    r->pos = (size_t)(end - r->buf) + 1;
+    return true;
+}
+
+static bool frame_get_args(frame_reader_t *r, log_binary_frame_t *frame)
+{
+    uint64_t value;
+    if (!frame_get_uint(r, 1, &value) || value > LOG_BINARY_MAX_ARGS) {
+        return false;
+    }
+    frame->argc = (uint8_t)value;
+
+    for (size_t i = 0; i < frame->argc; i++) {
+        uint64_t kind;
+        if (!frame_get_uint(r, 1, &kind)) {
+            return false;
+        }
+        if (kind == LOG_ARG_KIND_STRING) {
+            if (!frame_get_uint(r, 1, &value) || value + 1 > r->len - r->pos ||
+                r->buf[r->pos + value] != 0) {
+                return false;
+            }
+            frame->args[i].p = r->buf + r->pos;
+            r->pos += value + 1;
+        } else if (!frame_get_uint(r, 8, &value)) {
+            return false;
+        } else if (kind == LOG_ARG_KIND_DOUBLE) {
+            memcpy(&frame->args[i].d, &value, sizeof(double));
+        } else if (kind == LOG_ARG_KIND_POINTER) {
+            frame->args[i].p = (const void *)(uintptr_t)value;
+        } else {
+            frame->args[i].u = value;
+        }
+    }
+    return true;
+}
+
+/* ============================================================================
+   PUBLIC API - FORMATTING
+   ============================================================================ */
+
+int log_binary_arg_kinds(const char *fmt, log_arg_kind_t *kinds, size_t max_kinds)
+{
+    if (!fmt) {
+        return LOG_BINARY_ERR_PARAM;
+    }
+
+    size_t count = 0;
+    for (const char *p = fmt; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        if (p[1] == '%') {
+            p++;
+            continue;
+        }
+
+        log_spec_t spec;
+        const char *next = spec_parse(p + 1, &spec);
+        if (!next) {
+            break;
+        }
+
+        log_arg_kind_t consumed[3];
+        size_t n = 0;
+        if (spec.width[0] == '*') {
+            consumed[n++] = LOG_ARG_KIND_INT;
+        }
+        if (spec.precision[0] == '*') {
+            consumed[n++] = LOG_ARG_KIND_INT;
+        }
+        consumed[n++] = spec_kind(spec.conversion);
+
+        for (size_t i = 0; i < n; i++) {
+            if (count >= max_kinds && kinds) {
+                return LOG_BINARY_ERR_NO_SPACE;
+            }
+            if (kinds) {
+                kinds[count] = consumed[i];
+            }
+            count++;
+        }
+        p = next - 1;
+    }
+    return (int)count;
+}
+
+size_t log_binary_render(const char *fmt, const log_arg_t *args, size_t argc,
+                         char *out, size_t size)
+{
+    if (!out || size == 0) {
+        return 0;
+    }
+    out[0] = '\0';
+    if (!fmt) {
+        return 0;
+    }
+
+    render_writer_t w = { .out = out, .size = size };
+    size_t next = 0;
+    const char *p = fmt;
+
+    while (*p) {
+        const char *percent = strchr(p, '%');
+        if (!percent) {
+            render_append(&w, p, strlen(p));
+            break;
+        }
+        render_append(&w, p, (size_t)(percent - p));
+
+        if (percent[1] == '%') {
+            render_append(&w, "%", 1);
+            p = percent + 2;
+            continue;
+        }
+
+        log_spec_t spec;
+        const char *end = spec_parse(percent + 1, &spec);
+        if (!end) {
+            render_append(&w, percent, strlen(percent));
+            break;
+        }
+        p = end;
+
+        if (!render_star(spec.width, sizeof(spec.width), args, argc, &next) ||
+            !render_star(spec.precision, sizeof(spec.precision), args, argc, &next) ||
+            next >= argc) {
+            render_append(&w, "?", 1);
+            continue;
+        }
+        render_conversion(&w, &spec, &args[next++]);
+    }
+    return w.len;
+}
+
+char log_binary_level_char(uint8_t level)
+{
+    static const char letters[] = "?EWID";
+    return (level < sizeof(letters) - 1) ? letters[level] : '?';
+}
+
+/* ============================================================================
+   PUBLIC API - FRAMES
+   ============================================================================ */
+
+int log_binary_encode_format(uint16_t id, uint8_t level, const char *tag, const char *fmt,
+                             uint8_t *buf, size_t size)
+{
+    frame_writer_t w;
+    if (!tag || !fmt || !frame_begin(&w, LOG_BINARY_FRAME_FORMAT, buf, size)) {
+        return LOG_BINARY_ERR_PARAM;
+    }
+    frame_put_uint(&w, id, 2);
+    frame_put_u8(&w, level);
+    frame_put_string(&w, tag, LOG_BINARY_MAX_STRING);
+    frame_put_string(&w, fmt, LOG_BINARY_MAX_FRAME);
+    return frame_end(&w);
+}
+
+int log_binary_encode_record(uint16_t id, uint32_t time_ms, const char *fmt,
+                             const log_arg_t *args, size_t argc, uint8_t *buf, size_t size)
+{
+    frame_writer_t w;
+    if (!fmt || (argc && !args) || argc > LOG_BINARY_MAX_ARGS ||
+        !frame_begin(&w, LOG_BINARY_FRAME_RECORD, buf, size)) {
+        return LOG_BINARY_ERR_PARAM;
+    }
+
+    log_arg_kind_t kinds[LOG_BINARY_MAX_ARGS];
+    int kind_count = log_binary_arg_kinds(fmt, kinds, LOG_BINARY_MAX_ARGS);
+    if (kind_count < 0) {
+        kind_count = 0;
+    }
+
+    frame_put_uint(&w, id, 2);
+    frame_put_uint(&w, time_ms, 4);
+    frame_put_u8(&w, (uint8_t)argc);
+    for (size_t i = 0; i < argc; i++) {
+        log_arg_kind_t kind = ((int)i < kind_count) ? kinds[i] : LOG_ARG_KIND_INT;
+        if (kind == LOG_ARG_KIND_STRING && !args[i].p) {
+            kind = LOG_ARG_KIND_POINTER;
+        }
+
+        frame_put_u8(&w, (uint8_t)kind);
+        if (kind == LOG_ARG_KIND_STRING) {
+            const char *s = args[i].p;
+            size_t n = strlen(s);
+            if (n > LOG_BINARY_MAX_STRING) {
+                n = LOG_BINARY_MAX_STRING;
+            }
+            frame_put_u8(&w, (uint8_t)n);
+            frame_put(&w, s, n);
+            frame_put_u8(&w, 0);
+        } else if (kind == LOG_ARG_KIND_DOUBLE) {
+            uint64_t bits;
+            memcpy(&bits, &args[i].d, sizeof(bits));
+            frame_put_uint(&w, bits, 8);
+        } else if (kind == LOG_ARG_KIND_POINTER) {
+            frame_put_uint(&w, (uintptr_t)args[i].p, 8);
+        } else {
+            frame_put_uint(&w, args[i].u, 8);
+        }
+    }
+    return frame_end(&w);
+}
+
+int log_binary_encode_text(uint8_t level, uint32_t time_ms, const char *tag, const char *line,
+                           uint8_t *buf, size_t size)
+{
+    frame_writer_t w;
+    if (!tag || !line || !frame_begin(&w, LOG_BINARY_FRAME_TEXT, buf, size)) {
+        return LOG_BINARY_ERR_PARAM;
+    }
+    frame_put_u8(&w, level);
+    frame_put_uint(&w, time_ms, 4);
+    frame_put_string(&w, tag, LOG_BINARY_MAX_STRING);
+    frame_put_string(&w, line, LOG_BINARY_MAX_FRAME);
+    return frame_end(&w);
+}
+
+int log_binary_encode_dropped(uint32_t count, uint8_t *buf, size_t size)
+{
+    frame_writer_t w;
+    if (!frame_begin(&w, LOG_BINARY_FRAME_DROPPED, buf, size)) {
+        return LOG_BINARY_ERR_PARAM;
+    }
+    frame_put_uint(&w, count, 4);
+    return frame_end(&w);
+}
+
+int log_binary_decode(const uint8_t *buf, size_t len, log_binary_frame_t *frame)
+{
+    if (!buf || !frame) {
+        return LOG_BINARY_ERR_PARAM;
+    }
+    if (len > 0 && buf[0] != LOG_BINARY_SYNC) {
+        return LOG_BINARY_ERR_MALFORMED;
+    }
+    if (len < LOG_BINARY_HEADER_SIZE) {
+        return LOG_BINARY_ERR_INCOMPLETE;
+    }
+
+    size_t payload = (size_t)buf[2] | ((size_t)buf[3] << 8);
+    size_t total = LOG_BINARY_HEADER_SIZE + payload + 1;
+    if (total > LOG_BINARY_MAX_FRAME) {
+        return LOG_BINARY_ERR_MALFORMED;
+    }
+    if (len < total) {
+        return LOG_BINARY_ERR_INCOMPLETE;
+    }
+
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < total - 1; i++) {
+        checksum ^= buf[i];
+    }
+    if (checksum != buf[total - 1]) {
+        return LOG_BINARY_ERR_MALFORMED;
+    }
+
+    memset(frame, 0, sizeof(*frame));
+    frame->type = buf[1];
+    frame_reader_t r = { .buf = buf + LOG_BINARY_HEADER_SIZE, .len = payload };
+    uint64_t value = 0;
+    bool ok;
+
+    switch (frame->type) {
+        case LOG_BINARY_FRAME_FORMAT:
+            ok = frame_get_uint(&r, 2, &value);
+            frame->id = (uint16_t)value;
+            ok = ok && frame_get_uint(&r, 1, &value);
+            frame->level = (uint8_t)value;
+            ok = ok && frame_get_string(&r, &frame->tag) && frame_get_string(&r, &frame->text);
+            break;
+        case LOG_BINARY_FRAME_RECORD:
+            ok = frame_get_uint(&r, 2, &value);
+            frame->id = (uint16_t)value;
+            ok = ok && frame_get_uint(&r, 4, &value);
+            frame->time_ms = (uint32_t)value;
+            ok = ok && frame_get_args(&r, frame);
+            break;
+        case LOG_BINARY_FRAME_TEXT:
+            ok = frame_get_uint(&r, 1, &value);
+            frame->level = (uint8_t)value;
+            ok = ok && frame_get_uint(&r, 4, &value);
+            frame->time_ms = (uint32_t)value;
+            ok = ok && frame_get_string(&r, &frame->tag) && frame_get_string(&r, &frame->text);
+            break;
+        case LOG_BINARY_FRAME_DROPPED:
+            ok = frame_get_uint(&r, 4, &value);
+            frame->dropped = (uint32_t)value;
+            break;
+        default:
+            ok = false;
+            break;
+    }
+
+    return (ok && r.pos == r.len) ? (int)total : LOG_BINARY_ERR_MALFORMED;
+}
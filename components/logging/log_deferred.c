@@ -0,0 +1,376 @@
+/**
+ * @file log_deferred.c
+ * @brief Deferred logging - capture ring and logger task
+ * @version 2.0
+ *
+ * Ring:
+ * - Bounded multi-producer / single-consumer queue (Vyukov): producers
+ *   claim a slot with one CAS on the enqueue position and publish it with
+ *   a release store of the slot sequence; the logger task is the only
+ *   consumer and needs no atomic read-modify-write at all
+ * - Slot sequences are stored relative to the slot index, so the
+ *   zero-initialized ring is ready without an init call
+ *
+ * Binary IDs:
+ * - The logger task interns each (format, tag, level) call site into a
+ *   small open-addressing table the first time it ships a record for it,
+ *   sending a FORMAT frame before the first RECORD
+ * - Call sites beyond LOG_DEFERRED_MAX_FORMATS are shipped as TEXT frames
+ */
+
+#include "log_deferred.h"
+#include "metrics.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+static const char *TAG = "LOG";
+
+_Static_assert((LOG_DEFERRED_RING_SIZE & (LOG_DEFERRED_RING_SIZE - 1)) == 0,
+               "ring size must be a power of two");
+_Static_assert(LOG_DEFERRED_MAX_FORMATS < UINT16_MAX, "format IDs are 16-bit");
+_Static_assert(LOG_BINARY_LEVEL_ERROR == APP_LOG_LEVEL_ERROR && LOG_BINARY_LEVEL_DEBUG == APP_LOG_LEVEL_DEBUG,
+               "LOG_DEFERRED compares record levels with APP_LOG_LEVEL");
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+#define LOG_RING_MASK       (LOG_DEFERRED_RING_SIZE - 1u)
+#define LOG_FORMAT_SLOTS    (LOG_DEFERRED_MAX_FORMATS * 2)
+
+#if defined(HOST_LOG_DEBUG)
+#define LOG_DEFAULT_LEVEL   LOG_BINARY_LEVEL_DEBUG
+#elif defined(CONFIG_LOG_DEFAULT_LEVEL)
+#define LOG_DEFAULT_LEVEL   CONFIG_LOG_DEFAULT_LEVEL
+#else
+#define LOG_DEFAULT_LEVEL   LOG_BINARY_LEVEL_INFO
+#endif
+
+typedef struct {
+    atomic_uint sequence;   // Relative to the slot index, see log_ring_push()
+    uint8_t level;
+    uint8_t argc;
+    uint32_t time_ms;
+    const char *tag;
+    const char *fmt;
+    log_arg_t args[LOG_BINARY_MAX_ARGS];
+} log_slot_t;
+
+typedef struct {
+    const char *fmt;        // NULL = empty
+    const char *tag;
+    uint8_t level;
+    uint16_t id;
+    bool sent;              // FORMAT frame shipped
+} log_format_t;
+
+typedef struct {
+    log_slot_t slots[LOG_DEFERRED_RING_SIZE];
+    atomic_uint enqueue_pos;
+    uint32_t dequeue_pos;                       // Logger task only
+    atomic_bool running;
+    atomic_bool resync;
+    log_deferred_config_t config;
+    TaskHandle_t task;
+    log_format_t formats[LOG_FORMAT_SLOTS];     // Logger task only
+    uint16_t format_count;
+} log_context_t;
+
+static log_context_t g_log_ctx = {0};
+static metrics_counter_t g_log_dropped;
+
+atomic_uint g_log_deferred_level = LOG_DEFAULT_LEVEL;
+
+/* =========================================================================
+   RING
+   ========================================================================= */
+
+/**
+ * @brief Claim a slot, fill it, publish it
+ *
+ * Slot for position `pos` is free when its sequence equals the lap base
+ * (`pos & ~mask`) and holds a record when it equals base + 1.
+ *
+ * @return false if the ring is full
+ */
+static bool log_ring_push(uint8_t level, const char *tag, const char *fmt,
+                          const log_arg_t *args, size_t argc)
+{
+    uint32_t pos = atomic_load_explicit(&g_log_ctx.enqueue_pos, memory_order_relaxed);
+    log_slot_t *slot;
+
+    for (;;) {
+        slot = &g_log_ctx.slots[pos & LOG_RING_MASK];
+        uint32_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - (pos & ~LOG_RING_MASK));
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&g_log_ctx.enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&g_log_ctx.enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->argc = (uint8_t)argc;
+    slot->time_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    slot->tag = tag;
+    slot->fmt = fmt;
+    memcpy(slot->args, args, argc * sizeof(log_arg_t));
+
+    atomic_store_explicit(&slot->sequence, (pos & ~LOG_RING_MASK) + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Take the oldest record (logger task only)
+ * @return false if the ring is empty or its head is still being written
+ */
+static bool log_ring_pop(log_slot_t *out)
+{
+    uint32_t pos = g_log_ctx.dequeue_pos;
+    log_slot_t *slot = &g_log_ctx.slots[pos & LOG_RING_MASK];
+    uint32_t base = pos & ~LOG_RING_MASK;
+
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != base + 1) {
+        return false;
+    }
+
+    out->level = slot->level;
+    out->argc = slot->argc;
+    out->time_ms = slot->time_ms;
+    out->tag = slot->tag;
+    out->fmt = slot->fmt;
+    memcpy(out->args, slot->args, slot->argc * sizeof(log_arg_t));
+
+    atomic_store_explicit(&slot->sequence, base + LOG_DEFERRED_RING_SIZE, memory_order_release);
+    g_log_ctx.dequeue_pos = pos + 1;
+    return true;
+}
+
+/* =========================================================================
+   OUTPUT
+   ========================================================================= */
+
+static void log_output(const uint8_t *data, size_t len)
+{
+    if (g_log_ctx.config.sink) {
+        g_log_ctx.config.sink(data, len, g_log_ctx.config.sink_ctx);
+    } else {
+        fwrite(data, 1, len, stdout);
+    }
+}
+
+/**
+ * @brief Format a record like ESP_LOGx: "I (1234) TAG: message"
+ */
+static size_t log_format_line(uint8_t level, uint32_t time_ms, const char *tag, const char *fmt,
+                              const log_arg_t *args, size_t argc, char *line, size_t size)
+{
+    int prefix = snprintf(line, size, "%c (%lu) %s: ", log_binary_level_char(level),
+                          (unsigned long)time_ms, tag);
+    size_t len = (prefix > 0 && (size_t)prefix < size) ? (size_t)prefix : 0;
+    len += log_binary_render(fmt, args, argc, line + len, size - len - 1);
+    line[len++] = '\n';
+    line[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief Binary ID of a call site, interned on first use
+ * @return Entry, NULL if the table is full
+ */
+static log_format_t *log_format_lookup(const log_slot_t *rec)
+{
+    uintptr_t key = (uintptr_t)rec->fmt ^ ((uintptr_t)rec->tag << 3) ^ rec->level;
+    uint32_t slot = (uint32_t)(key * 2654435761u) % LOG_FORMAT_SLOTS;
+
+    for (uint32_t probe = 0; probe < LOG_FORMAT_SLOTS; probe++) {
+        log_format_t *entry = &g_log_ctx.formats[slot];
+        if (!entry->fmt) {
+            if (g_log_ctx.format_count >= LOG_DEFERRED_MAX_FORMATS) {
+                return NULL;
+            }
+            *entry = (log_format_t){
+                .fmt = rec->fmt,
+                .tag = rec->tag,
+                .level = rec->level,
+                .id = g_log_ctx.format_count++
+            };
+            return entry;
+        }
+        if (entry->fmt == rec->fmt && entry->tag == rec->tag && entry->level == rec->level) {
+            return entry;
+        }
+        slot = (slot + 1) % LOG_FORMAT_SLOTS;
+    }
+    return NULL;
+}
+
+static void log_emit_binary(const log_slot_t *rec)
+{
+    static uint8_t frame[LOG_BINARY_MAX_FRAME];
+    int len;
+
+    log_format_t *entry = log_format_lookup(rec);
+    if (!entry) {
+        static char line[LOG_DEFERRED_LINE_MAX];
+        log_binary_render(rec->fmt, rec->args, rec->argc, line, sizeof(line));
+        len = log_binary_encode_text(rec->level, rec->time_ms, rec->tag, line, frame, sizeof(frame));
+    } else {
+        if (!entry->sent) {
+            len = log_binary_encode_format(entry->id, entry->level, entry->tag, entry->fmt,
+                                           frame, sizeof(frame));
+            if (len > 0) {
+                log_output(frame, (size_t)len);
+                entry->sent = true;
+            }
+        }
+        len = log_binary_encode_record(entry->id, rec->time_ms, rec->fmt, rec->args, rec->argc,
+                                       frame, sizeof(frame));
+    }
+
+    if (len > 0) {
+        log_output(frame, (size_t)len);
+    }
+}
+
+static void log_emit_text(const log_slot_t *rec)
+{
+    static char line[LOG_DEFERRED_LINE_MAX];
+    size_t len = log_format_line(rec->level, rec->time_ms, rec->tag, rec->fmt,
+                                 rec->args, rec->argc, line, sizeof(line));
+    log_output((const uint8_t *)line, len);
+}
+
+static void log_report_dropped(uint32_t dropped)
+{
+    if (g_log_ctx.config.binary) {
+        uint8_t frame[16];
+        int len = log_binary_encode_dropped(dropped, frame, sizeof(frame));
+        if (len > 0) {
+            log_output(frame, (size_t)len);
+        }
+    } else {
+        log_arg_t arg = { .u = dropped };
+        log_slot_t rec = {
+            .level = LOG_BINARY_LEVEL_WARN,
+            .argc = 1,
+            .time_ms = (uint32_t)(esp_timer_get_time() / 1000),
+            .tag = TAG,
+            .fmt = "[WARN] %lu log records dropped (ring full)"
+        };
+        rec.args[0] = arg;
+        log_emit_text(&rec);
+    }
+}
+
+/* =========================================================================
+   LOGGER TASK
+   ========================================================================= */
+
+/**
+ * @brief Logger Task - Drain the ring every LOG_DEFERRED_FLUSH_MS
+ *
+ * Priority: Lowest application priority (1)
+ */
+static void task_logger(void *pvParameter)
+{
+    (void)pvParameter;
+    static log_slot_t rec;
+    uint32_t dropped_seen = 0;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_DEFERRED_FLUSH_MS));
+
+        if (atomic_exchange_explicit(&g_log_ctx.resync, false, memory_order_relaxed)) {
+            for (size_t i = 0; i < LOG_FORMAT_SLOTS; i++) {
+                g_log_ctx.formats[i].sent = false;
+            }
+        }
+
+        while (log_ring_pop(&rec)) {
+            if (g_log_ctx.config.binary) {
+                log_emit_binary(&rec);
+            } else {
+                log_emit_text(&rec);
+            }
+        }
+
+        uint32_t dropped = metrics_counter_get(&g_log_dropped);
+        if (dropped != dropped_seen) {
+            log_report_dropped(dropped - dropped_seen);
+            dropped_seen = dropped;
+        }
+
+        if (!g_log_ctx.config.sink) {
+            fflush(stdout);
+        }
+    }
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+void log_deferred_write(uint8_t level, const char *tag, const char *fmt,
+                        const log_arg_t *args, size_t argc)
+{
+    if (argc > LOG_BINARY_MAX_ARGS) {
+        argc = LOG_BINARY_MAX_ARGS;
+    }
+
+    if (!atomic_load_explicit(&g_log_ctx.running, memory_order_acquire)) {
+        // Logger not started yet: format on the caller like APP_LOG_*
+        char line[LOG_DEFERRED_LINE_MAX];
+        size_t len = log_format_line(level, (uint32_t)(esp_timer_get_time() / 1000), tag, fmt,
+                                     args, argc, line, sizeof(line));
+        fwrite(line, 1, len, stdout);
+        return;
+    }
+
+    if (!log_ring_push(level, tag, fmt, args, argc)) {
+        metrics_counter_inc(&g_log_dropped);
+    }
+}
+
+app_err_t log_deferred_start(const log_deferred_config_t *config)
+{
+    if (!config || (config->binary && !config->sink)) {
+        return APP_ERR_INVALID_PARAM;
+    }
+    if (g_log_ctx.task) {
+        return APP_OK;
+    }
+
+    g_log_ctx.config = *config;
+    metrics_register_counter(&g_log_dropped, "log_dropped_total");
+
+    if (xTaskCreate(task_logger, "logger", config->task_stack, NULL,
+                    config->task_priority, &g_log_ctx.task) != pdPASS) {
+        APP_LOG_ERROR(TAG, "Failed to create logger task");
+        g_log_ctx.task = NULL;
+        return APP_ERR_NO_MEMORY;
+    }
+
+    atomic_store_explicit(&g_log_ctx.running, true, memory_order_release);
+    APP_LOG_INFO(TAG, "✓ Deferred logger started (%s output)", config->binary ? "binary" : "text");
+    return APP_OK;
+}
+
+void log_deferred_set_level(uint8_t level)
+{
+    atomic_store_explicit(&g_log_deferred_level, level, memory_order_relaxed);
+}
+
+void log_deferred_resync(void)
+{
+    atomic_store_explicit(&g_log_ctx.resync, true, memory_order_relaxed);
+}
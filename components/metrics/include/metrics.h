@@ -0,0 +1,224 @@
+/**
+ * @file metrics.h
+ * @brief Metrics registry - counters, gauges and histograms of all components
+ * @version 2.0
+ *
+ * Components own their metrics as static objects, register them once at
+ * init and update them from any task or ISR. metrics_export_prometheus()
+ * serializes every registered metric in one pass.
+ *
+ * Cost per update:
+ * - Counter: one relaxed atomic add on the calling core's slot (slots are
+ *   summed on read, so the two cores never contend for one word)
+ * - Gauge: one relaxed atomic store or add
+ * - Histogram: a scan of the (few) bucket bounds, then two atomic adds
+ *
+ * Counters are 32-bit per core and wrap, like Prometheus counters after a
+ * reset; rate() handles both.
+ *
+ * Usage:
+    @code
+    ```c
+    static metrics_counter_t g_published;
+    METRICS_HISTOGRAM_DEFINE(g_publish_us, 1000, 5000, 20000, 100000);
+
+    // Init
+    metrics_register_counter(&g_published, "mqtt_messages_published_total");
+    metrics_register_histogram(&g_publish_us, "mqtt_publish_duration_us");
+
+    // Hot path
+    metrics_counter_inc(&g_published);
+    metrics_histogram_observe(&g_publish_us, elapsed_us);
+
+    // Export
+    size_t len = metrics_export_prometheus(buffer, sizeof(buffer));
+    ```
+    @endcode
+ *
+ * @note Register during startup. Registration is serialized, updates and
+ *       export never lock.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "app_common.h"
+#include "freertos/FreeRTOS.h"
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+#define METRICS_MAX             48                  /**< Registry slots */
+#define METRICS_CORES           portNUM_PROCESSORS  /**< Counter slots */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Monotonic counter, one slot per core
+ */
+typedef struct {
+    atomic_uint value[METRICS_CORES];
+} metrics_counter_t;
+
+/**
+ * @brief Value that goes up and down
+ */
+typedef struct {
+    atomic_int value;
+} metrics_gauge_t;
+
+/**
+ * @brief Histogram with fixed bucket bounds (use METRICS_HISTOGRAM_DEFINE)
+ */
+typedef struct {
+    const uint32_t *bounds;     // Ascending inclusive upper bounds
+    size_t bound_count;
+    atomic_uint *buckets;       // bound_count + 1, the last one is +Inf
+    atomic_uint sum;            // Sum of observed values (wraps)
+} metrics_histogram_t;
+
+/**
+ * @brief Define a static histogram with the given bucket bounds
+ *
+ * @code
+ * METRICS_HISTOGRAM_DEFINE(g_latency, 500, 1000, 5000);
+ * @endcode
+ */
+#define METRICS_HISTOGRAM_DEFINE(var, ...)                                          \
+    static const uint32_t var##_bounds[] = { __VA_ARGS__ };                         \
+    static atomic_uint var##_buckets[sizeof(var##_bounds) / sizeof(uint32_t) + 1];  \
+    static metrics_histogram_t var = {                                              \
+        .bounds = var##_bounds,                                                     \
+        .bound_count = sizeof(var##_bounds) / sizeof(uint32_t),                     \
+        .buckets = var##_buckets                                                    \
+    }
+
+/* =========================================================================
+   REGISTRATION
+   ========================================================================= */
+/**
+ * @brief Register a counter
+ *
+ * @param counter Counter (static storage)
+ * @param name Prometheus metric name (static string), e.g. "x_total"
+ * @return `APP_OK` on success (also if already registered), error code otherwise.
+ *
+ * @retval APP_ERR_INVALID_PARAM `NULL` argument
+ * @retval APP_ERR_NO_MEMORY Registry full (METRICS_MAX)
+ */
+app_err_t metrics_register_counter(metrics_counter_t *counter, const char *name);
+
+/**
+ * @brief Register a gauge
+ * @param gauge Gauge (static storage)
+ * @param name Prometheus metric name (static string)
+ * @return Same as metrics_register_counter()
+ */
+app_err_t metrics_register_gauge(metrics_gauge_t *gauge, const char *name);
+
+/**
+ * @brief Register a histogram
+ * @param histogram Histogram from METRICS_HISTOGRAM_DEFINE
+ * @param name Prometheus metric name (static string)
+ * @return Same as metrics_register_counter()
+ */
+app_err_t metrics_register_histogram(metrics_histogram_t *histogram, const char *name);
+
+/* =========================================================================
+   UPDATES
+   ========================================================================= */
+/**
+ * @brief Add to a counter (any task or ISR)
+ * @param counter Counter
+ * @param n Amount
+ */
+static inline void metrics_counter_add(metrics_counter_t *counter, uint32_t n)
+{
+    atomic_fetch_add_explicit(&counter->value[xPortGetCoreID()], n, memory_order_relaxed);
+}
+
+/**
+ * @brief Add one to a counter (any task or ISR)
+ * @param counter Counter
+ */
+static inline void metrics_counter_inc(metrics_counter_t *counter)
+{
+    metrics_counter_add(counter, 1);
+}
+
+/**
+ * @brief Set a gauge (any task or ISR)
+ * @param gauge Gauge
+ * @param value New value
+ */
+static inline void metrics_gauge_set(metrics_gauge_t *gauge, int32_t value)
+{
+    atomic_store_explicit(&gauge->value, value, memory_order_relaxed);
+}
+
+/**
+ * @brief Add to a gauge, negative to subtract (any task or ISR)
+ * @param gauge Gauge
+ * @param delta Amount
+ */
+static inline void metrics_gauge_add(metrics_gauge_t *gauge, int32_t delta)
+{
+    atomic_fetch_add_explicit(&gauge->value, delta, memory_order_relaxed);
+}
+
+/**
+ * @brief Count one observation (any task or ISR)
+ * @param histogram Histogram
+ * @param value Observed value
+ */
+void metrics_histogram_observe(metrics_histogram_t *histogram, uint32_t value);
+
+/* =========================================================================
+   READING
+   ========================================================================= */
+/**
+ * @brief Current counter value, all cores
+ * @param counter Counter
+ * @return Sum of the per-core slots
+ */
+uint32_t metrics_counter_get(const metrics_counter_t *counter);
+
+/**
+ * @brief Current gauge value
+ * @param gauge Gauge
+ * @return Value
+ */
+static inline int32_t metrics_gauge_get(const metrics_gauge_t *gauge)
+{
+    return atomic_load_explicit(&gauge->value, memory_order_relaxed);
+}
+
+/**
+ * @brief Read a registered counter or gauge by name
+ *
+ * For components that report another component's metric without
+ * depending on its private state.
+ *
+ * @param name Metric name
+ * @param value Output
+ * @return `APP_OK`, `APP_ERR_INVALID_PARAM` if unknown or a histogram
+ */
+app_err_t metrics_read(const char *name, int64_t *value);
+
+/**
+ * @brief Serialize all metrics in Prometheus text format
+ *
+ * One `# TYPE` line per metric, histograms as cumulative `_bucket{le=..}`
+ * series plus `_sum` and `_count`.
+ *
+ * @param buffer Output buffer
+ * @param size Buffer size
+ * @return Text length, 0 if it does not fit
+ */
+size_t metrics_export_prometheus(char *buffer, size_t size);
+
+#endif // METRICS_H
@@ -0,0 +1,229 @@
+/**
+ * @file metrics.c
+ * @brief Metrics registry - counters, gauges and histograms of all components
+ * @version 2.0
+ *
+ * Registry:
+ * - Fixed array of entries, appended under a spinlock; the entry count is
+ *   published with release so export walks only complete entries
+ * - Metric objects belong to their components, the registry only points
+ *   to them
+ */
+
+#include "metrics.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "METRICS";
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+typedef enum {
+    METRICS_TYPE_COUNTER = 0,
+    METRICS_TYPE_GAUGE,
+    METRICS_TYPE_HISTOGRAM
+} metrics_type_t;
+
+typedef struct {
+    metrics_type_t type;
+    const char *name;
+    void *metric;
+} metrics_entry_t;
+
+typedef struct {
+    metrics_entry_t entries[METRICS_MAX];
+    atomic_size_t count;
+} metrics_context_t;
+
+static metrics_context_t g_metrics_ctx = {0};
+static portMUX_TYPE g_metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+
+static app_err_t metrics_register(metrics_type_t type, void *metric, const char *name)
+{
+    if (!metric || !name) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    app_err_t ret = APP_OK;
+    bool registered = false;
+
+    portENTER_CRITICAL(&g_metrics_lock);
+    size_t count = atomic_load_explicit(&g_metrics_ctx.count, memory_order_relaxed);
+    for (size_t i = 0; i < count && !registered; i++) {
+        registered = (g_metrics_ctx.entries[i].metric == metric);
+    }
+    if (registered) {
+        // Component initialized twice, keep the first entry
+    } else if (count >= METRICS_MAX) {
+        ret = APP_ERR_NO_MEMORY;
+    } else {
+        g_metrics_ctx.entries[count] = (metrics_entry_t){
+            .type = type,
+            .name = name,
+            .metric = metric
+        };
+        atomic_store_explicit(&g_metrics_ctx.count, count + 1, memory_order_release);
+    }
+    portEXIT_CRITICAL(&g_metrics_lock);
+
+    if (ret != APP_OK) {
+        APP_LOG_ERROR(TAG, "Registry full, %s not registered", name);
+    }
+    return ret;
+}
+
+/**
+ * @brief snprintf() into the export buffer, false once it is full
+ */
+static bool metrics_append(char *buffer, size_t size, size_t *len, const char *fmt, ...)
+{
+    if (*len >= size) {
+        return false;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buffer + *len, size - *len, fmt, args);
+    va_end(args);
+
+    if (n < 0 || (size_t)n >= size - *len) {
+        *len = size;
+        return false;
+    }
+    *len += (size_t)n;
+    return true;
+}
+
+static bool metrics_export_histogram(const metrics_entry_t *entry, char *buffer,
+                                     size_t size, size_t *len)
+{
+    const metrics_histogram_t *hist = entry->metric;
+    uint64_t cumulative = 0;
+
+    for (size_t i = 0; i <= hist->bound_count; i++) {
+        cumulative += atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+        if (i < hist->bound_count) {
+            metrics_append(buffer, size, len, "%s_bucket{le=\"%lu\"} %llu\n", entry->name,
+                           (unsigned long)hist->bounds[i], (unsigned long long)cumulative);
+        } else {
+            metrics_append(buffer, size, len, "%s_bucket{le=\"+Inf\"} %llu\n", entry->name,
+                           (unsigned long long)cumulative);
+        }
+    }
+    metrics_append(buffer, size, len, "%s_sum %lu\n", entry->name,
+                   (unsigned long)atomic_load_explicit(&hist->sum, memory_order_relaxed));
+    return metrics_append(buffer, size, len, "%s_count %llu\n", entry->name,
+                          (unsigned long long)cumulative);
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+app_err_t metrics_register_counter(metrics_counter_t *counter, const char *name)
+{
+    return metrics_register(METRICS_TYPE_COUNTER, counter, name);
+}
+
+app_err_t metrics_register_gauge(metrics_gauge_t *gauge, const char *name)
+{
+    return metrics_register(METRICS_TYPE_GAUGE, gauge, name);
+}
+
+app_err_t metrics_register_histogram(metrics_histogram_t *histogram, const char *name)
+{
+    if (!histogram || !histogram->buckets) {
+        return APP_ERR_INVALID_PARAM;
+    }
+    return metrics_register(METRICS_TYPE_HISTOGRAM, histogram, name);
+}
+
+void metrics_histogram_observe(metrics_histogram_t *histogram, uint32_t value)
+{
+    size_t i = 0;
+    while (i < histogram->bound_count && value > histogram->bounds[i]) {
+        i++;
+    }
+    atomic_fetch_add_explicit(&histogram->buckets[i], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->sum, value, memory_order_relaxed);
+}
+
+uint32_t metrics_counter_get(const metrics_counter_t *counter)
+{
+    uint32_t total = 0;
+    for (size_t core = 0; core < METRICS_CORES; core++) {
+        total += atomic_load_explicit(&counter->value[core], memory_order_relaxed);
+    }
+    return total;
+}
+
+app_err_t metrics_read(const char *name, int64_t *value)
+{
+    if (!name || !value) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    size_t count = atomic_load_explicit(&g_metrics_ctx.count, memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        const metrics_entry_t *entry = &g_metrics_ctx.entries[i];
+        if (strcmp(entry->name, name) != 0) {
+            continue;
+        }
+        if (entry->type == METRICS_TYPE_COUNTER) {
+            *value = metrics_counter_get(entry->metric);
+            return APP_OK;
+        }
+        if (entry->type == METRICS_TYPE_GAUGE) {
+            *value = metrics_gauge_get(entry->metric);
+            return APP_OK;
+        }
+        break;
+    }
+    return APP_ERR_INVALID_PARAM;
+}
+
+size_t metrics_export_prometheus(char *buffer, size_t size)
+{
+    static const char *const type_names[] = {
+        [METRICS_TYPE_COUNTER] = "counter",
+        [METRICS_TYPE_GAUGE] = "gauge",
+        [METRICS_TYPE_HISTOGRAM] = "histogram"
+    };
+
+    if (!buffer || size == 0) {
+        return 0;
+    }
+
+    size_t len = 0;
+    size_t count = atomic_load_explicit(&g_metrics_ctx.count, memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        const metrics_entry_t *entry = &g_metrics_ctx.entries[i];
+
+        metrics_append(buffer, size, &len, "# TYPE %s %s\n", entry->name, type_names[entry->type]);
+        switch (entry->type) {
+            case METRICS_TYPE_COUNTER:
+                metrics_append(buffer, size, &len, "%s %lu\n", entry->name,
+                               (unsigned long)metrics_counter_get(entry->metric));
+                break;
+            case METRICS_TYPE_GAUGE:
+                metrics_append(buffer, size, &len, "%s %ld\n", entry->name,
+                               (long)metrics_gauge_get(entry->metric));
+                break;
+            case METRICS_TYPE_HISTOGRAM:
+                metrics_export_histogram(entry, buffer, size, &len);
+                break;
+        }
+    }
+
+    if (len >= size) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    return len;
+}
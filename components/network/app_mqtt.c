@@ -7,19 +7,24 @@
  * - Async non-blocking connection
  * - Automatic reconnection with exponential backoff
  * - TLS/SSL support
- * - Queue-based message handling
+ * - Commands parsed in the event handler, no heap allocation, handed
+ *   straight to the dispatching task (mqtt_config_t.on_command)
  * - Error tracking and statistics
  */
 
 #include "app_mqtt.h"
 #include "esp_log.h"
 #include "esp_timer.h"
-#include "freertos/queue.h"
 #include <string.h>
-#include <cJSON.h>
+#include "telemetry_json.h"
+#include "command.h"
+#include "metrics.h"
+#include "log_deferred.h"
 
 static const char *TAG = "MQTT";
 
+_Static_assert(TELEMETRY_COMMAND_MAX_CHANGES <= COMMAND_MAX_CHANGES, "decoded changes must fit command_t");
+
 /* ============================================================================
    PRIVATE STATE
    ============================================================================ */
@@ -27,9 +32,9 @@ static const char *TAG = "MQTT";
 /**
  * @brief Runtime context for the MQTT subsystem.
  *
- * @details Encapsulates the MQTT client handle, configuration, connection state,
- * runtime statistics, and a command queue used by the network/app_mqtt
- * component to manage MQTT operations and reconnection logic.
+ * @details Encapsulates the MQTT client handle, configuration and connection
+ * state used by the network/app_mqtt component to manage MQTT operations and
+ * reconnection logic. Statistics live in the metrics registry (below).
  *
  * Members:
  *  - client: Handle to the underlying ESP MQTT client instance used to
@@ -41,16 +46,6 @@ static const char *TAG = "MQTT";
  *  - initialized: Boolean flag indicating whether the context and client
  *                 have been successfully initialized.
  *
- *  - messages_published: Counter of successfully published messages.
- *  - messages_received: Counter of messages received from the broker.
- *  - publish_failures: Counter of failed publish attempts.
- *  - reconnect_count: Total number of reconnect attempts (used for logging
- *                     and backoff strategies).
- *
- *  - command_queue: RTOS queue handle used to receive commands or control
- *                   messages from other tasks (e.g., publish requests,
- *                   subscription changes, or shutdown signals).
- *
  *  - last_connect_time: Timestamp in milliseconds of the last successful
  *                       connection to the broker. Used for diagnostics and
  *                       backoff calculations.
@@ -60,8 +55,6 @@ static const char *TAG = "MQTT";
  * @note - Access to this context may occur from multiple tasks and from MQTT
  *    callbacks. Proper synchronization (mutexes or atomic operations) should
  *    be used when multiple writers/readers access mutable fields.
- * @note - Counters are monotonically increasing and may wrap; treat them as
- *    non-atomic snapshots unless synchronized externally.
  * @note - Timestamps are expected to be in the same clock domain as the rest of
  *    the system (e.g., millis since boot) for correct interval calculations.
  */
@@ -71,27 +64,22 @@ typedef struct {
     bool connected;
     bool initialized;
     
-    // Statistics
-    uint32_t messages_published;
-    uint32_t messages_received;
-    uint32_t publish_failures;
-    uint32_t reconnect_count;
-    
-    // Message queue for commands
-    QueueHandle_t command_queue;
-    
     // Status
     uint64_t last_connect_time;
     uint32_t reconnect_delay_ms;
 } mqtt_context_t;
 
-typedef struct {
-    char type[32];
-    int value;
-} mqtt_command_t;
-
 static mqtt_context_t g_mqtt_ctx = {0};
 
+// Statistics (metrics registry, safe from the event handler and any task)
+static metrics_counter_t g_mqtt_published;
+static metrics_counter_t g_mqtt_received;
+static metrics_counter_t g_mqtt_publish_failures;
+static metrics_counter_t g_mqtt_reconnects;
+static metrics_counter_t g_mqtt_commands_dropped;
+static metrics_gauge_t g_mqtt_connected;
+METRICS_HISTOGRAM_DEFINE(g_mqtt_publish_us, 100, 500, 1000, 5000, 20000, 100000);
+
 /* ============================================================================
    MQTT EVENT HANDLER
    ============================================================================ */
@@ -105,6 +93,7 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
     case MQTT_EVENT_CONNECTED:
         APP_LOG_INFO(TAG, "✓ MQTT connected!");
         g_mqtt_ctx.connected = true;
+        metrics_gauge_set(&g_mqtt_connected, 1);
         g_mqtt_ctx.reconnect_delay_ms = 1000;  // Reset backoff
         g_mqtt_ctx.last_connect_time = esp_timer_get_time() / 1000;
         
@@ -117,7 +106,8 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
     case MQTT_EVENT_DISCONNECTED:
         APP_LOG_WARN(TAG, "MQTT disconnected");
         g_mqtt_ctx.connected = false;
-        g_mqtt_ctx.reconnect_count++;
+        metrics_gauge_set(&g_mqtt_connected, 0);
+        metrics_counter_inc(&g_mqtt_reconnects);
         
         // Exponential backoff: max 60 seconds
         if (g_mqtt_ctx.reconnect_delay_ms < 60000) {
@@ -138,32 +128,21 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
         break;
         
     case MQTT_EVENT_PUBLISHED:
-        APP_LOG_DEBUG(TAG, "Published, msg_id=%d", event->msg_id);
+        APP_LOG_DEFER_DEBUG(TAG, "Published, msg_id=%d", event->msg_id);
         break;
         
     case MQTT_EVENT_DATA:
         APP_LOG_DEBUG(TAG, "Received data on topic: %.*s", 
                      event->topic_len, event->topic);
         
-        // Parse incoming message
+        // Payload is used in place (not NUL-terminated), no copy
         if (event->data_len > 0) {
-            // Create null-terminated copy
-            char *data = malloc(event->data_len + 1);
-            if (data) {
-                memcpy(data, event->data, event->data_len);
-                data[event->data_len] = '\0';
-                
-                // Invoke message callback
-                if (g_mqtt_ctx.config.on_message) {
-                    g_mqtt_ctx.config.on_message(event->topic, data, event->data_len);
-                }
-                
-                // Parse command if it's a JSON message
-                mqtt_parse_and_queue_command(data, event->data_len);
-                
-                free(data);
-                g_mqtt_ctx.messages_received++;
+            if (g_mqtt_ctx.config.on_message) {
+                g_mqtt_ctx.config.on_message(event->topic, event->data, event->data_len);
             }
+            
+            mqtt_parse_and_queue_command(event->data, event->data_len);
+            metrics_counter_inc(&g_mqtt_received);
         }
         break;
         
@@ -185,42 +164,94 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
    ============================================================================ */
 
 /**
- * @brief Parse JSON command and queue it
+ * @brief Parse JSON command and hand it to the dispatching task
+ * 
+ * Uses the in-place telemetry decoder, no heap allocation. The type name
+ * is resolved to a command_id_t here, unknown commands are dropped.
  */
 void mqtt_parse_and_queue_command(const char *data, int data_len)
 {
-    if (!g_mqtt_ctx.command_queue) {
+    uint32_t received_us = command_now_us();
+    
+    if (!g_mqtt_ctx.config.on_command || !data || data_len <= 0) {
         return;
     }
     
     // Parse JSON
-    cJSON *json = cJSON_ParseWithLength(data, data_len);
-    if (!json) {
+    telemetry_command_t parsed;
+    app_err_t ret = telemetry_json_decode_command(data, (size_t)data_len, &parsed);
+    if (ret == APP_ERR_INVALID_PARAM) {
         APP_LOG_WARN(TAG, "Failed to parse JSON command");
+        metrics_counter_inc(&g_mqtt_commands_dropped);
         return;
     }
     
-    // Extract type and value
-    cJSON *type_item = cJSON_GetObjectItem(json, "type");
-    cJSON *value_item = cJSON_GetObjectItem(json, "value");
-    
-    if (cJSON_IsString(type_item) && cJSON_IsNumber(value_item)) {
-        mqtt_command_t cmd = {0};
-        strncpy(cmd.type, type_item->valuestring, sizeof(cmd.type) - 1);
-        cmd.value = value_item->valueint;
-        
-        // Queue command
-        if (xQueueSend(g_mqtt_ctx.command_queue, &cmd, 0) == pdTRUE) {
-            APP_LOG_DEBUG(TAG, "Command queued: type=%s value=%d", 
-                         cmd.type, cmd.value);
-        } else {
-            APP_LOG_WARN(TAG, "Command queue full, dropping command");
-        }
-    } else {
+    if (ret != APP_OK) {
         APP_LOG_WARN(TAG, "Invalid JSON structure for command");
+        metrics_counter_inc(&g_mqtt_commands_dropped);
+        return;
+    }
+    
+    command_t cmd = {
+        .id = command_lookup(parsed.type, parsed.type_len),
+        .value = parsed.value,
+        .stamps.received_us = received_us
+    };
+    if (cmd.id == COMMAND_INVALID) {
+        APP_LOG_WARN(TAG, "Unknown command type: %.*s", (int)parsed.type_len, parsed.type);
+        metrics_counter_inc(&g_mqtt_commands_dropped);
+        return;
     }
     
-    cJSON_Delete(json);
+    // Channel and group changes, their values are range checked at dispatch
+    bool fits = (parsed.channel >= 0 && parsed.channel <= UINT8_MAX);
+    cmd.channel = (uint8_t)parsed.channel;
+    command_change_t changes[COMMAND_MAX_CHANGES];
+    for (size_t i = 0; i < parsed.change_count; i++) {
+        const telemetry_command_change_t *change = &parsed.changes[i];
+        fits = fits && change->channel >= 0 && change->channel <= UINT8_MAX &&
+               change->value >= INT16_MIN && change->value <= INT16_MAX;
+        changes[i].channel = (uint8_t)change->channel;
+        changes[i].value = (int16_t)change->value;
+    }
+
+    // Timing of scheduled commands, checked against the schedule by its handler,
+    // and time range of queries (they share the command's union)
+    fits = fits && parsed.duration >= 0 &&
+           parsed.start >= 0 && parsed.start <= UINT16_MAX &&
+           parsed.end >= 0 && parsed.end <= UINT16_MAX &&
+           parsed.from >= 0 && parsed.to >= 0;
+    if (cmd.id == COMMAND_OUTPUT_FOR || cmd.id == COMMAND_OUTPUT_DAILY) {
+        cmd.timing.duration_s = (uint32_t)parsed.duration;
+        cmd.timing.start_min = (uint16_t)parsed.start;
+        cmd.timing.end_min = (uint16_t)parsed.end;
+    } else if (cmd.id == COMMAND_HISTORY) {
+        cmd.range.from_s = (uint32_t)parsed.from;
+        cmd.range.to_s = (uint32_t)parsed.to;
+    }
+
+    if (!fits) {
+        APP_LOG_WARN(TAG, "Channel, change or timing out of range in %s command", command_to_string(cmd.id));
+        metrics_counter_inc(&g_mqtt_commands_dropped);
+        return;
+    }
+
+    ret = APP_OK;
+    if (parsed.change_count > 0) {
+        ret = command_set_group(&cmd, changes, parsed.change_count);
+    }
+    if (ret == APP_OK) {
+        ret = g_mqtt_ctx.config.on_command(&cmd);
+    }
+    if (ret == APP_OK) {
+        APP_LOG_DEFER_DEBUG(TAG, "Command queued: type=%s value=%ld",
+                            command_to_string(cmd.id), cmd.value);
+    } else {
+        command_release(&cmd);
+        APP_LOG_WARN(TAG, "Dropping command %s: %s",
+                    command_to_string(cmd.id), app_err_to_string(ret));
+        metrics_counter_inc(&g_mqtt_commands_dropped);
+    }
 }
 
 /**
@@ -261,16 +292,17 @@ app_err_t app_mqtt_init(const mqtt_config_t *config)
     APP_LOG_INFO(TAG, "Username: %s", config->username ? config->username : "(none)");
     APP_LOG_INFO(TAG, "Keep-alive: %ld seconds", config->keepalive_sec);
     
-    // Create command queue
-    g_mqtt_ctx.command_queue = xQueueCreate(10, sizeof(mqtt_command_t));
-    if (!g_mqtt_ctx.command_queue) {
-        APP_LOG_ERROR(TAG, "Failed to create command queue");
-        return APP_ERR_NO_MEMORY;
-    }
-    
     // Copy config
     memcpy(&g_mqtt_ctx.config, config, sizeof(mqtt_config_t));
     
+    metrics_register_counter(&g_mqtt_published, "mqtt_messages_published_total");
+    metrics_register_counter(&g_mqtt_received, "mqtt_messages_received_total");
+    metrics_register_counter(&g_mqtt_publish_failures, "mqtt_publish_failures_total");
+    metrics_register_counter(&g_mqtt_reconnects, "mqtt_disconnects_total");
+    metrics_register_counter(&g_mqtt_commands_dropped, "mqtt_commands_dropped_total");
+    metrics_register_gauge(&g_mqtt_connected, "mqtt_connected");
+    metrics_register_histogram(&g_mqtt_publish_us, "mqtt_publish_duration_us");
+    
     // Prepare MQTT config
     esp_mqtt_client_config_t mqtt_cfg = {0};
     mqtt_prepare_config(&mqtt_cfg, config);
@@ -295,7 +327,6 @@ app_err_t app_mqtt_init(const mqtt_config_t *config)
     
     g_mqtt_ctx.initialized = true;
     g_mqtt_ctx.reconnect_delay_ms = 1000;  // Initial backoff: 1 second
-    g_mqtt_ctx.reconnect_count = 0;
     
     APP_LOG_INFO(TAG, "✓ MQTT client initialized (async connection)");
     return APP_OK;
@@ -315,7 +346,7 @@ app_err_t app_mqtt_publish(const char *topic, const char *data, int data_len,
     
     if (!g_mqtt_ctx.initialized || !g_mqtt_ctx.connected) {
         APP_LOG_WARN(TAG, "MQTT not connected, cannot publish");
-        g_mqtt_ctx.publish_failures++;
+        metrics_counter_inc(&g_mqtt_publish_failures);
         return APP_ERR_MQTT_PUBLISH;
     }
     
@@ -325,17 +356,19 @@ app_err_t app_mqtt_publish(const char *topic, const char *data, int data_len,
     }
     
     // Publish message
+    int64_t start_us = esp_timer_get_time();
     int msg_id = esp_mqtt_client_publish(g_mqtt_ctx.client, topic, data, 
                                          data_len, qos, retain ? 1 : 0);
+    metrics_histogram_observe(&g_mqtt_publish_us, (uint32_t)(esp_timer_get_time() - start_us));
     
     if (msg_id < 0) {
         APP_LOG_ERROR(TAG, "Failed to publish to %s", topic);
-        g_mqtt_ctx.publish_failures++;
+        metrics_counter_inc(&g_mqtt_publish_failures);
         return APP_ERR_MQTT_PUBLISH;
     }
     
-    APP_LOG_DEBUG(TAG, "Published to %s (msg_id=%d)", topic, msg_id);
-    g_mqtt_ctx.messages_published++;
+    APP_LOG_DEFER_DEBUG(TAG, "Published %d bytes (msg_id=%d)", data_len, msg_id);
+    metrics_counter_inc(&g_mqtt_published);
     
     return APP_OK;
 }
@@ -384,29 +417,6 @@ app_err_t app_mqtt_unsubscribe(const char *topic)
     return APP_OK;
 }
 
-app_err_t app_mqtt_receive_command(char *type, int *value, uint32_t timeout_ms)
-{
-    if (!type || !value) {
-        return APP_ERR_INVALID_PARAM;
-    }
-    
-    if (!g_mqtt_ctx.command_queue) {
-        return APP_ERR_UNKNOWN;
-    }
-    
-    mqtt_command_t cmd = {0};
-    TickType_t ticks = (timeout_ms == 0) ? 0 : pdMS_TO_TICKS(timeout_ms);
-    
-    if (xQueueReceive(g_mqtt_ctx.command_queue, &cmd, ticks) == pdTRUE) {
-        strncpy(type, cmd.type, 31);
-        type[31] = '\0';
-        *value = cmd.value;
-        return APP_OK;
-    }
-    
-    return APP_ERR_TIMEOUT;
-}
-
 const char* app_mqtt_get_status_string(void)
 {
     if (!g_mqtt_ctx.initialized) {
@@ -429,6 +439,7 @@ app_err_t app_mqtt_disconnect(void)
     esp_mqtt_client_stop(g_mqtt_ctx.client);
     APP_LOG_INFO(TAG, "MQTT disconnected");
     g_mqtt_ctx.connected = false;
+    metrics_gauge_set(&g_mqtt_connected, 0);
     
     return APP_OK;
 }
@@ -440,9 +451,9 @@ app_err_t app_mqtt_get_stats(uint32_t *published, uint32_t *received,
         return APP_ERR_INVALID_PARAM;
     }
     
-    *published = g_mqtt_ctx.messages_published;
-    *received = g_mqtt_ctx.messages_received;
-    *failed = g_mqtt_ctx.publish_failures;
+    *published = metrics_counter_get(&g_mqtt_published);
+    *received = metrics_counter_get(&g_mqtt_received);
+    *failed = metrics_counter_get(&g_mqtt_publish_failures);
     
     return APP_OK;
 }
@@ -14,11 +14,14 @@
 
 #include "app_wifi.h"
 #include "app_common.h"
+#include "app_config.h"
+#include "metrics.h"
 #include "nvs_flash.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_sntp.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
 #include <string.h>
@@ -74,15 +77,16 @@ typedef struct {
     uint32_t ip_address;
     int8_t rssi;
     char ip_str[16];  // "192.168.1.100"
-    
-    // Statistics
-    uint32_t total_connections;
-    uint32_t total_disconnections;
-    uint32_t total_failed_attempts;
 } wifi_context_t;
 
 static wifi_context_t g_wifi_ctx = {0};
 
+// Statistics (metrics registry)
+static metrics_counter_t g_wifi_connections;
+static metrics_counter_t g_wifi_disconnections;
+static metrics_counter_t g_wifi_failed_attempts;
+static metrics_gauge_t g_wifi_connected;
+
 /* ============================================================================
    PRIVATE HELPER FUNCTIONS
    ============================================================================ */
@@ -151,7 +155,8 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
             
         case WIFI_EVENT_STA_DISCONNECTED:
             APP_LOG_WARN(TAG, "WiFi disconnected from AP");
-            g_wifi_ctx.total_disconnections++;
+            metrics_counter_inc(&g_wifi_disconnections);
+            metrics_gauge_set(&g_wifi_connected, 0);
             wifi_update_state(WIFI_STATE_DISCONNECTED);
             g_wifi_ctx.connected = false;
             xEventGroupSetBits(g_wifi_ctx.event_group, WIFI_DISCONNECTED_BIT);
@@ -175,7 +180,7 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
                 esp_wifi_connect();
             } else {
                 APP_LOG_ERROR(TAG, "Max WiFi connection attempts exceeded!");
-                g_wifi_ctx.total_failed_attempts++;
+                metrics_counter_inc(&g_wifi_failed_attempts);
                 wifi_update_state(WIFI_STATE_FAILED);
                 xEventGroupSetBits(g_wifi_ctx.event_group, WIFI_FAIL_BIT);
                 
@@ -208,8 +213,17 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
             // Reset retry count on successful connection
             g_wifi_ctx.retry_count = 0;
             g_wifi_ctx.retry_delay_ms = WIFI_RETRY_MIN_MS;
-            g_wifi_ctx.total_connections++;
+            metrics_counter_inc(&g_wifi_connections);
+            metrics_gauge_set(&g_wifi_connected, 1);
             g_wifi_ctx.connected = true;
+
+            // Wall clock for daily schedules, SNTP keeps resyncing once started
+            if (!esp_sntp_enabled()) {
+                esp_sntp_setoperatingmode(ESP_SNTP_OPMODE_POLL);
+                esp_sntp_setservername(0, DEFAULT_SNTP_SERVER);
+                esp_sntp_init();
+                APP_LOG_INFO(TAG, "SNTP started: %s", DEFAULT_SNTP_SERVER);
+            }
             
             // Signal connected
             xEventGroupSetBits(g_wifi_ctx.event_group, WIFI_CONNECTED_BIT);
@@ -412,9 +426,10 @@ app_err_t app_wifi_init(const app_wifi_config_t *config)
     g_wifi_ctx.connected = false;
     g_wifi_ctx.retry_count = 0;
     g_wifi_ctx.retry_delay_ms = WIFI_RETRY_MIN_MS;
-    g_wifi_ctx.total_connections = 0;
-    g_wifi_ctx.total_disconnections = 0;
-    g_wifi_ctx.total_failed_attempts = 0;
+    metrics_register_counter(&g_wifi_connections, "wifi_connections_total");
+    metrics_register_counter(&g_wifi_disconnections, "wifi_disconnections_total");
+    metrics_register_counter(&g_wifi_failed_attempts, "wifi_connect_failures_total");
+    metrics_register_gauge(&g_wifi_connected, "wifi_connected");
     
     APP_LOG_INFO(TAG, "✓ WiFi initialization complete (async)");
     APP_LOG_INFO(TAG, "  SSID: %s", config->ssid);
@@ -521,9 +536,9 @@ void app_wifi_print_status(void)
         APP_LOG_INFO(TAG, "RSSI: %d dBm", app_wifi_get_rssi());
     }
     
-    APP_LOG_INFO(TAG, "Total connections: %ld", g_wifi_ctx.total_connections);
-    APP_LOG_INFO(TAG, "Total disconnections: %ld", g_wifi_ctx.total_disconnections);
-    APP_LOG_INFO(TAG, "Failed attempts: %ld", g_wifi_ctx.total_failed_attempts);
+    APP_LOG_INFO(TAG, "Total connections: %ld", metrics_counter_get(&g_wifi_connections));
+    APP_LOG_INFO(TAG, "Total disconnections: %ld", metrics_counter_get(&g_wifi_disconnections));
+    APP_LOG_INFO(TAG, "Failed attempts: %ld", metrics_counter_get(&g_wifi_failed_attempts));
     APP_LOG_INFO(TAG, "Retry count: %ld/%ld", g_wifi_ctx.retry_count, 
                 g_wifi_ctx.config.max_retries);
 }
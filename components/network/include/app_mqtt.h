@@ -9,6 +9,7 @@
 
 #include "app_common.h"
 #include "mqtt_client.h"
+#include "command.h"
 
 /* ============================================================================
    MQTT CALLBACKS
@@ -16,9 +17,23 @@
 
 /**
  * @brief MQTT message callback function type
+ *
+ * @note `data` points into the client's receive buffer and is not
+ *       NUL-terminated; use `data_len`.
  */
 typedef void (*mqtt_message_callback_t)(const char *topic, const char *data, int data_len);
 
+/**
+ * @brief Parsed command callback function type
+ *
+ * Called from the MQTT event handler with every valid command, with
+ * `stamps.received_us` set. Must not block: queue the command and return.
+ *
+ * @param cmd Command (copy it, the pointer is only valid during the call)
+ * @return APP_OK if the command was accepted
+ */
+typedef app_err_t (*mqtt_command_callback_t)(const command_t *cmd);
+
 /**
  * @brief MQTT event callback function type
  */
@@ -35,6 +50,7 @@ typedef struct {
     uint32_t reconnect_timeout_ms;  // Reconnection timeout
     
     mqtt_message_callback_t on_message;        // Called when message received
+    mqtt_command_callback_t on_command;        // Called with each parsed command
     mqtt_event_callback_t on_connected;        // Called on successful connection
     mqtt_event_callback_t on_disconnected;     // Called on disconnection
     mqtt_event_callback_t on_publish_failed;   // Called on publish failure
@@ -44,9 +60,9 @@ typedef struct {
    HELPERS FUNCTION 
    ============================================================================*/
 /**
- * @brief Parse incoming MQTT command and queue it for processing
+ * @brief Parse incoming MQTT command and pass it to `on_command`
  * 
- * @param data Pointer to command data
+ * @param data Pointer to command data (need not be NUL-terminated)
  * @param data_len Length of command data
  */
 void mqtt_parse_and_queue_command(const char *data, int data_len);
@@ -112,15 +128,6 @@ app_err_t app_mqtt_subscribe(const char *topic, int qos);
  */
 app_err_t app_mqtt_unsubscribe(const char *topic);
 
-/**
- * @brief Receive command message from queue (blocking with timeout)
- * @param type Pointer to command type string
- * @param value Pointer to command value
- * @param timeout_ms Maximum wait time (0 = no wait)
- * @return APP_OK on success, APP_ERR_TIMEOUT on timeout
- */
-app_err_t app_mqtt_receive_command(char *type, int *value, uint32_t timeout_ms);
-
 /**
  * @brief Get MQTT connection status
  * @return Status string (e.g., "CONNECTED", "CONNECTING", "DISCONNECTED")
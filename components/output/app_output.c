@@ -2,15 +2,26 @@
  * @file app_output.c
  * @brief Output module implementation - Relay and Fan PWM control
  * @version 2.0
+ *
+ * Channels live in a fixed table set up once by app_output_init_channels().
+ * PWM channels take an LEDC channel from a pool; the fade-end ISR maps it
+ * back to the output channel. Every write goes through output_apply()
+ * under g_output_ctx.lock, single sets are batches of one.
  */
 
 #include "app_output.h"
+#include "command.h"
+#include "metrics.h"
+#include "log_deferred.h"
 #include "driver/gpio.h"
 #include "driver/ledc.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdatomic.h>
 #include <string.h>
 
 static const char *TAG = "OUTPUT";
@@ -20,54 +31,82 @@ static const char *TAG = "OUTPUT";
    ============================================================================ */
 
 typedef struct {
-    // Pins
-    uint8_t relay_pin;
-    uint8_t fan_pin;
-    
+    fan_ramp_state_t state;
+    fan_ramp_easing_t easing;
+    uint8_t start_speed;
+    uint8_t target_speed;
+    uint8_t segment;                // Segments started
+    uint8_t segment_target;         // Duty the running fade ends at
+    uint32_t duration_ms;
+    uint32_t elapsed_ms;            // Ramp time covered by started segments
+} output_ramp_t;
+
+typedef struct {
+    output_type_t type;
+    uint8_t pin;
+    uint8_t index;                  // Among the channels of its type ("fan1")
+    uint8_t ledc_channel;           // PWM: taken from the LEDC pool
+    uint8_t value;                  // Relay state or duty
+    output_ramp_t ramp;             // PWM: LEDC hardware fades, one per curve segment
+} output_channel_t;
+
+typedef struct {
+    // Channel table (fixed after init)
+    output_channel_t channels[OUTPUT_MAX_CHANNELS];
+    uint8_t channel_count;
+    uint8_t relay_channel;          // First relay (relay API), OUTPUT_CHANNEL_NONE if none
+    uint8_t fan_channel;            // First PWM channel (fan API), OUTPUT_CHANNEL_NONE if none
+
+    // LEDC pool
+    uint8_t ledc_free;                              // Bit n set: LEDC channel n free
+    uint8_t ledc_owner[OUTPUT_MAX_PWM_CHANNELS];    // Output channel per LEDC channel
+
     // State
-    relay_state_t relay_state;
-    uint8_t fan_speed;
     bool is_enabled;
     bool initialized;
-    
-    // Statistics
-    uint32_t error_count;
-    uint64_t total_operations;
-    uint32_t relay_toggle_count;
-    uint32_t fan_changes;
-    
-    // Fan ramp
-    bool ramp_active;
-    uint8_t ramp_target_speed;
-    uint32_t ramp_duration_ms;
-    uint32_t ramp_start_ms;
-    TaskHandle_t ramp_task;
+
+    TaskHandle_t ramp_task;         // Persistent, woken by the fade-end ISR
+    atomic_uint fade_ends;          // LEDC channels whose fade ended (ISR -> ramp task)
+    SemaphoreHandle_t lock;         // Channel values and ramps
 } output_context_t;
 
 static output_context_t g_output_ctx = {0};
 
+// Statistics (metrics registry)
+static metrics_counter_t g_output_errors;
+static metrics_counter_t g_output_operations;
+static metrics_counter_t g_output_relay_toggles;
+static metrics_counter_t g_output_fan_changes;
+static metrics_gauge_t g_output_relay_state;
+static metrics_gauge_t g_output_fan_speed;
+
 /* ============================================================================
    LEDC (PWM) CONFIGURATION
    ============================================================================ */
 
 #define LEDC_TIMER              LEDC_TIMER_0
 #define LEDC_MODE               LEDC_LOW_SPEED_MODE
-#define LEDC_OUTPUT_IO          18      // Will be overridden by fan_pin
-#define LEDC_CHANNEL            LEDC_CHANNEL_0
 #define LEDC_DUTY_RES           LEDC_TIMER_8_BIT  // 8-bit resolution (0-255)
-#define LEDC_FREQUENCY          5000    // 5kHz
+#define LEDC_FREQUENCY          5000    // 5kHz, shared by all PWM channels
+
+#define FAN_RAMP_SEGMENTS       8       // Linear pieces of an eased curve
+#define FAN_RAMP_TASK_STACK     2048
+#define FAN_RAMP_TASK_PRIORITY  5
+
+_Static_assert(OUTPUT_MAX_PWM_CHANNELS <= LEDC_CHANNEL_MAX, "more PWM channels than LEDC channels");
+_Static_assert(OUTPUT_MAX_PWM_CHANNELS <= 8, "LEDC pool is an 8-bit mask");
+
+static bool fan_fade_end_isr(const ledc_cb_param_t *param, void *user_arg);
 
 /* ============================================================================
    PRIVATE HELPER FUNCTIONS
    ============================================================================ */
 
 /**
- * @brief Initialize LEDC PWM timer for fan control
+ * @brief Initialize the LEDC timer shared by all PWM channels
  */
-static app_err_t output_init_ledc(uint8_t fan_pin)
+static app_err_t output_init_ledc(void)
 {
-    APP_LOG_INFO(TAG, "Initializing LEDC PWM on GPIO%d", fan_pin);
-    
     // Configure LEDC timer
     ledc_timer_config_t ledc_timer = {
         .speed_mode = LEDC_MODE,
@@ -76,211 +115,777 @@ static app_err_t output_init_ledc(uint8_t fan_pin)
         .freq_hz = LEDC_FREQUENCY,
         .clk_cfg = LEDC_AUTO_CLK,
     };
-    
+
     esp_err_t ret = ledc_timer_config(&ledc_timer);
     if (ret != ESP_OK) {
         APP_LOG_ERROR(TAG, "LEDC timer config failed: %d", ret);
         return APP_ERR_UNKNOWN;
     }
-    
+
+    // Hardware fades for ramps, fade end interrupts wake the ramp task
+    ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK) {
+        APP_LOG_ERROR(TAG, "LEDC fade install failed: %d", ret);
+        return APP_ERR_UNKNOWN;
+    }
+
+    g_output_ctx.ledc_free = (uint8_t)((1u << OUTPUT_MAX_PWM_CHANNELS) - 1);
+    memset(g_output_ctx.ledc_owner, OUTPUT_CHANNEL_NONE, sizeof(g_output_ctx.ledc_owner));
+
+    APP_LOG_INFO(TAG, "LEDC PWM initialized: freq=%dHz, resolution=%d-bit",
+                LEDC_FREQUENCY, LEDC_DUTY_RES);
+    return APP_OK;
+}
+
+/**
+ * @brief Take the lowest free LEDC channel from the pool
+ * @return LEDC channel, OUTPUT_CHANNEL_NONE if the pool is empty
+ */
+static uint8_t output_ledc_alloc(void)
+{
+    for (uint8_t i = 0; i < OUTPUT_MAX_PWM_CHANNELS; i++) {
+        if (g_output_ctx.ledc_free & (1u << i)) {
+            g_output_ctx.ledc_free &= (uint8_t)~(1u << i);
+            return i;
+        }
+    }
+    return OUTPUT_CHANNEL_NONE;
+}
+
+static void output_ledc_release(uint8_t ledc_channel)
+{
+    g_output_ctx.ledc_free |= (uint8_t)(1u << ledc_channel);
+    g_output_ctx.ledc_owner[ledc_channel] = OUTPUT_CHANNEL_NONE;
+}
+
+/**
+ * @brief Attach a PWM channel to a pooled LEDC channel
+ */
+static app_err_t output_init_pwm(uint8_t id, output_channel_t *ch)
+{
+    APP_LOG_INFO(TAG, "Initializing %s%d PWM on GPIO%d",
+                app_output_type_to_string(ch->type), ch->index, ch->pin);
+
+    uint8_t ledc_channel = output_ledc_alloc();
+    if (ledc_channel == OUTPUT_CHANNEL_NONE) {
+        APP_LOG_ERROR(TAG, "No free LEDC channel");
+        return APP_ERR_NO_MEMORY;
+    }
+
     // Configure LEDC channel
-    ledc_channel_config_t ledc_channel = {
+    ledc_channel_config_t ledc_channel_cfg = {
         .speed_mode = LEDC_MODE,
-        .channel = LEDC_CHANNEL,
+        .channel = (ledc_channel_t)ledc_channel,
         .timer_sel = LEDC_TIMER,
         .intr_type = LEDC_INTR_DISABLE,
-        .gpio_num = fan_pin,
+        .gpio_num = ch->pin,
         .duty = 0,              // Initial duty = 0%
         .hpoint = 0,
         .flags.output_invert = 0,
     };
-    
-    ret = ledc_channel_config(&ledc_channel);
+
+    esp_err_t ret = ledc_channel_config(&ledc_channel_cfg);
     if (ret != ESP_OK) {
         APP_LOG_ERROR(TAG, "LEDC channel config failed: %d", ret);
+        output_ledc_release(ledc_channel);
         return APP_ERR_UNKNOWN;
     }
-    
-    APP_LOG_INFO(TAG, "LEDC PWM initialized: freq=%dHz, resolution=%d-bit",
-                LEDC_FREQUENCY, LEDC_DUTY_RES);
-    
+
+    ledc_cbs_t callbacks = {
+        .fade_cb = fan_fade_end_isr,
+    };
+    ret = ledc_cb_register(LEDC_MODE, (ledc_channel_t)ledc_channel, &callbacks, NULL);
+    if (ret != ESP_OK) {
+        APP_LOG_ERROR(TAG, "LEDC callback register failed: %d", ret);
+        output_ledc_release(ledc_channel);
+        return APP_ERR_UNKNOWN;
+    }
+
+    ch->ledc_channel = ledc_channel;
+    ch->ramp.state = FAN_RAMP_IDLE;
+    g_output_ctx.ledc_owner[ledc_channel] = id;
     return APP_OK;
 }
 
 /**
  * @brief Initialize GPIO for relay
  */
-static app_err_t output_init_relay(uint8_t relay_pin)
+static app_err_t output_init_relay(const output_channel_t *ch)
 {
-    APP_LOG_INFO(TAG, "Initializing relay on GPIO%d", relay_pin);
-    
+    APP_LOG_INFO(TAG, "Initializing %s%d on GPIO%d",
+                app_output_type_to_string(ch->type), ch->index, ch->pin);
+
     gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << relay_pin),
+        .pin_bit_mask = (1ULL << ch->pin),
         .mode = GPIO_MODE_OUTPUT,
         .pull_up_en = GPIO_PULLUP_DISABLE,
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
         .intr_type = GPIO_INTR_DISABLE,
     };
-    
+
     esp_err_t ret = gpio_config(&io_conf);
     if (ret != ESP_OK) {
         APP_LOG_ERROR(TAG, "GPIO config failed: %d", ret);
         return APP_ERR_UNKNOWN;
     }
-    
+
     // Set initial state: OFF
-    ret = gpio_set_level(relay_pin, RELAY_OFF);
+    ret = gpio_set_level(ch->pin, RELAY_OFF);
     if (ret != ESP_OK) {
         APP_LOG_ERROR(TAG, "GPIO set level failed: %d", ret);
         return APP_ERR_UNKNOWN;
     }
-    
-    APP_LOG_INFO(TAG, "Relay initialized (initial state: OFF)");
+
     return APP_OK;
 }
 
 /**
- * @brief Fan ramp task (smooth speed transition)
+ * @brief Check a channel table before touching any hardware
+ */
+static app_err_t output_check_table(const output_channel_config_t *channels, size_t count)
+{
+    uint64_t pins = 0;
+    size_t pwm_count = 0;
+    size_t relay_count = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const output_channel_config_t *cfg = &channels[i];
+
+        if (cfg->pin > 39 || (pins & (1ULL << cfg->pin))) {
+            APP_LOG_ERROR(TAG, "Invalid or repeated GPIO pin: %d", cfg->pin);
+            return APP_ERR_INVALID_PARAM;
+        }
+        pins |= 1ULL << cfg->pin;
+
+        if (cfg->type == OUTPUT_TYPE_PWM) {
+            pwm_count++;
+        } else if (cfg->type == OUTPUT_TYPE_RELAY) {
+            relay_count++;
+        } else {
+            APP_LOG_ERROR(TAG, "Invalid channel type: %d", cfg->type);
+            return APP_ERR_INVALID_PARAM;
+        }
+    }
+
+    if (pwm_count > OUTPUT_MAX_PWM_CHANNELS || relay_count > OUTPUT_MAX_RELAYS) {
+        APP_LOG_ERROR(TAG, "Too many channels: %d PWM (max %d), %d relays (max %d)",
+                     (int)pwm_count, OUTPUT_MAX_PWM_CHANNELS,
+                     (int)relay_count, OUTPUT_MAX_RELAYS);
+        return APP_ERR_INVALID_PARAM;
+    }
+    return APP_OK;
+}
+
+/**
+ * @brief Check one change against the channel table
+ */
+static app_err_t output_check_change(const output_change_t *change)
+{
+    if (change->channel >= g_output_ctx.channel_count) {
+        APP_LOG_ERROR(TAG, "Unknown output channel: %d", change->channel);
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    const output_channel_t *ch = &g_output_ctx.channels[change->channel];
+    if (ch->type == OUTPUT_TYPE_RELAY && change->value != RELAY_OFF && change->value != RELAY_ON) {
+        APP_LOG_ERROR(TAG, "Invalid relay state: %ld (must be 0 or 1)", change->value);
+        return APP_ERR_INVALID_VALUE;
+    }
+    if (ch->type == OUTPUT_TYPE_PWM && (change->value < FAN_SPEED_MIN || change->value > FAN_SPEED_MAX)) {
+        APP_LOG_ERROR(TAG, "Invalid duty: %ld (%d-%d)", change->value, FAN_SPEED_MIN, FAN_SPEED_MAX);
+        return APP_ERR_INVALID_VALUE;
+    }
+    return APP_OK;
+}
+
+/**
+ * @brief Keep the relay/fan gauges on the first relay and fan
+ */
+static void output_update_gauges(uint8_t id)
+{
+    if (id == g_output_ctx.relay_channel) {
+        metrics_gauge_set(&g_output_relay_state, g_output_ctx.channels[id].value);
+    } else if (id == g_output_ctx.fan_channel) {
+        metrics_gauge_set(&g_output_fan_speed, g_output_ctx.channels[id].value);
+    }
+}
+
+/* ============================================================================
+   FAN RAMP STATE MACHINE
+   ============================================================================
+ * Per PWM channel:
+ * IDLE --ramp()--> FADING --fade end--> FADING (next segment) ... --> IDLE
+ * FADING --set / new ramp / disable / stop--> IDLE (fade stopped)
+ *
+ * The LEDC peripheral moves the duty, the CPU only runs once per segment:
+ * the fade-end interrupt flags its LEDC channel and notifies the ramp
+ * task, which starts the next segment of each flagged channel. Linear
+ * ramps are a single fade. Ramp state and duty writes are under the
+ * output lock.
+ */
+
+/**
+ * @brief Easing curve, t and result in 1/256ths of the ramp
+ */
+static uint32_t fan_ramp_ease(fan_ramp_easing_t easing, uint32_t t)
+{
+    switch (easing) {
+        case FAN_RAMP_EASE_IN:      return t * t / 256;
+        case FAN_RAMP_EASE_OUT:     return t * (512 - t) / 256;
+        case FAN_RAMP_EASE_IN_OUT:  return t * t * (768 - 2 * t) / 65536;
+        default:                    return t;
+    }
+}
+
+/**
+ * @brief Duty at the end of a segment
+ */
+static uint8_t fan_ramp_point(const output_ramp_t *ramp, uint8_t segment, uint8_t segments)
+{
+    int from = ramp->start_speed;
+    int delta = ramp->target_speed - from;
+    int eased = (int)fan_ramp_ease(ramp->easing, (uint32_t)segment * 256 / segments);
+    return (uint8_t)(from + delta * eased / 256);
+}
+
+/**
+ * @brief Start the next segment that changes the duty (lock held)
+ *
+ * Segments without a duty change add their time to the next one.
+ *
+ * @param started Set to true if a fade is running
+ * @return `ESP_OK`, or the LEDC error
+ */
+static esp_err_t fan_ramp_next_segment(output_channel_t *ch, bool *started)
+{
+    output_ramp_t *ramp = &ch->ramp;
+    uint8_t segments = (ramp->easing == FAN_RAMP_LINEAR) ? 1 : FAN_RAMP_SEGMENTS;
+
+    *started = false;
+    while (ramp->segment < segments) {
+        ramp->segment++;
+        uint8_t duty = fan_ramp_point(ramp, ramp->segment, segments);
+        uint32_t end_ms = ramp->duration_ms * ramp->segment / segments;
+
+        if (duty == ramp->segment_target) {
+            continue;
+        }
+
+        ledc_channel_t ledc_channel = (ledc_channel_t)ch->ledc_channel;
+        esp_err_t ret = ledc_set_fade_with_time(LEDC_MODE, ledc_channel, duty,
+                                                (int)(end_ms - ramp->elapsed_ms));
+        if (ret == ESP_OK) {
+            ret = ledc_fade_start(LEDC_MODE, ledc_channel, LEDC_FADE_NO_WAIT);
+        }
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        ramp->elapsed_ms = end_ms;
+        ramp->segment_target = duty;
+        *started = true;
+        break;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Back to IDLE at the duty the fan is at (lock held)
+ */
+static void fan_ramp_finish(uint8_t id)
+{
+    output_channel_t *ch = &g_output_ctx.channels[id];
+    ch->ramp.state = FAN_RAMP_IDLE;
+    ch->value = (uint8_t)ledc_get_duty(LEDC_MODE, (ledc_channel_t)ch->ledc_channel);
+    output_update_gauges(id);
+}
+
+/**
+ * @brief Stop a running ramp where it is (lock held)
+ */
+static void fan_ramp_cancel(uint8_t id)
+{
+    output_channel_t *ch = &g_output_ctx.channels[id];
+    if (ch->type != OUTPUT_TYPE_PWM || ch->ramp.state != FAN_RAMP_FADING) {
+        return;
+    }
+
+    ledc_fade_stop(LEDC_MODE, (ledc_channel_t)ch->ledc_channel);
+    fan_ramp_finish(id);
+    APP_LOG_DEBUG(TAG, "fan%d ramp cancelled at PWM %d", ch->index, ch->value);
+}
+
+/**
+ * @brief LEDC fade end (ISR)
+ */
+static bool IRAM_ATTR fan_fade_end_isr(const ledc_cb_param_t *param, void *user_arg)
+{
+    (void)user_arg;
+    BaseType_t woken = pdFALSE;
+
+    if (param->event == LEDC_FADE_END_EVT && g_output_ctx.ramp_task) {
+        atomic_fetch_or_explicit(&g_output_ctx.fade_ends, 1u << param->channel,
+                                 memory_order_relaxed);
+        vTaskNotifyGiveFromISR(g_output_ctx.ramp_task, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+/**
+ * @brief Next segment of one channel after its fade ended (lock held)
+ */
+static void fan_ramp_on_fade_end(uint8_t id)
+{
+    output_channel_t *ch = &g_output_ctx.channels[id];
+
+    // Ends of fades that were stopped or replaced do not count
+    if (ch->ramp.state != FAN_RAMP_FADING ||
+        ledc_get_duty(LEDC_MODE, (ledc_channel_t)ch->ledc_channel) != ch->ramp.segment_target) {
+        return;
+    }
+
+    bool started = false;
+    esp_err_t ret = fan_ramp_next_segment(ch, &started);
+    if (ret != ESP_OK) {
+        APP_LOG_ERROR(TAG, "LEDC fade failed: %d", ret);
+        metrics_counter_inc(&g_output_errors);
+    }
+    if (!started) {
+        fan_ramp_finish(id);
+        if (ret == ESP_OK) {
+            APP_LOG_DEFER_DEBUG(TAG, "fan%d ramp complete: %d%%", ch->index, (ch->value * 100) / 255);
+        }
+    }
+}
+
+/**
+ * @brief Fan ramp task - starts the next segment at each fade end
+ *
+ * Created once by app_output_init_channels(), blocked while no ramp runs.
  */
 static void task_fan_ramp(void *pvParameter)
 {
-    APP_LOG_INFO(TAG, "Fan ramp task started");
-    
-    while (g_output_ctx.ramp_active) {
-        uint32_t elapsed_ms = (esp_timer_get_time() / 1000) - g_output_ctx.ramp_start_ms;
-        
-        if (elapsed_ms >= g_output_ctx.ramp_duration_ms) {
-            // Ramp complete
-            g_output_ctx.fan_speed = g_output_ctx.ramp_target_speed;
-            ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, g_output_ctx.fan_speed);
-            ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
-            
-            APP_LOG_DEBUG(TAG, "Fan ramp complete: %d%%", 
-                         (g_output_ctx.fan_speed * 100) / 255);
-            
-            g_output_ctx.ramp_active = false;
-            break;
+    (void)pvParameter;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        unsigned ends = atomic_exchange_explicit(&g_output_ctx.fade_ends, 0, memory_order_relaxed);
+
+        xSemaphoreTake(g_output_ctx.lock, portMAX_DELAY);
+        for (uint8_t ledc_channel = 0; ledc_channel < OUTPUT_MAX_PWM_CHANNELS; ledc_channel++) {
+            uint8_t id = g_output_ctx.ledc_owner[ledc_channel];
+            if ((ends & (1u << ledc_channel)) && id != OUTPUT_CHANNEL_NONE) {
+                fan_ramp_on_fade_end(id);
+            }
+        }
+        xSemaphoreGive(g_output_ctx.lock);
+    }
+}
+
+/* ============================================================================
+   CHANNEL WRITES
+   ============================================================================ */
+
+/**
+ * @brief Write checked changes to the hardware
+ *
+ * Staging: ramps are stopped and duties written to the LEDC duty
+ * registers, which do not drive the pins yet. Commit: relay GPIOs, then
+ * ledc_update_duty() for each PWM channel, back to back.
+ *
+ * @param old_values Output: value of each channel before the batch
+ */
+static app_err_t output_apply(const output_change_t *changes, size_t count, uint8_t *old_values)
+{
+    esp_err_t ret = ESP_OK;
+
+    xSemaphoreTake(g_output_ctx.lock, portMAX_DELAY);
+
+    for (size_t i = 0; i < count && ret == ESP_OK; i++) {
+        output_channel_t *ch = &g_output_ctx.channels[changes[i].channel];
+        if (ch->type == OUTPUT_TYPE_PWM) {
+            fan_ramp_cancel(changes[i].channel);
+            ret = ledc_set_duty(LEDC_MODE, (ledc_channel_t)ch->ledc_channel, (uint32_t)changes[i].value);
+        }
+        old_values[i] = ch->value;
+    }
+    for (size_t i = 0; i < count && ret == ESP_OK; i++) {
+        const output_channel_t *ch = &g_output_ctx.channels[changes[i].channel];
+        if (ch->type == OUTPUT_TYPE_RELAY) {
+            ret = gpio_set_level(ch->pin, (uint32_t)changes[i].value);
+        }
+    }
+    for (size_t i = 0; i < count && ret == ESP_OK; i++) {
+        const output_channel_t *ch = &g_output_ctx.channels[changes[i].channel];
+        if (ch->type == OUTPUT_TYPE_PWM) {
+            ret = ledc_update_duty(LEDC_MODE, (ledc_channel_t)ch->ledc_channel);
+        }
+    }
+
+    if (ret == ESP_OK) {
+        command_mark_actuated();
+        for (size_t i = 0; i < count; i++) {
+            g_output_ctx.channels[changes[i].channel].value = (uint8_t)changes[i].value;
+            output_update_gauges(changes[i].channel);
+        }
+    }
+
+    xSemaphoreGive(g_output_ctx.lock);
+
+    if (ret != ESP_OK) {
+        APP_LOG_ERROR(TAG, "Output write failed: %d", ret);
+        metrics_counter_inc(&g_output_errors);
+        return APP_ERR_UNKNOWN;
+    }
+    return APP_OK;
+}
+
+/**
+ * @brief Statistics and logs of an applied batch
+ */
+static void output_log_changes(const output_change_t *changes, size_t count, const uint8_t *old_values)
+{
+    for (size_t i = 0; i < count; i++) {
+        const output_channel_t *ch = &g_output_ctx.channels[changes[i].channel];
+        int value = (int)changes[i].value;
+        int old_value = old_values[i];
+
+        metrics_counter_inc(&g_output_operations);
+        if (ch->type == OUTPUT_TYPE_RELAY) {
+            metrics_counter_inc(&g_output_relay_toggles);
+            APP_LOG_DEFER_INFO(TAG, "relay%d: %s → %s", ch->index,
+                               old_value ? "ON" : "OFF",
+                               value ? "ON" : "OFF");
+        } else {
+            metrics_counter_inc(&g_output_fan_changes);
+            if (old_value != value) {
+                APP_LOG_DEFER_INFO(TAG, "fan%d speed: %d%% → %d%% (PWM: %d → %d)",
+                                   ch->index, (old_value * 100) / 255, (value * 100) / 255,
+                                   old_value, value);
+            }
+        }
+    }
+}
+
+/* ============================================================================
+   COMMAND HANDLERS
+   ============================================================================ */
+
+app_err_t app_output_command_handler(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+
+    switch (cmd->id) {
+        case COMMAND_RELAY:
+            return app_output_set_relay((relay_state_t)cmd->value);
+        case COMMAND_FAN:
+            return app_output_set_fan_speed((int)cmd->value);
+        case COMMAND_OUTPUT:
+            return app_output_set(cmd->channel, cmd->value);
+        case COMMAND_OUTPUTS: {
+            const command_group_t *group = command_get_group(cmd);
+            if (!group) {
+                return APP_ERR_INVALID_PARAM;
+            }
+            output_change_t changes[COMMAND_MAX_CHANGES];
+            for (uint8_t i = 0; i < group->count; i++) {
+                changes[i].channel = group->changes[i].channel;
+                changes[i].value = group->changes[i].value;
+            }
+            return app_output_set_batch(changes, group->count);
         }
-        
-        // Linear interpolation
-        uint8_t current_speed = g_output_ctx.fan_speed;
-        int delta = g_output_ctx.ramp_target_speed - current_speed;
-        uint8_t new_speed = current_speed + (delta * elapsed_ms) / g_output_ctx.ramp_duration_ms;
-        
-        ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, new_speed);
-        ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
-        
-        vTaskDelay(pdMS_TO_TICKS(50));  // Update every 50ms
-    }
-    
-    APP_LOG_DEBUG(TAG, "Fan ramp task ending");
-    g_output_ctx.ramp_task = NULL;
-    vTaskDelete(NULL);
+        default:
+            return APP_ERR_INVALID_PARAM;
+    }
 }
 
 /* ============================================================================
    PUBLIC API IMPLEMENTATION
    ============================================================================ */
 
-app_err_t app_output_init(uint8_t relay_pin, uint8_t fan_pin)
+app_err_t app_output_init_channels(const output_channel_config_t *channels, size_t count)
 {
-    if (relay_pin > 39 || fan_pin > 39) {
-        APP_LOG_ERROR(TAG, "Invalid GPIO pin: relay=%d, fan=%d", relay_pin, fan_pin);
+    if (!channels || count == 0 || count > OUTPUT_MAX_CHANNELS) {
+        APP_LOG_ERROR(TAG, "Invalid channel table (%d channels)", (int)count);
         return APP_ERR_INVALID_PARAM;
     }
-    
+
     if (g_output_ctx.initialized) {
         APP_LOG_WARN(TAG, "Output module already initialized");
         return APP_OK;
     }
-    
-    APP_LOG_INFO(TAG, "=== OUTPUT MODULE INITIALIZATION ===");
-    APP_LOG_INFO(TAG, "Relay pin: GPIO%d", relay_pin);
-    APP_LOG_INFO(TAG, "Fan pin: GPIO%d", fan_pin);
-    
-    // Initialize relay
-    app_err_t ret = output_init_relay(relay_pin);
+
+    app_err_t ret = output_check_table(channels, count);
     if (ret != APP_OK) {
         return ret;
     }
-    
-    // Initialize fan PWM
-    ret = output_init_ledc(fan_pin);
+
+    APP_LOG_INFO(TAG, "=== OUTPUT MODULE INITIALIZATION ===");
+
+    ret = output_init_ledc();
     if (ret != APP_OK) {
         return ret;
     }
-    
+
+    // Initialize channels (all off)
+    uint8_t type_count[OUTPUT_TYPE_PWM + 1] = {0};
+    g_output_ctx.relay_channel = OUTPUT_CHANNEL_NONE;
+    g_output_ctx.fan_channel = OUTPUT_CHANNEL_NONE;
+
+    for (uint8_t id = 0; id < count; id++) {
+        output_channel_t *ch = &g_output_ctx.channels[id];
+        ch->type = channels[id].type;
+        ch->pin = channels[id].pin;
+        ch->index = type_count[ch->type]++;
+        ch->value = 0;
+
+        if (ch->type == OUTPUT_TYPE_PWM) {
+            ret = output_init_pwm(id, ch);
+            if (g_output_ctx.fan_channel == OUTPUT_CHANNEL_NONE) {
+                g_output_ctx.fan_channel = id;
+            }
+        } else {
+            ret = output_init_relay(ch);
+            if (g_output_ctx.relay_channel == OUTPUT_CHANNEL_NONE) {
+                g_output_ctx.relay_channel = id;
+            }
+        }
+        if (ret != APP_OK) {
+            return ret;
+        }
+    }
+
+    // Fan ramps: one persistent task, idle until a fade ends (kept by app_output_deinit())
+    if (!g_output_ctx.lock) {
+        g_output_ctx.lock = xSemaphoreCreateMutex();
+        if (!g_output_ctx.lock) {
+            APP_LOG_ERROR(TAG, "Failed to create output mutex");
+            return APP_ERR_NO_MEMORY;
+        }
+    }
+
+    if (!g_output_ctx.ramp_task) {
+        BaseType_t task_ret = xTaskCreate(
+            task_fan_ramp,
+            "fan_ramp",
+            FAN_RAMP_TASK_STACK,
+            NULL,
+            FAN_RAMP_TASK_PRIORITY,
+            &g_output_ctx.ramp_task
+        );
+
+        if (task_ret != pdPASS) {
+            APP_LOG_ERROR(TAG, "Failed to create fan ramp task");
+            vSemaphoreDelete(g_output_ctx.lock);
+            g_output_ctx.lock = NULL;
+            return APP_ERR_NO_MEMORY;
+        }
+    }
+
     // Initialize context
-    g_output_ctx.relay_pin = relay_pin;
-    g_output_ctx.fan_pin = fan_pin;
-    g_output_ctx.relay_state = RELAY_OFF;
-    g_output_ctx.fan_speed = 0;
+    g_output_ctx.channel_count = (uint8_t)count;
     g_output_ctx.is_enabled = true;
     g_output_ctx.initialized = true;
-    g_output_ctx.error_count = 0;
-    g_output_ctx.total_operations = 0;
-    g_output_ctx.ramp_active = false;
-    g_output_ctx.ramp_task = NULL;
-    
-    APP_LOG_INFO(TAG, "✓ Output module initialized successfully");
+
+    metrics_register_counter(&g_output_errors, "output_errors_total");
+    metrics_register_counter(&g_output_operations, "output_operations_total");
+    metrics_register_counter(&g_output_relay_toggles, "relay_toggles_total");
+    metrics_register_counter(&g_output_fan_changes, "fan_changes_total");
+    metrics_register_gauge(&g_output_relay_state, "relay_state");
+    metrics_register_gauge(&g_output_fan_speed, "fan_speed");
+    metrics_gauge_set(&g_output_relay_state, RELAY_OFF);
+    metrics_gauge_set(&g_output_fan_speed, 0);
+
+    // Commands owned by this module
+    command_register(COMMAND_RELAY, RELAY_OFF, RELAY_ON, app_output_command_handler, NULL);
+    command_register(COMMAND_FAN, 0, 255, app_output_command_handler, NULL);
+    command_register(COMMAND_OUTPUT, 0, 255, app_output_command_handler, NULL);
+    command_register(COMMAND_OUTPUTS, 0, 255, app_output_command_handler, NULL);
+
+    APP_LOG_INFO(TAG, "✓ Output module initialized: %d relay(s), %d fan(s), %d LEDC channel(s) free",
+                type_count[OUTPUT_TYPE_RELAY], type_count[OUTPUT_TYPE_PWM],
+                __builtin_popcount(g_output_ctx.ledc_free));
     return APP_OK;
 }
 
+app_err_t app_output_deinit(void)
+{
+    if (!g_output_ctx.initialized) {
+        return APP_OK;
+    }
+
+    xSemaphoreTake(g_output_ctx.lock, portMAX_DELAY);
+    for (uint8_t id = 0; id < g_output_ctx.channel_count; id++) {
+        output_channel_t *ch = &g_output_ctx.channels[id];
+        if (ch->type == OUTPUT_TYPE_RELAY) {
+            gpio_set_level(ch->pin, RELAY_OFF);
+        } else {
+            fan_ramp_cancel(id);
+            ledc_stop(LEDC_MODE, (ledc_channel_t)ch->ledc_channel, 0);
+            output_ledc_release(ch->ledc_channel);
+        }
+    }
+
+    memset(g_output_ctx.channels, 0, sizeof(g_output_ctx.channels));
+    g_output_ctx.channel_count = 0;
+    g_output_ctx.relay_channel = OUTPUT_CHANNEL_NONE;
+    g_output_ctx.fan_channel = OUTPUT_CHANNEL_NONE;
+    g_output_ctx.is_enabled = false;
+    g_output_ctx.initialized = false;
+    xSemaphoreGive(g_output_ctx.lock);
+
+    // Fade ends still flagged find no channel and no ramp
+    ledc_fade_func_uninstall();
+    metrics_gauge_set(&g_output_relay_state, RELAY_OFF);
+    metrics_gauge_set(&g_output_fan_speed, 0);
+
+    APP_LOG_INFO(TAG, "Output module deinitialized");
+    return APP_OK;
+}
+
+app_err_t app_output_init(uint8_t relay_pin, uint8_t fan_pin)
+{
+    output_channel_config_t channels[] = {
+        { .type = OUTPUT_TYPE_RELAY, .pin = relay_pin },
+        { .type = OUTPUT_TYPE_PWM, .pin = fan_pin },
+    };
+    return app_output_init_channels(channels, sizeof(channels) / sizeof(channels[0]));
+}
+
 /* ============================================================================
-   RELAY CONTROL
+   CHANNELS
    ============================================================================ */
 
-app_err_t app_output_set_relay(relay_state_t state)
+app_err_t app_output_set(uint8_t channel, int32_t value)
+{
+    output_change_t change = {
+        .channel = channel,
+        .value = value
+    };
+    return app_output_set_batch(&change, 1);
+}
+
+app_err_t app_output_set_batch(const output_change_t *changes, size_t count)
 {
+    if (!changes || count == 0 || count > OUTPUT_MAX_CHANNELS) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
     if (!g_output_ctx.initialized) {
         APP_LOG_ERROR(TAG, "Output module not initialized");
         return APP_ERR_UNKNOWN;
     }
-    
+
     if (!g_output_ctx.is_enabled) {
-        APP_LOG_WARN(TAG, "Output module disabled, rejecting relay command");
+        APP_LOG_WARN(TAG, "Output module disabled, rejecting output command");
         return APP_ERR_UNKNOWN;
     }
-    
-    // Validate state value
-    if (state != RELAY_OFF && state != RELAY_ON) {
-        APP_LOG_ERROR(TAG, "Invalid relay state: %d (must be 0 or 1)", state);
-        g_output_ctx.error_count++;
-        return APP_ERR_INVALID_VALUE;
+
+    // Check the whole batch before the first write
+    app_err_t ret = app_output_check(changes, count);
+    if (ret != APP_OK) {
+        metrics_counter_inc(&g_output_errors);
+        return ret;
     }
-    
-    // Set GPIO level
-    esp_err_t ret = gpio_set_level(g_output_ctx.relay_pin, state);
-    if (ret != ESP_OK) {
-        APP_LOG_ERROR(TAG, "GPIO set level failed: %d", ret);
-        g_output_ctx.error_count++;
-        return APP_ERR_UNKNOWN;
+
+    uint8_t old_values[OUTPUT_MAX_CHANNELS];
+    ret = output_apply(changes, count, old_values);
+    if (ret == APP_OK) {
+        output_log_changes(changes, count, old_values);
+    }
+    return ret;
+}
+
+app_err_t app_output_check(const output_change_t *changes, size_t count)
+{
+    if (!changes || count == 0 || count > OUTPUT_MAX_CHANNELS) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    uint32_t seen = 0;
+    for (size_t i = 0; i < count; i++) {
+        app_err_t ret = output_check_change(&changes[i]);
+        if (ret != APP_OK) {
+            return ret;
+        }
+        if (seen & (1u << changes[i].channel)) {
+            APP_LOG_ERROR(TAG, "Channel %d repeated in batch", changes[i].channel);
+            return APP_ERR_INVALID_PARAM;
+        }
+        seen |= 1u << changes[i].channel;
     }
-    
-    // Update state
-    relay_state_t old_state = g_output_ctx.relay_state;
-    g_output_ctx.relay_state = (relay_state_t)state;
-    g_output_ctx.relay_toggle_count++;
-    g_output_ctx.total_operations++;
-    
-    APP_LOG_INFO(TAG, "Relay: %s → %s", 
-                old_state ? "ON" : "OFF",
-                state ? "ON" : "OFF");
-    
     return APP_OK;
 }
 
-relay_state_t app_output_get_relay(void)
+app_err_t app_output_get(uint8_t channel, uint8_t *value)
+{
+    if (!value || channel >= g_output_ctx.channel_count) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    const output_channel_t *ch = &g_output_ctx.channels[channel];
+    if (ch->type == OUTPUT_TYPE_PWM && ch->ramp.state == FAN_RAMP_FADING) {
+        *value = (uint8_t)ledc_get_duty(LEDC_MODE, (ledc_channel_t)ch->ledc_channel);
+    } else {
+        *value = ch->value;
+    }
+    return APP_OK;
+}
+
+size_t app_output_channel_count(void)
+{
+    return g_output_ctx.channel_count;
+}
+
+uint8_t app_output_find_channel(output_type_t type, uint8_t index)
+{
+    for (uint8_t id = 0; id < g_output_ctx.channel_count; id++) {
+        const output_channel_t *ch = &g_output_ctx.channels[id];
+        if (ch->type == type && ch->index == index) {
+            return id;
+        }
+    }
+    return OUTPUT_CHANNEL_NONE;
+}
+
+const char *app_output_type_to_string(output_type_t type)
+{
+    switch (type) {
+        case OUTPUT_TYPE_RELAY: return "relay";
+        case OUTPUT_TYPE_PWM:   return "fan";
+        default:                return "unknown";
+    }
+}
+
+/* ============================================================================
+   RELAY CONTROL
+   ============================================================================ */
+
+app_err_t app_output_set_relay(relay_state_t state)
 {
     if (!g_output_ctx.initialized) {
-        return RELAY_OFF;
+        APP_LOG_ERROR(TAG, "Output module not initialized");
+        return APP_ERR_UNKNOWN;
     }
-    return g_output_ctx.relay_state;
+
+    if (g_output_ctx.relay_channel == OUTPUT_CHANNEL_NONE) {
+        APP_LOG_ERROR(TAG, "No relay channel configured");
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    return app_output_set(g_output_ctx.relay_channel, state);
+}
+
+relay_state_t app_output_get_relay(void)
+{
+    uint8_t value = RELAY_OFF;
+    app_output_get(g_output_ctx.relay_channel, &value);
+    return (relay_state_t)value;
 }
 
 app_err_t app_output_toggle_relay(void)
 {
-    relay_state_t new_state = g_output_ctx.relay_state ? RELAY_OFF : RELAY_ON;
+    relay_state_t new_state = app_output_get_relay() ? RELAY_OFF : RELAY_ON;
     return app_output_set_relay(new_state);
 }
 
@@ -294,131 +899,137 @@ app_err_t app_output_set_fan_speed(int speed)
         APP_LOG_ERROR(TAG, "Output module not initialized");
         return APP_ERR_UNKNOWN;
     }
-    
-    if (!g_output_ctx.is_enabled) {
-        APP_LOG_WARN(TAG, "Output module disabled, rejecting fan command");
-        return APP_ERR_UNKNOWN;
+
+    if (g_output_ctx.fan_channel == OUTPUT_CHANNEL_NONE) {
+        APP_LOG_ERROR(TAG, "No fan channel configured");
+        return APP_ERR_INVALID_PARAM;
     }
-    
+
     // Clamp speed to valid range
     if (speed < FAN_SPEED_MIN) {
-        APP_LOG_WARN(TAG, "Fan speed %d clamped to minimum (%d)", 
+        APP_LOG_WARN(TAG, "Fan speed %d clamped to minimum (%d)",
                     speed, FAN_SPEED_MIN);
         speed = FAN_SPEED_MIN;
     } else if (speed > FAN_SPEED_MAX) {
-        APP_LOG_WARN(TAG, "Fan speed %d clamped to maximum (%d)", 
+        APP_LOG_WARN(TAG, "Fan speed %d clamped to maximum (%d)",
                     speed, FAN_SPEED_MAX);
         speed = FAN_SPEED_MAX;
     }
-    
-    // Cancel any active ramp
-    if (g_output_ctx.ramp_active) {
-        g_output_ctx.ramp_active = false;
-        APP_LOG_DEBUG(TAG, "Cancelling active fan ramp");
-    }
-    
-    // Set PWM duty
-    esp_err_t ret = ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, speed);
-    if (ret != ESP_OK) {
-        APP_LOG_ERROR(TAG, "LEDC set duty failed: %d", ret);
-        g_output_ctx.error_count++;
-        return APP_ERR_UNKNOWN;
-    }
-    
-    // Update duty value
-    ret = ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
-    if (ret != ESP_OK) {
-        APP_LOG_ERROR(TAG, "LEDC update duty failed: %d", ret);
-        g_output_ctx.error_count++;
-        return APP_ERR_UNKNOWN;
-    }
-    
-    uint8_t old_speed = g_output_ctx.fan_speed;
-    g_output_ctx.fan_speed = (uint8_t)speed;
-    g_output_ctx.fan_changes++;
-    g_output_ctx.total_operations++;
-    
-    // Log speed change
-    if (old_speed != g_output_ctx.fan_speed) {
-        int old_percent = (old_speed * 100) / 255;
-        int new_percent = (speed * 100) / 255;
-        APP_LOG_INFO(TAG, "Fan speed: %d%% → %d%% (PWM: %d → %d)", 
-                    old_percent, new_percent, old_speed, speed);
-    }
-    
-    return APP_OK;
+
+    return app_output_set(g_output_ctx.fan_channel, speed);
 }
 
 uint8_t app_output_get_fan_speed(void)
 {
-    if (!g_output_ctx.initialized) {
-        return 0;
-    }
-    return g_output_ctx.fan_speed;
+    uint8_t value = 0;
+    app_output_get(g_output_ctx.fan_channel, &value);
+    return value;
 }
 
-app_err_t app_output_ramp_fan_speed(uint8_t target_speed, uint32_t duration_ms)
+app_err_t app_output_ramp(uint8_t channel, uint8_t target_speed, uint32_t duration_ms,
+                          fan_ramp_easing_t easing)
 {
     if (!g_output_ctx.initialized) {
         return APP_ERR_UNKNOWN;
     }
-    
+
     if (!g_output_ctx.is_enabled) {
         return APP_ERR_UNKNOWN;
     }
-    
-    // Clamp target
-    // TODO: OPTIMIZE
-    // is this comparator need?
-    if (target_speed > FAN_SPEED_MAX) {
-        target_speed = FAN_SPEED_MAX;
+
+    if (channel >= g_output_ctx.channel_count ||
+        g_output_ctx.channels[channel].type != OUTPUT_TYPE_PWM ||
+        easing >= FAN_RAMP_EASING_COUNT) {
+        return APP_ERR_INVALID_PARAM;
     }
-    
+
     // Validate duration
     if (duration_ms == 0) {
-        return app_output_set_fan_speed(target_speed);
+        return app_output_set(channel, target_speed);
     }
-    
+
     if (duration_ms < 100 || duration_ms > 60000) {
         APP_LOG_ERROR(TAG, "Invalid ramp duration: %ld ms (100-60000)", duration_ms);
         return APP_ERR_INVALID_VALUE;
     }
-    
-    // Cancel existing ramp
-    if (g_output_ctx.ramp_active) {
-        g_output_ctx.ramp_active = false;
+
+    output_channel_t *ch = &g_output_ctx.channels[channel];
+    output_ramp_t *ramp = &ch->ramp;
+
+    xSemaphoreTake(g_output_ctx.lock, portMAX_DELAY);
+
+    // A running ramp is stopped where it is, the new one starts from there
+    fan_ramp_cancel(channel);
+    uint8_t start_speed = ch->value;
+
+    ramp->easing = easing;
+    ramp->start_speed = start_speed;
+    ramp->target_speed = target_speed;
+    ramp->duration_ms = duration_ms;
+    ramp->segment = 0;
+    ramp->segment_target = start_speed;
+    ramp->elapsed_ms = 0;
+
+    bool started = false;
+    esp_err_t ret = fan_ramp_next_segment(ch, &started);
+    if (started) {
+        ramp->state = FAN_RAMP_FADING;
+        command_mark_actuated();
+    } else {
+        fan_ramp_finish(channel);
     }
-    
-    APP_LOG_INFO(TAG, "Starting fan ramp: %d%% → %d%% over %ld ms",
-                (g_output_ctx.fan_speed * 100) / 255,
-                (target_speed * 100) / 255,
-                duration_ms);
-    
-    // Set ramp parameters
-    g_output_ctx.ramp_active = true;
-    g_output_ctx.ramp_target_speed = target_speed;
-    g_output_ctx.ramp_duration_ms = duration_ms;
-    g_output_ctx.ramp_start_ms = esp_timer_get_time() / 1000;
-    
-    // Create ramp task
-    BaseType_t ret = xTaskCreate(
-        task_fan_ramp,
-        "fan_ramp",
-        2048,
-        NULL,
-        5,
-        &g_output_ctx.ramp_task
-    );
-    
-    if (ret != pdPASS) {
-        APP_LOG_ERROR(TAG, "Failed to create fan ramp task");
-        g_output_ctx.ramp_active = false;
-        return APP_ERR_NO_MEMORY;
+
+    xSemaphoreGive(g_output_ctx.lock);
+
+    if (ret != ESP_OK) {
+        APP_LOG_ERROR(TAG, "LEDC fade failed: %d", ret);
+        metrics_counter_inc(&g_output_errors);
+        return APP_ERR_UNKNOWN;
     }
-    
+
+    metrics_counter_inc(&g_output_fan_changes);
+    metrics_counter_inc(&g_output_operations);
+    APP_LOG_INFO(TAG, "Starting fan%d ramp: %d%% → %d%% over %ld ms (%s)",
+                ch->index,
+                (start_speed * 100) / 255,
+                (target_speed * 100) / 255,
+                duration_ms, app_output_easing_to_string(easing));
+
     return APP_OK;
 }
 
+app_err_t app_output_ramp_fan_speed(uint8_t target_speed, uint32_t duration_ms,
+                                    fan_ramp_easing_t easing)
+{
+    if (!g_output_ctx.initialized) {
+        return APP_ERR_UNKNOWN;
+    }
+    return app_output_ramp(g_output_ctx.fan_channel, target_speed, duration_ms, easing);
+}
+
+bool app_output_fan_is_ramping(void)
+{
+    return app_output_is_ramping(g_output_ctx.fan_channel);
+}
+
+bool app_output_is_ramping(uint8_t channel)
+{
+    return channel < g_output_ctx.channel_count &&
+           g_output_ctx.channels[channel].type == OUTPUT_TYPE_PWM &&
+           g_output_ctx.channels[channel].ramp.state == FAN_RAMP_FADING;
+}
+
+const char *app_output_easing_to_string(fan_ramp_easing_t easing)
+{
+    switch (easing) {
+        case FAN_RAMP_LINEAR:       return "linear";
+        case FAN_RAMP_EASE_IN:      return "ease-in";
+        case FAN_RAMP_EASE_OUT:     return "ease-out";
+        case FAN_RAMP_EASE_IN_OUT:  return "ease-in-out";
+        default:                    return "unknown";
+    }
+}
+
 /* ============================================================================
    STATUS & DIAGNOSTICS
    ============================================================================ */
@@ -428,34 +1039,38 @@ app_err_t app_output_get_status(output_status_t *status)
     if (!status) {
         return APP_ERR_INVALID_PARAM;
     }
-    
+
     if (!g_output_ctx.initialized) {
         return APP_ERR_UNKNOWN;
     }
-    
-    status->relay = g_output_ctx.relay_state;
-    status->fan.speed = g_output_ctx.fan_speed;
-    status->fan.is_active = (g_output_ctx.fan_speed > 0);
+
+    status->relay = app_output_get_relay();
+    status->fan.speed = app_output_get_fan_speed();
+    status->fan.is_active = (status->fan.speed > 0);
     status->fan.last_update_ms = esp_timer_get_time() / 1000;
-    status->error_count = g_output_ctx.error_count;
-    status->total_operations = g_output_ctx.total_operations;
-    
+    status->error_count = metrics_counter_get(&g_output_errors);
+    status->total_operations = metrics_counter_get(&g_output_operations);
+
     return APP_OK;
 }
 
 app_err_t app_output_set_enabled(bool enabled)
 {
-    g_output_ctx.is_enabled = enabled;
-    
-    if (!enabled) {
-        // Disable all outputs
+    if (!enabled && g_output_ctx.initialized) {
+        // Disable all outputs (before rejecting writes)
         APP_LOG_WARN(TAG, "Output module disabled!");
-        app_output_set_relay(RELAY_OFF);
-        app_output_set_fan_speed(FAN_SPEED_OFF);
-    } else {
+        output_change_t changes[OUTPUT_MAX_CHANNELS];
+        uint8_t old_values[OUTPUT_MAX_CHANNELS];
+        for (uint8_t id = 0; id < g_output_ctx.channel_count; id++) {
+            changes[id].channel = id;
+            changes[id].value = 0;
+        }
+        output_apply(changes, g_output_ctx.channel_count, old_values);
+    } else if (enabled) {
         APP_LOG_INFO(TAG, "Output module enabled");
     }
-    
+
+    g_output_ctx.is_enabled = enabled;
     return APP_OK;
 }
 
@@ -467,17 +1082,25 @@ bool app_output_is_enabled(void)
 app_err_t app_output_emergency_stop(void)
 {
     APP_LOG_ERROR(TAG, "🚨 EMERGENCY STOP TRIGGERED!");
-    
-    // Force all outputs OFF
-    gpio_set_level(g_output_ctx.relay_pin, RELAY_OFF);
-    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 0);
-    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
-    
+
+    // Force all outputs OFF (a running fade would override the duty)
+    for (uint8_t id = 0; id < g_output_ctx.channel_count; id++) {
+        output_channel_t *ch = &g_output_ctx.channels[id];
+        if (ch->type == OUTPUT_TYPE_RELAY) {
+            gpio_set_level(ch->pin, RELAY_OFF);
+        } else {
+            ledc_fade_stop(LEDC_MODE, (ledc_channel_t)ch->ledc_channel);
+            ledc_set_duty(LEDC_MODE, (ledc_channel_t)ch->ledc_channel, 0);
+            ledc_update_duty(LEDC_MODE, (ledc_channel_t)ch->ledc_channel);
+            ch->ramp.state = FAN_RAMP_IDLE;
+        }
+        ch->value = 0;
+    }
+
     // Reset state
-    g_output_ctx.relay_state = RELAY_OFF;
-    g_output_ctx.fan_speed = 0;
+    metrics_gauge_set(&g_output_relay_state, RELAY_OFF);
+    metrics_gauge_set(&g_output_fan_speed, 0);
     g_output_ctx.is_enabled = false;
-    g_output_ctx.ramp_active = false;
-    
+
     return APP_OK;
 }
@@ -2,17 +2,73 @@
  * @file app_output.h
  * @brief Output control module - Relay and Fan PWM control
  * @version 2.0
+ *
+ * Outputs are a table of channels, each a relay (GPIO, 0/1) or a PWM fan
+ * (LEDC, duty 0-255). PWM channels take an LEDC channel from a pool of
+ * OUTPUT_MAX_PWM_CHANNELS, all on one timer (5 kHz, 8 bit). The channel
+ * id is the index in the table given to app_output_init_channels().
+ *
+ * app_output_set_batch() applies several changes as one unit: every
+ * change is checked before the first write, no other write runs between
+ * them, and the PWM duties are latched back to back. MQTT:
+ *
+ *   {"type": "output", "channel": 2, "value": 200}
+ *   {"type": "outputs", "changes": [[0, 1], [1, 128], [2, 128]]}
+ *
+ * The relay/fan functions and commands drive the first relay and the
+ * first PWM channel.
+ *
+ * Usage:
+    @code
+    ```c
+    // Heater relay, two fans
+    output_channel_config_t channels[] = {
+        { .type = OUTPUT_TYPE_RELAY, .pin = 5 },    // Channel 0
+        { .type = OUTPUT_TYPE_PWM, .pin = 18 },     // Channel 1
+        { .type = OUTPUT_TYPE_PWM, .pin = 19 },     // Channel 2
+    };
+    app_output_init_channels(channels, 3);
+
+    output_change_t both_fans[] = { { 1, 200 }, { 2, 200 } };
+    app_output_set_batch(both_fans, 2);
+    ```
+    @endcode
  */
 
 #ifndef APP_OUTPUT_H
 #define APP_OUTPUT_H
 
 #include "app_common.h"
+#include "command.h"
 
 /* ============================================================================
    OUTPUT CONTROL - RELAY & FAN
    ============================================================================ */
 
+/**
+ * @brief Output channel types
+ */
+typedef enum {
+    OUTPUT_TYPE_RELAY = 0,      // GPIO, 0 or 1
+    OUTPUT_TYPE_PWM,            // LEDC duty, 0-255
+} output_type_t;
+
+/**
+ * @brief One entry of the channel table
+ */
+typedef struct {
+    output_type_t type;
+    uint8_t pin;
+} output_channel_config_t;
+
+/**
+ * @brief One change of a batch
+ */
+typedef struct {
+    uint8_t channel;
+    int32_t value;              // Relay: 0 or 1, PWM: 0-255
+} output_change_t;
+
 /**
  * @brief Relay states
  */
@@ -30,6 +86,25 @@ typedef struct {
     uint32_t last_update_ms;
 } fan_state_t;
 
+/**
+ * @brief Fan ramp curves (speed over time)
+ */
+typedef enum {
+    FAN_RAMP_LINEAR = 0,        // Constant rate
+    FAN_RAMP_EASE_IN,           // Slow start (quadratic)
+    FAN_RAMP_EASE_OUT,          // Slow end (quadratic)
+    FAN_RAMP_EASE_IN_OUT,       // Slow start and end (smoothstep)
+    FAN_RAMP_EASING_COUNT
+} fan_ramp_easing_t;
+
+/**
+ * @brief Fan ramp states
+ */
+typedef enum {
+    FAN_RAMP_IDLE = 0,
+    FAN_RAMP_FADING,            // LEDC hardware fade running
+} fan_ramp_state_t;
+
 /**
  * @brief Output device status
  */
@@ -45,13 +120,126 @@ typedef struct {
    ============================================================================ */
 
 /**
- * @brief Initialize output module with configured pins
- * @param relay_pin GPIO pin for relay
- * @param fan_pin GPIO pin for fan PWM
+ * @brief Initialize output module with a channel table
+ *
+ * All channels start off. Registers the "relay", "fan", "output" and
+ * "outputs" commands.
+ *
+ * @param channels Channel table, copied (channel id = index)
+ * @param count Number of channels (1 to OUTPUT_MAX_CHANNELS)
+ * @return `APP_OK` on success, error code otherwise
+ *
+ * @retval APP_ERR_INVALID_PARAM `NULL`, bad count or pin, a pin used twice,
+ *         more than OUTPUT_MAX_PWM_CHANNELS PWM or OUTPUT_MAX_RELAYS relays
+ * @retval APP_ERR_NO_MEMORY Mutex or ramp task creation failed
+ */
+app_err_t app_output_init_channels(const output_channel_config_t *channels, size_t count);
+
+/**
+ * @brief Initialize output module with one relay and one fan
+ * @param relay_pin GPIO pin for relay (channel 0)
+ * @param fan_pin GPIO pin for fan PWM (channel 1)
  * @return APP_OK on success
  */
 app_err_t app_output_init(uint8_t relay_pin, uint8_t fan_pin);
 
+/**
+ * @brief Turn all channels off and forget the channel table
+ *
+ * Stops running ramps and returns the LEDC channels to the pool; the
+ * ramp task and the output lock are kept for the next
+ * app_output_init_channels(). Registered commands stay registered and
+ * are rejected until then. Used by host tests, which reset the
+ * peripherals between test cases.
+ *
+ * @return `APP_OK` (also when not initialized)
+ */
+app_err_t app_output_deinit(void);
+
+/* ============================================================================
+   PUBLIC API - CHANNELS
+   ============================================================================ */
+
+/**
+ * @brief Set one channel
+ * @param channel Channel id
+ * @param value Relay: 0 or 1, PWM: duty 0-255 (stops a running ramp)
+ * @return `APP_OK` on success, error code otherwise
+ *
+ * @retval APP_ERR_INVALID_PARAM Unknown channel
+ * @retval APP_ERR_INVALID_VALUE Value out of range for the channel type
+ * @retval APP_ERR_UNKNOWN Not initialized, disabled or driver error
+ */
+app_err_t app_output_set(uint8_t channel, int32_t value);
+
+/**
+ * @brief Set several channels as one unit
+ *
+ * All changes are checked first, nothing is written if one is invalid.
+ * The writes run under the output lock: relays first, then the PWM duties
+ * are latched back to back.
+ *
+ * @param changes Changes, each channel at most once
+ * @param count Number of changes (1 to OUTPUT_MAX_CHANNELS)
+ * @return `APP_OK` on success, error code otherwise
+ *
+ * @retval APP_ERR_INVALID_PARAM `NULL`, bad count, unknown or repeated channel
+ * @retval APP_ERR_INVALID_VALUE A value out of range for its channel
+ * @retval APP_ERR_UNKNOWN Not initialized, disabled or driver error (the
+ *         batch may then be partly applied)
+ */
+app_err_t app_output_set_batch(const output_change_t *changes, size_t count);
+
+/**
+ * @brief Check a batch without applying it
+ * @param changes Changes
+ * @param count Number of changes (1 to OUTPUT_MAX_CHANNELS)
+ * @return `APP_OK` if app_output_set_batch() would accept it, otherwise
+ *         the error it would return
+ */
+app_err_t app_output_check(const output_change_t *changes, size_t count);
+
+/**
+ * @brief Read one channel
+ * @param channel Channel id
+ * @param value Output: relay state or duty (read back from LEDC during a ramp)
+ * @return `APP_OK`, `APP_ERR_INVALID_PARAM` on an unknown channel or `NULL`
+ */
+app_err_t app_output_get(uint8_t channel, uint8_t *value);
+
+/**
+ * @brief Number of configured channels
+ * @return Channel count, 0 before init
+ */
+size_t app_output_channel_count(void);
+
+/**
+ * @brief Find the n-th channel of a type
+ * @param type Channel type
+ * @param index 0 for the first relay/fan, 1 for the second...
+ * @return Channel id, `OUTPUT_CHANNEL_NONE` if there is no such channel
+ */
+uint8_t app_output_find_channel(output_type_t type, uint8_t index);
+
+/**
+ * @brief Handler of the "relay", "fan", "output" and "outputs" commands
+ *
+ * Registered by app_output_init_channels(). Public so that components
+ * which take over these commands (controller.h) can forward to it.
+ *
+ * @param cmd Command
+ * @param ctx Unused
+ * @return Result of the output call
+ */
+app_err_t app_output_command_handler(const command_t *cmd, void *ctx);
+
+/**
+ * @brief Channel type name for logs
+ * @param type Type
+ * @return Name ("relay", "fan")
+ */
+const char *app_output_type_to_string(output_type_t type);
+
 /* ============================================================================
    PUBLIC API - RELAY CONTROL
    ============================================================================ */
@@ -102,20 +290,59 @@ app_err_t app_output_set_fan_speed(int speed);
 
 /**
  * @brief Get current fan speed
- * @return Current PWM duty (0-255)
+ * @return Current PWM duty (0-255), read back from LEDC during a ramp
  */
 uint8_t app_output_get_fan_speed(void);
 
 /**
  * @brief Ramp fan speed (smooth acceleration)
  * @param target_speed Target PWM duty (0-255)
- * @param duration_ms Duration of ramp in milliseconds
+ * @param duration_ms Duration of ramp in milliseconds (100-60000, 0 = set at once)
+ * @param easing Curve
  * @return APP_OK on success
  * 
  * @note
- * This is non-blocking and runs in background task
+ * - Non-blocking, the LEDC fade hardware moves the duty: one fade for
+ *   linear ramps, FAN_RAMP_SEGMENTS linear pieces for eased curves
+ * - A new ramp, app_output_set_fan_speed(), disable or emergency stop
+ *   stops a running ramp at the duty it reached
  */
-app_err_t app_output_ramp_fan_speed(uint8_t target_speed, uint32_t duration_ms);
+app_err_t app_output_ramp_fan_speed(uint8_t target_speed, uint32_t duration_ms,
+                                    fan_ramp_easing_t easing);
+
+/**
+ * @brief Ramp the duty of a PWM channel
+ * @param channel PWM channel id
+ * @param target_speed Target PWM duty (0-255)
+ * @param duration_ms Duration of ramp in milliseconds (100-60000, 0 = set at once)
+ * @param easing Curve
+ * @return APP_OK on success, `APP_ERR_INVALID_PARAM` for relays
+ *
+ * @note Same behaviour as app_output_ramp_fan_speed(), ramps on different
+ *       channels run independently
+ */
+app_err_t app_output_ramp(uint8_t channel, uint8_t target_speed, uint32_t duration_ms,
+                          fan_ramp_easing_t easing);
+
+/**
+ * @brief Check if a fan ramp is running
+ * @return true while fading
+ */
+bool app_output_fan_is_ramping(void);
+
+/**
+ * @brief Check if a ramp runs on a channel
+ * @param channel Channel id
+ * @return true while fading
+ */
+bool app_output_is_ramping(uint8_t channel);
+
+/**
+ * @brief Easing name for logs
+ * @param easing Curve
+ * @return Name ("linear", "ease-in", "ease-out", "ease-in-out")
+ */
+const char *app_output_easing_to_string(fan_ramp_easing_t easing);
 
 /* ============================================================================
    PUBLIC API - STATUS & DIAGNOSTICS
@@ -135,8 +362,8 @@ app_err_t app_output_get_status(output_status_t *status);
  * 
  * @note
  * When disabled:
- * - Relay goes to OFF
- * - Fan goes to 0% speed
+ * - Relays go to OFF
+ * - Fans go to 0% speed
  * - All commands are rejected
  */
 app_err_t app_output_set_enabled(bool enabled);
@@ -152,8 +379,8 @@ bool app_output_is_enabled(void);
  * @return APP_OK on success
  * 
  * @note
- * - Forces relay OFF
- * - Forces fan OFF
+ * - Forces all relays OFF
+ * - Forces all fans OFF
  * - Resets module
  */
 app_err_t app_output_emergency_stop(void);
@@ -162,6 +389,11 @@ app_err_t app_output_emergency_stop(void);
    CONSTANTS
    ============================================================================ */
 
+#define OUTPUT_MAX_PWM_CHANNELS 8     /**< LEDC channel pool */
+#define OUTPUT_MAX_RELAYS       4
+#define OUTPUT_MAX_CHANNELS     (OUTPUT_MAX_PWM_CHANNELS + OUTPUT_MAX_RELAYS)
+#define OUTPUT_CHANNEL_NONE     0xFF
+
 #define FAN_SPEED_MIN         0
 #define FAN_SPEED_MAX         255
 #define FAN_SPEED_OFF         0
@@ -0,0 +1,144 @@
+/**
+ * @file output_schedule.h
+ * @brief Timed and daily output actions, run on the device
+ * @version 2.0
+ *
+ * Actions:
+ * - Timed: set channels now, put their previous values back after a
+ *   duration ("relay on for 300 s")
+ * - Daily: set channels from a start to an end time of day, local time,
+ *   and put the previous values back outside that window ("fan 60 % from
+ *   22:00 to 06:00"). An end before the start spans midnight
+ *
+ *   {"type": "output_for", "channel": 0, "value": 1, "duration": 300}
+ *   {"type": "output_daily", "channel": 1, "value": 153, "start": 1320, "end": 360}
+ *   {"type": "output_daily", "changes": [[1, 153], [2, 153]], "start": 1320, "end": 360}
+ *   {"type": "schedule_cancel", "value": 1}      channel, 255 = all
+ *
+ * Times of day are minutes after midnight. A new action replaces the
+ * actions on any of its channels; cancelling an action puts its channels
+ * back.
+ *
+ * All actions share one hashed timer wheel (timer_wheel.h) driven by one
+ * one-shot esp_timer, armed for the wheel's next expiry and stopped while
+ * no action is pending: no task or esp_timer per action, and no wakeups
+ * between boundaries. Actions do not write outputs themselves, they
+ * queue "outputs" commands for the output task, so scheduled writes are
+ * checked like MQTT ones (including the controller's lock on the loop's
+ * outputs).
+ *
+ * Actions run without WiFi or the broker and survive reconnects. They
+ * live in RAM and are lost on reboot. Daily actions need the system clock
+ * (SNTP): they wait while it is not set, and recompute the next boundary
+ * each time they wake (at least hourly), so clock corrections are
+ * followed.
+ *
+ * Usage:
+    @code
+    ```c
+    // After system_task_init() (command queue) and app_output_init_channels()
+    output_schedule_config_t schedule_cfg = {
+        .submit = system_task_submit_command,
+    };
+    output_schedule_init(&schedule_cfg);
+
+    output_change_t relay_on = { .channel = 0, .value = RELAY_ON };
+    output_schedule_add_timed(&relay_on, 1, 300);
+    ```
+    @endcode
+ */
+
+#ifndef OUTPUT_SCHEDULE_H
+#define OUTPUT_SCHEDULE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "app_common.h"
+#include "app_output.h"
+#include "command.h"
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+#define OUTPUT_SCHEDULE_MAX_ACTIONS     8       /**< Actions pending at once */
+#define OUTPUT_SCHEDULE_TICK_MS         1000    /**< Wheel tick (timing resolution) */
+#define OUTPUT_SCHEDULE_MAX_DURATION_S  (7 * 24 * 3600)
+#define OUTPUT_SCHEDULE_MINUTES_PER_DAY 1440
+#define OUTPUT_SCHEDULE_ALL_CHANNELS    0xFF    /**< output_schedule_cancel(): every action */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Queues a command for the output task (never blocks)
+ *
+ * On success the command's group (command_set_group()) goes with it,
+ * on failure the scheduler releases it.
+ */
+typedef app_err_t (*output_schedule_submit_t)(const command_t *cmd);
+
+/**
+ * @brief Scheduler configuration
+ */
+typedef struct {
+    output_schedule_submit_t submit;    // e.g. system_task_submit_command
+} output_schedule_config_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Initialize the scheduler and register its commands
+ *
+ * Registers "output_for", "output_daily" and "schedule_cancel".
+ *
+ * @param config Configuration, copied
+ * @return `APP_OK` on success, error code otherwise.
+ *
+ * @retval APP_ERR_INVALID_PARAM `NULL` config or submit callback
+ * @retval APP_ERR_NO_MEMORY Mutex or esp_timer creation failed
+ */
+app_err_t output_schedule_init(const output_schedule_config_t *config);
+
+/**
+ * @brief Set channels now, put them back after a duration
+ *
+ * @param changes Values to set
+ * @param count Number of changes (1 to COMMAND_MAX_CHANGES)
+ * @param duration_s Seconds (1 to OUTPUT_SCHEDULE_MAX_DURATION_S)
+ * @return `APP_OK` on success, error code otherwise.
+ *
+ * @retval APP_ERR_INVALID_PARAM Bad batch (app_output_check()), bad
+ *         duration or not initialized
+ * @retval APP_ERR_INVALID_VALUE Value out of range for its channel
+ * @retval APP_ERR_NO_MEMORY OUTPUT_SCHEDULE_MAX_ACTIONS pending
+ */
+app_err_t output_schedule_add_timed(const output_change_t *changes, size_t count,
+                                    uint32_t duration_s);
+
+/**
+ * @brief Set channels every day between two times
+ *
+ * @param changes Values to set inside the window
+ * @param count Number of changes (1 to COMMAND_MAX_CHANGES)
+ * @param start_min Window start, minutes after midnight
+ * @param end_min Window end, minutes after midnight (before start: next day)
+ * @return Same as output_schedule_add_timed(), `APP_ERR_INVALID_PARAM`
+ *         also for times of 1440 or more and start == end
+ */
+app_err_t output_schedule_add_daily(const output_change_t *changes, size_t count,
+                                    uint16_t start_min, uint16_t end_min);
+
+/**
+ * @brief Cancel the actions on a channel and put their channels back
+ * @param channel Channel, OUTPUT_SCHEDULE_ALL_CHANNELS for every action
+ * @return Number of actions cancelled
+ */
+size_t output_schedule_cancel(uint8_t channel);
+
+/**
+ * @brief Number of pending actions
+ */
+size_t output_schedule_count(void);
+
+#endif // OUTPUT_SCHEDULE_H
@@ -0,0 +1,547 @@
+/**
+ * @file output_schedule.c
+ * @brief Timed and daily output actions, run on the device
+ * @version 2.0
+ *
+ * Actions are a fixed pool, each with a timer embedded in it. The mutex
+ * serializes the wheel tick (esp_timer task) with the commands (output
+ * task). An action remembers the values it replaced, so it can put them
+ * back; a replacing action inherits them, so the channels end up at their
+ * unscheduled values whichever way the actions overlapped.
+ */
+
+#include "output_schedule.h"
+#include "timer_wheel.h"
+#include "metrics.h"
+#include "log_deferred.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "SCHEDULE";
+
+#define SCHEDULE_CLOCK_VALID_AFTER  1577836800  // 2020-01-01: earlier means SNTP has not synced
+#define SCHEDULE_CLOCK_RETRY_S      60          // Daily action waiting for the clock
+#define SCHEDULE_DAILY_RECHECK_S    3600        // Longest sleep of a daily action (clock corrections)
+
+_Static_assert(COMMAND_MAX_CHANGES <= OUTPUT_MAX_CHANNELS, "action changes must fit one output batch");
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+typedef enum {
+    SCHEDULE_ACTION_FREE = 0,
+    SCHEDULE_ACTION_TIMED,
+    SCHEDULE_ACTION_DAILY,
+} schedule_kind_t;
+
+typedef struct {
+    schedule_kind_t kind;
+    bool applied;                   // Values set, restore holds what they replaced
+    uint8_t count;
+    output_change_t changes[COMMAND_MAX_CHANGES];
+    uint8_t restore[COMMAND_MAX_CHANGES];
+    uint16_t start_min;             // Daily window
+    uint16_t end_min;
+    timer_wheel_timer_t timer;      // Timed: expiry, daily: next boundary
+} schedule_action_t;
+
+typedef struct {
+    output_schedule_config_t config;
+    schedule_action_t actions[OUTPUT_SCHEDULE_MAX_ACTIONS];
+    size_t action_count;
+    timer_wheel_t wheel;
+    esp_timer_handle_t tick_timer;  // One-shot, armed for the wheel's next expiry
+    SemaphoreHandle_t mutex;
+    bool initialized;
+} schedule_context_t;
+
+static schedule_context_t g_schedule_ctx = {0};
+
+static metrics_gauge_t g_schedule_actions;
+static metrics_counter_t g_schedule_writes;
+static metrics_counter_t g_schedule_errors;
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+
+static uint64_t schedule_now_tick(void)
+{
+    return (uint64_t)esp_timer_get_time() / (OUTPUT_SCHEDULE_TICK_MS * 1000ULL);
+}
+
+static uint64_t schedule_seconds_to_ticks(uint32_t seconds)
+{
+    return (uint64_t)seconds * 1000 / OUTPUT_SCHEDULE_TICK_MS;
+}
+
+/**
+ * @brief Local time of day, false while the clock is not set
+ */
+static bool schedule_local_time(int *minute, int *second)
+{
+    time_t now = time(NULL);
+    if (now < SCHEDULE_CLOCK_VALID_AFTER) {
+        return false;
+    }
+
+    struct tm tm_now;
+    localtime_r(&now, &tm_now);
+    *minute = tm_now.tm_hour * 60 + tm_now.tm_min;
+    *second = tm_now.tm_sec;
+    return true;
+}
+
+static bool schedule_window_contains(const schedule_action_t *action, int minute)
+{
+    if (action->start_min < action->end_min) {
+        return minute >= action->start_min && minute < action->end_min;
+    }
+    // Spans midnight
+    return minute >= action->start_min || minute < action->end_min;
+}
+
+static bool schedule_action_has_channel(const schedule_action_t *action, uint8_t channel)
+{
+    for (uint8_t i = 0; i < action->count; i++) {
+        if (action->changes[i].channel == channel) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Queue an "outputs" command with the action's values or its restore values
+ */
+static void schedule_write(const schedule_action_t *action, bool restore)
+{
+    command_t cmd = { .id = COMMAND_OUTPUTS };
+    command_change_t changes[COMMAND_MAX_CHANGES];
+    for (uint8_t i = 0; i < action->count; i++) {
+        changes[i].channel = action->changes[i].channel;
+        changes[i].value = restore ? action->restore[i] : (int16_t)action->changes[i].value;
+    }
+
+    app_err_t ret = command_set_group(&cmd, changes, action->count);
+    if (ret == APP_OK) {
+        ret = g_schedule_ctx.config.submit(&cmd);
+    }
+    if (ret != APP_OK) {
+        command_release(&cmd);
+        APP_LOG_WARN(TAG, "Scheduled write of channel %d dropped: %s",
+                    action->changes[0].channel, app_err_to_string(ret));
+        metrics_counter_inc(&g_schedule_errors);
+        return;
+    }
+    metrics_counter_inc(&g_schedule_writes);
+}
+
+/**
+ * @brief Set the action's values (mutex held)
+ * @param baseline Values they replace, read from the outputs if `NULL`
+ */
+static void schedule_apply(schedule_action_t *action, const uint8_t *baseline)
+{
+    for (uint8_t i = 0; i < action->count; i++) {
+        if (baseline) {
+            action->restore[i] = baseline[i];
+        } else if (app_output_get(action->changes[i].channel, &action->restore[i]) != APP_OK) {
+            action->restore[i] = 0;
+        }
+    }
+    schedule_write(action, false);
+    action->applied = true;
+}
+
+/**
+ * @brief Put back the values the action replaced (mutex held)
+ */
+static void schedule_restore(schedule_action_t *action)
+{
+    if (action->applied) {
+        schedule_write(action, true);
+        action->applied = false;
+    }
+}
+
+static void schedule_free(schedule_action_t *action)
+{
+    timer_wheel_cancel(&g_schedule_ctx.wheel, &action->timer);
+    action->kind = SCHEDULE_ACTION_FREE;
+    action->applied = false;
+    g_schedule_ctx.action_count--;
+    metrics_gauge_set(&g_schedule_actions, (int32_t)g_schedule_ctx.action_count);
+}
+
+/**
+ * @brief Arm the tick timer for the wheel's next expiry, stop it while idle (mutex held)
+ *
+ * The wheel only moves when the timer fires or an action is added, so an
+ * hour-long daily wait costs one wakeup instead of 3600 ticks.
+ */
+static void schedule_arm_timer(void)
+{
+    esp_timer_stop(g_schedule_ctx.tick_timer);
+
+    uint64_t expires;
+    if (!timer_wheel_next_expiry(&g_schedule_ctx.wheel, &expires)) {
+        return;
+    }
+
+    int64_t delay_us = (int64_t)(expires * OUTPUT_SCHEDULE_TICK_MS * 1000ULL) - esp_timer_get_time();
+    esp_timer_start_once(g_schedule_ctx.tick_timer, delay_us > 0 ? (uint64_t)delay_us : 1);
+}
+
+/* =========================================================================
+   ACTION TIMERS (wheel callbacks, mutex held)
+   ========================================================================= */
+
+static void schedule_timed_expired(timer_wheel_timer_t *timer, void *arg)
+{
+    (void)timer;
+    schedule_action_t *action = (schedule_action_t *)arg;
+
+    APP_LOG_DEFER_INFO(TAG, "Timed action on channel %d ended", action->changes[0].channel);
+    schedule_restore(action);
+    schedule_free(action);
+}
+
+static void schedule_daily_boundary(timer_wheel_timer_t *timer, void *arg);
+
+/**
+ * @brief Enter or leave a daily window and sleep until the next boundary
+ * @param baseline Passed to schedule_apply() when entering
+ */
+static void schedule_daily_update(schedule_action_t *action, const uint8_t *baseline)
+{
+    int minute;
+    int second;
+    uint32_t delay_s = SCHEDULE_CLOCK_RETRY_S;
+
+    if (schedule_local_time(&minute, &second)) {
+        bool inside = schedule_window_contains(action, minute);
+        if (inside && !action->applied) {
+            APP_LOG_DEFER_INFO(TAG, "Daily window on channel %d started", action->changes[0].channel);
+            schedule_apply(action, baseline);
+        } else if (!inside && action->applied) {
+            APP_LOG_DEFER_INFO(TAG, "Daily window on channel %d ended", action->changes[0].channel);
+            schedule_restore(action);
+        }
+
+        // Never 0: the window includes its start and excludes its end
+        int boundary = inside ? action->end_min : action->start_min;
+        int minutes = (boundary - minute + OUTPUT_SCHEDULE_MINUTES_PER_DAY) % OUTPUT_SCHEDULE_MINUTES_PER_DAY;
+        delay_s = (uint32_t)(minutes * 60 - second);
+        if (delay_s > SCHEDULE_DAILY_RECHECK_S) {
+            delay_s = SCHEDULE_DAILY_RECHECK_S;
+        }
+    }
+
+    timer_wheel_schedule(&g_schedule_ctx.wheel, &action->timer,
+                         schedule_seconds_to_ticks(delay_s), schedule_daily_boundary, action);
+}
+
+static void schedule_daily_boundary(timer_wheel_timer_t *timer, void *arg)
+{
+    (void)timer;
+    schedule_daily_update((schedule_action_t *)arg, NULL);
+}
+
+/**
+ * @brief esp_timer callback: advance the wheel, sleep until its next expiry
+ */
+static void schedule_tick(void *arg)
+{
+    (void)arg;
+
+    xSemaphoreTake(g_schedule_ctx.mutex, portMAX_DELAY);
+    timer_wheel_advance(&g_schedule_ctx.wheel, schedule_now_tick());
+    schedule_arm_timer();
+    xSemaphoreGive(g_schedule_ctx.mutex);
+}
+
+/* =========================================================================
+   ADDING ACTIONS
+   ========================================================================= */
+
+/**
+ * @brief Replace the actions on the new action's channels and take a slot (mutex held)
+ *
+ * Replaced actions put their channels back; the values they replaced
+ * become the baseline of the new action's channels.
+ *
+ * @return Free action, `NULL` if the pool is full
+ */
+static schedule_action_t *schedule_take_slot(const output_change_t *changes, size_t count,
+                                             uint8_t *baseline)
+{
+    schedule_action_t *slot = NULL;
+    bool overlaps = false;
+
+    for (size_t i = 0; i < OUTPUT_SCHEDULE_MAX_ACTIONS && !overlaps; i++) {
+        const schedule_action_t *action = &g_schedule_ctx.actions[i];
+        for (size_t j = 0; j < count && action->kind != SCHEDULE_ACTION_FREE; j++) {
+            overlaps = overlaps || schedule_action_has_channel(action, changes[j].channel);
+        }
+    }
+    if (!overlaps && g_schedule_ctx.action_count >= OUTPUT_SCHEDULE_MAX_ACTIONS) {
+        return NULL;
+    }
+
+    for (size_t j = 0; j < count; j++) {
+        if (app_output_get(changes[j].channel, &baseline[j]) != APP_OK) {
+            baseline[j] = 0;
+        }
+    }
+
+    for (size_t i = 0; i < OUTPUT_SCHEDULE_MAX_ACTIONS; i++) {
+        schedule_action_t *action = &g_schedule_ctx.actions[i];
+        if (action->kind == SCHEDULE_ACTION_FREE) {
+            slot = slot ? slot : action;
+            continue;
+        }
+
+        bool replaced = false;
+        for (size_t j = 0; j < count; j++) {
+            for (uint8_t k = 0; k < action->count; k++) {
+                if (action->changes[k].channel != changes[j].channel) {
+                    continue;
+                }
+                replaced = true;
+                if (action->applied) {
+                    baseline[j] = action->restore[k];
+                }
+            }
+        }
+        if (replaced) {
+            APP_LOG_INFO(TAG, "Replacing the action on channel %d", action->changes[0].channel);
+            schedule_restore(action);
+            schedule_free(action);
+            slot = slot ? slot : action;
+        }
+    }
+    return slot;
+}
+
+static app_err_t schedule_add(schedule_kind_t kind, const output_change_t *changes, size_t count,
+                              uint32_t duration_s, uint16_t start_min, uint16_t end_min)
+{
+    if (!g_schedule_ctx.initialized || count == 0 || count > COMMAND_MAX_CHANGES) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    app_err_t ret = app_output_check(changes, count);
+    if (ret != APP_OK) {
+        return ret;
+    }
+
+    xSemaphoreTake(g_schedule_ctx.mutex, portMAX_DELAY);
+
+    uint8_t baseline[COMMAND_MAX_CHANGES];
+    schedule_action_t *action = schedule_take_slot(changes, count, baseline);
+    if (!action) {
+        xSemaphoreGive(g_schedule_ctx.mutex);
+        APP_LOG_WARN(TAG, "All %d schedule slots in use", OUTPUT_SCHEDULE_MAX_ACTIONS);
+        metrics_counter_inc(&g_schedule_errors);
+        return APP_ERR_NO_MEMORY;
+    }
+
+    memset(action, 0, sizeof(*action));
+    action->kind = kind;
+    action->count = (uint8_t)count;
+    memcpy(action->changes, changes, count * sizeof(changes[0]));
+    action->start_min = start_min;
+    action->end_min = end_min;
+    g_schedule_ctx.action_count++;
+    metrics_gauge_set(&g_schedule_actions, (int32_t)g_schedule_ctx.action_count);
+
+    // Delays count from the current tick, also when the wheel stood still
+    timer_wheel_advance(&g_schedule_ctx.wheel, schedule_now_tick());
+
+    if (kind == SCHEDULE_ACTION_TIMED) {
+        schedule_apply(action, baseline);
+        timer_wheel_schedule(&g_schedule_ctx.wheel, &action->timer,
+                             schedule_seconds_to_ticks(duration_s), schedule_timed_expired, action);
+    } else {
+        schedule_daily_update(action, baseline);
+    }
+    schedule_arm_timer();
+
+    xSemaphoreGive(g_schedule_ctx.mutex);
+    return APP_OK;
+}
+
+/* =========================================================================
+   COMMAND HANDLERS
+   ========================================================================= */
+
+/**
+ * @brief Channel/value or the group changes of a command
+ */
+static size_t schedule_command_changes(const command_t *cmd, output_change_t *changes)
+{
+    const command_group_t *group = command_get_group(cmd);
+    if (!group) {
+        changes[0].channel = cmd->channel;
+        changes[0].value = cmd->value;
+        return 1;
+    }
+
+    for (uint8_t i = 0; i < group->count; i++) {
+        changes[i].channel = group->changes[i].channel;
+        changes[i].value = group->changes[i].value;
+    }
+    return group->count;
+}
+
+static app_err_t schedule_command_timed(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+    output_change_t changes[COMMAND_MAX_CHANGES];
+    size_t count = schedule_command_changes(cmd, changes);
+
+    app_err_t ret = output_schedule_add_timed(changes, count, cmd->timing.duration_s);
+    if (ret != APP_OK) {
+        APP_LOG_WARN(TAG, "Rejected output_for: %s", app_err_to_string(ret));
+    }
+    return ret;
+}
+
+static app_err_t schedule_command_daily(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+    output_change_t changes[COMMAND_MAX_CHANGES];
+    size_t count = schedule_command_changes(cmd, changes);
+
+    app_err_t ret = output_schedule_add_daily(changes, count, cmd->timing.start_min,
+                                              cmd->timing.end_min);
+    if (ret != APP_OK) {
+        APP_LOG_WARN(TAG, "Rejected output_daily: %s", app_err_to_string(ret));
+    }
+    return ret;
+}
+
+static app_err_t schedule_command_cancel(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+    size_t cancelled = output_schedule_cancel((uint8_t)cmd->value);
+    APP_LOG_INFO(TAG, "Cancelled %u action(s)", (unsigned)cancelled);
+    return APP_OK;
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+app_err_t output_schedule_init(const output_schedule_config_t *config)
+{
+    if (!config || !config->submit) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (g_schedule_ctx.initialized) {
+        APP_LOG_WARN(TAG, "Scheduler already initialized");
+        return APP_OK;
+    }
+
+    g_schedule_ctx.mutex = xSemaphoreCreateMutex();
+    if (!g_schedule_ctx.mutex) {
+        APP_LOG_ERROR(TAG, "Failed to create mutex");
+        return APP_ERR_NO_MEMORY;
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = schedule_tick,
+        .name = "schedule",
+    };
+    if (esp_timer_create(&timer_args, &g_schedule_ctx.tick_timer) != ESP_OK) {
+        APP_LOG_ERROR(TAG, "Failed to create tick timer");
+        vSemaphoreDelete(g_schedule_ctx.mutex);
+        g_schedule_ctx.mutex = NULL;
+        return APP_ERR_NO_MEMORY;
+    }
+
+    g_schedule_ctx.config = *config;
+    timer_wheel_init(&g_schedule_ctx.wheel, schedule_now_tick());
+
+    metrics_register_gauge(&g_schedule_actions, "schedule_actions");
+    metrics_register_counter(&g_schedule_writes, "schedule_writes_total");
+    metrics_register_counter(&g_schedule_errors, "schedule_errors_total");
+
+    g_schedule_ctx.initialized = true;
+
+    command_register(COMMAND_OUTPUT_FOR, 0, 255, schedule_command_timed, NULL);
+    command_register(COMMAND_OUTPUT_DAILY, 0, 255, schedule_command_daily, NULL);
+    command_register(COMMAND_SCHEDULE_CANCEL, 0, OUTPUT_SCHEDULE_ALL_CHANNELS,
+                     schedule_command_cancel, NULL);
+
+    APP_LOG_INFO(TAG, "Scheduler initialized: %d actions, %d ms tick",
+                OUTPUT_SCHEDULE_MAX_ACTIONS, OUTPUT_SCHEDULE_TICK_MS);
+    return APP_OK;
+}
+
+app_err_t output_schedule_add_timed(const output_change_t *changes, size_t count,
+                                    uint32_t duration_s)
+{
+    if (duration_s == 0 || duration_s > OUTPUT_SCHEDULE_MAX_DURATION_S) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    app_err_t ret = schedule_add(SCHEDULE_ACTION_TIMED, changes, count, duration_s, 0, 0);
+    if (ret == APP_OK) {
+        APP_LOG_INFO(TAG, "Channel %d set to %ld for %lu s (%u change(s))", changes[0].channel,
+                    changes[0].value, (unsigned long)duration_s, (unsigned)count);
+    }
+    return ret;
+}
+
+app_err_t output_schedule_add_daily(const output_change_t *changes, size_t count,
+                                    uint16_t start_min, uint16_t end_min)
+{
+    if (start_min >= OUTPUT_SCHEDULE_MINUTES_PER_DAY || end_min >= OUTPUT_SCHEDULE_MINUTES_PER_DAY ||
+        start_min == end_min) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    app_err_t ret = schedule_add(SCHEDULE_ACTION_DAILY, changes, count, 0, start_min, end_min);
+    if (ret == APP_OK) {
+        APP_LOG_INFO(TAG, "Channel %d set to %ld daily %02u:%02u-%02u:%02u (%u change(s))",
+                    changes[0].channel, changes[0].value,
+                    start_min / 60, start_min % 60, end_min / 60, end_min % 60, (unsigned)count);
+    }
+    return ret;
+}
+
+size_t output_schedule_cancel(uint8_t channel)
+{
+    if (!g_schedule_ctx.initialized) {
+        return 0;
+    }
+
+    size_t cancelled = 0;
+
+    xSemaphoreTake(g_schedule_ctx.mutex, portMAX_DELAY);
+    for (size_t i = 0; i < OUTPUT_SCHEDULE_MAX_ACTIONS; i++) {
+        schedule_action_t *action = &g_schedule_ctx.actions[i];
+        if (action->kind == SCHEDULE_ACTION_FREE ||
+            (channel != OUTPUT_SCHEDULE_ALL_CHANNELS && !schedule_action_has_channel(action, channel))) {
+            continue;
+        }
+        schedule_restore(action);
+        schedule_free(action);
+        cancelled++;
+    }
+    schedule_arm_timer();
+    xSemaphoreGive(g_schedule_ctx.mutex);
+
+    return cancelled;
+}
+
+size_t output_schedule_count(void)
+{
+    return g_schedule_ctx.action_count;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file sensor_bus.h
+ * @brief Multi-sensor scheduler for several sensors - Public API
+ * @version 2.0
+ *
+ * Owns up to SENSOR_BUS_MAX_SENSORS instances of one sensor_driver_t (one
+ * per GPIO) and spreads their reads evenly over the read interval, so every
+ * sensor is read once per interval and never faster than the driver's
+ * `min_read_interval_ms`.
+ *
+ * With 3 sensors and a 5 s interval (t = 0 at sensor_bus_init()), sensor 0
+ * is read at t = 1.67, 6.67 s, sensor 1 at t = 3.33, 8.33 s and sensor 2
+ * at t = 5, 10 s.
+ *
+ * Optionally (sensor_bus_set_adaptive()) each sensor's interval adapts to
+ * its signal: while temperature or humidity moves it is read at the base
+ * interval, when stable the interval doubles per reading up to a ceiling.
+ *
+ * Usage:
+    @code
+    ```c
+    const uint8_t pins[] = { 4, 19, 21 };
+    sensor_bus_init(&sensor_driver_dht22, pins, 3, 5000);
+
+    // Optional: back off to 20 s while readings are stable
+    sensor_bus_adaptive_t adaptive = { 20000, 0.2f, 1.0f };
+    sensor_bus_set_adaptive(&adaptive);
+
+    // Sensor task
+    while (1) {
+        sensor_data_t reading;
+        if (sensor_bus_read_next(&reading) == APP_OK) {
+            printf("Sensor %d: %.1f C\n", reading.sensor_id, reading.temperature);
+        }
+    }
+    ```
+    @endcode
+ *
+ * @note sensor_bus_read_next() must be called from a single task.
+ */
+
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "app_common.h"
+#include "sensor_driver.h"
+#include "sensor_dht.h"
+
+#define SENSOR_BUS_MAX_SENSORS APP_MAX_DHT_SENSORS /**< Sensors per bus */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Adaptive sampling settings
+ *
+ * A reading counts as "changing" when it deviates from the sensor's
+ * smoothed trend by at least one threshold.
+ */
+typedef struct {
+    uint32_t max_interval_ms;   // Ceiling while stable (base interval is the floor)
+    float temp_threshold;       // Celsius
+    float hum_threshold;        // Percent
+} sensor_bus_adaptive_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Create one sensor instance per pin and set up the read schedule
+ *
+ * A sensor's ID is the index of its pin. Pins that fail to initialize
+ * are skipped with a warning and leave their ID unused, so the other
+ * sensors keep the IDs (zones) they were configured with.
+ *
+ * @param driver Sensor driver (e.g. sensor_dht_get_driver(config->dht_type))
+ * @param pins GPIO pins, one per sensor
+ * @param count Number of pins (1 to SENSOR_BUS_MAX_SENSORS)
+ * @param interval_ms Read interval per sensor
+ * @return `APP_OK` if at least one sensor is ready, error code otherwise
+ *
+ * @retval `APP_OK` Bus ready
+ * @retval `APP_ERR_INVALID_PARAM` NULL driver/pins or bad count
+ * @retval `APP_ERR_SENSOR_READ` No sensor could be initialized
+ */
+app_err_t sensor_bus_init(const sensor_driver_t *driver, const uint8_t *pins,
+                          size_t count, uint32_t interval_ms);
+
+/**
+ * @brief Wait for the next scheduled read and perform it
+ *
+ * Sleeps (vTaskDelay) until the earliest due sensor, then reads it.
+ * `reading->sensor_id` identifies the sensor, also on failure.
+ *
+ * @param reading Output reading
+ * @return Result of the driver read for that sensor
+ */
+app_err_t sensor_bus_read_next(sensor_data_t *reading);
+
+/**
+ * @brief Enable or disable adaptive read intervals
+ *
+ * Call after sensor_bus_init(), from the task that calls
+ * sensor_bus_read_next() or before it starts.
+ *
+ * @param cfg Settings, NULL (or a ceiling not above the base interval)
+ *            restores the fixed interval
+ * @return `APP_OK` on success, error code on failure
+ *
+ * @retval `APP_OK` Settings applied
+ * @retval `APP_ERR_INVALID_PARAM` Threshold <= 0
+ * @retval `APP_ERR_NO_MEMORY` Change detector allocation failed
+ * @retval `APP_ERR_UNKNOWN` Bus not initialized
+ *
+ * @note Keep the ceiling below the driver's health timeout (30 s for DHT),
+ *       or stable sensors will be reported unhealthy.
+ */
+app_err_t sensor_bus_set_adaptive(const sensor_bus_adaptive_t *cfg);
+
+/**
+ * @brief Read one sensor now, outside the schedule
+ *
+ * Subject to the driver's minimum read interval (may return cached data).
+ *
+ * @param sensor_id Sensor ID
+ * @param reading Output reading
+ * @return Result of the driver read, `APP_ERR_UNKNOWN` for an unknown or
+ *         failed ID
+ */
+app_err_t sensor_bus_read_sensor(uint8_t sensor_id, sensor_data_t *reading);
+
+/**
+ * @brief Number of sensor IDs on the bus (pins given to sensor_bus_init())
+ * @return ID count, including failed pins (0 if not initialized)
+ */
+size_t sensor_bus_count(void);
+
+/**
+ * @brief Number of sensors that initialized
+ * @return Sensor count (0 if not initialized)
+ */
+size_t sensor_bus_ready_count(void);
+
+/**
+ * @brief Current read interval of one sensor
+ * @param sensor_id Sensor ID
+ * @return Interval in ms, 0 for an unknown or failed ID
+ */
+uint32_t sensor_bus_get_interval_ms(uint8_t sensor_id);
+
+/**
+ * @brief Number of sensors currently reporting healthy
+ * @return Healthy sensor count
+ * @see sensor_driver_t.is_healthy
+ */
+size_t sensor_bus_healthy_count(void);
+
+#endif // SENSOR_BUS_H
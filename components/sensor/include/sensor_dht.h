@@ -1,22 +1,28 @@
 /**
  * @file sensor_dht.h
  * @author grace
- * @brief DHT11 Temperature and Humidity Sensor Driver - Public API
+ * @brief DHT11/DHT21/DHT22/AM2302 Temperature and Humidity Sensor Driver - Public API
  * @version 2.0
  * @date 2025-12-02
  * 
- * Non-blocking DHT11 sensor driver with error handling,
- * timeout protection, and data validation.
+ * Non-blocking DHT sensor driver with error handling,
+ * timeout protection, and data validation. The models share the
+ * single-wire protocol and differ in start pulse, read interval and
+ * data layout (DHT11: integer bytes, DHT21/DHT22/AM2302: 16-bit x10
+ * values with a sign bit on temperature).
+ *
+ * Each model is also exposed as a sensor_driver_t (see sensor_driver.h).
  * 
  * Usage:
     @code
     ```c
-    // Initialize on GPIO4
-    sensor_dht_init(4);
+    // Initialize a DHT22 on GPIO4
+    sensor_dht_handle_t dht;
+    sensor_dht_init(DHT_TYPE_DHT22, 0, 4, &dht);
 
-    // Read sensor data (blocks ~40ms for read)
+    // Read sensor data (task sleeps ~7 ms for a DHT22 while the frame is captured)
     sensor_data_t raeding = {0};
-    app_err_t ret = sensor_dht_read(&reading);
+    app_err_t ret = sensor_dht_read(dht, &reading);
 
     if (ret == APP_OK && reading.is_valid) {
         printf("Temperature: %.1f C\n", reading.temperature);
@@ -26,10 +32,10 @@
     }
 
     // Get cached reading (fast, no IO)
-    sensor_ht_get_last_reading(&reading);
+    sensor_dht_get_last_reading(dht, &reading);
     
     // Check sensor health
-    if (sensor_dht_is_healthy()) {
+    if (sensor_dht_is_healthy(dht)) {
         printf("Sensor is healthy\n");
     }
     ```
@@ -42,6 +48,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "app_common.h"
+#include "sensor_driver.h"
 
 /* =========================================================================
    DHT SENSOR TYPES
@@ -52,30 +59,50 @@
 #define DHT_TYPE_DHT11 0x01 /**< DHT11 Sensor Type */
 #define DHT_TYPE_DHT22 0x02 /**< DHT22 Sensor Type */
 #define DHT_TYPE_DHT21 0x03 /**< DHT21 Sensor Type */
+#define DHT_TYPE_AM2302 0x04 /**< AM2302 Sensor Type (DHT22 data layout) */
 /** @} */
 
 /** @defgroup DHT_SPECS DHT Sensor Specifications
  * @{
  */
-#define DHT_MIN_READ_INTERVAL_MS 1000 /**< Minimum 1 second between reads */
+#define DHT_MIN_READ_INTERVAL_MS 1000 /**< Minimum 1 second between reads (DHT11, DHT22 needs 2) */
 #define DHT_MAX_READ_TIME_MS 3000 /**< Max time for complete read */
 #define DHT_SENSOR_CACHE_TIMEOUT_MS 30000 /**< Cache timeout (30 seconds) */
+#define SENSOR_DHT_MAX_SENSORS APP_MAX_DHT_SENSORS /**< Sensor instances (one per pin) */
 /** @} */
 
+/* =========================================================================
+   DHT SENSOR HANDLE
+   ========================================================================= */
+/**
+ * @brief Opaque handle to one DHT sensor instance
+ *
+ * Instances come from a static pool of SENSOR_DHT_MAX_SENSORS. Each owns
+ * its pin, GPIO ISR and start pulse timer, so sensors on different pins
+ * can be read from different tasks.
+ */
+typedef struct dht_sensor *sensor_dht_handle_t;
+
 /* =========================================================================
    PUBLIC API - Sensor functions
    ========================================================================= */
 /**
- * @brief Initialize DHT sensor on specified GPIO pin
+ * @brief Initialize a DHT sensor instance on specified GPIO pin
  * 
  * Configures GPIO as open-drain with pull-up resistor.
- * Should be called once at startup before reading.
+ * Should be called once per sensor at startup before reading.
+ * Sensor IDs are assigned in creation order (0, 1, ...).
  * 
+ * @param type Sensor model (DHT_TYPE_*)
+ * @param id Sensor ID, stamped into readings and used in logs (the
+ *        sensor_bus slot)
  * @param pin GPIO pin number (0-39 on ESP32)
+ * @param handle Output sensor handle
  * @return `APP_OK` on success, error code on failure
  * 
- * @retval APP_OK Initialization successful
- * @retval APP_ERR_INVALID_PARAM Invalid GPIO pin (>39)
+ * @retval APP_OK Initialization successful (or pin already initialized)
+ * @retval APP_ERR_INVALID_PARAM Invalid GPIO pin (>39), unknown type or NULL handle
+ * @retval APP_ERR_NO_MEMORY All SENSOR_DHT_MAX_SENSORS slots in use
  * @retval APP_ERR_UNKNOWN GPIO configuration failed
  * 
  * @note Pin must have external pull-up resistor (~10k).
@@ -83,7 +110,8 @@
  * 
     @code
     ```c
-    app_err_t ret = sensor_dht_init(4); // GPIO4
+    sensor_dht_handle_t dht;
+    app_err_t ret = sensor_dht_init(DHT_TYPE_DHT11, 0, 4, &dht); // Sensor 0 on GPIO4
     if (ret != APP_OK) {
          printf("DHT init failed: %s\n", app_err_to_string(ret));
     }
@@ -92,7 +120,7 @@
  *
  * @see sensor_dht_read
  */
-app_err_t sensor_dht_init(uint8_t pin);
+app_err_t sensor_dht_init(uint8_t type, uint8_t id, uint8_t pin, sensor_dht_handle_t *handle);
 
 /**
  * @brief Read current sensor data
@@ -104,20 +132,22 @@ app_err_t sensor_dht_init(uint8_t pin);
  * 4. Validate checksum
  * 5. Extract temperature and humidity
  * 
+ * @param dht Sensor handle
  * @param sensor_data Pointer to sensor_data_t structure for output
  * @return `APP_OK` on success, error code on failure
  * 
  * @retval APP_OK Read successful, data valid
  * @retval APP_ERR_INVALID_PARAM `sensor_data` pointer is NULL
- * @retval APP_ERR_UNKNOWN Sensor not initialized
- * @retval APP_ERR_TIMEOUT Sensor response timeout
- * @retval APP_ERR_SENSOR_READ Checksum validate failed
+ * @retval APP_ERR_UNKNOWN Sensor not initialized (or NULL handle)
+ * @retval APP_ERR_TIMEOUT Sensor did not respond
+ * @retval APP_ERR_SENSOR_READ Incomplete frame, bad bit timing or checksum
  * 
- * @note This function is BLOCKING for ~40ms while reading.
+ * @note The calling task blocks ~23 ms (DHT11) or ~7 ms (DHT22) on a task notification while a
+ * GPIO ISR captures the frame (no busy waiting, other tasks keep running).
  * Should be called from a task, not from ISR context.
  * 
- * @note DHT11 requires minimum 1 second between reads.
- * Shorter intervals will return cached data.
+ * @note DHT11 requires minimum 1 second between reads, DHT21/DHT22/AM2302
+ * 2 seconds. Shorter intervals will return cached data.
  * 
  * @note On error, `sensor_data->is_valid` will be false,
  * and `sensor_data->last_error` will contain error code.
@@ -125,9 +155,10 @@ app_err_t sensor_dht_init(uint8_t pin);
     @code
     ```c
     sensor_data_t reading = {0};
-    app_err_t ret = sensor_dht_read(&reading);
+    app_err_t ret = sensor_dht_read(dht, &reading);
 
     if (ret == APP_OK && reading.is_valid) {
+        printf("Sensor: %d\n", reading.sensor_id);
         printf("Temperature: %.1f C\n", reading.temperature);
         printf("Humidity: %.1f %%\n", reading.humidity);
         printf("Timestamp: %llu ms\n", reading.timestamp_ms);
@@ -140,7 +171,7 @@ app_err_t sensor_dht_init(uint8_t pin);
  *
  * @see sensor_dht_get_last_reading
  */
-app_err_t sensor_dht_read(sensor_data_t *sensor_data);
+app_err_t sensor_dht_read(sensor_dht_handle_t dht, sensor_data_t *sensor_data);
 
 /**
  * @brief Get last cached sensor reading (non-blocking)
@@ -148,6 +179,7 @@ app_err_t sensor_dht_read(sensor_data_t *sensor_data);
  * Returns the most recent valid sensor reading without performing
  * a new I/O operation. Useful for fast data access.
  * 
+ * @param dht Sensor handle
  * @param sensor_data Pointer to `sensor_data_t` structure for output
  * @return `APP_OK` on success, error code on failure
  * 
@@ -161,7 +193,7 @@ app_err_t sensor_dht_read(sensor_data_t *sensor_data);
     @code
     ```c
     sensor_data_t reading = {0};
-    sensor_dht_get_last_reading(&reading);
+    sensor_dht_get_last_reading(dht, &reading);
 
     if (reading.is_valid) {
         printf("Cached Temperature: %.1f C\n", reading.temperature);
@@ -172,7 +204,7 @@ app_err_t sensor_dht_read(sensor_data_t *sensor_data);
  *
  * @see sensor_dht_read
  */
-app_err_t sensor_dht_get_last_reading(sensor_data_t *sensor_data);
+app_err_t sensor_dht_get_last_reading(sensor_dht_handle_t dht, sensor_data_t *sensor_data);
 
 
 /**
@@ -181,6 +213,7 @@ app_err_t sensor_dht_get_last_reading(sensor_data_t *sensor_data);
  * Return true if sensor has valid data within the last 30 seconds.
  * useful for monitoring sensor status.
  * 
+ * @param dht Sensor handle
  * @return true if healthy, false otherwise
  * 
  * @note A healthy sensor means:
@@ -190,7 +223,7 @@ app_err_t sensor_dht_get_last_reading(sensor_data_t *sensor_data);
  * 
    @code
     ```c
-    if (sensor_dht_is_healthy()) {
+    if (sensor_dht_is_healthy(dht)) {
         ESP_LOGI(TAG, "DHT sensor is healthy");
     } else {
         ESP_LOGW(TAG, "DHT sensor health check failed");
@@ -198,24 +231,64 @@ app_err_t sensor_dht_get_last_reading(sensor_data_t *sensor_data);
     ```
     @endcode
  */
-bool sensor_dht_is_healthy(void);
+bool sensor_dht_is_healthy(sensor_dht_handle_t dht);
 
 /**
  * @brief Get GPIO pin number used by sensor
  * 
  * Returns the GPIO pin that the sensor is initialized on.
  * 
+ * @param dht Sensor handle
  * @return GPIO pin number (0-39), or `0xFF` if not initialized
  * 
    @code
     ```c
-    uint8_t pin = sensor_dht_get_pin();
+    uint8_t pin = sensor_dht_get_pin(dht);
     if (pin != 0xFF) {
         ESP_LOGI(TAG, "DHT sensor on GPIO%d", pin);
     }
     ```
     @endcode
  */
-uint8_t sensor_dht_get_pin(void);
+uint8_t sensor_dht_get_pin(sensor_dht_handle_t dht);
+
+/**
+ * @brief Get sensor ID
+ * 
+ * The ID is stamped into `sensor_data_t.sensor_id` of every reading.
+ * 
+ * @param dht Sensor handle
+ * @return Sensor ID (0 to SENSOR_DHT_MAX_SENSORS - 1), or `0xFF` if not initialized
+ */
+uint8_t sensor_dht_get_id(sensor_dht_handle_t dht);
+
+/* =========================================================================
+   PUBLIC API - Driver interface
+   ========================================================================= */
+/** @defgroup DHT_DRIVERS DHT Sensor Drivers
+ * @{
+ */
+extern const sensor_driver_t sensor_driver_dht11; /**< DHT11 */
+extern const sensor_driver_t sensor_driver_dht22; /**< DHT22 */
+extern const sensor_driver_t sensor_driver_dht21; /**< DHT21 (AM2301) */
+extern const sensor_driver_t sensor_driver_am2302; /**< AM2302 (wired DHT22) */
+/** @} */
+
+/**
+ * @brief Get the sensor driver for a DHT model
+ * 
+ * @param type Sensor model (DHT_TYPE_*), typically `app_config_t.dht_type`
+ * @return Driver, or NULL if the type is unknown
+ * 
+   @code
+    ```c
+    const sensor_driver_t *driver = sensor_dht_get_driver(config->dht_type);
+    if (!driver) {
+        driver = &sensor_driver_dht11;
+    }
+    ```
+    @endcode
+ */
+const sensor_driver_t *sensor_dht_get_driver(uint8_t type);
 
 #endif // SENSOR_DHT_H
\ No newline at end of file
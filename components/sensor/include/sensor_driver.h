@@ -0,0 +1,66 @@
+/**
+ * @file sensor_driver.h
+ * @brief Pluggable temperature/humidity sensor driver interface
+ * @version 2.0
+ *
+ * A driver is a constant table of function pointers. Callers (sensor_bus)
+ * only see an opaque per-sensor context, so a new sensor family only has
+ * to provide one sensor_driver_t.
+ *
+ * Usage:
+    @code
+    ```c
+    const sensor_driver_t *driver = &sensor_driver_dht22;
+    void *sensor;
+
+    if (driver->init(0, 4, &sensor) == APP_OK) {
+        sensor_data_t reading = {0};
+        driver->read(sensor, &reading);
+    }
+    ```
+    @endcode
+ */
+
+#ifndef SENSOR_DRIVER_H
+#define SENSOR_DRIVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_common.h"
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Sensor driver operations
+ */
+typedef struct {
+    const char *name;                   // Model name for logs
+    uint32_t min_read_interval_ms;      // Reads closer than this return cached data
+
+    /**
+     * @brief Create a sensor instance on a GPIO pin
+     * @param id Sensor ID for its readings and logs (sensor_bus slot)
+     * @param pin GPIO pin number
+     * @param ctx Output sensor context
+     * @return `APP_OK` on success, error code on failure
+     */
+    app_err_t (*init)(uint8_t id, uint8_t pin, void **ctx);
+
+    /**
+     * @brief Read one sample (may block for the bus transaction)
+     * @param ctx Sensor context from init()
+     * @param data Output reading
+     * @return `APP_OK` on success, error code on failure
+     */
+    app_err_t (*read)(void *ctx, sensor_data_t *data);
+
+    /**
+     * @brief Check whether the sensor delivered a valid reading recently
+     * @param ctx Sensor context from init()
+     * @return true if healthy
+     */
+    bool (*is_healthy)(void *ctx);
+} sensor_driver_t;
+
+#endif // SENSOR_DRIVER_H
@@ -0,0 +1,285 @@
+/**
+ * @file sensor_bus.c
+ * @brief Staggered, adaptive read scheduler for several sensors of one driver
+ * @version 2.0
+ *
+ * Each sensor has its own due time. Sensor k starts at (k + 1) * period / N,
+ * so reads are evenly spaced and at most one frame is on the wire at
+ * any time.
+ *
+ * Adaptive sampling: every reading is compared with an exponential trend
+ * of that sensor. The deviation, scaled by the change thresholds, is a
+ * change score (>= 1 means "changing"). A changing reading snaps the
+ * sensor back to the fast interval; once the moving average of the score
+ * is low the interval doubles per reading up to the ceiling.
+ */
+
+#include "sensor_bus.h"
+#include "app_common.h"
+#include "log_deferred.h"
+#include "utils.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <math.h>
+
+static const char *TAG = "SENSOR_BUS";
+
+/* =========================================================================
+   ADAPTIVE SAMPLING TUNING
+   ========================================================================= */
+#define BUS_TREND_ALPHA         0.3f    // EMA weight of the newest reading
+#define BUS_ACTIVITY_WINDOW     4       // Readings in the change score average
+#define BUS_STABLE_SCORE        0.5f    // Average score below which to back off
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+typedef struct {
+    void *sensor;                       // NULL: pin failed to initialize
+    uint64_t next_due_ms;
+    uint32_t interval_ms;               // Current read interval
+
+    // Change detection (adaptive mode only)
+    bool has_trend;
+    float temp_trend;
+    float hum_trend;
+    utils_moving_average_t *activity;
+} bus_sensor_t;
+
+typedef struct {
+    const sensor_driver_t *driver;
+    bus_sensor_t sensors[SENSOR_BUS_MAX_SENSORS];   // Indexed by sensor ID (pin index)
+    size_t count;                       // Slots, including failed ones
+    size_t ready;                       // Slots with a sensor
+    uint32_t period_ms;                 // Fast (and fixed-mode) interval
+
+    bool adaptive;
+    sensor_bus_adaptive_t adaptive_cfg;
+} sensor_bus_context_t;
+
+static sensor_bus_context_t g_bus_ctx = {0};
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+/**
+ * @brief Update the read interval of a sensor from its latest reading
+ */
+static void bus_adapt_interval(bus_sensor_t *slot, size_t id, const sensor_data_t *reading)
+{
+    const sensor_bus_adaptive_t *cfg = &g_bus_ctx.adaptive_cfg;
+
+    if (!slot->has_trend) {
+        slot->temp_trend = reading->temperature;
+        slot->hum_trend = reading->humidity;
+        slot->has_trend = true;
+        return;
+    }
+
+    float temp_score = fabsf(reading->temperature - slot->temp_trend) / cfg->temp_threshold;
+    float hum_score = fabsf(reading->humidity - slot->hum_trend) / cfg->hum_threshold;
+    float score = (temp_score > hum_score) ? temp_score : hum_score;
+
+    slot->temp_trend = utils_exponential_average(reading->temperature, slot->temp_trend, BUS_TREND_ALPHA);
+    slot->hum_trend = utils_exponential_average(reading->humidity, slot->hum_trend, BUS_TREND_ALPHA);
+    utils_moving_average_add(slot->activity, score);
+
+    uint32_t interval = slot->interval_ms;
+    if (score >= 1.0f) {
+        // Transient: sample fast right away
+        interval = g_bus_ctx.period_ms;
+    } else if (utils_moving_average_get(slot->activity) < BUS_STABLE_SCORE) {
+        interval = (interval > cfg->max_interval_ms / 2) ? cfg->max_interval_ms : interval * 2;
+    }
+
+    if (interval != slot->interval_ms) {
+        APP_LOG_DEFER_DEBUG(TAG, "Sensor %u interval %ld -> %ld ms (score %.2f)",
+                           (unsigned)id, slot->interval_ms, interval, score);
+        slot->interval_ms = interval;
+    }
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+app_err_t sensor_bus_init(const sensor_driver_t *driver, const uint8_t *pins,
+                          size_t count, uint32_t interval_ms)
+{
+    if (!driver || !pins || count == 0 || count > SENSOR_BUS_MAX_SENSORS) {
+        APP_LOG_ERROR(TAG, "Invalid driver or sensor count: %u (1-%d)",
+                     (unsigned)count, SENSOR_BUS_MAX_SENSORS);
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    g_bus_ctx.driver = driver;
+    g_bus_ctx.count = 0;
+    g_bus_ctx.ready = 0;
+    g_bus_ctx.period_ms = (interval_ms < driver->min_read_interval_ms) ?
+                          driver->min_read_interval_ms : interval_ms;
+
+    // A sensor's ID is its pin index, a failed pin leaves its slot empty
+    for (size_t i = 0; i < count; i++) {
+        void *sensor = NULL;
+        app_err_t ret = driver->init((uint8_t)i, pins[i], &sensor);
+        if (ret != APP_OK) {
+            APP_LOG_WARN(TAG, "Skipping %s %u on GPIO%d: %s", driver->name, (unsigned)i, pins[i],
+                        app_err_to_string(ret));
+            sensor = NULL;
+        } else {
+            g_bus_ctx.ready++;
+        }
+        g_bus_ctx.sensors[i].sensor = sensor;
+    }
+    g_bus_ctx.count = count;
+
+    if (g_bus_ctx.ready == 0) {
+        APP_LOG_ERROR(TAG, "No %s sensor available", driver->name);
+        g_bus_ctx.count = 0;
+        return APP_ERR_SENSOR_READ;
+    }
+
+    // Stagger first reads evenly over the first period
+    uint64_t now_ms = esp_timer_get_time() / 1000;
+    size_t k = 0;
+    for (size_t i = 0; i < g_bus_ctx.count; i++) {
+        bus_sensor_t *slot = &g_bus_ctx.sensors[i];
+        slot->interval_ms = g_bus_ctx.period_ms;
+        if (slot->sensor) {
+            k++;
+            slot->next_due_ms = now_ms + (uint64_t)g_bus_ctx.period_ms * k / g_bus_ctx.ready;
+        }
+    }
+
+    APP_LOG_INFO(TAG, "Sensor bus ready: %u of %u %s sensors, %ld ms interval",
+                (unsigned)g_bus_ctx.ready, (unsigned)g_bus_ctx.count, driver->name,
+                g_bus_ctx.period_ms);
+    return APP_OK;
+}
+
+app_err_t sensor_bus_set_adaptive(const sensor_bus_adaptive_t *cfg)
+{
+    if (g_bus_ctx.count == 0) {
+        return APP_ERR_UNKNOWN;
+    }
+
+    if (!cfg || cfg->max_interval_ms <= g_bus_ctx.period_ms) {
+        g_bus_ctx.adaptive = false;
+        for (size_t i = 0; i < g_bus_ctx.count; i++) {
+            g_bus_ctx.sensors[i].interval_ms = g_bus_ctx.period_ms;
+        }
+        APP_LOG_INFO(TAG, "Adaptive sampling off (fixed %ld ms)", g_bus_ctx.period_ms);
+        return APP_OK;
+    }
+
+    if (cfg->temp_threshold <= 0.0f || cfg->hum_threshold <= 0.0f) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    for (size_t i = 0; i < g_bus_ctx.count; i++) {
+        bus_sensor_t *slot = &g_bus_ctx.sensors[i];
+        if (!slot->sensor) {
+            continue;
+        }
+        if (!slot->activity) {
+            slot->activity = utils_moving_average_create(BUS_ACTIVITY_WINDOW);
+            if (!slot->activity) {
+                return APP_ERR_NO_MEMORY;
+            }
+        }
+        utils_moving_average_reset(slot->activity);
+        slot->has_trend = false;
+    }
+
+    g_bus_ctx.adaptive_cfg = *cfg;
+    g_bus_ctx.adaptive = true;
+    APP_LOG_INFO(TAG, "Adaptive sampling: %ld-%ld ms (change %.1f C / %.1f %%)",
+                g_bus_ctx.period_ms, cfg->max_interval_ms,
+                cfg->temp_threshold, cfg->hum_threshold);
+    return APP_OK;
+}
+
+app_err_t sensor_bus_read_next(sensor_data_t *reading)
+{
+    if (!reading) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (g_bus_ctx.count == 0) {
+        return APP_ERR_UNKNOWN;
+    }
+
+    // Earliest due sensor (init guarantees one)
+    size_t next = SENSOR_BUS_MAX_SENSORS;
+    for (size_t i = 0; i < g_bus_ctx.count; i++) {
+        if (g_bus_ctx.sensors[i].sensor &&
+            (next == SENSOR_BUS_MAX_SENSORS ||
+             g_bus_ctx.sensors[i].next_due_ms < g_bus_ctx.sensors[next].next_due_ms)) {
+            next = i;
+        }
+    }
+    bus_sensor_t *slot = &g_bus_ctx.sensors[next];
+
+    uint64_t now_ms = esp_timer_get_time() / 1000;
+    if (slot->next_due_ms > now_ms) {
+        vTaskDelay(pdMS_TO_TICKS(slot->next_due_ms - now_ms));
+        now_ms = esp_timer_get_time() / 1000;
+    }
+
+    app_err_t ret = sensor_bus_read_sensor((uint8_t)next, reading);
+    if (g_bus_ctx.adaptive && ret == APP_OK && reading->is_valid) {
+        bus_adapt_interval(slot, next, reading);
+    }
+
+    // Keep the cadence, but do not burst to catch up after a stall
+    slot->next_due_ms += slot->interval_ms;
+    if (slot->next_due_ms <= now_ms) {
+        slot->next_due_ms = now_ms + slot->interval_ms;
+    }
+
+    return ret;
+}
+
+app_err_t sensor_bus_read_sensor(uint8_t sensor_id, sensor_data_t *reading)
+{
+    if (!reading) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (sensor_id >= g_bus_ctx.count || !g_bus_ctx.sensors[sensor_id].sensor) {
+        return APP_ERR_UNKNOWN;
+    }
+
+    app_err_t ret = g_bus_ctx.driver->read(g_bus_ctx.sensors[sensor_id].sensor, reading);
+    reading->sensor_id = sensor_id;
+    return ret;
+}
+
+size_t sensor_bus_count(void)
+{
+    return g_bus_ctx.count;
+}
+
+size_t sensor_bus_ready_count(void)
+{
+    return g_bus_ctx.ready;
+}
+
+uint32_t sensor_bus_get_interval_ms(uint8_t sensor_id)
+{
+    if (sensor_id >= g_bus_ctx.count || !g_bus_ctx.sensors[sensor_id].sensor) {
+        return 0;
+    }
+    return g_bus_ctx.sensors[sensor_id].interval_ms;
+}
+
+size_t sensor_bus_healthy_count(void)
+{
+    size_t healthy = 0;
+    for (size_t i = 0; i < g_bus_ctx.count; i++) {
+        if (g_bus_ctx.sensors[i].sensor && g_bus_ctx.driver->is_healthy(g_bus_ctx.sensors[i].sensor)) {
+            healthy++;
+        }
+    }
+    return healthy;
+}
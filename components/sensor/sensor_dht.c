@@ -1,7 +1,7 @@
 /**
  * @file sensor_dht.c
  * @author grace
- * @brief DHT11 sensor driver with non-blocking capability
+ * @brief DHT11/DHT21/DHT22/AM2302 sensor driver with non-blocking capability
  * @version 2.0
  * @date 2025-12-02
  * 
@@ -11,87 +11,196 @@
  * - Timeout protection
  * - Better error logging
  * - Input validation
+ * - Edge-capture decoding (GPIO ISR + esp_timer), no busy waiting
+ * - Instance-based, up to SENSOR_DHT_MAX_SENSORS sensors on separate pins
+ * - Per-model start pulse, read interval and data decoding, exposed as
+ *   sensor_driver_t implementations
  */
 
 #include "sensor_dht.h"
 #include "app_common.h"
+#include "log_deferred.h"
 #include "driver/gpio.h"
 #include "esp_timer.h"
-#include "rom/ets_sys.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <string.h>
 
 static const char *TAG = "DHT_SENSOR";
 
 /* =========================================================================
-   DHT SENSOR PRIVATE STATE
+   DHT PROTOCOL TIMING
    ========================================================================= */
+#define DHT_FRAME_TIMEOUT_MS    12      // Response + 40 bits (~5 ms) after the start pulse
+#define DHT_FALLING_EDGES       42      // Response LOW, data start, 40 bit ends
+
+// Bit classification by falling-edge period. Overridable at build time to
+// tune against cable length and sensor clock spread (see host/sim/dht_sim.c)
+// Threshold near the geometric mean of 76 and 120 us keeps both bit kinds
+// apart for a sensor clock off by up to +/-15 % (bench_dht_decode). At
+// -20 % "1" periods drop to 92-100 us and no frame decodes
+#ifndef DHT_BIT_PERIOD_MIN_US
+#define DHT_BIT_PERIOD_MIN_US   50      // 50 us LOW + 26-28 us HIGH = "0"
+#endif
+#ifndef DHT_BIT_PERIOD_MAX_US
+#define DHT_BIT_PERIOD_MAX_US   160     // 50 us LOW + 70 us HIGH = "1"
+#endif
+#ifndef DHT_BIT_THRESHOLD_US
+#define DHT_BIT_THRESHOLD_US    96
+#endif
+
+/* =========================================================================
+   DHT MODELS
+   ========================================================================= */
+/**
+ * @brief Per-model protocol differences
+ * 
+ * All models share the single-wire frame (40 bits, checksum in byte 4),
+ * they differ in start pulse, minimum read interval and data layout.
+ */
 typedef struct {
+    uint8_t type;                   // DHT_TYPE_*
+    const char *name;
+    uint32_t start_low_us;          // Host start pulse
+    uint32_t min_read_interval_ms;
+    void (*decode)(const uint8_t *raw, sensor_data_t *out);
+} dht_model_t;
+
+/**
+ * @brief DHT11: integer + decimal byte, 1 C / 1 % resolution
+ */
+static void dht11_decode(const uint8_t *raw, sensor_data_t *out)
+{
+    out->humidity = (float)raw[0] + (float)raw[1] * 0.1f;
+    out->temperature = (float)raw[2] + (float)raw[3] * 0.1f;
+}
+
+/**
+ * @brief DHT21/DHT22/AM2302: 16-bit x10 values, sign bit on temperature
+ */
+static void dht22_decode(const uint8_t *raw, sensor_data_t *out)
+{
+    uint16_t hum_x10 = ((uint16_t)raw[0] << 8) | raw[1];
+    uint16_t temp_x10 = ((uint16_t)(raw[2] & 0x7F) << 8) | raw[3];
+
+    out->humidity = (float)hum_x10 * 0.1f;
+    out->temperature = (float)temp_x10 * 0.1f;
+    if (raw[2] & 0x80) {
+        out->temperature = -out->temperature;
+    }
+}
+
+static const dht_model_t g_dht_models[] = {
+    { DHT_TYPE_DHT11,  "DHT11",  18000, 1000, dht11_decode },
+    { DHT_TYPE_DHT22,  "DHT22",  2000,  2000, dht22_decode },
+    { DHT_TYPE_DHT21,  "DHT21",  2000,  2000, dht22_decode },
+    { DHT_TYPE_AM2302, "AM2302", 2000,  2000, dht22_decode },
+};
+
+static const dht_model_t *dht_find_model(uint8_t type)
+{
+    for (size_t i = 0; i < sizeof(g_dht_models) / sizeof(g_dht_models[0]); i++) {
+        if (g_dht_models[i].type == type) {
+            return &g_dht_models[i];
+        }
+    }
+    return NULL;
+}
+
+/* =========================================================================
+   DHT SENSOR PRIVATE STATE
+   ========================================================================= */
+struct dht_sensor {
+    uint8_t id;
     uint8_t pin;
+    const dht_model_t *model;
     bool initialized;
     uint32_t last_read_ms;
     sensor_data_t last_reading;
-} dht_context_t;
 
-static dht_context_t g_dht_context = {0};
+    // Edge capture (written by the GPIO ISR)
+    esp_timer_handle_t start_timer;
+    TaskHandle_t waiting_task;
+    volatile uint32_t edge_count;
+    int64_t edge_us[DHT_FALLING_EDGES];
+};
+
+typedef struct dht_sensor dht_context_t;
+
+// Static pool, handles point into it (no heap allocation)
+static dht_context_t g_dht_sensors[SENSOR_DHT_MAX_SENSORS] = {0};
 
 /* =========================================================================
    HELPER FUNCTIONS 
    ========================================================================= */
 /**
- * @brief Wait for GPIO level change with timeout
+ * @brief GPIO ISR - timestamp every falling edge of the DHT frame
  * 
- * @param target_level Level to wait for (0 or 1)
- * @param timeout_us Maximum time to wait (us)
- * @return `APP_OK` if level detected, `APP_ERR_TIMEOUT` if timeout
+ * Wakes the reading task once the whole frame has been captured.
  */
-static app_err_t dht_wait_for_level(int target_level, uint32_t timeout_us)
+static void IRAM_ATTR dht_gpio_isr(void *arg)
 {
-    uint64_t start_time = esp_timer_get_time();
-    int current_level;
+    dht_context_t *dht = (dht_context_t *)arg;
+    uint32_t n = dht->edge_count;
+    if (n >= DHT_FALLING_EDGES) {
+        return;
+    }
 
-    while (1) {
-        current_level = gpio_get_level(g_dht_context.pin);
+    dht->edge_us[n] = esp_timer_get_time();
+    dht->edge_count = n + 1;
 
-        if (current_level == target_level) {
-            return APP_OK;
-        }
+    if (n + 1 == DHT_FALLING_EDGES && dht->waiting_task) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(dht->waiting_task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
 
-        // Check timeout
-        if ((esp_timer_get_time() - start_time) > timeout_us) {
-            APP_LOG_DEBUG(TAG, "Timeout waiting for level %d after %lu us",
-                            target_level, timeout_us);
-            return APP_ERR_TIMEOUT;
-        }
+/**
+ * @brief End of host start pulse (esp_timer callback)
+ * 
+ * Arms edge capture, then releases the line so the sensor can answer.
+ * Capture is armed first because the sensor responds within 20-40 us.
+ */
+static void dht_start_timer_cb(void *arg)
+{
+    dht_context_t *dht = (dht_context_t *)arg;
 
-        // Yield to other tasks (busy waiting)
-        // TODO: Need to consider
-        ets_delay_us(1);
-    }
+    gpio_set_intr_type(dht->pin, GPIO_INTR_NEGEDGE);
+    gpio_set_level(dht->pin, 1);
 }
 
 /**
- * @brief Send DHT start signal
+ * @brief Decode 40 data bits from falling edge timestamps
  * 
- * 1. Pull data LOW for 18ms - lets DHT11 detect the signal
- * 2. Pull data HIGH for 20-40us - wait for DHT11 response
- * 3. Switch pin to input mode to read data
+ * Bit i spans from the falling edge that starts its LOW phase to the
+ * falling edge that ends its HIGH phase, so the period alone tells "0"
+ * (~78 us) from "1" (~120 us).
  * 
- * @return `APP_OK` on success
+ * @param edge_us Falling edge timestamps (DHT_FALLING_EDGES entries)
+ * @param data Buffer to store 5 bytes of data
+ * @return `APP_OK` on success, `APP_ERR_SENSOR_READ` on bad timing
  */
-static app_err_t dht_send_start_signal(void) {
-    // Set pin as output
-    gpio_set_direction(g_dht_context.pin, GPIO_MODE_OUTPUT);
+static app_err_t dht_decode_edges(const int64_t *edge_us, uint8_t *data)
+{
+    memset(data, 0, 5);
+
+    // edge_us[0] = response LOW, edge_us[1] = start of bit 0
+    for (int i = 0; i < 40; i++) {
+        uint32_t period_us = (uint32_t)(edge_us[i + 2] - edge_us[i + 1]);
+
+        if (period_us < DHT_BIT_PERIOD_MIN_US || period_us > DHT_BIT_PERIOD_MAX_US) {
+            APP_LOG_DEBUG(TAG, "Bad period for bit %d: %lu us", i, period_us);
+            return APP_ERR_SENSOR_READ;
+        }
 
-    // Pull low for 18ms (initialization)
-    gpio_set_level(g_dht_context.pin, 0);
-    ets_delay_us(18000); // 18ms
+        int bit_value = (period_us > DHT_BIT_THRESHOLD_US) ? 1 : 0;
 
-    // Release pin (pull HIGH)
-    gpio_set_level(g_dht_context.pin, 1);
-    ets_delay_us(30); // 30us (20-40us)
-    
-    // Switch to input mode for sensor response
-    gpio_set_direction(g_dht_context.pin, GPIO_MODE_INPUT);
+        // Pack bits into bytes (MSB first)
+        int byte_index = i / 8;
+        data[byte_index] = (data[byte_index] << 1) | (bit_value & 0x1);
+    }
 
     return APP_OK;
 }
@@ -99,71 +208,45 @@ static app_err_t dht_send_start_signal(void) {
 /**
  * @brief Read raw 40-bit data from DHT sensor
  * 
+ * 1. Pull data LOW, an esp_timer releases it after the model's start pulse
+ * 2. GPIO ISR timestamps the falling edges of the sensor response
+ * 3. Calling task blocks on a task notification meanwhile (no CPU use)
+ * 
  * @param data Buffer to store 5 bytes of data
  * @return `APP_OK` on success, error code on failure
  */
-static app_err_t dht_read_raw_data(uint8_t *data) {
+static app_err_t dht_read_raw_data(dht_context_t *dht, uint8_t *data) {
     if (!data) {
         return APP_ERR_INVALID_PARAM;
     }
 
-    // Send start signal
-    if (dht_send_start_signal() != APP_OK) {
-        APP_LOG_ERROR(TAG, "Failed to send start signal");
-        return APP_ERR_SENSOR_READ;
-    }
+    dht->edge_count = 0;
+    dht->waiting_task = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTake(pdTRUE, 0);    // Drop a stale notification
 
-    // Wait for sensor response: LOW in 80us
-    if (dht_wait_for_level(0, 1000) != APP_OK) {
-        APP_LOG_ERROR(TAG, "No sensor response (LOW pulse)");
-        return APP_ERR_SENSOR_READ;
-    }
-
-    // Wait for sensor response: HIGH ~80us
-    if (dht_wait_for_level(1, 1000) != APP_OK) {
-        APP_LOG_ERROR(TAG, "No sensor response (HIGH pulse)");
-        return APP_ERR_SENSOR_READ;
-    }
-
-    // Wait for data start: LOW
-    if (dht_wait_for_level(0, 1000) != APP_OK) {
-        APP_LOG_ERROR(TAG, "Data phase timeout");
+    // Start signal: LOW now, released by dht_start_timer_cb()
+    gpio_set_level(dht->pin, 0);
+    if (esp_timer_start_once(dht->start_timer, dht->model->start_low_us) != ESP_OK) {
+        gpio_set_level(dht->pin, 1);
+        APP_LOG_ERROR(TAG, "Failed to send start signal");
         return APP_ERR_SENSOR_READ;
     }
 
-    // Clear data buffer
-    memset(data, 0, 5);
-
-    // Read 40 bits (5 bytes)
-    for (int i = 0; i < 40; i++) {
-        // Wait for bit to start (HIGH)
-        if (dht_wait_for_level(1, 1000) != APP_OK) {
-            APP_LOG_ERROR(TAG, "Timeout waiting for bit %d (HIGH)", i);
-            return APP_ERR_SENSOR_READ;
-        }
-        
-        // Measure HIGH pulse duration
-        uint64_t pulse_start = esp_timer_get_time();
+    uint32_t timeout_ms = dht->model->start_low_us / 1000 + DHT_FRAME_TIMEOUT_MS;
+    uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
 
-        // Wait for bit to end (LOW)
-        if (dht_wait_for_level(0, 1000) != APP_OK) {
-            APP_LOG_ERROR(TAG, "Timeout waiting for bit %d (LOW)", i);
-            return APP_ERR_SENSOR_READ;
-        }
+    esp_timer_stop(dht->start_timer);
+    gpio_set_intr_type(dht->pin, GPIO_INTR_DISABLE);
+    gpio_set_level(dht->pin, 1);
+    dht->waiting_task = NULL;
 
-        // Calculate pulse duration
-        uint32_t pulse_duration_us = (uint32_t)(esp_timer_get_time() - pulse_start);
-
-        // If pulse > 50us, bit is 1; otherwise 0
-        int bit_value = (pulse_duration_us > 50) ? 1 : 0;
-
-        // Pack bits into bytes (MSB first)
-        int byte_index = i / 8;
-        data[byte_index] = (data[byte_index] << 1) | (bit_value & 0x1);
+    if (notified == 0) {
+        APP_LOG_ERROR(TAG, "Sensor response timeout (%lu/%d edges)",
+                      dht->edge_count, DHT_FALLING_EDGES);
+        return (dht->edge_count == 0) ? APP_ERR_TIMEOUT : APP_ERR_SENSOR_READ;
     }
 
-    // Do I need to pull HIGH again? => current mode is input with pull-up
-    return APP_OK;
+    return dht_decode_edges(dht->edge_us, data);
 }
 
 /**
@@ -191,23 +274,52 @@ static bool dht_validate_data(const uint8_t *data) {
    PUBLIC SENSOR API
    ========================================================================= */
 /**
- * @brief Initialize DHT sensor on specified pin
+ * @brief Create a DHT sensor instance on specified pin
  * 
+ * @param type Sensor model (DHT_TYPE_*)
+ * @param id Sensor ID for readings and logs
  * @param pin GPIO pin number
+ * @param handle Output sensor handle
  * @return `APP_OK` on success
  */
-app_err_t sensor_dht_init(uint8_t pin) {
+app_err_t sensor_dht_init(uint8_t type, uint8_t id, uint8_t pin, sensor_dht_handle_t *handle) {
+    if (!handle) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    const dht_model_t *model = dht_find_model(type);
+    if (!model) {
+        APP_LOG_ERROR(TAG, "Unsupported DHT type: %d", type);
+        return APP_ERR_INVALID_PARAM;
+    }
+
     if (pin > 39) {
         APP_LOG_ERROR(TAG, "Invalid GPIO pin: %d", pin);
         return APP_ERR_INVALID_PARAM;
     }
 
-    if (g_dht_context.initialized) {
-        APP_LOG_WARN(TAG, "DHT sensor already initialized on GPIO%d", g_dht_context.pin);
-        return APP_OK;
+    // Reuse an instance already on this pin, otherwise take a free slot
+    dht_context_t *dht = NULL;
+    for (int i = 0; i < SENSOR_DHT_MAX_SENSORS; i++) {
+        if (g_dht_sensors[i].initialized && g_dht_sensors[i].pin == pin) {
+            APP_LOG_WARN(TAG, "DHT sensor already initialized on GPIO%d", pin);
+            *handle = &g_dht_sensors[i];
+            return APP_OK;
+        }
+        if (!dht && !g_dht_sensors[i].initialized) {
+            dht = &g_dht_sensors[i];
+        }
     }
 
-    g_dht_context.pin = pin;
+    if (!dht) {
+        APP_LOG_ERROR(TAG, "No free DHT slot (max %d sensors)", SENSOR_DHT_MAX_SENSORS);
+        return APP_ERR_NO_MEMORY;
+    }
+
+    memset(dht, 0, sizeof(*dht));
+    dht->id = id;
+    dht->pin = pin;
+    dht->model = model;
 
     // Configure GPIO as open-drain with pull-up
     gpio_config_t io_conf = {
@@ -225,56 +337,86 @@ app_err_t sensor_dht_init(uint8_t pin) {
     }
 
     // Initial state: HIGH
-    gpio_set_level(g_dht_context.pin, 1);
+    gpio_set_level(pin, 1);
+
+    // Falling edges are captured only while a read is in progress
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {     // Already installed is fine
+        APP_LOG_ERROR(TAG, "GPIO ISR service install failed: %d", ret);
+        return APP_ERR_UNKNOWN;
+    }
+
+    ret = gpio_isr_handler_add(pin, dht_gpio_isr, dht);
+    if (ret != ESP_OK) {
+        APP_LOG_ERROR(TAG, "GPIO ISR handler add failed for pin %d: %d", pin, ret);
+        return APP_ERR_UNKNOWN;
+    }
+    gpio_intr_enable(pin);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = dht_start_timer_cb,
+        .arg = dht,
+        .name = "dht_start"
+    };
+    ret = esp_timer_create(&timer_args, &dht->start_timer);
+    if (ret != ESP_OK) {
+        APP_LOG_ERROR(TAG, "Start pulse timer create failed: %d", ret);
+        gpio_isr_handler_remove(pin);
+        return APP_ERR_NO_MEMORY;
+    }
 
     // Initialize last reading
-    g_dht_context.last_reading.is_valid = false;
-    g_dht_context.last_reading.last_error = APP_OK;
-    g_dht_context.last_reading.temperature = 0.0f;
-    g_dht_context.last_reading.humidity = 0.0f;
+    dht->last_reading.sensor_id = dht->id;
+    dht->last_reading.is_valid = false;
+    dht->last_reading.last_error = APP_OK;
+    dht->last_read_ms = 0;
 
-    g_dht_context.initialized = true;
-    g_dht_context.last_read_ms = 0;
+    dht->initialized = true;
+    *handle = dht;
 
-    APP_LOG_INFO(TAG, "DHT sensor initialized on GPIO%d", pin);
+    APP_LOG_INFO(TAG, "%s sensor %d initialized on GPIO%d", model->name, dht->id, pin);
     return APP_OK;
 }
 
 /**
  * @brief Read sensor data with error handling
  * 
+ * @param dht Sensor handle
  * @param sensor_data Pointer to `sensor_data_t` structure
  * @return `APP_OK` on success, error code on failure
  * 
- * Note: DHT11 requires minimum 1 second between reads.
+ * Note: DHT11 requires minimum 1 second between reads, DHT22 2 seconds.
  */
-app_err_t sensor_dht_read(sensor_data_t *sensor_data) {
+app_err_t sensor_dht_read(sensor_dht_handle_t dht, sensor_data_t *sensor_data) {
     if (!sensor_data) {
         return APP_ERR_INVALID_PARAM;
     }
 
-    if (!g_dht_context.initialized) {
+    if (!dht || !dht->initialized) {
         APP_LOG_ERROR(TAG, "DHT sensor not initialized");
         return APP_ERR_UNKNOWN;
     }
 
-    // Check read interval (DHT11 needs >= 1 second between reads)
+    // Check read interval (model minimum between reads)
     uint32_t current_ms = esp_timer_get_time() / 1000;
-    if ((current_ms - g_dht_context.last_read_ms) < 1000) {
-        APP_LOG_DEBUG(TAG, "DHT read too fast, using cached data");
-        memcpy(sensor_data, &g_dht_context.last_reading, sizeof(sensor_data_t));
+    if (dht->last_read_ms != 0 &&
+        (current_ms - dht->last_read_ms) < dht->model->min_read_interval_ms) {
+        APP_LOG_DEFER_DEBUG(TAG, "DHT %d read too fast, using cached data", dht->id);
+        memcpy(sensor_data, &dht->last_reading, sizeof(sensor_data_t));
         return APP_OK;
     }
 
+    sensor_data->sensor_id = dht->id;
+
     // Read raw data
     uint8_t raw_data[5] = {0};
-    app_err_t ret = dht_read_raw_data(raw_data);
+    app_err_t ret = dht_read_raw_data(dht, raw_data);
 
     if (ret != APP_OK) {
         sensor_data->is_valid = false;
         sensor_data->last_error = ret;
-        g_dht_context.last_reading.last_error = ret;
-        APP_LOG_ERROR(TAG, "Failed to read sensor: %d", ret);
+        dht->last_reading.last_error = ret;
+        APP_LOG_ERROR(TAG, "Failed to read sensor %d: %d", dht->id, ret);
         return ret;
     }
 
@@ -282,69 +424,161 @@ app_err_t sensor_dht_read(sensor_data_t *sensor_data) {
     if (!dht_validate_data(raw_data)) {
         sensor_data->is_valid = false;
         sensor_data->last_error = APP_ERR_SENSOR_READ;
-        g_dht_context.last_reading.last_error = APP_ERR_SENSOR_READ;
-        APP_LOG_ERROR(TAG, "DHT data checksum invalid");
+        dht->last_reading.last_error = APP_ERR_SENSOR_READ;
+        APP_LOG_ERROR(TAG, "DHT %d data checksum invalid", dht->id);
         return APP_ERR_SENSOR_READ;
     }
 
-    // Extract temperature and humidity
-    // DHT11: data[2] = temperature integer, data[0] = humidity integer
-    sensor_data->humidity = ((float)raw_data[0] + (float)raw_data[1] * 0.1f);
-    sensor_data->temperature = ((float)raw_data[2] + (float)raw_data[3] * 0.1f);
+    // Extract temperature and humidity (layout depends on model)
+    dht->model->decode(raw_data, sensor_data);
     sensor_data->timestamp_ms = esp_timer_get_time() / 1000;
     sensor_data->is_valid = true;
     sensor_data->last_error = APP_OK;
 
     // Update last reading
-    g_dht_context.last_read_ms = current_ms;
-    memcpy(&g_dht_context.last_reading, sensor_data, sizeof(sensor_data_t));
+    dht->last_read_ms = current_ms;
+    memcpy(&dht->last_reading, sensor_data, sizeof(sensor_data_t));
 
-    APP_LOG_DEBUG(TAG, "Sensor read successful: Temp=%.1f C, Hum=%.1f %%", 
-                    sensor_data->temperature, sensor_data->humidity);
+    APP_LOG_DEFER_DEBUG(TAG, "Sensor %d read successful: Temp=%.1f C, Hum=%.1f %%",
+                        dht->id, sensor_data->temperature, sensor_data->humidity);
     return APP_OK;
 }
 
 /**
  * @brief Get last cached sensor reading (fast, no I/O)
  * 
+ * @param dht Sensor handle
  * @param sensor_data Pointer to `sensor_data_t` structure
  * @return `APP_OK` on success
  */
-app_err_t sensor_dht_get_last_reading(sensor_data_t *sensor_data) {
+app_err_t sensor_dht_get_last_reading(sensor_dht_handle_t dht, sensor_data_t *sensor_data) {
     if (!sensor_data) {
         return APP_ERR_INVALID_PARAM;
     }
 
-    if (!g_dht_context.initialized) {
+    if (!dht || !dht->initialized) {
         APP_LOG_ERROR(TAG, "DHT sensor not initialized");
         return APP_ERR_UNKNOWN;
     }
 
-    memcpy(sensor_data, &g_dht_context.last_reading, sizeof(sensor_data_t));
+    memcpy(sensor_data, &dht->last_reading, sizeof(sensor_data_t));
     return APP_OK;
 }
 
 /**
  * @brief Get sensor health/status
  * 
+ * @param dht Sensor handle
  * @return true if sensor is healthy, false otherwise
  */
-bool sensor_dht_is_healthy(void) {
-    if (!g_dht_context.initialized) {
+bool sensor_dht_is_healthy(sensor_dht_handle_t dht) {
+    if (!dht || !dht->initialized) {
         return false;
     }
 
     // Check if last reading is valid and recent (< 30 seconds)
     uint32_t current_ms = esp_timer_get_time() / 1000;
-    return (g_dht_context.last_reading.is_valid &&
-            ((current_ms - g_dht_context.last_read_ms) < 30000));
+    return (dht->last_reading.is_valid &&
+            ((current_ms - dht->last_read_ms) < DHT_SENSOR_CACHE_TIMEOUT_MS));
 }
 
 /**
  * @brief Get pin number (for diagnostics)
  * 
+ * @param dht Sensor handle
  * @return GPIO pin number, or 0xFF if not initialized
  */
-uint8_t sensor_dht_get_pin(void) {
-    return g_dht_context.initialized ? g_dht_context.pin : 0xFF;
-}
\ No newline at end of file
+uint8_t sensor_dht_get_pin(sensor_dht_handle_t dht) {
+    return (dht && dht->initialized) ? dht->pin : 0xFF;
+}
+
+/**
+ * @brief Get sensor ID (stamped into every reading)
+ * 
+ * @param dht Sensor handle
+ * @return Sensor ID, or 0xFF if not initialized
+ */
+uint8_t sensor_dht_get_id(sensor_dht_handle_t dht) {
+    return (dht && dht->initialized) ? dht->id : 0xFF;
+}
+
+/* =========================================================================
+   SENSOR DRIVER INTERFACE
+   ========================================================================= */
+static app_err_t dht_driver_read(void *ctx, sensor_data_t *data)
+{
+    return sensor_dht_read((sensor_dht_handle_t)ctx, data);
+}
+
+static bool dht_driver_is_healthy(void *ctx)
+{
+    return sensor_dht_is_healthy((sensor_dht_handle_t)ctx);
+}
+
+static app_err_t dht11_driver_init(uint8_t id, uint8_t pin, void **ctx)
+{
+    return sensor_dht_init(DHT_TYPE_DHT11, id, pin, (sensor_dht_handle_t *)ctx);
+}
+
+static app_err_t dht22_driver_init(uint8_t id, uint8_t pin, void **ctx)
+{
+    return sensor_dht_init(DHT_TYPE_DHT22, id, pin, (sensor_dht_handle_t *)ctx);
+}
+
+static app_err_t dht21_driver_init(uint8_t id, uint8_t pin, void **ctx)
+{
+    return sensor_dht_init(DHT_TYPE_DHT21, id, pin, (sensor_dht_handle_t *)ctx);
+}
+
+static app_err_t am2302_driver_init(uint8_t id, uint8_t pin, void **ctx)
+{
+    return sensor_dht_init(DHT_TYPE_AM2302, id, pin, (sensor_dht_handle_t *)ctx);
+}
+
+const sensor_driver_t sensor_driver_dht11 = {
+    .name = "DHT11",
+    .min_read_interval_ms = 1000,
+    .init = dht11_driver_init,
+    .read = dht_driver_read,
+    .is_healthy = dht_driver_is_healthy,
+};
+
+const sensor_driver_t sensor_driver_dht22 = {
+    .name = "DHT22",
+    .min_read_interval_ms = 2000,
+    .init = dht22_driver_init,
+    .read = dht_driver_read,
+    .is_healthy = dht_driver_is_healthy,
+};
+
+const sensor_driver_t sensor_driver_dht21 = {
+    .name = "DHT21",
+    .min_read_interval_ms = 2000,
+    .init = dht21_driver_init,
+    .read = dht_driver_read,
+    .is_healthy = dht_driver_is_healthy,
+};
+
+const sensor_driver_t sensor_driver_am2302 = {
+    .name = "AM2302",
+    .min_read_interval_ms = 2000,
+    .init = am2302_driver_init,
+    .read = dht_driver_read,
+    .is_healthy = dht_driver_is_healthy,
+};
+
+/**
+ * @brief Get the driver for a DHT model
+ * 
+ * @param type Sensor model (DHT_TYPE_*)
+ * @return Driver, NULL if unsupported
+ */
+const sensor_driver_t *sensor_dht_get_driver(uint8_t type) {
+    switch (type) {
+        case DHT_TYPE_DHT11: return &sensor_driver_dht11;
+        case DHT_TYPE_DHT22: return &sensor_driver_dht22;
+        case DHT_TYPE_DHT21: return &sensor_driver_dht21;
+        case DHT_TYPE_AM2302: return &sensor_driver_am2302;
+        default: return NULL;
+    }
+}
@@ -0,0 +1,171 @@
+/**
+ * @file sensor_history.h
+ * @brief In-memory time-series history of sensor readings - Public API
+ * @version 2.0
+ *
+ * Keeps recent readings in PSRAM in three downsampling tiers:
+ * - RAW: every valid reading
+ * - MINUTE: one aggregate per 1-minute window
+ * - HOUR: one aggregate per 1-hour window
+ *
+ * Every sensor has its own set of tiers. Each tier is a ring of
+ * sensor_history_bucket_t (min/max/mean of temperature and humidity).
+ * The oldest bucket of a tier is overwritten once the tier is full. Windows are aligned on multiples of the tier
+ * period since boot (same clock as sensor_data_t.timestamp_ms).
+ *
+ * Usage:
+    @code
+    ```c
+    sensor_history_init(sensor_count);
+
+    // Sensor task, for every reading (uses reading.sensor_id)
+    sensor_history_add(&reading);
+
+    // Any task
+    sensor_history_bucket_t buckets[24];
+    size_t n = sensor_history_query(sensor_id, SENSOR_HISTORY_TIER_MINUTE,
+                                    from_ms, to_ms, buckets, 24);
+    ```
+    @endcode
+ *
+ * @note Thread-safe. Content is lost on reboot, use sensor_store.h for
+ *       readings that must survive a power cycle.
+ */
+
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "app_common.h"
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+/** @defgroup SENSOR_HISTORY_CONFIG History Configuration
+ * @{
+ */
+#define SENSOR_HISTORY_RAW_CAPACITY 16384 /**< Raw readings, split between sensors (~22 h at 5 s for one sensor) */
+#define SENSOR_HISTORY_MINUTE_CAPACITY 10080 /**< 1-minute buckets, split between sensors (7 days for one) */
+#define SENSOR_HISTORY_HOUR_CAPACITY 8760 /**< 1-hour buckets, split between sensors (1 year for one) */
+
+#define SENSOR_HISTORY_MINUTE_MS 60000 /**< MINUTE tier window */
+#define SENSOR_HISTORY_HOUR_MS 3600000 /**< HOUR tier window */
+/** @} */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief History tier
+ */
+typedef enum {
+    SENSOR_HISTORY_TIER_RAW = 0,
+    SENSOR_HISTORY_TIER_MINUTE = 1,
+    SENSOR_HISTORY_TIER_HOUR = 2,
+    SENSOR_HISTORY_TIER_COUNT
+} sensor_history_tier_t;
+
+/**
+ * @brief One aggregate (or one reading for the RAW tier)
+ */
+typedef struct {
+    uint64_t start_ms;      // Window start (RAW: reading timestamp)
+    uint32_t count;         // Readings in this window (RAW: 1)
+    float temp_min;
+    float temp_max;
+    float temp_mean;
+    float hum_min;
+    float hum_max;
+    float hum_mean;
+} sensor_history_bucket_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Allocate the history tiers in PSRAM
+ *
+ * Needs about 1.4 MB of SPIRAM, split evenly between sensors (with 2
+ * sensors each keeps 3.5 days of 1-minute buckets). Without PSRAM the
+ * history stays disabled and sensor_history_add() is a no-op.
+ *
+ * @param sensor_count Number of sensors (1 to APP_MAX_DHT_SENSORS)
+ * @return `APP_OK` on success, error code on failure
+ *
+ * @retval `APP_OK` History ready
+ * @retval `APP_ERR_INVALID_PARAM` Bad sensor count
+ * @retval `APP_ERR_NO_MEMORY` PSRAM not available or too small
+ */
+app_err_t sensor_history_init(size_t sensor_count);
+
+/**
+ * @brief Check whether the history was allocated
+ * @return true if ready
+ */
+bool sensor_history_is_ready(void);
+
+/**
+ * @brief Add a reading to all tiers of its sensor
+ *
+ * MINUTE and HOUR buckets are closed when the first reading of the next
+ * window arrives. Invalid readings and unknown sensor IDs are ignored.
+ *
+ * @param reading Sensor reading
+ * @return `APP_OK` on success, error code on failure
+ */
+app_err_t sensor_history_add(const sensor_data_t *reading);
+
+/**
+ * @brief Read buckets whose start lies in [from_ms, to_ms], oldest first
+ *
+ * Only closed buckets are returned. To page through a long range, call
+ * again with `from_ms` set past the last returned `start_ms`.
+ *
+ * @param sensor_id Sensor ID
+ * @param tier History tier
+ * @param from_ms Range start (inclusive)
+ * @param to_ms Range end (inclusive)
+ * @param buckets Output array
+ * @param max_buckets Capacity of `buckets`
+ * @return Number of buckets read (0 if none or not ready)
+ */
+size_t sensor_history_query(uint8_t sensor_id, sensor_history_tier_t tier,
+                            uint64_t from_ms, uint64_t to_ms,
+                            sensor_history_bucket_t *buckets, size_t max_buckets);
+
+/**
+ * @brief Read the newest closed buckets, oldest first
+ *
+ * @param sensor_id Sensor ID
+ * @param tier History tier
+ * @param buckets Output array
+ * @param max_buckets Capacity of `buckets`
+ * @return Number of buckets read (0 if none or not ready)
+ */
+size_t sensor_history_latest(uint8_t sensor_id, sensor_history_tier_t tier,
+                             sensor_history_bucket_t *buckets, size_t max_buckets);
+
+/**
+ * @brief Number of closed buckets held by a tier
+ * @param sensor_id Sensor ID
+ * @param tier History tier
+ * @return Bucket count (0 if not ready)
+ */
+uint32_t sensor_history_count(uint8_t sensor_id, sensor_history_tier_t tier);
+
+/**
+ * @brief Number of sensors tracked by the history
+ * @return Sensor count (0 if not ready)
+ */
+size_t sensor_history_sensor_count(void);
+
+/**
+ * @brief Convert tier to a short name ("raw", "1m", "1h")
+ * @param tier History tier
+ * @return Tier name
+ */
+const char* sensor_history_tier_to_string(sensor_history_tier_t tier);
+
+#endif // SENSOR_HISTORY_H
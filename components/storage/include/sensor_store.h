@@ -0,0 +1,158 @@
+/**
+ * @file sensor_store.h
+ * @brief Offline store-and-forward log for sensor readings - Public API
+ * @version 2.0
+ *
+ * Persistent circular log on the dedicated `sensor_log` flash partition.
+ * Readings that cannot be published (MQTT down, publish failed) are appended
+ * here and replayed in order once the broker is reachable again.
+ *
+ * Design:
+ * - Fixed-size 32-byte records, appended sequentially (O(1), one flash write)
+ * - Sectors are used round-robin, so every sector is erased once per lap
+ *   (natural wear levelling)
+ * - The sector ahead of the write head is erased in advance by
+ *   sensor_store_service(), so appends never wait for a sector erase
+ * - Replayed records are marked in place (1 -> 0 bit flip, no erase)
+ * - When the log is full the oldest sector is recycled
+ *
+ * Usage:
+    @code
+    ```c
+    sensor_store_init();
+
+    // While offline
+    sensor_store_append(&reading, sequence);
+
+    // Once connected
+    sensor_store_entry_t entries[8];
+    size_t n = sensor_store_peek(entries, 8);
+    if (publish(entries, n) == APP_OK) {
+        sensor_store_consume(n);
+    }
+
+    // From a low priority context
+    sensor_store_service();
+    ```
+    @endcode
+ *
+ * @note Not thread-safe. The log is owned by the publisher task; only
+ *       sensor_store_get_stats() may be called from other tasks.
+ */
+
+#ifndef SENSOR_STORE_H
+#define SENSOR_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "app_common.h"
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+/** @defgroup SENSOR_STORE_CONFIG Store Configuration
+ * @{
+ */
+#define SENSOR_STORE_PARTITION_LABEL "sensor_log" /**< Partition label in partitions.csv */
+#define SENSOR_STORE_RECORD_SIZE 32 /**< Bytes per stored reading */
+#define SENSOR_STORE_SECTOR_SIZE 4096 /**< Flash erase unit */
+/** @} */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Stored reading as returned by sensor_store_peek()
+ */
+typedef struct {
+    sensor_data_t data;     // Reading (is_valid always true)
+    uint32_t sequence;      // Sequence number assigned by the sensor task
+} sensor_store_entry_t;
+
+/**
+ * @brief Store statistics
+ */
+typedef struct {
+    uint32_t pending;       // Records waiting for replay
+    uint32_t capacity;      // Usable records (excluding spare sector)
+    uint32_t appended;      // Records appended since boot
+    uint32_t replayed;      // Records consumed since boot
+    uint32_t overwritten;   // Pending records lost to ring wrap-around
+    uint32_t errors;        // Flash read/write/erase failures
+} sensor_store_stats_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Mount the store and recover head/tail from flash
+ *
+ * Scans the partition once to find the newest record and the oldest
+ * record that has not been replayed. A partition with foreign content
+ * is erased.
+ *
+ * @return `APP_OK` on success, error code on failure
+ *
+ * @retval `APP_OK` Store ready
+ * @retval `APP_ERR_UNKNOWN` Partition not found or flash error
+ * @retval `APP_ERR_INVALID_VALUE` Partition too small (< 2 sectors)
+ */
+app_err_t sensor_store_init(void);
+
+/**
+ * @brief Check whether the store was mounted successfully
+ * @return true if ready
+ */
+bool sensor_store_is_ready(void);
+
+/**
+ * @brief Append one reading
+ *
+ * Writes a single fixed-size record. Never erases, unless
+ * sensor_store_service() has not prepared the next sector in time.
+ *
+ * @param data Reading to store
+ * @param sequence Reading sequence number
+ * @return `APP_OK` on success, error code on failure
+ */
+app_err_t sensor_store_append(const sensor_data_t *data, uint32_t sequence);
+
+/**
+ * @brief Read oldest pending readings without consuming them
+ *
+ * @param entries Output array
+ * @param max_entries Capacity of `entries`
+ * @return Number of entries read (0 if none pending or on error)
+ */
+size_t sensor_store_peek(sensor_store_entry_t *entries, size_t max_entries);
+
+/**
+ * @brief Mark the oldest `count` pending readings as replayed
+ *
+ * @param count Number of readings (typically the value from sensor_store_peek())
+ * @return `APP_OK` on success, error code on failure
+ */
+app_err_t sensor_store_consume(size_t count);
+
+/**
+ * @brief Number of readings waiting for replay
+ * @return Pending record count (0 if not ready)
+ */
+uint32_t sensor_store_pending(void);
+
+/**
+ * @brief Background maintenance (erase the sector ahead of the head)
+ *
+ * Call periodically from a context that may block ~50 ms.
+ */
+void sensor_store_service(void);
+
+/**
+ * @brief Get store statistics
+ * @param stats Output statistics
+ * @return `APP_OK` on success
+ */
+app_err_t sensor_store_get_stats(sensor_store_stats_t *stats);
+
+#endif // SENSOR_STORE_H
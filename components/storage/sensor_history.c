@@ -0,0 +1,319 @@
+/**
+ * @file sensor_history.c
+ * @brief PSRAM time-series history with raw, 1-minute and 1-hour tiers
+ * @version 2.0
+ *
+ * Layout:
+ * - Each sensor has one ring of buckets per tier, allocated once in PSRAM
+ * - `head` is the next slot to write, buckets are stored in time order
+ *   so range queries are a binary search plus one copy
+ * - MINUTE/HOUR keep the open window (running sums) in internal RAM and
+ *   only touch PSRAM when a window closes
+ */
+
+#include "sensor_history.h"
+#include "app_common.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "SENSOR_HISTORY";
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+typedef struct {
+    sensor_history_bucket_t *buckets;   // Ring in PSRAM
+    uint32_t capacity;
+    uint32_t period_ms;                 // Window length, 0 = RAW
+    uint32_t head;                      // Next slot to write
+    uint32_t count;                     // Closed buckets held
+
+    // Open window (MINUTE/HOUR only)
+    sensor_history_bucket_t open;
+    float temp_sum;
+    float hum_sum;
+} history_tier_t;
+
+typedef struct {
+    history_tier_t tiers[APP_MAX_DHT_SENSORS][SENSOR_HISTORY_TIER_COUNT];
+    size_t sensor_count;
+    SemaphoreHandle_t mutex;
+    bool initialized;
+} history_context_t;
+
+static history_context_t g_history_ctx = {0};
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+static void history_push(history_tier_t *tier, const sensor_history_bucket_t *bucket)
+{
+    tier->buckets[tier->head] = *bucket;
+    tier->head = (tier->head + 1) % tier->capacity;
+    if (tier->count < tier->capacity) {
+        tier->count++;
+    }
+}
+
+/**
+ * @brief Bucket at logical index (0 = oldest)
+ */
+static const sensor_history_bucket_t *history_at(const history_tier_t *tier, uint32_t index)
+{
+    uint32_t oldest = (tier->head + tier->capacity - tier->count) % tier->capacity;
+    return &tier->buckets[(oldest + index) % tier->capacity];
+}
+
+/**
+ * @brief Logical index of the first bucket starting at or after `from_ms`
+ */
+static uint32_t history_lower_bound(const history_tier_t *tier, uint64_t from_ms)
+{
+    uint32_t lo = 0;
+    uint32_t hi = tier->count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (history_at(tier, mid)->start_ms < from_ms) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void history_close_window(history_tier_t *tier)
+{
+    if (tier->open.count == 0) {
+        return;
+    }
+
+    tier->open.temp_mean = tier->temp_sum / (float)tier->open.count;
+    tier->open.hum_mean = tier->hum_sum / (float)tier->open.count;
+    history_push(tier, &tier->open);
+
+    tier->open.count = 0;
+    tier->temp_sum = 0.0f;
+    tier->hum_sum = 0.0f;
+}
+
+static void history_accumulate(history_tier_t *tier, const sensor_data_t *reading)
+{
+    uint64_t window = reading->timestamp_ms - (reading->timestamp_ms % tier->period_ms);
+
+    if (tier->open.count > 0 && window != tier->open.start_ms) {
+        history_close_window(tier);
+    }
+
+    if (tier->open.count == 0) {
+        tier->open.start_ms = window;
+        tier->open.temp_min = reading->temperature;
+        tier->open.temp_max = reading->temperature;
+        tier->open.hum_min = reading->humidity;
+        tier->open.hum_max = reading->humidity;
+    } else {
+        if (reading->temperature < tier->open.temp_min) tier->open.temp_min = reading->temperature;
+        if (reading->temperature > tier->open.temp_max) tier->open.temp_max = reading->temperature;
+        if (reading->humidity < tier->open.hum_min) tier->open.hum_min = reading->humidity;
+        if (reading->humidity > tier->open.hum_max) tier->open.hum_max = reading->humidity;
+    }
+
+    tier->open.count++;
+    tier->temp_sum += reading->temperature;
+    tier->hum_sum += reading->humidity;
+}
+
+static size_t history_copy(const history_tier_t *tier, uint32_t first, size_t n,
+                           sensor_history_bucket_t *buckets)
+{
+    for (size_t i = 0; i < n; i++) {
+        buckets[i] = *history_at(tier, first + (uint32_t)i);
+    }
+    return n;
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+app_err_t sensor_history_init(size_t sensor_count)
+{
+    if (g_history_ctx.initialized) {
+        return APP_OK;
+    }
+
+    if (sensor_count == 0 || sensor_count > APP_MAX_DHT_SENSORS) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    static const uint32_t capacity[SENSOR_HISTORY_TIER_COUNT] = {
+        SENSOR_HISTORY_RAW_CAPACITY,
+        SENSOR_HISTORY_MINUTE_CAPACITY,
+        SENSOR_HISTORY_HOUR_CAPACITY,
+    };
+    static const uint32_t period_ms[SENSOR_HISTORY_TIER_COUNT] = {
+        0,
+        SENSOR_HISTORY_MINUTE_MS,
+        SENSOR_HISTORY_HOUR_MS,
+    };
+
+    g_history_ctx.mutex = xSemaphoreCreateMutex();
+    if (!g_history_ctx.mutex) {
+        APP_LOG_ERROR(TAG, "Failed to create mutex");
+        return APP_ERR_NO_MEMORY;
+    }
+
+    // One allocation per tier, split into one ring per sensor
+    size_t total = 0;
+    for (int i = 0; i < SENSOR_HISTORY_TIER_COUNT; i++) {
+        uint32_t per_sensor = capacity[i] / (uint32_t)sensor_count;
+        size_t bytes = (size_t)per_sensor * sensor_count * sizeof(sensor_history_bucket_t);
+
+        sensor_history_bucket_t *block = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!block) {
+            APP_LOG_ERROR(TAG, "PSRAM allocation failed for tier %s (%u bytes)",
+                         sensor_history_tier_to_string((sensor_history_tier_t)i),
+                         (unsigned)bytes);
+            for (int j = 0; j < i; j++) {
+                heap_caps_free(g_history_ctx.tiers[0][j].buckets);
+            }
+            memset(g_history_ctx.tiers, 0, sizeof(g_history_ctx.tiers));
+            vSemaphoreDelete(g_history_ctx.mutex);
+            g_history_ctx.mutex = NULL;
+            return APP_ERR_NO_MEMORY;
+        }
+
+        for (size_t s = 0; s < sensor_count; s++) {
+            history_tier_t *tier = &g_history_ctx.tiers[s][i];
+            tier->buckets = block + s * per_sensor;
+            tier->capacity = per_sensor;
+            tier->period_ms = period_ms[i];
+            tier->head = 0;
+            tier->count = 0;
+            tier->open.count = 0;
+        }
+        total += bytes;
+    }
+
+    g_history_ctx.sensor_count = sensor_count;
+    g_history_ctx.initialized = true;
+    APP_LOG_INFO(TAG, "History ready: %u KB PSRAM for %u sensors (per sensor: raw %lu, 1m %lu, 1h %lu)",
+                (unsigned)(total / 1024), (unsigned)sensor_count,
+                (unsigned long)g_history_ctx.tiers[0][SENSOR_HISTORY_TIER_RAW].capacity,
+                (unsigned long)g_history_ctx.tiers[0][SENSOR_HISTORY_TIER_MINUTE].capacity,
+                (unsigned long)g_history_ctx.tiers[0][SENSOR_HISTORY_TIER_HOUR].capacity);
+    return APP_OK;
+}
+
+bool sensor_history_is_ready(void)
+{
+    return g_history_ctx.initialized;
+}
+
+app_err_t sensor_history_add(const sensor_data_t *reading)
+{
+    if (!reading) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (!g_history_ctx.initialized || !reading->is_valid ||
+        reading->sensor_id >= g_history_ctx.sensor_count) {
+        return APP_OK;
+    }
+
+    history_tier_t *tiers = g_history_ctx.tiers[reading->sensor_id];
+
+    sensor_history_bucket_t raw = {
+        .start_ms = reading->timestamp_ms,
+        .count = 1,
+        .temp_min = reading->temperature,
+        .temp_max = reading->temperature,
+        .temp_mean = reading->temperature,
+        .hum_min = reading->humidity,
+        .hum_max = reading->humidity,
+        .hum_mean = reading->humidity,
+    };
+
+    xSemaphoreTake(g_history_ctx.mutex, portMAX_DELAY);
+    history_push(&tiers[SENSOR_HISTORY_TIER_RAW], &raw);
+    history_accumulate(&tiers[SENSOR_HISTORY_TIER_MINUTE], reading);
+    history_accumulate(&tiers[SENSOR_HISTORY_TIER_HOUR], reading);
+    xSemaphoreGive(g_history_ctx.mutex);
+
+    return APP_OK;
+}
+
+size_t sensor_history_query(uint8_t sensor_id, sensor_history_tier_t tier,
+                            uint64_t from_ms, uint64_t to_ms,
+                            sensor_history_bucket_t *buckets, size_t max_buckets)
+{
+    if (!g_history_ctx.initialized || sensor_id >= g_history_ctx.sensor_count ||
+        tier >= SENSOR_HISTORY_TIER_COUNT ||
+        !buckets || max_buckets == 0 || from_ms > to_ms) {
+        return 0;
+    }
+
+    const history_tier_t *t = &g_history_ctx.tiers[sensor_id][tier];
+    size_t n = 0;
+
+    xSemaphoreTake(g_history_ctx.mutex, portMAX_DELAY);
+    uint32_t first = history_lower_bound(t, from_ms);
+    while (first + n < t->count && n < max_buckets &&
+           history_at(t, first + (uint32_t)n)->start_ms <= to_ms) {
+        n++;
+    }
+    history_copy(t, first, n, buckets);
+    xSemaphoreGive(g_history_ctx.mutex);
+
+    return n;
+}
+
+size_t sensor_history_latest(uint8_t sensor_id, sensor_history_tier_t tier,
+                             sensor_history_bucket_t *buckets, size_t max_buckets)
+{
+    if (!g_history_ctx.initialized || sensor_id >= g_history_ctx.sensor_count ||
+        tier >= SENSOR_HISTORY_TIER_COUNT ||
+        !buckets || max_buckets == 0) {
+        return 0;
+    }
+
+    const history_tier_t *t = &g_history_ctx.tiers[sensor_id][tier];
+
+    xSemaphoreTake(g_history_ctx.mutex, portMAX_DELAY);
+    size_t n = (t->count < max_buckets) ? t->count : max_buckets;
+    history_copy(t, t->count - (uint32_t)n, n, buckets);
+    xSemaphoreGive(g_history_ctx.mutex);
+
+    return n;
+}
+
+uint32_t sensor_history_count(uint8_t sensor_id, sensor_history_tier_t tier)
+{
+    if (!g_history_ctx.initialized || sensor_id >= g_history_ctx.sensor_count ||
+        tier >= SENSOR_HISTORY_TIER_COUNT) {
+        return 0;
+    }
+
+    xSemaphoreTake(g_history_ctx.mutex, portMAX_DELAY);
+    uint32_t count = g_history_ctx.tiers[sensor_id][tier].count;
+    xSemaphoreGive(g_history_ctx.mutex);
+
+    return count;
+}
+
+size_t sensor_history_sensor_count(void)
+{
+    return g_history_ctx.initialized ? g_history_ctx.sensor_count : 0;
+}
+
+const char* sensor_history_tier_to_string(sensor_history_tier_t tier)
+{
+    switch (tier) {
+        case SENSOR_HISTORY_TIER_RAW: return "raw";
+        case SENSOR_HISTORY_TIER_MINUTE: return "1m";
+        case SENSOR_HISTORY_TIER_HOUR: return "1h";
+        default: return "unknown";
+    }
+}
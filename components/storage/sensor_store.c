@@ -0,0 +1,469 @@
+/**
+ * @file sensor_store.c
+ * @brief Offline store-and-forward log on a dedicated flash partition
+ * @version 2.0
+ *
+ * Layout:
+ * - Partition is split in 4 KB sectors of 128 x 32-byte records
+ * - `head` is the next slot to write, `tail` the oldest pending slot
+ * - Record `seq` grows monotonically, the newest record marks the head
+ *   after a reboot
+ * - Record `flags` is 0xFFFF while pending and cleared to 0 once
+ *   replayed (NOR flash allows 1 -> 0 writes without erase)
+ * - One sector ahead of the head is kept erased so appends are a single
+ *   32-byte write
+ */
+
+#include "sensor_store.h"
+#include "app_common.h"
+#include "utils.h"
+#include "esp_partition.h"
+#include <string.h>
+
+static const char *TAG = "SENSOR_STORE";
+
+/* =========================================================================
+   RECORD FORMAT
+   ========================================================================= */
+#define STORE_SEQ_ERASED 0xFFFFFFFFu
+#define STORE_FLAGS_PENDING 0xFFFFu
+#define STORE_FLAGS_CONSUMED 0x0000u
+
+typedef struct {
+    uint32_t seq;           // Record sequence, STORE_SEQ_ERASED = empty slot
+    uint16_t flags;         // STORE_FLAGS_PENDING / STORE_FLAGS_CONSUMED
+    uint8_t sensor_id;
+    uint8_t reserved;
+    uint64_t timestamp_ms;
+    float temperature;
+    float humidity;
+    uint32_t sequence;      // Reading sequence from the sensor task
+    uint32_t crc;           // CRC32 of the record with flags = pending
+} store_record_t;
+
+_Static_assert(sizeof(store_record_t) == SENSOR_STORE_RECORD_SIZE, "store record must be 32 bytes");
+
+typedef enum {
+    RECORD_EMPTY = 0,
+    RECORD_VALID = 1,
+    RECORD_CORRUPT = 2
+} store_record_state_t;
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+typedef struct {
+    const esp_partition_t *partition;
+    bool initialized;
+
+    uint32_t sector_count;
+    uint32_t slots_per_sector;
+    uint32_t total_slots;
+
+    uint32_t head;          // Next slot to write
+    uint32_t tail;          // Oldest pending slot
+    uint32_t next_seq;      // Sequence for next record
+    int32_t spare_sector;   // Sector erased ahead of head (-1 = none)
+
+    sensor_store_stats_t stats;
+} store_context_t;
+
+static store_context_t g_store_ctx = {0};
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+static uint32_t store_record_crc(const store_record_t *rec)
+{
+    store_record_t tmp = *rec;
+    tmp.flags = STORE_FLAGS_PENDING;
+    return utils_crc32((const uint8_t *)&tmp, offsetof(store_record_t, crc));
+}
+
+static store_record_state_t store_record_state(const store_record_t *rec)
+{
+    if (rec->seq == STORE_SEQ_ERASED && rec->crc == 0xFFFFFFFFu) {
+        return RECORD_EMPTY;
+    }
+    return (store_record_crc(rec) == rec->crc) ? RECORD_VALID : RECORD_CORRUPT;
+}
+
+static app_err_t store_read_record(uint32_t slot, store_record_t *rec)
+{
+    esp_err_t ret = esp_partition_read(g_store_ctx.partition,
+                                       (size_t)slot * SENSOR_STORE_RECORD_SIZE,
+                                       rec, sizeof(*rec));
+    if (ret != ESP_OK) {
+        g_store_ctx.stats.errors++;
+        APP_LOG_ERROR(TAG, "Flash read failed at slot %lu: %d", slot, ret);
+        return APP_ERR_UNKNOWN;
+    }
+    return APP_OK;
+}
+
+static uint32_t store_pending_slots(void)
+{
+    return (g_store_ctx.head + g_store_ctx.total_slots - g_store_ctx.tail) %
+           g_store_ctx.total_slots;
+}
+
+static bool store_sector_is_blank(uint32_t sector)
+{
+    uint32_t words[SENSOR_STORE_RECORD_SIZE * 4 / sizeof(uint32_t)];
+    size_t base = (size_t)sector * SENSOR_STORE_SECTOR_SIZE;
+
+    for (size_t off = 0; off < SENSOR_STORE_SECTOR_SIZE; off += sizeof(words)) {
+        if (esp_partition_read(g_store_ctx.partition, base + off, words, sizeof(words)) != ESP_OK) {
+            g_store_ctx.stats.errors++;
+            return false;
+        }
+        for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+            if (words[i] != 0xFFFFFFFFu) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Erase a sector so the head can move into it
+ *
+ * If the sector still holds pending records (log full), they are dropped
+ * and the tail moves to the next sector.
+ */
+static app_err_t store_prepare_sector(uint32_t sector)
+{
+    uint32_t spp = g_store_ctx.slots_per_sector;
+
+    if (store_pending_slots() > 0 && g_store_ctx.tail / spp == sector) {
+        uint32_t next_start = ((sector + 1) % g_store_ctx.sector_count) * spp;
+        uint32_t lost = (next_start + g_store_ctx.total_slots - g_store_ctx.tail) %
+                        g_store_ctx.total_slots;
+
+        g_store_ctx.tail = next_start;
+        g_store_ctx.stats.overwritten += lost;
+        APP_LOG_WARN(TAG, "Store full, dropping %lu oldest readings", lost);
+    }
+
+    esp_err_t ret = esp_partition_erase_range(g_store_ctx.partition,
+                                              (size_t)sector * SENSOR_STORE_SECTOR_SIZE,
+                                              SENSOR_STORE_SECTOR_SIZE);
+    if (ret != ESP_OK) {
+        g_store_ctx.stats.errors++;
+        APP_LOG_ERROR(TAG, "Sector %lu erase failed: %d", sector, ret);
+        return APP_ERR_UNKNOWN;
+    }
+
+    g_store_ctx.spare_sector = (int32_t)sector;
+    APP_LOG_DEBUG(TAG, "Sector %lu erased", sector);
+    return APP_OK;
+}
+
+/**
+ * @brief Sector the head will write into next
+ */
+static uint32_t store_next_sector(void)
+{
+    uint32_t spp = g_store_ctx.slots_per_sector;
+    uint32_t sector = g_store_ctx.head / spp;
+
+    if (g_store_ctx.head % spp != 0) {
+        sector = (sector + 1) % g_store_ctx.sector_count;
+    }
+    return sector;
+}
+
+/**
+ * @brief Find oldest pending slot, scanning sectors oldest-first
+ * @param newest_sector Sector holding the newest record
+ */
+static uint32_t store_recover_tail(uint32_t newest_sector)
+{
+    uint32_t spp = g_store_ctx.slots_per_sector;
+    store_record_t rec;
+
+    for (uint32_t k = 1; k <= g_store_ctx.sector_count; k++) {
+        uint32_t sector = (newest_sector + k) % g_store_ctx.sector_count;
+        uint32_t first = sector * spp;
+        uint32_t end = first + spp;
+
+        if (sector == g_store_ctx.head / spp && g_store_ctx.head % spp != 0) {
+            end = g_store_ctx.head;
+        }
+
+        if (store_read_record(first, &rec) != APP_OK || store_record_state(&rec) == RECORD_EMPTY) {
+            continue;
+        }
+
+        // Records are replayed in order: a consumed last record means
+        // the whole sector has been replayed
+        if (store_read_record(end - 1, &rec) == APP_OK &&
+            store_record_state(&rec) == RECORD_VALID &&
+            rec.flags == STORE_FLAGS_CONSUMED) {
+            continue;
+        }
+
+        for (uint32_t slot = first; slot < end; slot++) {
+            if (store_read_record(slot, &rec) != APP_OK) {
+                continue;
+            }
+            if (store_record_state(&rec) == RECORD_VALID && rec.flags == STORE_FLAGS_PENDING) {
+                return slot;
+            }
+        }
+    }
+
+    return g_store_ctx.head;
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+app_err_t sensor_store_init(void)
+{
+    if (g_store_ctx.initialized) {
+        APP_LOG_WARN(TAG, "Sensor store already initialized");
+        return APP_OK;
+    }
+
+    g_store_ctx.partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                     ESP_PARTITION_SUBTYPE_ANY,
+                                                     SENSOR_STORE_PARTITION_LABEL);
+    if (!g_store_ctx.partition) {
+        APP_LOG_ERROR(TAG, "Partition '%s' not found", SENSOR_STORE_PARTITION_LABEL);
+        return APP_ERR_UNKNOWN;
+    }
+
+    g_store_ctx.sector_count = g_store_ctx.partition->size / SENSOR_STORE_SECTOR_SIZE;
+    if (g_store_ctx.sector_count < 2) {
+        APP_LOG_ERROR(TAG, "Partition too small: %lu bytes", g_store_ctx.partition->size);
+        return APP_ERR_INVALID_VALUE;
+    }
+
+    g_store_ctx.slots_per_sector = SENSOR_STORE_SECTOR_SIZE / SENSOR_STORE_RECORD_SIZE;
+    g_store_ctx.total_slots = g_store_ctx.sector_count * g_store_ctx.slots_per_sector;
+    g_store_ctx.spare_sector = -1;
+
+    // Find the sector holding the newest record
+    store_record_t rec;
+    bool found = false;
+    uint32_t newest_sector = 0;
+    uint32_t newest_seq = 0;
+
+    for (uint32_t sector = 0; sector < g_store_ctx.sector_count; sector++) {
+        if (store_read_record(sector * g_store_ctx.slots_per_sector, &rec) != APP_OK) {
+            return APP_ERR_UNKNOWN;
+        }
+        if (store_record_state(&rec) == RECORD_VALID && (!found || rec.seq > newest_seq)) {
+            found = true;
+            newest_sector = sector;
+            newest_seq = rec.seq;
+        }
+    }
+
+    if (!found) {
+        // Empty log: start at sector 0
+        g_store_ctx.head = 0;
+        g_store_ctx.tail = 0;
+        g_store_ctx.next_seq = 0;
+    } else {
+        // Head is the first empty slot after the newest record
+        uint32_t first = newest_sector * g_store_ctx.slots_per_sector;
+        uint32_t slot = first;
+
+        for (; slot < first + g_store_ctx.slots_per_sector; slot++) {
+            if (store_read_record(slot, &rec) != APP_OK) {
+                return APP_ERR_UNKNOWN;
+            }
+            store_record_state_t state = store_record_state(&rec);
+            if (state == RECORD_EMPTY) {
+                break;
+            }
+            if (state == RECORD_VALID && rec.seq >= newest_seq) {
+                newest_seq = rec.seq;
+            }
+        }
+
+        g_store_ctx.head = slot % g_store_ctx.total_slots;
+        g_store_ctx.next_seq = newest_seq + 1;
+        g_store_ctx.tail = store_recover_tail(newest_sector);
+    }
+
+    g_store_ctx.initialized = true;
+    g_store_ctx.stats.capacity = g_store_ctx.total_slots - g_store_ctx.slots_per_sector;
+
+    // Make sure the head can be written without an erase,
+    // skipping the erase if the sector is already blank
+    uint32_t next_sector = store_next_sector();
+    if (store_sector_is_blank(next_sector)) {
+        g_store_ctx.spare_sector = (int32_t)next_sector;
+    }
+    sensor_store_service();
+
+    APP_LOG_INFO(TAG, "Sensor store ready: %lu sectors, %lu pending readings",
+                g_store_ctx.sector_count, store_pending_slots());
+    return APP_OK;
+}
+
+bool sensor_store_is_ready(void)
+{
+    return g_store_ctx.initialized;
+}
+
+app_err_t sensor_store_append(const sensor_data_t *data, uint32_t sequence)
+{
+    if (!data) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (!g_store_ctx.initialized) {
+        return APP_ERR_UNKNOWN;
+    }
+
+    uint32_t spp = g_store_ctx.slots_per_sector;
+    uint32_t sector = g_store_ctx.head / spp;
+
+    // Entering a new sector: normally pre-erased by sensor_store_service()
+    if (g_store_ctx.head % spp == 0 && g_store_ctx.spare_sector != (int32_t)sector) {
+        APP_LOG_WARN(TAG, "Sector %lu not prepared, erasing inline", sector);
+        app_err_t ret = store_prepare_sector(sector);
+        if (ret != APP_OK) {
+            return ret;
+        }
+    }
+
+    store_record_t rec = {
+        .seq = g_store_ctx.next_seq,
+        .flags = STORE_FLAGS_PENDING,
+        .sensor_id = data->sensor_id,
+        .reserved = 0xFF,
+        .timestamp_ms = data->timestamp_ms,
+        .temperature = data->temperature,
+        .humidity = data->humidity,
+        .sequence = sequence,
+    };
+    rec.crc = store_record_crc(&rec);
+
+    esp_err_t ret = esp_partition_write(g_store_ctx.partition,
+                                        (size_t)g_store_ctx.head * SENSOR_STORE_RECORD_SIZE,
+                                        &rec, sizeof(rec));
+    if (ret != ESP_OK) {
+        g_store_ctx.stats.errors++;
+        APP_LOG_ERROR(TAG, "Flash write failed at slot %lu: %d", g_store_ctx.head, ret);
+        return APP_ERR_UNKNOWN;
+    }
+
+    // Spare sector is now in use, sensor_store_service() prepares the next one
+    if (g_store_ctx.spare_sector == (int32_t)sector) {
+        g_store_ctx.spare_sector = -1;
+    }
+
+    g_store_ctx.head = (g_store_ctx.head + 1) % g_store_ctx.total_slots;
+    g_store_ctx.next_seq++;
+    g_store_ctx.stats.appended++;
+
+    return APP_OK;
+}
+
+size_t sensor_store_peek(sensor_store_entry_t *entries, size_t max_entries)
+{
+    if (!entries || !g_store_ctx.initialized) {
+        return 0;
+    }
+
+    size_t count = 0;
+    uint32_t slot = g_store_ctx.tail;
+    store_record_t rec;
+
+    while (count < max_entries && slot != g_store_ctx.head) {
+        if (store_read_record(slot, &rec) != APP_OK) {
+            break;
+        }
+
+        if (store_record_state(&rec) == RECORD_VALID && rec.flags == STORE_FLAGS_PENDING) {
+            entries[count].data.sensor_id = rec.sensor_id;
+            entries[count].data.timestamp_ms = rec.timestamp_ms;
+            entries[count].data.temperature = rec.temperature;
+            entries[count].data.humidity = rec.humidity;
+            entries[count].data.is_valid = true;
+            entries[count].data.last_error = APP_OK;
+            entries[count].sequence = rec.sequence;
+            count++;
+        }
+
+        slot = (slot + 1) % g_store_ctx.total_slots;
+    }
+
+    return count;
+}
+
+app_err_t sensor_store_consume(size_t count)
+{
+    if (!g_store_ctx.initialized) {
+        return APP_ERR_UNKNOWN;
+    }
+
+    static const uint16_t consumed = STORE_FLAGS_CONSUMED;
+    store_record_t rec;
+
+    while (g_store_ctx.tail != g_store_ctx.head) {
+        if (store_read_record(g_store_ctx.tail, &rec) != APP_OK) {
+            return APP_ERR_UNKNOWN;
+        }
+
+        bool pending = (store_record_state(&rec) == RECORD_VALID &&
+                        rec.flags == STORE_FLAGS_PENDING);
+
+        // Stop before the first pending record that was not requested;
+        // corrupt or already consumed slots are skipped
+        if (pending && count == 0) {
+            break;
+        }
+
+        if (pending) {
+            esp_err_t ret = esp_partition_write(g_store_ctx.partition,
+                (size_t)g_store_ctx.tail * SENSOR_STORE_RECORD_SIZE + offsetof(store_record_t, flags),
+                &consumed, sizeof(consumed));
+            if (ret != ESP_OK) {
+                g_store_ctx.stats.errors++;
+                APP_LOG_ERROR(TAG, "Flash write failed at slot %lu: %d", g_store_ctx.tail, ret);
+                return APP_ERR_UNKNOWN;
+            }
+            g_store_ctx.stats.replayed++;
+            count--;
+        }
+
+        g_store_ctx.tail = (g_store_ctx.tail + 1) % g_store_ctx.total_slots;
+    }
+
+    return APP_OK;
+}
+
+uint32_t sensor_store_pending(void)
+{
+    return g_store_ctx.initialized ? store_pending_slots() : 0;
+}
+
+void sensor_store_service(void)
+{
+    if (!g_store_ctx.initialized) {
+        return;
+    }
+
+    uint32_t target = store_next_sector();
+    if (g_store_ctx.spare_sector != (int32_t)target) {
+        store_prepare_sector(target);
+    }
+}
+
+app_err_t sensor_store_get_stats(sensor_store_stats_t *stats)
+{
+    if (!stats) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    *stats = g_store_ctx.stats;
+    stats->pending = sensor_store_pending();
+    return APP_OK;
+}
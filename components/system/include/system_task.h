@@ -7,14 +7,14 @@
  * 
  * Manages multiple FreeRTOS tasks for different system functions:
  * - Sensor reading task (periodic, 5 senconds)
- * - MQTT receive task (event-driven)
- * - Output control task (command-driven)
- * - System monitor task (periodic, 10 seconds)
+ * - Publisher task (batches readings into one MQTT message)
+ * - Output control task (command-driven, MQTT commands included)
+ * - System monitor task (periodic, 10 seconds; profiler and diagnostics)
  * 
  * Tasks commmunicate via:
- * - Queues (message passing)
+ * - Lock-free ring (sensor readings -> publisher), queues (commands)
  * - Event groups (synchronization)
- * - Shared status (protected by mutex)
+ * - Shared status (seqlock snapshot, counters in the metrics registry)
  * 
  * Usage:
     @code
@@ -44,6 +44,7 @@
 #include <stdbool.h>
 #include "app_common.h"
 #include "app_config.h"
+#include "command.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 
@@ -79,8 +80,8 @@ app_err_t system_task_init(void);
  * 
  * Create and starts:
  * 1. Sensor read task (priority 5, 3KB stack)
- * 2. MQTT RX task (priority 10, 4KB stack)
- * 3. Output control task (priority 6, 2KB stack)
+ * 2. Publisher task (priority 4, 4KB stack)
+ * 3. Output control task, runs commands (priority 10, 4KB stack)
  * 4. System monitor task (priority 2, 3KB stack)
  * 
  * @param config Pointer to application configuration
@@ -154,8 +155,9 @@ void system_task_signal_ready(void);
 /**
  * @brief Get system status (thread-safe)
  * 
- * Retrieves current system status information.
- * Protected by mutex, safe to call from any task/ISR.
+ * Retrieves current system status information as a consistent
+ * snapshot. Lock-free (seqlock), safe to call from any task, not from an
+ * ISR.
  * 
  * @param status Pointer to system_status_t structure for output
  * @return APP_OK on success
@@ -175,44 +177,56 @@ void system_task_signal_ready(void);
 app_err_t system_task_get_status(system_status_t *status);
 
 /**
- * @brief Get sensor data queue handle
+ * @brief Get command queue handle
  * 
- * Returns the FreeRTOS queue handle used for sensor data.
- * Advanced use: send sensor data from other modules.
+ * Returns the FreeRTOS queue handle used for control commands.
+ * Advanced use: send commands from other modules.
  * 
  * @return Queue handle (never NULL after init)
  * 
- * @note Queue size: 5 sensor_message_t
- * @note Item size: sizeof(sensor_message_t)
+ * @note Queue size: 10 command_t
+ * @note Item size: sizeof(command_t), see command.h
+ * @note Commands are run through command_dispatch() by the output task
  * 
  * @code
    ```c
-   QueueHandle_t q = system_task_get_sensor_queue();
-   // Can now xQueueSend() or xQueueReceive() directly
+   QueueHandle_t q = system_task_get_command_queue();
+   command_t cmd = { .id = COMMAND_FAN, .value = 128 };
+   xQueueSend(q, &cmd, 0);
    ```
  * @endcode
  */
-QueueHandle_t system_task_get_sensor_queue(void);
+QueueHandle_t system_task_get_command_queue(void);
 
 /**
- * @brief Get command queue handle
+ * @brief Queue a command for the output task
  * 
- * Returns the FreeRTOS queue handle used for control commands.
- * Advanced use: send commands from other modules.
+ * Never blocks, so it can be used as the MQTT client's `on_command`
+ * callback: commands go from the MQTT event handler to the output task in
+ * a single queue hop. Sets `stamps.queued_us` (and `received_us` if the
+ * caller did not) for the command latency statistics (command.h).
  * 
- * @return Queue handle (never NULL after init)
+ * A queued command's group is released by the output task's dispatch;
+ * when this fails the group stays with the caller (command_release()).
+ * 
+ * @param cmd Command
+ * @return `APP_OK` if queued, error code otherwise.
  * 
- * @note Queue size: 10 control_message_t
- * @note Item size: sizeof(control_message_t)
+ * @retval APP_OK Command queued
+ * @retval APP_ERR_INVALID_PARAM `cmd` is `NULL`
+ * @retval APP_ERR_TIMEOUT Queue full, command dropped
+ * @retval APP_ERR_UNKNOWN system_task_init() not called
  * 
  * @code
    ```c
-   QueueHandle_t q = system_task_get_command_queue();
-   // Can now xQueueSend() or xQueueReceive() directly
+   mqtt_config_t mqtt_cfg = {
+       ...
+       .on_command = system_task_submit_command,
+   };
    ```
  * @endcode
  */
-QueueHandle_t system_task_get_command_queue(void);
+app_err_t system_task_submit_command(const command_t *cmd);
 
 /**
  * @brief Queue sensor data from external source
@@ -220,8 +234,14 @@ QueueHandle_t system_task_get_command_queue(void);
  * Sends sensor data to the system for processing.
  * Useful when external sensors send data via other interfaces.
  * 
+ * Readings go through their own ring (8 entries, lock-free towards the
+ * publisher task, callers serialized by a mutex, so not from ISRs) next
+ * to the sensor task's and are published in batches to
+ * `mqtt_topic_sensor`. This is the only way into the rings from other
+ * modules.
+ * 
  * @param data Pointer to sensor_data_t
- * @return APP_OK if queued, error if queue full
+ * @return APP_OK if queued, error if the ring is full
  * 
  * @code
  * sensor_data_t reading = {0};
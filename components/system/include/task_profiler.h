@@ -0,0 +1,112 @@
+/**
+ * @file task_profiler.h
+ * @brief Runtime profiler - per-task CPU and stack, heap fragmentation
+ * @version 2.0
+ *
+ * Each sample reads the FreeRTOS run-time stats of every task
+ * (uxTaskGetSystemState()) and turns the counters into the CPU share of
+ * each task since the previous sample, together with its stack high-water
+ * mark. The heap part reports free, minimum-ever free and largest free
+ * block of the internal heap; fragmentation is the share of free memory
+ * that is not in the largest block.
+ *
+ * Needs CONFIG_FREERTOS_USE_TRACE_FACILITY and
+ * CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS (sdkconfig.defaults). Without
+ * them a sample only holds the heap figures.
+ *
+ * Usage:
+    @code
+    ```c
+    static task_profile_t profile;
+
+    // Every few seconds, from one task
+    task_profiler_sample(&profile);
+    size_t len = task_profiler_to_json(&profile, buffer, sizeof(buffer));
+    ```
+    @endcode
+ *
+ * @note Not thread-safe: sample from one task only (the monitor task).
+ * @note CPU shares are per core. On the dual-core ESP32 the two idle
+ *       tasks (IDLE0/IDLE1) each show the headroom of their core.
+ */
+
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "app_common.h"
+#include "freertos/FreeRTOS.h"
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+#define TASK_PROFILER_MAX_TASKS 24 /**< Application, IDF and idle tasks */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief One task in a sample
+ */
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    uint8_t priority;
+    uint16_t cpu_permille;      // CPU share since the previous sample
+    uint32_t stack_free;        // Stack high-water mark (bytes never used)
+} task_profile_entry_t;
+
+/**
+ * @brief One profiler sample
+ */
+typedef struct {
+    uint32_t interval_ms;       // Time the CPU shares cover
+    uint32_t heap_free;         // Internal heap, bytes
+    uint32_t heap_min_free;     // Lowest heap_free since boot
+    uint32_t heap_largest_block;
+    uint8_t heap_fragmentation; // Percent of free heap outside the largest block
+    uint8_t task_count;         // Entries in tasks[]
+    uint8_t tasks_skipped;      // Tasks beyond TASK_PROFILER_MAX_TASKS
+    task_profile_entry_t tasks[TASK_PROFILER_MAX_TASKS];
+} task_profile_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Take a sample
+ *
+ * The first sample's CPU shares cover the time since boot.
+ *
+ * @param profile Output
+ * @return `APP_OK` on success, error code otherwise.
+ *
+ * @retval APP_OK Sample taken
+ * @retval APP_ERR_INVALID_PARAM `profile` is `NULL`
+ */
+app_err_t task_profiler_sample(task_profile_t *profile);
+
+/**
+ * @brief The task using the most CPU in a sample, idle tasks excluded
+ * @param profile Sample
+ * @return Entry, `NULL` if there is none
+ */
+const task_profile_entry_t *task_profiler_busiest(const task_profile_t *profile);
+
+/**
+ * @brief Encode a sample as compact JSON
+ *
+ * Payload format:
+ * {"type":"tasks","interval_ms":10000,
+ *  "heap":{"free":181204,"min":170352,"largest":110592,"frag":39},
+ *  "tasks":[["sensor_task",5,12,1840],...],"skipped":0}
+ * Each task is [name, priority, CPU permille, stack free bytes].
+ *
+ * @param profile Sample
+ * @param buffer Output buffer
+ * @param size Buffer size
+ * @return Payload length, 0 if it does not fit
+ */
+size_t task_profiler_to_json(const task_profile_t *profile, char *buffer, size_t size);
+
+#endif // TASK_PROFILER_H
@@ -7,21 +7,40 @@
  * 
  * Task Architecture:
  * - Main Task: Initialize system, manage startup sequence
- * - Sensor Task: Read DHT sensor at fixed interval (non-blocking)
- * - MQTT Rx Task: Handle incoming commands
- * - Output Task: Control relay and fan (separate from sensor)
+ * - Sensor Task: Read DHT sensor at fixed interval (non-blocking), and
+ *   run the local control loop on each reading (controller.h)
+ * - Publisher Task: Batch sensor readings and publish them over MQTT,
+ *   buffering them in flash while offline
+ * - Output Task: Run commands (relay, fan, settings); MQTT commands are
+ *   parsed in the MQTT event handler and queued straight to it
  * - Monitor Task: Health check and diagnostics
  */
 
 #include "system_task.h"
 #include "app_common.h"
-#include "sensor_dht.h"
+#include "sensor_bus.h"
 #include "app_output.h"
+#include "controller.h"
 #include "app_mqtt.h"
 #include "app_wifi.h"
+#include "utils.h"
+#include "telemetry_json.h"
+#include "telemetry_binary.h"
+#include "sensor_store.h"
+#include "sensor_history.h"
+#include "spsc_ring.h"
+#include "latency_hist.h"
+#include "seqlock.h"
+#include "task_profiler.h"
+#include "command.h"
+#include "metrics.h"
+#include "log_deferred.h"
 #include "esp_timer.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include <math.h>
+#include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "SYSTEM_TASK";
@@ -31,7 +50,7 @@ static const char *TAG = "SYSTEM_TASK";
    ============================================================================ */
 
    static TaskHandle_t g_task_sensor = NULL;
-static TaskHandle_t g_task_mqtt_rx = NULL;
+static TaskHandle_t g_task_publish = NULL;
 static TaskHandle_t g_task_output = NULL;
 static TaskHandle_t g_task_monitor = NULL;
 
@@ -43,15 +62,42 @@ static EventGroupHandle_t g_system_events = NULL;
 #define EVENT_SYSTEM_READY      (1 << 2)
 #define EVENT_ERROR             (1 << 3)
 
-// Queue for sensor data
-static QueueHandle_t g_sensor_queue = NULL;
+// Sensor readings -> publisher (lock-free rings, see sensor_ring_push())
+#define SENSOR_RING_CAPACITY    16
+#define EXTERNAL_RING_CAPACITY  8
+static spsc_ring_t g_sensor_ring;           // sensor task only
+static spsc_ring_t g_external_ring;         // system_task_queue_sensor_data()
+static SemaphoreHandle_t g_external_ring_lock = NULL;
 
-// Queue for control commands
+// Queue for control commands (command_t)
 static QueueHandle_t g_command_queue = NULL;
 
-// System status (protected by mutex)
+// Publisher payload buffer (only touched by the publisher task)
+#define PUBLISH_BUFFER_SIZE     1024
+static char g_publish_buffer[PUBLISH_BUFFER_SIZE];
+
+// History queries: queued by the output task, reported by the publisher
+// task (publisher task only touches the buffer)
+#define HISTORY_QUEUE_LENGTH        2
+#define HISTORY_REPORT_MAX_BUCKETS  16
+#define HISTORY_BUFFER_SIZE         2048
+static QueueHandle_t g_history_queue = NULL;
+static char g_history_buffer[HISTORY_BUFFER_SIZE];
+
+// Diagnostics report buffer (monitor task only)
+#define DIAG_BUFFER_SIZE            4096
+static char g_diag_buffer[DIAG_BUFFER_SIZE];
+
+// System status: state, uptime and last error under a seqlock, counters
+// live in the metrics registry
 static system_status_t g_system_status = {0};
-static portMUX_TYPE g_status_mutex = portMUX_INITIALIZER_UNLOCKED;
+static seqlock_t g_status_lock = SEQLOCK_INITIALIZER;
+
+static metrics_counter_t g_system_errors;
+static metrics_counter_t g_sensor_reads;
+static metrics_counter_t g_sensor_errors;
+static metrics_counter_t g_publish_suppressed;
+static metrics_gauge_t g_system_state;
 
 /* ============================================================================
    MESSAGE STRUCTURES
@@ -63,9 +109,37 @@ typedef struct {
 } sensor_message_t;
 
 typedef struct {
-    char type[16];      // "relay" or "fan"
-    int value;          // 0-1 for relay, 0-255 for fan
-} control_message_t;
+    sensor_history_tier_t tier;
+    command_range_t range;          // Seconds since boot, 0 = open end
+} history_request_t;
+
+static sensor_message_t g_sensor_ring_storage[SENSOR_RING_CAPACITY];
+static sensor_message_t g_external_ring_storage[EXTERNAL_RING_CAPACITY];
+
+/* ============================================================================
+   SENSOR RING
+   ============================================================================ */
+
+/**
+ * @brief Hand a reading to the publisher task
+ * 
+ * Each ring has one producer and one consumer (publisher task): the
+ * sensor task owns g_sensor_ring, system_task_queue_sensor_data() pushes
+ * to g_external_ring, its callers serialized by a mutex (interrupts stay
+ * enabled, the publisher never takes it). The publisher is woken with a
+ * task notification instead of blocking in a queue.
+ * 
+ * @return true if queued, false if the ring is full
+ */
+static bool sensor_ring_push(spsc_ring_t *ring, const sensor_message_t *msg)
+{
+    bool queued = spsc_ring_push(ring, msg);
+
+    if (queued && g_task_publish) {
+        xTaskNotifyGive(g_task_publish);
+    }
+    return queued;
+}
 
 /* ============================================================================
    SYSTEM STATUS MANAGEMENT
@@ -73,10 +147,13 @@ typedef struct {
 
 static void system_status_update_state(system_state_t new_state)
 {
-    portENTER_CRITICAL(&g_status_mutex);
+    uint64_t now_ms = esp_timer_get_time() / 1000;
+    
+    seqlock_write_begin(&g_status_lock);
     g_system_status.state = new_state;
-    g_system_status.uptime_ms = esp_timer_get_time() / 1000;
-    portEXIT_CRITICAL(&g_status_mutex);
+    g_system_status.uptime_ms = now_ms;
+    seqlock_write_end(&g_status_lock);
+    metrics_gauge_set(&g_system_state, new_state);
     
     APP_LOG_INFO(TAG, "System state changed to: %s", 
                 system_state_to_string(new_state));
@@ -84,24 +161,55 @@ static void system_status_update_state(system_state_t new_state)
 
 static void system_status_record_error(uint32_t error_code)
 {
-    portENTER_CRITICAL(&g_status_mutex);
+    seqlock_write_begin(&g_status_lock);
     g_system_status.last_error = error_code;
-    g_system_status.error_count++;
-    portEXIT_CRITICAL(&g_status_mutex);
+    seqlock_write_end(&g_status_lock);
+    metrics_counter_inc(&g_system_errors);
 }
 
 static void system_status_increment_sensor_reads(void)
 {
-    portENTER_CRITICAL(&g_status_mutex);
-    g_system_status.sensor_read_count++;
-    portEXIT_CRITICAL(&g_status_mutex);
+    metrics_counter_inc(&g_sensor_reads);
 }
 
 static void system_status_increment_sensor_errors(void)
 {
-    portENTER_CRITICAL(&g_status_mutex);
-    g_system_status.sensor_error_count++;
-    portEXIT_CRITICAL(&g_status_mutex);
+    metrics_counter_inc(&g_sensor_errors);
+}
+
+static void system_status_increment_publish_suppressed(void)
+{
+    metrics_counter_inc(&g_publish_suppressed);
+}
+
+/**
+ * @brief Copy the status, counters read from the metrics registry
+ * 
+ * Lock-free: the seqlock read retries if a state change or error was
+ * recorded meanwhile. The reconnect counts belong to the network
+ * component and are read by name; they stay 0 until WiFi/MQTT are
+ * initialized.
+ */
+static void system_status_snapshot(system_status_t *status)
+{
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&g_status_lock);
+        memcpy(status, &g_system_status, sizeof(system_status_t));
+    } while (seqlock_read_retry(&g_status_lock, seq));
+    
+    status->error_count = metrics_counter_get(&g_system_errors);
+    status->sensor_read_count = metrics_counter_get(&g_sensor_reads);
+    status->sensor_error_count = metrics_counter_get(&g_sensor_errors);
+    status->publish_suppressed_count = metrics_counter_get(&g_publish_suppressed);
+    
+    int64_t value;
+    if (metrics_read("wifi_disconnections_total", &value) == APP_OK) {
+        status->wifi_reconnect_count = (uint32_t)value;
+    }
+    if (metrics_read("mqtt_disconnects_total", &value) == APP_OK) {
+        status->mqtt_reconnect_count = (uint32_t)value;
+    }
 }
 
 /* ============================================================================
@@ -109,48 +217,46 @@ static void system_status_increment_sensor_errors(void)
    ============================================================================ */
 
 /**
- * @brief Sensor Task - Read DHT at fixed interval
+ * @brief Sensor Task - Read all DHT sensors, staggered over the interval
  * 
  * Priority: Medium (5)
  * Stack: 3KB
- * Interval: 5 seconds
+ * Interval: 5 seconds per sensor, up to 20 seconds while stable (see sensor_bus.h)
  */
 static void task_sensor_read(void *pvParameter)
 {
     const app_config_t *config = (const app_config_t *)pvParameter;
-    TickType_t last_wake_time = xTaskGetTickCount();
-    const TickType_t period = pdMS_TO_TICKS(config->sensor_read_interval_ms);
     
     uint32_t read_sequence = 0;
     
-    APP_LOG_INFO(TAG, "Sensor task started (interval: %ld ms)", 
-                config->sensor_read_interval_ms);
+    APP_LOG_INFO(TAG, "Sensor task started (%u sensors, interval: %ld ms)", 
+                (unsigned)sensor_bus_count(), config->sensor_read_interval_ms);
     
     while (1) {
-        // Wait until next read time
-        vTaskDelayUntil(&last_wake_time, period);
-        
-        // Read sensor
+        // Sleep until the next sensor is due, then read it
         sensor_data_t reading = {0};
-        app_err_t ret = sensor_dht_read(&reading);
+        app_err_t ret = sensor_bus_read_next(&reading);
         
         if (ret == APP_OK && reading.is_valid) {
             system_status_increment_sensor_reads();
-            APP_LOG_DEBUG(TAG, "Sensor read #%ld: T=%.1f°C H=%.1f%%",
-                         read_sequence, reading.temperature, reading.humidity);
+            APP_LOG_DEFER_DEBUG(TAG, "Sensor %d read #%ld: T=%.1f°C H=%.1f%%",
+                               reading.sensor_id, read_sequence, reading.temperature, reading.humidity);
             
-            // Send to queue
+            sensor_history_add(&reading);
+            controller_on_reading(&reading);
+
+            // Hand over to the publisher
             sensor_message_t msg = {
                 .data = reading,
                 .sequence = read_sequence++
             };
             
-            if (xQueueSend(g_sensor_queue, &msg, 0) != pdTRUE) {
-                APP_LOG_WARN(TAG, "Sensor queue full, dropping reading");
+            if (!sensor_ring_push(&g_sensor_ring, &msg)) {
+                APP_LOG_WARN(TAG, "Sensor ring full, dropping reading");
             }
         } else {
             system_status_increment_sensor_errors();
-            APP_LOG_ERROR(TAG, "Sensor read failed: %d", ret);
+            APP_LOG_ERROR(TAG, "Sensor %d read failed: %d", reading.sensor_id, ret);
         }
         
         // Check stack usage (debug)
@@ -163,84 +269,602 @@ static void task_sensor_read(void *pvParameter)
 }
 
 /**
- * @brief MQTT Receive Task - Process incoming commands
+ * @brief Encode a batch as JSON
  * 
- * Priority: High (10)
+ * Payload format:
+ * {"seq":12,"count":2,"readings":[{"id":0,"ts":1000,"t":25.1,"h":60.2},...]}
+ * 
+ * @return Payload length, 0 on overflow
+ */
+static size_t publisher_encode_json(const sensor_message_t *batch, size_t count)
+{
+    telemetry_json_writer_t w;
+    telemetry_json_init(&w, g_publish_buffer, sizeof(g_publish_buffer));
+
+    telemetry_json_begin_object(&w);
+    telemetry_json_key(&w, "seq");
+    telemetry_json_uint(&w, batch[0].sequence);
+    telemetry_json_key(&w, "count");
+    telemetry_json_uint(&w, count);
+    telemetry_json_key(&w, "readings");
+    telemetry_json_begin_array(&w);
+    for (size_t i = 0; i < count; i++) {
+        telemetry_json_write_reading(&w, &batch[i].data);
+    }
+    telemetry_json_end_array(&w);
+    telemetry_json_end_object(&w);
+
+    return telemetry_json_finish(&w);
+}
+
+/**
+ * @brief Encode a batch as a delta-encoded binary frame
+ * 
+ * @return Payload length, 0 on error
+ */
+static size_t publisher_encode_binary(const sensor_message_t *batch, size_t count)
+{
+    telemetry_binary_reading_t readings[MAX_PUBLISH_BATCH_SIZE];
+
+    for (size_t i = 0; i < count; i++) {
+        readings[i].sensor_id = batch[i].data.sensor_id;
+        readings[i].timestamp_ms = batch[i].data.timestamp_ms;
+        readings[i].temperature = batch[i].data.temperature;
+        readings[i].humidity = batch[i].data.humidity;
+    }
+
+    int len = telemetry_binary_encode(readings, count,
+                                      (uint8_t *)g_publish_buffer, sizeof(g_publish_buffer));
+    return (len > 0) ? (size_t)len : 0;
+}
+
+/**
+ * @brief Encode a batch of readings and publish it as one MQTT message
+ * 
+ * Encoding follows `config->mqtt_sensor_format` (JSON or binary).
+ * 
+ * @param config Application configuration (topic, QoS, format)
+ * @param batch Sensor messages, oldest first
+ * @param count Number of messages in batch
+ * @return APP_OK if published
+ */
+static app_err_t publisher_send_batch(const app_config_t *config,
+                                      const sensor_message_t *batch, size_t count)
+{
+    size_t len = (config->mqtt_sensor_format == PAYLOAD_FORMAT_BINARY) ?
+                 publisher_encode_binary(batch, count) :
+                 publisher_encode_json(batch, count);
+
+    if (len == 0) {
+        APP_LOG_ERROR(TAG, "Payload encoding failed for %u readings", (unsigned)count);
+        return APP_ERR_NO_MEMORY;
+    }
+
+    app_err_t ret = app_mqtt_publish(config->mqtt_topic_sensor, g_publish_buffer,
+                                     (int)len, config->mqtt_qos, false);
+    if (ret != APP_OK) {
+        return ret;
+    }
+
+    APP_LOG_DEFER_DEBUG(TAG, "Published batch: %u readings, %u bytes", (unsigned)count, (unsigned)len);
+    return APP_OK;
+}
+
+/**
+ * @brief Publish a batch, or keep it in the offline store
+ * 
+ * While older readings are still waiting in the store, new batches are
+ * stored behind them so the broker always receives readings in order.
+ */
+static void publisher_flush_batch(const app_config_t *config,
+                                  const sensor_message_t *batch, size_t count)
+{
+    if (app_mqtt_is_connected() && sensor_store_pending() == 0) {
+        if (publisher_send_batch(config, batch, count) == APP_OK) {
+            return;
+        }
+    }
+
+    if (!sensor_store_is_ready()) {
+        APP_LOG_WARN(TAG, "Offline store unavailable, dropping %u readings", (unsigned)count);
+        system_status_record_error(APP_ERR_MQTT_PUBLISH);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (sensor_store_append(&batch[i].data, batch[i].sequence) != APP_OK) {
+            system_status_record_error(APP_ERR_UNKNOWN);
+        }
+    }
+
+    APP_LOG_DEFER_DEBUG(TAG, "Stored %u readings offline (%lu pending)",
+                       (unsigned)count, sensor_store_pending());
+}
+
+/**
+ * @brief Replay one batch of readings stored while offline
+ * 
+ * @param config Application configuration
+ * @param max_count Maximum readings to replay
+ */
+static void publisher_replay_stored(const app_config_t *config, size_t max_count)
+{
+    // Only touched by the publisher task, kept off its stack
+    static sensor_store_entry_t entries[MAX_PUBLISH_BATCH_SIZE];
+    static sensor_message_t batch[MAX_PUBLISH_BATCH_SIZE];
+
+    size_t count = sensor_store_peek(entries, max_count);
+    if (count == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        batch[i].data = entries[i].data;
+        batch[i].sequence = entries[i].sequence;
+    }
+
+    if (publisher_send_batch(config, batch, count) == APP_OK) {
+        sensor_store_consume(count);
+        APP_LOG_DEFER_DEBUG(TAG, "Replayed %u stored readings (%lu left)",
+                           (unsigned)count, sensor_store_pending());
+    }
+}
+
+/**
+ * @brief Report-by-exception filter
+ * 
+ * A reading is published if it is the first of its sensor, if temperature
+ * or humidity moved by at least the deadband since the last published
+ * reading of that sensor, or if `publish_heartbeat_ms` has elapsed since.
+ * 
+ * @param config Application configuration (deadbands may change at runtime)
+ * @param data Reading
+ * @return true if the reading should be published
+ */
+static bool publisher_should_publish(const app_config_t *config, const sensor_data_t *data)
+{
+    // Last published reading per sensor (publisher task only)
+    static sensor_data_t last[APP_MAX_DHT_SENSORS];
+    static bool has_last[APP_MAX_DHT_SENSORS];
+
+    if (data->sensor_id >= APP_MAX_DHT_SENSORS) {
+        return true;
+    }
+
+    const sensor_data_t *prev = &last[data->sensor_id];
+    bool publish = !has_last[data->sensor_id] ||
+                   fabsf(data->temperature - prev->temperature) >= config->publish_deadband_temp ||
+                   fabsf(data->humidity - prev->humidity) >= config->publish_deadband_hum ||
+                   (config->publish_heartbeat_ms > 0 &&
+                    data->timestamp_ms - prev->timestamp_ms >= config->publish_heartbeat_ms);
+
+    if (publish) {
+        last[data->sensor_id] = *data;
+        has_last[data->sensor_id] = true;
+    }
+    return publish;
+}
+
+/**
+ * @brief Publish buckets of one sensor's history tier
+ * 
+ * Without a range, the newest buckets are reported. With one, the oldest
+ * buckets starting in it; a full report carries "next", the `from` of
+ * the following page.
+ * 
+ * Payload format (on `<mqtt_topic_sensor>/history`):
+ * {"id":0,"tier":"1m","count":2,"buckets":[{"ts":60000,"n":30,
+ *   "t":[24.8,25.0,25.3],"h":[59.7,60.1,60.4]},...],"next":181}
+ * Each array is [min, mean, max]; "ts" is in milliseconds, "next" in
+ * seconds since boot.
+ * 
+ * @param config Application configuration
+ * @param sensor_id Sensor to report
+ * @param tier History tier to report
+ * @param range Time range (seconds since boot, 0 = open end), `NULL` or
+ *        both ends open for the newest buckets
+ * @return APP_OK if published
+ */
+static app_err_t history_publish_report(const app_config_t *config, uint8_t sensor_id,
+                                        sensor_history_tier_t tier, const command_range_t *range)
+{
+    static sensor_history_bucket_t buckets[HISTORY_REPORT_MAX_BUCKETS];
+
+    if (!sensor_history_is_ready()) {
+        return APP_ERR_UNKNOWN;
+    }
+
+    size_t count;
+    bool ranged = range && (range->from_s || range->to_s);
+    if (ranged) {
+        uint64_t from_ms = (uint64_t)range->from_s * 1000;
+        uint64_t to_ms = range->to_s ? (uint64_t)range->to_s * 1000 + 999 : UINT64_MAX;
+        count = sensor_history_query(sensor_id, tier, from_ms, to_ms, buckets, HISTORY_REPORT_MAX_BUCKETS);
+    } else {
+        count = sensor_history_latest(sensor_id, tier, buckets, HISTORY_REPORT_MAX_BUCKETS);
+    }
+
+    telemetry_json_writer_t w;
+    telemetry_json_init(&w, g_history_buffer, sizeof(g_history_buffer));
+
+    telemetry_json_begin_object(&w);
+    telemetry_json_key(&w, "id");
+    telemetry_json_uint(&w, sensor_id);
+    telemetry_json_key(&w, "tier");
+    telemetry_json_string(&w, sensor_history_tier_to_string(tier));
+    telemetry_json_key(&w, "count");
+    telemetry_json_uint(&w, count);
+    telemetry_json_key(&w, "buckets");
+    telemetry_json_begin_array(&w);
+    for (size_t i = 0; i < count; i++) {
+        telemetry_json_begin_object(&w);
+        telemetry_json_key(&w, "ts");
+        telemetry_json_uint(&w, buckets[i].start_ms);
+        telemetry_json_key(&w, "n");
+        telemetry_json_uint(&w, buckets[i].count);
+        telemetry_json_key(&w, "t");
+        telemetry_json_begin_array(&w);
+        telemetry_json_fixed1(&w, buckets[i].temp_min);
+        telemetry_json_fixed1(&w, buckets[i].temp_mean);
+        telemetry_json_fixed1(&w, buckets[i].temp_max);
+        telemetry_json_end_array(&w);
+        telemetry_json_key(&w, "h");
+        telemetry_json_begin_array(&w);
+        telemetry_json_fixed1(&w, buckets[i].hum_min);
+        telemetry_json_fixed1(&w, buckets[i].hum_mean);
+        telemetry_json_fixed1(&w, buckets[i].hum_max);
+        telemetry_json_end_array(&w);
+        telemetry_json_end_object(&w);
+    }
+    telemetry_json_end_array(&w);
+    if (ranged && count == HISTORY_REPORT_MAX_BUCKETS) {
+        telemetry_json_key(&w, "next");
+        telemetry_json_uint(&w, buckets[count - 1].start_ms / 1000 + 1);
+    }
+    telemetry_json_end_object(&w);
+
+    size_t len = telemetry_json_finish(&w);
+    if (len == 0) {
+        APP_LOG_ERROR(TAG, "History report overflow (%u buckets)", (unsigned)count);
+        return APP_ERR_NO_MEMORY;
+    }
+
+    char topic[MAX_MQTT_TOPIC_LEN + 8];
+    snprintf(topic, sizeof(topic), "%s/history", config->mqtt_topic_sensor);
+
+    return app_mqtt_publish(topic, g_history_buffer, (int)len, config->mqtt_qos, false);
+}
+
+/**
+ * @brief Run the queued history queries, one report per sensor each
+ *        (publisher task)
+ */
+static void publisher_run_history(const app_config_t *config)
+{
+    history_request_t request;
+
+    while (xQueueReceive(g_history_queue, &request, 0) == pdTRUE) {
+        app_err_t ret = APP_OK;
+        for (size_t id = 0; id < sensor_history_sensor_count() && ret == APP_OK; id++) {
+            ret = history_publish_report(config, (uint8_t)id, request.tier, &request.range);
+        }
+        if (ret != APP_OK) {
+            APP_LOG_WARN(TAG, "History report failed: %s", app_err_to_string(ret));
+            system_status_record_error(ret);
+        }
+    }
+}
+
+/**
+ * @brief Publisher Task - Drain the sensor ring and publish in batches
+ * 
+ * Priority: Low (4)
  * Stack: 4KB
+ * 
+ * Collects up to `publish_batch_size` readings and sends them as a single
+ * message to `mqtt_topic_sensor`. A partial batch is flushed once its oldest
+ * reading has waited `publish_linger_ms`. Readings are popped from the
+ * ring straight into the batch, all available ones at once.
+ * 
+ * Readings within the deadband of the last published one are dropped
+ * (see publisher_should_publish()).
+ * 
+ * Readings that cannot be published go to the offline store and are
+ * replayed in order, one batch per DEFAULT_STORE_REPLAY_INTERVAL_MS, once
+ * MQTT is connected again.
+ * 
+ * "history" queries are reported here too (publisher_run_history()), so
+ * the range queries and publishes stay off the output task.
  */
-static void task_mqtt_receive(void *pvParameter)
+static void task_sensor_publish(void *pvParameter)
 {
     const app_config_t *config = (const app_config_t *)pvParameter;
-    
-    // Wait for MQTT to be ready
-    xEventGroupWaitBits(g_system_events, EVENT_MQTT_CONNECTED, 
-                       pdFALSE, pdTRUE, portMAX_DELAY);
-    
-    APP_LOG_INFO(TAG, "MQTT RX task started");
-    
-    control_message_t cmd;
+
+    size_t batch_size = (size_t)utils_clamp_int(config->publish_batch_size, 1, MAX_PUBLISH_BATCH_SIZE);
+    sensor_message_t batch[MAX_PUBLISH_BATCH_SIZE];
+    size_t batch_count = 0;
+    uint64_t batch_start_ms = 0;
+    uint64_t last_replay_ms = 0;
+    const TickType_t replay_period = pdMS_TO_TICKS(DEFAULT_STORE_REPLAY_INTERVAL_MS);
+
+    APP_LOG_INFO(TAG, "Publisher task started (batch: %u, linger: %ld ms)",
+                (unsigned)batch_size, config->publish_linger_ms);
+
     while (1) {
-        memset(&cmd, 0, sizeof(cmd));
-        // Wait for MQTT messages
-        if (app_mqtt_receive_command(cmd.type, &cmd.value, pdMS_TO_TICKS(1000)) == APP_OK) {
-            APP_LOG_INFO(TAG, "Received command: type=%s value=%d", cmd.type, cmd.value);
-            
-            // Validate command
-            app_err_t ret = APP_OK;
-            
-            if (strcmp(cmd.type, "relay") == 0) {
-                if (cmd.value < 0 || cmd.value > 1) {
-                    APP_LOG_WARN(TAG, "Invalid relay value: %d", cmd.value);
-                    ret = APP_ERR_INVALID_VALUE;
-                } else {
-                    ret = app_output_set_relay(cmd.value);
-                    APP_LOG_INFO(TAG, "Relay set to %d", cmd.value);
-                }
-            }
-            else if (strcmp(cmd.type, "fan") == 0) {
-                if (cmd.value < 0 || cmd.value > 255) {
-                    APP_LOG_WARN(TAG, "Invalid fan value: %d (0-255)", cmd.value);
-                    ret = APP_ERR_INVALID_VALUE;
-                } else {
-                    ret = app_output_set_fan_speed(cmd.value);
-                    APP_LOG_INFO(TAG, "Fan speed set to %d", cmd.value);
-                }
+        // Block indefinitely while idle, otherwise only until the batch expires
+        TickType_t wait = portMAX_DELAY;
+        if (batch_count > 0) {
+            uint32_t elapsed_ms = (uint32_t)(esp_timer_get_time() / 1000 - batch_start_ms);
+            wait = (elapsed_ms >= config->publish_linger_ms) ?
+                   0 : pdMS_TO_TICKS(config->publish_linger_ms - elapsed_ms);
+        }
+
+        // Wake up regularly while stored readings wait for replay
+        if (sensor_store_pending() > 0 && wait > replay_period) {
+            wait = replay_period;
+        }
+
+        // Sleep only while both rings are empty, producers notify on push
+        if (spsc_ring_count(&g_sensor_ring) == 0 && spsc_ring_count(&g_external_ring) == 0) {
+            ulTaskNotifyTake(pdTRUE, wait);
+        }
+
+        // Pop into the free tail of the batch, then compact out suppressed readings
+        sensor_message_t *incoming = &batch[batch_count];
+        size_t popped = spsc_ring_pop_batch(&g_sensor_ring, incoming, batch_size - batch_count);
+        popped += spsc_ring_pop_batch(&g_external_ring, &incoming[popped],
+                                      batch_size - batch_count - popped);
+        uint64_t now_ms = esp_timer_get_time() / 1000;
+
+        for (size_t i = 0; i < popped; i++) {
+            if (!publisher_should_publish(config, &incoming[i].data)) {
+                system_status_increment_publish_suppressed();
+                continue;
             }
-            else {
-                APP_LOG_WARN(TAG, "Unknown command type: %s", cmd.type);
-                ret = APP_ERR_INVALID_PARAM;
+            if (batch_count == 0) {
+                batch_start_ms = now_ms;
             }
-            
-            if (ret != APP_OK) {
-                system_status_record_error(ret);
+            batch[batch_count++] = incoming[i];
+        }
+
+        // Batch full or linger time expired
+        if (batch_count >= batch_size ||
+            (batch_count > 0 && now_ms - batch_start_ms >= config->publish_linger_ms)) {
+            publisher_flush_batch(config, batch, batch_count);
+            batch_count = 0;
+        }
+
+        // Rate-limited replay of readings buffered while offline
+        if (sensor_store_pending() > 0 && app_mqtt_is_connected() &&
+            now_ms - last_replay_ms >= DEFAULT_STORE_REPLAY_INTERVAL_MS) {
+            publisher_replay_stored(config, batch_size);
+            last_replay_ms = now_ms;
+        }
+
+        // History queries queued by command_history()
+        publisher_run_history(config);
+
+        // Erase ahead in the store here, never in the append path
+        sensor_store_service();
+    }
+}
+
+/**
+ * @brief Publish a profiler sample
+ * 
+ * Payload format (on `<mqtt_topic_sensor>/diagnostics`): see
+ * task_profiler_to_json().
+ * 
+ * @param config Application configuration
+ * @param profile Sample to publish
+ * @return APP_OK if published
+ */
+static app_err_t profile_publish_report(const app_config_t *config, const task_profile_t *profile)
+{
+    size_t len = task_profiler_to_json(profile, g_diag_buffer, sizeof(g_diag_buffer));
+    if (len == 0) {
+        APP_LOG_ERROR(TAG, "Task profile overflow (%u tasks)", (unsigned)profile->task_count);
+        return APP_ERR_NO_MEMORY;
+    }
+
+    char topic[MAX_MQTT_TOPIC_LEN + 16];
+    snprintf(topic, sizeof(topic), "%s/diagnostics", config->mqtt_topic_sensor);
+
+    return app_mqtt_publish(topic, g_diag_buffer, (int)len, config->mqtt_qos, false);
+}
+
+/**
+ * @brief Publish all registered metrics
+ * 
+ * Payload (on `<mqtt_topic_sensor>/metrics`): Prometheus text exposition
+ * format, see metrics_export_prometheus().
+ * 
+ * @param config Application configuration
+ * @return APP_OK if published
+ */
+static app_err_t metrics_publish_report(const app_config_t *config)
+{
+    size_t len = metrics_export_prometheus(g_diag_buffer, sizeof(g_diag_buffer));
+    if (len == 0) {
+        APP_LOG_ERROR(TAG, "Metrics export overflow");
+        return APP_ERR_NO_MEMORY;
+    }
+
+    char topic[MAX_MQTT_TOPIC_LEN + 16];
+    snprintf(topic, sizeof(topic), "%s/metrics", config->mqtt_topic_sensor);
+
+    return app_mqtt_publish(topic, g_diag_buffer, (int)len, config->mqtt_qos, false);
+}
+
+/**
+ * @brief Publish the command latency histograms
+ * 
+ * Payload format (on `<mqtt_topic_sensor>/diagnostics`):
+ * {"type":"command_latency","uptime_ms":600000,"stages":[{"stage":"total",
+ *   "n":12,"last":850,"mean":790,"max":1210,"p50":831,"p90":1151,"p99":1210,
+ *   "buckets":[[768,5],[832,6],[1152,1]]},...]}
+ * Values in microseconds, counts since boot. Buckets are [lower bound,
+ * count], empty ones left out (bounds: latency_hist.h).
+ * 
+ * @param config Application configuration
+ * @return APP_OK if published
+ */
+static app_err_t latency_publish_report(const app_config_t *config)
+{
+    static command_stage_stats_t stats;
+
+    telemetry_json_writer_t w;
+    telemetry_json_init(&w, g_diag_buffer, sizeof(g_diag_buffer));
+
+    telemetry_json_begin_object(&w);
+    telemetry_json_key(&w, "type");
+    telemetry_json_string(&w, "command_latency");
+    telemetry_json_key(&w, "uptime_ms");
+    telemetry_json_uint(&w, (uint32_t)(esp_timer_get_time() / 1000));
+    telemetry_json_key(&w, "stages");
+    telemetry_json_begin_array(&w);
+    for (int stage = 0; stage < COMMAND_STAGE_COUNT; stage++) {
+        command_get_stage_latency((command_stage_t)stage, &stats);
+        const latency_hist_t *hist = &stats.hist;
+
+        telemetry_json_begin_object(&w);
+        telemetry_json_key(&w, "stage");
+        telemetry_json_string(&w, command_stage_to_string((command_stage_t)stage));
+        telemetry_json_key(&w, "n");
+        telemetry_json_uint(&w, hist->count);
+        telemetry_json_key(&w, "last");
+        telemetry_json_uint(&w, stats.last_us);
+        telemetry_json_key(&w, "mean");
+        telemetry_json_uint(&w, hist->count ? (uint32_t)(hist->total / hist->count) : 0);
+        telemetry_json_key(&w, "max");
+        telemetry_json_uint(&w, hist->max);
+        telemetry_json_key(&w, "p50");
+        telemetry_json_uint(&w, latency_hist_percentile(hist, 500));
+        telemetry_json_key(&w, "p90");
+        telemetry_json_uint(&w, latency_hist_percentile(hist, 900));
+        telemetry_json_key(&w, "p99");
+        telemetry_json_uint(&w, latency_hist_percentile(hist, 990));
+        telemetry_json_key(&w, "buckets");
+        telemetry_json_begin_array(&w);
+        for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+            if (hist->buckets[i] == 0) {
+                continue;
             }
+            telemetry_json_begin_array(&w);
+            telemetry_json_uint(&w, latency_hist_bucket_lower(i));
+            telemetry_json_uint(&w, hist->buckets[i]);
+            telemetry_json_end_array(&w);
         }
+        telemetry_json_end_array(&w);
+        telemetry_json_end_object(&w);
+    }
+    telemetry_json_end_array(&w);
+    telemetry_json_end_object(&w);
+
+    size_t len = telemetry_json_finish(&w);
+    if (len == 0) {
+        APP_LOG_ERROR(TAG, "Latency report overflow");
+        return APP_ERR_NO_MEMORY;
+    }
+
+    char topic[MAX_MQTT_TOPIC_LEN + 16];
+    snprintf(topic, sizeof(topic), "%s/diagnostics", config->mqtt_topic_sensor);
+
+    return app_mqtt_publish(topic, g_diag_buffer, (int)len, config->mqtt_qos, false);
+}
+
+/* ============================================================================
+   COMMAND HANDLERS
+   ============================================================================ */
+
+/**
+ * @brief "history": queue one report per sensor for the publisher task
+ *        (value = tier, optional "from"/"to" in seconds since boot)
+ * 
+ * Only queues the query: the relay and fan commands behind it do not
+ * wait for the reports.
+ */
+static app_err_t command_history(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+    history_request_t request = {
+        .tier = (sensor_history_tier_t)cmd->value,
+        .range = cmd->range,
+    };
+
+    if (xQueueSend(g_history_queue, &request, 0) != pdTRUE) {
+        APP_LOG_WARN(TAG, "History query dropped, %d already pending", HISTORY_QUEUE_LENGTH);
+        return APP_ERR_NO_MEMORY;
     }
+    if (g_task_publish) {
+        xTaskNotifyGive(g_task_publish);
+    }
+    return APP_OK;
 }
 
 /**
- * @brief Output Task - Control relay and fan
+ * @brief "deadband_temp": value in tenths of a degree, 0 = publish every reading
+ */
+static app_err_t command_deadband_temp(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+    app_config_get()->publish_deadband_temp = (float)cmd->value / 10.0f;
+    APP_LOG_INFO(TAG, "Temperature deadband set to %.1f C", (float)cmd->value / 10.0f);
+    return APP_OK;
+}
+
+/**
+ * @brief "deadband_hum": value in tenths of a percent, 0 = publish every reading
+ */
+static app_err_t command_deadband_hum(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+    app_config_get()->publish_deadband_hum = (float)cmd->value / 10.0f;
+    APP_LOG_INFO(TAG, "Humidity deadband set to %.1f %%", (float)cmd->value / 10.0f);
+    return APP_OK;
+}
+
+/**
+ * @brief "heartbeat": value in seconds, 0 = publish only on change
+ */
+static app_err_t command_heartbeat(const command_t *cmd, void *ctx)
+{
+    (void)ctx;
+    app_config_get()->publish_heartbeat_ms = (uint32_t)cmd->value * 1000;
+    APP_LOG_INFO(TAG, "Publish heartbeat set to %ld s", cmd->value);
+    return APP_OK;
+}
+
+/**
+ * @brief Output Task - Run commands (relay, fan, settings)
  * 
- * Priority: Medium (6)
- * Stack: 2KB
+ * Priority: mqtt_task_priority (10)
+ * Stack: mqtt_task_stack (4KB)
+ * 
+ * Single hop: MQTT commands are parsed in the MQTT event handler and
+ * queued here by system_task_submit_command(), already resolved to a
+ * command_id_t. They are run through the command registry (handlers are
+ * registered by their modules).
  */
 static void task_output_control(void *pvParameter)
 {
+    (void)pvParameter;
+    
     APP_LOG_INFO(TAG, "Output control task started");
     
-    control_message_t cmd = {0};
+    command_t cmd = {0};
     
     while (1) {
-        // Wait for commands from queue
-        if (xQueueReceive(g_command_queue, &cmd, pdMS_TO_TICKS(500)) == pdTRUE) {
-            APP_LOG_DEBUG(TAG, "Output command: %s = %d", cmd.type, cmd.value);
-            
-            if (strcmp(cmd.type, "relay") == 0) {
-                app_output_set_relay(cmd.value);
-            }
-            else if (strcmp(cmd.type, "fan") == 0) {
-                app_output_set_fan_speed(cmd.value);
-            }
+        if (xQueueReceive(g_command_queue, &cmd, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        cmd.stamps.dequeued_us = command_now_us();
+        
+        APP_LOG_DEFER_DEBUG(TAG, "Output command: %s = %ld", command_to_string(cmd.id), cmd.value);
+        
+        app_err_t ret = command_dispatch(&cmd);
+        if (ret != APP_OK) {
+            system_status_record_error(ret);
         }
     }
 }
@@ -250,7 +874,9 @@ static void task_output_control(void *pvParameter)
  * 
  * Priority: Low (3)
  * Stack: 3KB
- * Interval: 10 seconds
+ * Interval: 10 seconds, task profile, command latency and metrics reports
+ * every DEFAULT_DIAG_PUBLISH_INTERVAL_MS, log FORMAT frames resent every
+ * DEFAULT_LOG_RESYNC_INTERVAL_MS
  */
 static void task_system_monitor(void *pvParameter)
 {
@@ -260,38 +886,101 @@ static void task_system_monitor(void *pvParameter)
     
     TickType_t last_wake_time = xTaskGetTickCount();
     const TickType_t period = pdMS_TO_TICKS(10000);  // 10 seconds
+    TickType_t last_diag_time = last_wake_time;
+    TickType_t last_profile_time = last_wake_time;
+    TickType_t last_metrics_time = last_wake_time;
+    TickType_t last_resync_time = last_wake_time;
+    uint32_t last_diag_count = 0;
+    static task_profile_t profile;
     
     while (1) {
         vTaskDelayUntil(&last_wake_time, period);
         
         // Log system status
-        portENTER_CRITICAL(&g_status_mutex);
+        system_status_t status;
+        system_status_snapshot(&status);
         APP_LOG_INFO(TAG, "=== System Status ===");
-        APP_LOG_INFO(TAG, "State: %s", system_state_to_string(g_system_status.state));
-        APP_LOG_INFO(TAG, "Uptime: %ld ms", g_system_status.uptime_ms);
-        APP_LOG_INFO(TAG, "Sensor reads: %ld, errors: %ld",
-                    g_system_status.sensor_read_count,
-                    g_system_status.sensor_error_count);
+        APP_LOG_INFO(TAG, "State: %s", system_state_to_string(status.state));
+        APP_LOG_INFO(TAG, "Uptime: %ld ms", status.uptime_ms);
+        APP_LOG_INFO(TAG, "Sensor reads: %ld, errors: %ld, unpublished (deadband): %ld",
+                    status.sensor_read_count,
+                    status.sensor_error_count,
+                    status.publish_suppressed_count);
         APP_LOG_INFO(TAG, "WiFi reconnects: %ld, MQTT reconnects: %ld",
-                    g_system_status.wifi_reconnect_count,
-                    g_system_status.mqtt_reconnect_count);
-        portEXIT_CRITICAL(&g_status_mutex);
+                    status.wifi_reconnect_count,
+                    status.mqtt_reconnect_count);
+
+        spsc_ring_stats_t ring_stats;
+        spsc_ring_get_stats(&g_sensor_ring, &ring_stats);
+        APP_LOG_INFO(TAG, "Sensor ring: %ld/%ld queued, high water %ld, overflows %ld",
+                    ring_stats.count, ring_stats.capacity,
+                    ring_stats.high_water, ring_stats.overflows);
+        spsc_ring_get_stats(&g_external_ring, &ring_stats);
+        APP_LOG_INFO(TAG, "External ring: %ld/%ld queued, high water %ld, overflows %ld",
+                    ring_stats.count, ring_stats.capacity,
+                    ring_stats.high_water, ring_stats.overflows);
+        
+        static command_stage_stats_t total;
+        command_get_stage_latency(COMMAND_STAGE_TOTAL, &total);
+        if (total.hist.count > 0) {
+            APP_LOG_INFO(TAG, "Command latency: %ld cmds, last %ld us, p50 %ld us, p99 %ld us, max %ld us",
+                        total.hist.count, total.last_us,
+                        latency_hist_percentile(&total.hist, 500),
+                        latency_hist_percentile(&total.hist, 990), total.hist.max);
+        }
+        
+        // Latency report, only when there is something new
+        if ((xTaskGetTickCount() - last_diag_time) >= pdMS_TO_TICKS(DEFAULT_DIAG_PUBLISH_INTERVAL_MS) &&
+            total.hist.count != last_diag_count && app_mqtt_is_connected()) {
+            if (latency_publish_report(config) == APP_OK) {
+                last_diag_time = xTaskGetTickCount();
+                last_diag_count = total.hist.count;
+            }
+        }
         
         // Check sensor health
-        if (!sensor_dht_is_healthy()) {
-            APP_LOG_WARN(TAG, "Sensor health check failed");
+        size_t healthy = sensor_bus_healthy_count();
+        if (healthy < sensor_bus_count()) {
+            APP_LOG_WARN(TAG, "Sensor health check failed (%u/%u healthy)",
+                        (unsigned)healthy, (unsigned)sensor_bus_count());
             system_status_record_error(APP_ERR_SENSOR_READ);
         }
         
-        // Check heap
-        size_t free_heap = esp_get_free_heap_size();
-        size_t min_free_heap = esp_get_minimum_free_heap_size();
-        APP_LOG_DEBUG(TAG, "Heap: free=%zu bytes, min_free=%zu bytes", 
-                     free_heap, min_free_heap);
+        // Profile tasks and heap over the last period
+        task_profiler_sample(&profile);
+        const task_profile_entry_t *busiest = task_profiler_busiest(&profile);
+        if (busiest) {
+            APP_LOG_INFO(TAG, "Busiest task: %s %u.%u%% CPU, %ld bytes stack free",
+                        busiest->name, busiest->cpu_permille / 10, busiest->cpu_permille % 10,
+                        busiest->stack_free);
+        }
+        APP_LOG_DEBUG(TAG, "Heap: free=%ld bytes, min_free=%ld bytes, largest=%ld bytes (%u%% fragmented)", 
+                     profile.heap_free, profile.heap_min_free,
+                     profile.heap_largest_block, profile.heap_fragmentation);
         
-        if (free_heap < 5000) {
+        if (profile.heap_free < 5000) {
             APP_LOG_ERROR(TAG, "Critical: Low heap memory!");
         }
+        
+        if ((xTaskGetTickCount() - last_profile_time) >= pdMS_TO_TICKS(DEFAULT_DIAG_PUBLISH_INTERVAL_MS) &&
+            app_mqtt_is_connected()) {
+            if (profile_publish_report(config, &profile) == APP_OK) {
+                last_profile_time = xTaskGetTickCount();
+            }
+        }
+        
+        if ((xTaskGetTickCount() - last_metrics_time) >= pdMS_TO_TICKS(DEFAULT_DIAG_PUBLISH_INTERVAL_MS) &&
+            app_mqtt_is_connected()) {
+            if (metrics_publish_report(config) == APP_OK) {
+                last_metrics_time = xTaskGetTickCount();
+            }
+        }
+        
+        // Binary logs: repeat the FORMAT frames for a decoder attached after boot
+        if ((xTaskGetTickCount() - last_resync_time) >= pdMS_TO_TICKS(DEFAULT_LOG_RESYNC_INTERVAL_MS)) {
+            log_deferred_resync();
+            last_resync_time = xTaskGetTickCount();
+        }
     }
 }
 
@@ -314,23 +1003,46 @@ app_err_t system_task_init(void)
         return APP_ERR_NO_MEMORY;
     }
     
-    // Create queue for sensor readings
-    g_sensor_queue = xQueueCreate(5, sizeof(sensor_message_t));
-    if (!g_sensor_queue) {
-        APP_LOG_ERROR(TAG, "Failed to create sensor queue");
+    // Rings for sensor readings (static storage), one per producer
+    if (!spsc_ring_init(&g_sensor_ring, g_sensor_ring_storage,
+                        sizeof(g_sensor_ring_storage[0]), SENSOR_RING_CAPACITY) ||
+        !spsc_ring_init(&g_external_ring, g_external_ring_storage,
+                        sizeof(g_external_ring_storage[0]), EXTERNAL_RING_CAPACITY)) {
+        APP_LOG_ERROR(TAG, "Failed to create sensor ring");
+        return APP_ERR_INVALID_PARAM;
+    }
+    
+    g_external_ring_lock = xSemaphoreCreateMutex();
+    if (!g_external_ring_lock) {
+        APP_LOG_ERROR(TAG, "Failed to create sensor ring mutex");
+        return APP_ERR_NO_MEMORY;
+    }
+    
+    g_history_queue = xQueueCreate(HISTORY_QUEUE_LENGTH, sizeof(history_request_t));
+    if (!g_history_queue) {
+        APP_LOG_ERROR(TAG, "Failed to create history queue");
         return APP_ERR_NO_MEMORY;
     }
     
     // Create queue for control commands
-    g_command_queue = xQueueCreate(10, sizeof(control_message_t));
+    g_command_queue = xQueueCreate(10, sizeof(command_t));
     if (!g_command_queue) {
         APP_LOG_ERROR(TAG, "Failed to create command queue");
         return APP_ERR_NO_MEMORY;
     }
     
     // Initialize system status
+    seqlock_write_begin(&g_status_lock);
     memset(&g_system_status, 0, sizeof(system_status_t));
     g_system_status.state = SYSTEM_STATE_INIT;
+    seqlock_write_end(&g_status_lock);
+    
+    metrics_register_counter(&g_system_errors, "system_errors_total");
+    metrics_register_counter(&g_sensor_reads, "sensor_reads_total");
+    metrics_register_counter(&g_sensor_errors, "sensor_errors_total");
+    metrics_register_counter(&g_publish_suppressed, "sensor_publish_suppressed_total");
+    metrics_register_gauge(&g_system_state, "system_state");
+    metrics_gauge_set(&g_system_state, SYSTEM_STATE_INIT);
     
     APP_LOG_INFO(TAG, "Task system initialized");
     return APP_OK;
@@ -350,6 +1062,13 @@ app_err_t system_task_start_all(const app_config_t *config)
     APP_LOG_INFO(TAG, "Starting all tasks...");
     system_status_update_state(SYSTEM_STATE_HARDWARE_READY);
     
+    // Commands owned by the system tasks (relay/fan: app_output)
+    command_register(COMMAND_HISTORY, 0, SENSOR_HISTORY_TIER_COUNT - 1,
+                     command_history, NULL);
+    command_register(COMMAND_DEADBAND_TEMP, 0, 1000, command_deadband_temp, NULL);
+    command_register(COMMAND_DEADBAND_HUM, 0, 1000, command_deadband_hum, NULL);
+    command_register(COMMAND_HEARTBEAT, 0, 86400, command_heartbeat, NULL);
+    
     // Create sensor read task
     BaseType_t ret = xTaskCreate(
         task_sensor_read,
@@ -365,28 +1084,28 @@ app_err_t system_task_start_all(const app_config_t *config)
         return APP_ERR_NO_MEMORY;
     }
     
-    // Create MQTT RX task
+    // Create publisher task
     ret = xTaskCreate(
-        task_mqtt_receive,
-        "mqtt_rx_task",
-        config->mqtt_task_stack,
+        task_sensor_publish,
+        "publish_task",
+        DEFAULT_PUBLISH_TASK_STACK,
         (void *)config,
-        config->mqtt_task_priority,
-        &g_task_mqtt_rx
+        DEFAULT_PUBLISH_TASK_PRIORITY,
+        &g_task_publish
     );
     
     if (ret != pdPASS) {
-        APP_LOG_ERROR(TAG, "Failed to create MQTT RX task");
+        APP_LOG_ERROR(TAG, "Failed to create publisher task");
         return APP_ERR_NO_MEMORY;
     }
     
-    // Create output control task
+    // Create output control task (also runs MQTT commands)
     ret = xTaskCreate(
         task_output_control,
         "output_task",
-        2048,
-        NULL,
-        4,
+        config->mqtt_task_stack,
+        (void *)config,
+        config->mqtt_task_priority,
         &g_task_output
     );
     
@@ -451,7 +1170,7 @@ void system_task_signal_ready(void)
  */
 app_err_t system_task_queue_sensor_data(const sensor_data_t *data)
 {
-    if (!data) {
+    if (!data || !g_external_ring_lock) {
         return APP_ERR_INVALID_PARAM;
     }
     
@@ -460,11 +1179,12 @@ app_err_t system_task_queue_sensor_data(const sensor_data_t *data)
         .sequence = 0
     };
     
-    if (xQueueSend(g_sensor_queue, &msg, 0) == pdTRUE) {
-        return APP_OK;
-    }
+    // Several tasks may call this, the ring takes one producer at a time
+    xSemaphoreTake(g_external_ring_lock, portMAX_DELAY);
+    bool queued = sensor_ring_push(&g_external_ring, &msg);
+    xSemaphoreGive(g_external_ring_lock);
     
-    return APP_ERR_UNKNOWN;
+    return queued ? APP_OK : APP_ERR_UNKNOWN;
 }
 
 /**
@@ -478,27 +1198,41 @@ app_err_t system_task_get_status(system_status_t *status)
         return APP_ERR_INVALID_PARAM;
     }
     
-    portENTER_CRITICAL(&g_status_mutex);
-    memcpy(status, &g_system_status, sizeof(system_status_t));
-    portEXIT_CRITICAL(&g_status_mutex);
+    system_status_snapshot(status);
     
     return APP_OK;
 }
 
 /**
- * @brief Get sensor queue handle (for other modules)
+ * @brief Get command queue handle (for other modules)
  * @return Queue handle
  */
-QueueHandle_t system_task_get_sensor_queue(void)
+QueueHandle_t system_task_get_command_queue(void)
 {
-    return g_sensor_queue;
+    return g_command_queue;
 }
 
 /**
- * @brief Get command queue handle (for other modules)
- * @return Queue handle
+ * @brief Queue a command for the output task (any task, MQTT event handler)
  */
-QueueHandle_t system_task_get_command_queue(void)
+app_err_t system_task_submit_command(const command_t *cmd)
 {
-    return g_command_queue;
+    if (!cmd) {
+        return APP_ERR_INVALID_PARAM;
+    }
+    
+    if (!g_command_queue) {
+        return APP_ERR_UNKNOWN;
+    }
+    
+    command_t stamped = *cmd;
+    stamped.stamps.queued_us = command_now_us();
+    if (!stamped.stamps.received_us) {
+        stamped.stamps.received_us = stamped.stamps.queued_us;
+    }
+    
+    if (xQueueSend(g_command_queue, &stamped, 0) != pdTRUE) {
+        return APP_ERR_TIMEOUT;     // Queue full, never blocks
+    }
+    return APP_OK;
 }
@@ -0,0 +1,191 @@
+/**
+ * @file task_profiler.c
+ * @brief Runtime profiler - per-task CPU and stack, heap fragmentation
+ * @version 2.0
+ *
+ * CPU share:
+ * - Run-time counters are 32-bit microseconds (esp_timer clock) and wrap
+ *   every 71 minutes; deltas between samples stay correct as long as
+ *   samples are closer than that
+ * - The previous counter of each task is kept by handle, a task that is
+ *   new since the last sample is measured from its creation
+ */
+
+#include "task_profiler.h"
+#include "sdkconfig.h"
+#include "telemetry_json.h"
+#include "esp_heap_caps.h"
+#include "freertos/task.h"
+#include <string.h>
+
+/* =========================================================================
+   PRIVATE STATE
+   ========================================================================= */
+typedef struct {
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    TaskStatus_t status[TASK_PROFILER_MAX_TASKS];
+    TaskHandle_t prev_handle[TASK_PROFILER_MAX_TASKS];
+    uint32_t prev_run_time[TASK_PROFILER_MAX_TASKS];
+    size_t prev_count;
+    uint32_t prev_total;
+#endif
+    uint32_t prev_sample_ms;
+} task_profiler_context_t;
+
+static task_profiler_context_t g_profiler_ctx = {0};
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+
+static void profiler_sample_heap(task_profile_t *profile)
+{
+    size_t free_bytes = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+
+    profile->heap_free = (uint32_t)free_bytes;
+    profile->heap_min_free = esp_get_minimum_free_heap_size();
+    profile->heap_largest_block = (uint32_t)largest;
+    profile->heap_fragmentation = (free_bytes > 0 && largest < free_bytes)
+        ? (uint8_t)(100 - (largest * 100) / free_bytes) : 0;
+}
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static uint32_t profiler_prev_run_time(TaskHandle_t handle)
+{
+    for (size_t i = 0; i < g_profiler_ctx.prev_count; i++) {
+        if (g_profiler_ctx.prev_handle[i] == handle) {
+            return g_profiler_ctx.prev_run_time[i];
+        }
+    }
+    return 0;
+}
+
+static void profiler_sample_tasks(task_profile_t *profile)
+{
+    task_profiler_context_t *ctx = &g_profiler_ctx;
+    UBaseType_t total_tasks = uxTaskGetNumberOfTasks();
+    uint32_t total_run_time = 0;
+
+    // Needs room for every task, or it reports nothing
+    UBaseType_t count = 0;
+    if (total_tasks <= TASK_PROFILER_MAX_TASKS) {
+        count = uxTaskGetSystemState(ctx->status, TASK_PROFILER_MAX_TASKS, &total_run_time);
+    }
+    profile->tasks_skipped = (count == 0 && total_tasks > 0) ? (uint8_t)total_tasks : 0;
+
+    uint32_t elapsed = total_run_time - ctx->prev_total;
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t *status = &ctx->status[i];
+        task_profile_entry_t *entry = &profile->tasks[i];
+
+        strncpy(entry->name, status->pcTaskName, sizeof(entry->name) - 1);
+        entry->name[sizeof(entry->name) - 1] = '\0';
+        entry->priority = (uint8_t)status->uxCurrentPriority;
+        entry->stack_free = status->usStackHighWaterMark;
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        uint32_t used = status->ulRunTimeCounter - profiler_prev_run_time(status->xHandle);
+        uint64_t permille = elapsed ? ((uint64_t)used * 1000) / elapsed : 0;
+        entry->cpu_permille = (uint16_t)(permille > 1000 ? 1000 : permille);
+#else
+        entry->cpu_permille = 0;
+#endif
+
+        ctx->prev_handle[i] = status->xHandle;
+        ctx->prev_run_time[i] = status->ulRunTimeCounter;
+    }
+    ctx->prev_count = count;
+    ctx->prev_total = total_run_time;
+    profile->task_count = (uint8_t)count;
+}
+#endif
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+app_err_t task_profiler_sample(task_profile_t *profile)
+{
+    if (!profile) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    memset(profile, 0, sizeof(*profile));
+
+    uint32_t now_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+    profile->interval_ms = now_ms - g_profiler_ctx.prev_sample_ms;
+    g_profiler_ctx.prev_sample_ms = now_ms;
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    profiler_sample_tasks(profile);
+#endif
+    profiler_sample_heap(profile);
+    return APP_OK;
+}
+
+const task_profile_entry_t *task_profiler_busiest(const task_profile_t *profile)
+{
+    const task_profile_entry_t *busiest = NULL;
+
+    if (!profile) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < profile->task_count; i++) {
+        const task_profile_entry_t *entry = &profile->tasks[i];
+        if (strncmp(entry->name, "IDLE", 4) == 0) {
+            continue;
+        }
+        if (!busiest || entry->cpu_permille > busiest->cpu_permille) {
+            busiest = entry;
+        }
+    }
+    return busiest;
+}
+
+size_t task_profiler_to_json(const task_profile_t *profile, char *buffer, size_t size)
+{
+    if (!profile || !buffer) {
+        return 0;
+    }
+
+    telemetry_json_writer_t w;
+    telemetry_json_init(&w, buffer, size);
+
+    telemetry_json_begin_object(&w);
+    telemetry_json_key(&w, "type");
+    telemetry_json_string(&w, "tasks");
+    telemetry_json_key(&w, "interval_ms");
+    telemetry_json_uint(&w, profile->interval_ms);
+
+    telemetry_json_key(&w, "heap");
+    telemetry_json_begin_object(&w);
+    telemetry_json_key(&w, "free");
+    telemetry_json_uint(&w, profile->heap_free);
+    telemetry_json_key(&w, "min");
+    telemetry_json_uint(&w, profile->heap_min_free);
+    telemetry_json_key(&w, "largest");
+    telemetry_json_uint(&w, profile->heap_largest_block);
+    telemetry_json_key(&w, "frag");
+    telemetry_json_uint(&w, profile->heap_fragmentation);
+    telemetry_json_end_object(&w);
+
+    telemetry_json_key(&w, "tasks");
+    telemetry_json_begin_array(&w);
+    for (size_t i = 0; i < profile->task_count; i++) {
+        const task_profile_entry_t *entry = &profile->tasks[i];
+        telemetry_json_begin_array(&w);
+        telemetry_json_string(&w, entry->name);
+        telemetry_json_uint(&w, entry->priority);
+        telemetry_json_uint(&w, entry->cpu_permille);
+        telemetry_json_uint(&w, entry->stack_free);
+        telemetry_json_end_array(&w);
+    }
+    telemetry_json_end_array(&w);
+    telemetry_json_key(&w, "skipped");
+    telemetry_json_uint(&w, profile->tasks_skipped);
+    telemetry_json_end_object(&w);
+
+    return telemetry_json_finish(&w);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file telemetry_binary.h
+ * @brief Compact delta-encoded binary payload for sensor readings
+ * @version 2.0
+ *
+ * Frame layout (all integers are LEB128 varints, signed ones zigzag-encoded):
+ *
+ *   [version:u8]
+ *   [id][ts_ms][temp_x10:s][hum_x10:s]          first reading, absolute values
+ *   [id][dts_ms][dtemp_x10:s][dhum_x10:s] ...   next readings, delta to previous
+ *
+ * A single reading takes ~9 bytes, every further reading in the same frame
+ * ~5 bytes, versus ~45 bytes per reading for JSON. The reading count is
+ * implied by the frame length. Deltas are taken against the previous
+ * reading in the frame, whatever its sensor.
+ *
+ * Version 1 frames (no `[id]` field) are still decoded, with sensor_id 0.
+ *
+ * @note This header and telemetry_binary.c are shared with the Linux decoder
+ *       library in tools/telemetry_decoder, so keep them free of ESP-IDF
+ *       includes.
+ *
+ * Usage:
+    @code
+    ```c
+    telemetry_binary_reading_t readings[2] = { ... };
+    uint8_t buf[TELEMETRY_BINARY_MAX_SIZE(2)];
+    int len = telemetry_binary_encode(readings, 2, buf, sizeof(buf));
+
+    telemetry_binary_reading_t decoded[2];
+    int count = telemetry_binary_decode(buf, len, decoded, 2);
+    ```
+    @endcode
+ */
+
+#ifndef TELEMETRY_BINARY_H
+#define TELEMETRY_BINARY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+   FORMAT CONSTANTS
+   ============================================================================ */
+
+#define TELEMETRY_BINARY_VERSION        2   /**< Current frame version byte */
+#define TELEMETRY_BINARY_VERSION_V1     1   /**< Legacy frame without sensor IDs */
+#define TELEMETRY_BINARY_MAX_READING    22  /**< Worst-case bytes per reading (2+10+5+5) */
+
+/** Worst-case frame size for `n` readings */
+#define TELEMETRY_BINARY_MAX_SIZE(n)    (1 + (n) * TELEMETRY_BINARY_MAX_READING)
+
+/** @defgroup TELEMETRY_BINARY_ERRORS Binary codec error codes
+ * @{
+ */
+#define TELEMETRY_BINARY_ERR_PARAM      -1  /**< NULL pointer or zero count */
+#define TELEMETRY_BINARY_ERR_NO_SPACE   -2  /**< Output buffer too small */
+#define TELEMETRY_BINARY_ERR_VERSION    -3  /**< Unsupported frame version */
+#define TELEMETRY_BINARY_ERR_MALFORMED  -4  /**< Truncated or invalid frame */
+/** @} */
+
+/* ============================================================================
+   TYPES
+   ============================================================================ */
+
+/**
+ * @brief One reading as carried in a binary frame
+ *
+ * @note Temperature and humidity are transported in 0.1 units.
+ */
+typedef struct {
+    uint8_t sensor_id;      // Sensor on the device (0 for version 1 frames)
+    uint64_t timestamp_ms;  // Milliseconds since boot
+    float temperature;      // Celsius
+    float humidity;         // Percent
+} telemetry_binary_reading_t;
+
+/* ============================================================================
+   PUBLIC API
+   ============================================================================ */
+
+/**
+ * @brief Encode readings into one binary frame
+ * @param readings Readings in timestamp order (non-decreasing)
+ * @param count Number of readings (>= 1)
+ * @param buf Output buffer
+ * @param size Output buffer size, TELEMETRY_BINARY_MAX_SIZE(count) always fits
+ * @return Frame length in bytes, or negative TELEMETRY_BINARY_ERR_* code
+ */
+int telemetry_binary_encode(const telemetry_binary_reading_t *readings, size_t count,
+                            uint8_t *buf, size_t size);
+
+/**
+ * @brief Decode a binary frame
+ * @param buf Frame data
+ * @param len Frame length in bytes
+ * @param readings Output readings
+ * @param max_count Capacity of `readings`
+ * @return Number of readings decoded, or negative TELEMETRY_BINARY_ERR_* code
+ */
+int telemetry_binary_decode(const uint8_t *buf, size_t len,
+                            telemetry_binary_reading_t *readings, size_t max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_BINARY_H */
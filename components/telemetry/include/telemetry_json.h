@@ -0,0 +1,195 @@
+/**
+ * @file telemetry_json.h
+ * @brief Zero-allocation JSON encoder/decoder for telemetry and commands
+ * @version 2.0
+ *
+ * Streaming encoder for outbound sensor telemetry and an in-place decoder
+ * for inbound `{"type": "...", "value": N}` commands. Both work on
+ * caller-provided buffers and never touch the heap, so they are safe to
+ * call from the MQTT event handler and from tasks with small stacks.
+ *
+ * Usage:
+    @code
+    ```c
+    char buf[128];
+    telemetry_json_writer_t w;
+    telemetry_json_init(&w, buf, sizeof(buf));
+    telemetry_json_write_reading(&w, &reading);
+    size_t len = telemetry_json_finish(&w); // 0 on overflow
+
+    telemetry_command_t cmd;
+    if (telemetry_json_decode_command(data, data_len, &cmd) == APP_OK) {
+        printf("type=%.*s value=%ld\n", (int)cmd.type_len, cmd.type, cmd.value);
+    }
+    ```
+    @endcode
+ */
+
+#ifndef TELEMETRY_JSON_H
+#define TELEMETRY_JSON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "app_common.h"
+
+/* ============================================================================
+   ENCODER
+   ============================================================================ */
+
+#define TELEMETRY_JSON_FIXED1_MAX 100000000.0f /**< Largest magnitude telemetry_json_fixed1() writes */
+
+/**
+ * @brief Streaming JSON writer state
+ *
+ * @note Once `overflow` is set all further writes are ignored, so callers
+ *       only need to check the result of telemetry_json_finish().
+ */
+typedef struct {
+    char *buf;          // Caller-provided output buffer
+    size_t size;        // Buffer capacity (including NUL terminator)
+    size_t len;         // Bytes written so far
+    bool need_comma;    // Next value/key must be preceded by ','
+    bool overflow;      // Output did not fit in buffer
+} telemetry_json_writer_t;
+
+/**
+ * @brief Initialize writer on a caller-provided buffer
+ * @param w Writer state
+ * @param buf Output buffer
+ * @param size Output buffer size in bytes
+ */
+void telemetry_json_init(telemetry_json_writer_t *w, char *buf, size_t size);
+
+/**
+ * @brief Start a JSON object (`{`)
+ * @param w Writer state
+ */
+void telemetry_json_begin_object(telemetry_json_writer_t *w);
+
+/**
+ * @brief End a JSON object (`}`)
+ * @param w Writer state
+ */
+void telemetry_json_end_object(telemetry_json_writer_t *w);
+
+/**
+ * @brief Start a JSON array (`[`)
+ * @param w Writer state
+ */
+void telemetry_json_begin_array(telemetry_json_writer_t *w);
+
+/**
+ * @brief End a JSON array (`]`)
+ * @param w Writer state
+ */
+void telemetry_json_end_array(telemetry_json_writer_t *w);
+
+/**
+ * @brief Write an object key (must be followed by a value)
+ * @param w Writer state
+ * @param key Key name (written verbatim, must not need escaping)
+ */
+void telemetry_json_key(telemetry_json_writer_t *w, const char *key);
+
+/**
+ * @brief Write an unsigned integer value
+ * @param w Writer state
+ * @param value Value to write
+ */
+void telemetry_json_uint(telemetry_json_writer_t *w, uint64_t value);
+
+/**
+ * @brief Write a signed integer value
+ * @param w Writer state
+ * @param value Value to write
+ */
+void telemetry_json_int(telemetry_json_writer_t *w, int32_t value);
+
+/**
+ * @brief Write a float with one decimal place (e.g. 25.4)
+ * @param w Writer state
+ * @param value Value to write (rounded to nearest 0.1), `null` is written
+ *        for NaN, infinities and magnitudes above TELEMETRY_JSON_FIXED1_MAX
+ *
+ * @note Uses integer formatting, no printf/float formatting is pulled in.
+ */
+void telemetry_json_fixed1(telemetry_json_writer_t *w, float value);
+
+/**
+ * @brief Write a string value with JSON escaping
+ * @param w Writer state
+ * @param str NUL-terminated string
+ */
+void telemetry_json_string(telemetry_json_writer_t *w, const char *str);
+
+/**
+ * @brief Write a sensor reading as `{"id":...,"ts":...,"t":...,"h":...}`
+ * @param w Writer state
+ * @param reading Sensor reading
+ */
+void telemetry_json_write_reading(telemetry_json_writer_t *w, const sensor_data_t *reading);
+
+/**
+ * @brief NUL-terminate output and return its length
+ * @param w Writer state
+ * @return Payload length in bytes (excluding NUL), 0 if output overflowed
+ */
+size_t telemetry_json_finish(telemetry_json_writer_t *w);
+
+/* ============================================================================
+   DECODER
+   ============================================================================ */
+
+#define TELEMETRY_COMMAND_MAX_CHANGES 8 /**< Pairs in a `changes` array */
+
+/**
+ * @brief One `[channel, value]` pair of a `changes` array
+ */
+typedef struct {
+    int32_t channel;
+    int32_t value;
+} telemetry_command_change_t;
+
+/**
+ * @brief Decoded command, `type` points into the source buffer (not copied)
+ */
+typedef struct {
+    const char *type;   // Command type (NOT NUL-terminated)
+    size_t type_len;    // Length of command type
+    int32_t value;      // Command value (fraction truncated, saturated to int32), 0 if absent
+    int32_t channel;    // Optional `channel`, 0 if absent
+    size_t change_count;    // Pairs in `changes`
+    telemetry_command_change_t changes[TELEMETRY_COMMAND_MAX_CHANGES];
+    int32_t duration;   // Optional `duration` (seconds), 0 if absent
+    int32_t start;      // Optional `start` (minutes after midnight), 0 if absent
+    int32_t end;        // Optional `end` (minutes after midnight), 0 if absent
+    int32_t from;       // Optional `from` (seconds since boot), 0 if absent
+    int32_t to;         // Optional `to` (seconds since boot), 0 if absent
+} telemetry_command_t;
+
+/**
+ * @brief Decode `{"type": "<string>", "value": <number>}` in place
+ *
+ * Optional keys: `"channel": <number>` and `"changes": [[<channel>,
+ * <value>], ...]` (group commands, `value` may then be omitted), and the
+ * integer timing keys `"duration"`, `"start"` and `"end"` (scheduled
+ * commands) and `"from"` and `"to"` (time range queries).
+ * Unknown keys are skipped (including nested objects/arrays).
+ * The input does not need to be NUL-terminated.
+ *
+ * @param data JSON payload
+ * @param len Payload length in bytes
+ * @param cmd Output command
+ * @return `APP_OK` on success, error code otherwise
+ *
+ * @retval `APP_OK` Command decoded
+ * @retval `APP_ERR_INVALID_PARAM` NULL pointer or malformed JSON
+ * @retval `APP_ERR_INVALID_VALUE` Missing/mistyped `type` or `value`,
+ *         `type` contains escape sequences, mistyped `channel`, timing key
+ *         or pair, or
+ *         more than TELEMETRY_COMMAND_MAX_CHANGES pairs
+ */
+app_err_t telemetry_json_decode_command(const char *data, size_t len, telemetry_command_t *cmd);
+
+#endif /* TELEMETRY_JSON_H */
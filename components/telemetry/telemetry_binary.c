@@ -0,0 +1,193 @@
+/**
+ * @file telemetry_binary.c
+ * @brief Compact delta-encoded binary payload implementation
+ * @version 2.0
+ *
+ * Portable C, no ESP-IDF dependencies (also built for Linux by
+ * tools/telemetry_decoder).
+ */
+
+#include "telemetry_binary.h"
+#include <stdbool.h>
+
+/* ============================================================================
+   PRIVATE HELPERS
+   ============================================================================ */
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+} binary_writer_t;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+} binary_reader_t;
+
+static int32_t binary_to_tenths(float value)
+{
+    return (int32_t)(value * 10.0f + (value < 0.0f ? -0.5f : 0.5f));
+}
+
+static uint64_t binary_zigzag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t binary_unzigzag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static int binary_put_varint(binary_writer_t *w, uint64_t value)
+{
+    do {
+        if (w->len >= w->size) {
+            return TELEMETRY_BINARY_ERR_NO_SPACE;
+        }
+
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        w->buf[w->len++] = byte | (value ? 0x80 : 0x00);
+    } while (value);
+
+    return 0;
+}
+
+static int binary_get_varint(binary_reader_t *r, uint64_t *value)
+{
+    uint64_t result = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (r->pos >= r->len) {
+            return TELEMETRY_BINARY_ERR_MALFORMED;
+        }
+
+        uint8_t byte = r->buf[r->pos++];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 0;
+        }
+    }
+
+    return TELEMETRY_BINARY_ERR_MALFORMED;  // Varint longer than 10 bytes
+}
+
+/* ============================================================================
+   PUBLIC API
+   ============================================================================ */
+
+int telemetry_binary_encode(const telemetry_binary_reading_t *readings, size_t count,
+                            uint8_t *buf, size_t size)
+{
+    if (!readings || !buf || count == 0) {
+        return TELEMETRY_BINARY_ERR_PARAM;
+    }
+
+    binary_writer_t w = { .buf = buf, .size = size, .len = 0 };
+
+    if (size < 1) {
+        return TELEMETRY_BINARY_ERR_NO_SPACE;
+    }
+    buf[w.len++] = TELEMETRY_BINARY_VERSION;
+
+    uint64_t prev_ts = 0;
+    int32_t prev_temp = 0;
+    int32_t prev_hum = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        int32_t temp = binary_to_tenths(readings[i].temperature);
+        int32_t hum = binary_to_tenths(readings[i].humidity);
+        int ret = binary_put_varint(&w, readings[i].sensor_id);
+        if (ret != 0) {
+            return ret;
+        }
+
+        if (i == 0) {
+            ret = binary_put_varint(&w, readings[i].timestamp_ms);
+            if (ret == 0) ret = binary_put_varint(&w, binary_zigzag(temp));
+            if (ret == 0) ret = binary_put_varint(&w, binary_zigzag(hum));
+        } else {
+            if (readings[i].timestamp_ms < prev_ts) {
+                return TELEMETRY_BINARY_ERR_PARAM;
+            }
+            ret = binary_put_varint(&w, readings[i].timestamp_ms - prev_ts);
+            if (ret == 0) ret = binary_put_varint(&w, binary_zigzag((int64_t)temp - prev_temp));
+            if (ret == 0) ret = binary_put_varint(&w, binary_zigzag((int64_t)hum - prev_hum));
+        }
+
+        if (ret != 0) {
+            return ret;
+        }
+
+        prev_ts = readings[i].timestamp_ms;
+        prev_temp = temp;
+        prev_hum = hum;
+    }
+
+    return (int)w.len;
+}
+
+int telemetry_binary_decode(const uint8_t *buf, size_t len,
+                            telemetry_binary_reading_t *readings, size_t max_count)
+{
+    if (!buf || !readings) {
+        return TELEMETRY_BINARY_ERR_PARAM;
+    }
+
+    if (len < 1) {
+        return TELEMETRY_BINARY_ERR_MALFORMED;
+    }
+
+    if (buf[0] != TELEMETRY_BINARY_VERSION && buf[0] != TELEMETRY_BINARY_VERSION_V1) {
+        return TELEMETRY_BINARY_ERR_VERSION;
+    }
+
+    bool has_id = (buf[0] != TELEMETRY_BINARY_VERSION_V1);
+
+    binary_reader_t r = { .buf = buf, .len = len, .pos = 1 };
+    size_t count = 0;
+    uint64_t ts = 0;
+    int64_t temp = 0;
+    int64_t hum = 0;
+
+    while (r.pos < r.len) {
+        uint64_t f_id = 0, f_ts, f_temp, f_hum;
+
+        if ((has_id && binary_get_varint(&r, &f_id) != 0) ||
+            binary_get_varint(&r, &f_ts) != 0 ||
+            binary_get_varint(&r, &f_temp) != 0 ||
+            binary_get_varint(&r, &f_hum) != 0) {
+            return TELEMETRY_BINARY_ERR_MALFORMED;
+        }
+
+        if (count >= max_count) {
+            return TELEMETRY_BINARY_ERR_NO_SPACE;
+        }
+
+        if (f_id > UINT8_MAX) {
+            return TELEMETRY_BINARY_ERR_MALFORMED;
+        }
+
+        // First reading is absolute, the rest are deltas
+        ts += f_ts;
+        temp += binary_unzigzag(f_temp);
+        hum += binary_unzigzag(f_hum);
+
+        readings[count].sensor_id = (uint8_t)f_id;
+        readings[count].timestamp_ms = ts;
+        readings[count].temperature = (float)temp / 10.0f;
+        readings[count].humidity = (float)hum / 10.0f;
+        count++;
+    }
+
+    if (count == 0) {
+        return TELEMETRY_BINARY_ERR_MALFORMED;
+    }
+
+    return (int)count;
+}
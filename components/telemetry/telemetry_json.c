@@ -0,0 +1,593 @@
+/**
+ * @file telemetry_json.c
+ * @brief Zero-allocation JSON encoder/decoder implementation
+ * @version 2.0
+ *
+ * Replaces cJSON on the telemetry/command hot path:
+ * - No heap allocation (encoder writes into caller buffer,
+ *   decoder returns pointers into the source payload)
+ * - No float printf, readings are formatted as fixed-point
+ * - Decoder only understands the small command schema and skips the rest
+ */
+
+#include "telemetry_json.h"
+#include <string.h>
+#include <math.h>
+
+/* ============================================================================
+   ENCODER - PRIVATE HELPERS
+   ============================================================================ */
+
+static void json_put_char(telemetry_json_writer_t *w, char c)
+{
+    if (w->overflow) {
+        return;
+    }
+
+    // Always keep one byte for the NUL terminator
+    if (w->len + 1 >= w->size) {
+        w->overflow = true;
+        return;
+    }
+
+    w->buf[w->len++] = c;
+}
+
+static void json_put_raw(telemetry_json_writer_t *w, const char *str, size_t len)
+{
+    if (w->overflow) {
+        return;
+    }
+
+    if (w->len + len >= w->size) {
+        w->overflow = true;
+        return;
+    }
+
+    memcpy(w->buf + w->len, str, len);
+    w->len += len;
+}
+
+/**
+ * @brief Emit separator before a value or key when needed
+ */
+static void json_separate(telemetry_json_writer_t *w)
+{
+    if (w->need_comma) {
+        json_put_char(w, ',');
+    }
+    w->need_comma = false;
+}
+
+static void json_put_u64(telemetry_json_writer_t *w, uint64_t value)
+{
+    char digits[20];
+    size_t n = 0;
+
+    do {
+        digits[n++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value > 0);
+
+    while (n > 0) {
+        json_put_char(w, digits[--n]);
+    }
+}
+
+/* ============================================================================
+   ENCODER - PUBLIC API
+   ============================================================================ */
+
+void telemetry_json_init(telemetry_json_writer_t *w, char *buf, size_t size)
+{
+    w->buf = buf;
+    w->size = size;
+    w->len = 0;
+    w->need_comma = false;
+    w->overflow = (buf == NULL || size == 0);
+}
+
+void telemetry_json_begin_object(telemetry_json_writer_t *w)
+{
+    json_separate(w);
+    json_put_char(w, '{');
+}
+
+void telemetry_json_end_object(telemetry_json_writer_t *w)
+{
+    json_put_char(w, '}');
+    w->need_comma = true;
+}
+
+void telemetry_json_begin_array(telemetry_json_writer_t *w)
+{
+    json_separate(w);
+    json_put_char(w, '[');
+}
+
+void telemetry_json_end_array(telemetry_json_writer_t *w)
+{
+    json_put_char(w, ']');
+    w->need_comma = true;
+}
+
+void telemetry_json_key(telemetry_json_writer_t *w, const char *key)
+{
+    json_separate(w);
+    json_put_char(w, '"');
+    json_put_raw(w, key, strlen(key));
+    json_put_raw(w, "\":", 2);
+}
+
+void telemetry_json_uint(telemetry_json_writer_t *w, uint64_t value)
+{
+    json_separate(w);
+    json_put_u64(w, value);
+    w->need_comma = true;
+}
+
+void telemetry_json_int(telemetry_json_writer_t *w, int32_t value)
+{
+    json_separate(w);
+    if (value < 0) {
+        json_put_char(w, '-');
+        json_put_u64(w, (uint64_t)(-(int64_t)value));
+    } else {
+        json_put_u64(w, (uint64_t)value);
+    }
+    w->need_comma = true;
+}
+
+void telemetry_json_fixed1(telemetry_json_writer_t *w, float value)
+{
+    json_separate(w);
+
+    // No JSON number for NaN/inf, and the cast below needs tenths within int32
+    if (!isfinite(value) || fabsf(value) > TELEMETRY_JSON_FIXED1_MAX) {
+        json_put_raw(w, "null", 4);
+        w->need_comma = true;
+        return;
+    }
+
+    // Scale to tenths and round half away from zero
+    int32_t tenths = (int32_t)(value * 10.0f + (value < 0.0f ? -0.5f : 0.5f));
+    if (tenths < 0) {
+        json_put_char(w, '-');
+        tenths = -tenths;
+    }
+
+    json_put_u64(w, (uint64_t)(tenths / 10));
+    json_put_char(w, '.');
+    json_put_char(w, (char)('0' + (tenths % 10)));
+    w->need_comma = true;
+}
+
+void telemetry_json_string(telemetry_json_writer_t *w, const char *str)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    json_separate(w);
+    json_put_char(w, '"');
+
+    for (const char *p = str; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+
+        if (c == '"' || c == '\\') {
+            json_put_char(w, '\\');
+            json_put_char(w, (char)c);
+        } else if (c < 0x20) {
+            json_put_raw(w, "\\u00", 4);
+            json_put_char(w, hex[c >> 4]);
+            json_put_char(w, hex[c & 0x0F]);
+        } else {
+            json_put_char(w, (char)c);
+        }
+    }
+
+    json_put_char(w, '"');
+    w->need_comma = true;
+}
+
+void telemetry_json_write_reading(telemetry_json_writer_t *w, const sensor_data_t *reading)
+{
+    telemetry_json_begin_object(w);
+    telemetry_json_key(w, "id");
+    telemetry_json_uint(w, reading->sensor_id);
+    telemetry_json_key(w, "ts");
+    telemetry_json_uint(w, reading->timestamp_ms);
+    telemetry_json_key(w, "t");
+    telemetry_json_fixed1(w, reading->temperature);
+    telemetry_json_key(w, "h");
+    telemetry_json_fixed1(w, reading->humidity);
+    telemetry_json_end_object(w);
+}
+
+size_t telemetry_json_finish(telemetry_json_writer_t *w)
+{
+    if (w->overflow) {
+        if (w->buf && w->size > 0) {
+            w->buf[0] = '\0';
+        }
+        return 0;
+    }
+
+    w->buf[w->len] = '\0';
+    return w->len;
+}
+
+/* ============================================================================
+   DECODER - PRIVATE HELPERS
+   ============================================================================ */
+
+#define JSON_MAX_SKIP_DEPTH 8
+
+typedef struct {
+    const char *p;
+    const char *end;
+} json_cursor_t;
+
+static void json_skip_ws(json_cursor_t *c)
+{
+    while (c->p < c->end &&
+           (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) {
+        c->p++;
+    }
+}
+
+static bool json_expect(json_cursor_t *c, char ch)
+{
+    json_skip_ws(c);
+    if (c->p < c->end && *c->p == ch) {
+        c->p++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Scan a string token, returning its raw (still escaped) contents
+ * @param has_escape Set to true if the string contains backslash escapes
+ */
+static bool json_scan_string(json_cursor_t *c, const char **str, size_t *len, bool *has_escape)
+{
+    if (!json_expect(c, '"')) {
+        return false;
+    }
+
+    const char *start = c->p;
+    *has_escape = false;
+
+    while (c->p < c->end) {
+        char ch = *c->p;
+        if (ch == '"') {
+            *str = start;
+            *len = (size_t)(c->p - start);
+            c->p++;
+            return true;
+        }
+        if (ch == '\\') {
+            if (c->end - c->p < 2) {
+                return false;   // Backslash without escaped character
+            }
+            *has_escape = true;
+            c->p++;     // Skip escaped character
+        } else if ((unsigned char)ch < 0x20) {
+            return false;
+        }
+        c->p++;
+    }
+
+    return false;   // Unterminated string
+}
+
+/**
+ * @brief Scan a number, truncating fraction and saturating to int32
+ * @param is_integral Set to false if number has an exponent
+ */
+static bool json_scan_number(json_cursor_t *c, int32_t *value, bool *is_integral)
+{
+    json_skip_ws(c);
+
+    bool negative = false;
+    int64_t acc = 0;
+    bool digits = false;
+
+    if (c->p < c->end && *c->p == '-') {
+        negative = true;
+        c->p++;
+    }
+
+    while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+        if (acc <= INT32_MAX) {
+            acc = acc * 10 + (*c->p - '0');
+        }
+        digits = true;
+        c->p++;
+    }
+
+    if (!digits) {
+        return false;
+    }
+
+    // Fraction is accepted but truncated (same as cJSON valueint)
+    if (c->p < c->end && *c->p == '.') {
+        c->p++;
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            c->p++;
+        }
+    }
+
+    *is_integral = true;
+    if (c->p < c->end && (*c->p == 'e' || *c->p == 'E')) {
+        *is_integral = false;
+        c->p++;
+        if (c->p < c->end && (*c->p == '+' || *c->p == '-')) {
+            c->p++;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            c->p++;
+        }
+    }
+
+    if (negative) {
+        acc = -acc;
+    }
+    if (acc > INT32_MAX) {
+        acc = INT32_MAX;
+    } else if (acc < INT32_MIN) {
+        acc = INT32_MIN;
+    }
+
+    *value = (int32_t)acc;
+    return true;
+}
+
+static bool json_skip_literal(json_cursor_t *c, const char *lit)
+{
+    size_t n = strlen(lit);
+    if ((size_t)(c->end - c->p) < n || memcmp(c->p, lit, n) != 0) {
+        return false;
+    }
+    c->p += n;
+    return true;
+}
+
+/**
+ * @brief Skip any JSON value (used for unknown keys)
+ */
+static bool json_skip_value(json_cursor_t *c, int depth)
+{
+    if (depth > JSON_MAX_SKIP_DEPTH) {
+        return false;
+    }
+
+    json_skip_ws(c);
+    if (c->p >= c->end) {
+        return false;
+    }
+
+    const char *str;
+    size_t len;
+    bool flag;
+    int32_t num;
+
+    switch (*c->p) {
+    case '"':
+        return json_scan_string(c, &str, &len, &flag);
+
+    case '{':
+        c->p++;
+        if (json_expect(c, '}')) {
+            return true;
+        }
+        do {
+            if (!json_scan_string(c, &str, &len, &flag) ||
+                !json_expect(c, ':') ||
+                !json_skip_value(c, depth + 1)) {
+                return false;
+            }
+        } while (json_expect(c, ','));
+        return json_expect(c, '}');
+
+    case '[':
+        c->p++;
+        if (json_expect(c, ']')) {
+            return true;
+        }
+        do {
+            if (!json_skip_value(c, depth + 1)) {
+                return false;
+            }
+        } while (json_expect(c, ','));
+        return json_expect(c, ']');
+
+    case 't':
+        return json_skip_literal(c, "true");
+    case 'f':
+        return json_skip_literal(c, "false");
+    case 'n':
+        return json_skip_literal(c, "null");
+
+    default:
+        return json_scan_number(c, &num, &flag);
+    }
+}
+
+static bool json_at_number(const json_cursor_t *c)
+{
+    return c->p < c->end && (*c->p == '-' || (*c->p >= '0' && *c->p <= '9'));
+}
+
+/**
+ * @brief Scan an integer, a mistyped value is skipped and flagged in result
+ */
+static bool json_scan_int(json_cursor_t *c, int32_t *value, app_err_t *result)
+{
+    bool integral;
+
+    json_skip_ws(c);
+    if (!json_at_number(c)) {
+        *result = APP_ERR_INVALID_VALUE;
+        return json_skip_value(c, 1);
+    }
+    if (!json_scan_number(c, value, &integral)) {
+        return false;
+    }
+    if (!integral) {
+        *result = APP_ERR_INVALID_VALUE;
+    }
+    return true;
+}
+
+/**
+ * @brief Scan `[[channel, value], ...]` into cmd->changes
+ */
+static bool json_scan_changes(json_cursor_t *c, telemetry_command_t *cmd, app_err_t *result)
+{
+    if (!json_expect(c, '[')) {
+        return false;
+    }
+    if (json_expect(c, ']')) {
+        return true;
+    }
+
+    do {
+        int32_t pair[2] = {0, 0};
+        size_t n = 0;
+
+        if (!json_expect(c, '[')) {
+            *result = APP_ERR_INVALID_VALUE;
+            if (!json_skip_value(c, 1)) {
+                return false;
+            }
+            continue;
+        }
+        if (!json_expect(c, ']')) {
+            do {
+                int32_t extra;
+                if (!json_scan_int(c, (n < 2) ? &pair[n] : &extra, result)) {
+                    return false;
+                }
+                n++;
+            } while (json_expect(c, ','));
+            if (!json_expect(c, ']')) {
+                return false;
+            }
+        }
+
+        if (n != 2 || cmd->change_count >= TELEMETRY_COMMAND_MAX_CHANGES) {
+            *result = APP_ERR_INVALID_VALUE;
+            continue;
+        }
+        cmd->changes[cmd->change_count].channel = pair[0];
+        cmd->changes[cmd->change_count].value = pair[1];
+        cmd->change_count++;
+    } while (json_expect(c, ','));
+
+    return json_expect(c, ']');
+}
+
+/* ============================================================================
+   DECODER - PUBLIC API
+   ============================================================================ */
+
+app_err_t telemetry_json_decode_command(const char *data, size_t len, telemetry_command_t *cmd)
+{
+    if (!data || !cmd) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    json_cursor_t c = { .p = data, .end = data + len };
+    bool have_type = false;
+    bool have_value = false;
+    bool have_changes = false;
+    app_err_t result = APP_OK;
+
+    cmd->value = 0;
+    cmd->channel = 0;
+    cmd->change_count = 0;
+    cmd->duration = 0;
+    cmd->start = 0;
+    cmd->end = 0;
+    cmd->from = 0;
+    cmd->to = 0;
+
+    if (!json_expect(&c, '{')) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (!json_expect(&c, '}')) {
+        do {
+            const char *key;
+            size_t key_len;
+            bool escaped;
+
+            if (!json_scan_string(&c, &key, &key_len, &escaped) || !json_expect(&c, ':')) {
+                return APP_ERR_INVALID_PARAM;
+            }
+
+            json_skip_ws(&c);
+
+            if (key_len == 4 && memcmp(key, "type", 4) == 0 && c.p < c.end && *c.p == '"') {
+                if (!json_scan_string(&c, &cmd->type, &cmd->type_len, &escaped)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+                if (escaped) {
+                    result = APP_ERR_INVALID_VALUE;
+                }
+                have_type = true;
+            } else if (key_len == 5 && memcmp(key, "value", 5) == 0 && json_at_number(&c)) {
+                bool integral;
+                if (!json_scan_number(&c, &cmd->value, &integral)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+                if (!integral) {
+                    result = APP_ERR_INVALID_VALUE;
+                }
+                have_value = true;
+            } else if (key_len == 7 && memcmp(key, "channel", 7) == 0) {
+                if (!json_scan_int(&c, &cmd->channel, &result)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+            } else if (key_len == 8 && memcmp(key, "duration", 8) == 0) {
+                if (!json_scan_int(&c, &cmd->duration, &result)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+            } else if (key_len == 5 && memcmp(key, "start", 5) == 0) {
+                if (!json_scan_int(&c, &cmd->start, &result)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+            } else if (key_len == 3 && memcmp(key, "end", 3) == 0) {
+                if (!json_scan_int(&c, &cmd->end, &result)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+            } else if (key_len == 4 && memcmp(key, "from", 4) == 0) {
+                if (!json_scan_int(&c, &cmd->from, &result)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+            } else if (key_len == 2 && memcmp(key, "to", 2) == 0) {
+                if (!json_scan_int(&c, &cmd->to, &result)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+            } else if (key_len == 7 && memcmp(key, "changes", 7) == 0 &&
+                       c.p < c.end && *c.p == '[') {
+                if (!json_scan_changes(&c, cmd, &result)) {
+                    return APP_ERR_INVALID_PARAM;
+                }
+                have_changes = true;
+            } else if (!json_skip_value(&c, 0)) {
+                return APP_ERR_INVALID_PARAM;
+            }
+        } while (json_expect(&c, ','));
+
+        if (!json_expect(&c, '}')) {
+            return APP_ERR_INVALID_PARAM;
+        }
+    }
+
+    if (!have_type || (!have_value && !have_changes)) {
+        return APP_ERR_INVALID_VALUE;
+    }
+
+    return result;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file latency_hist.h
+ * @brief Fixed-bucket log-linear latency histogram (HDR-style)
+ * @version 2.0
+ *
+ * Microsecond values are counted in buckets whose width grows with the
+ * value: every power of two is split into LATENCY_HIST_SUB_COUNT equal
+ * buckets, so any recorded value is known to within 1/8 (12.5 %) from
+ * 1 us up to 16.7 s, in a fixed 176-bucket array. Recording is a few
+ * integer operations (count leading zeros, shift, mask), no search and
+ * no floating point.
+ *
+ * Layout (SUB_BITS = 3):
+ * - 0..7 us: one bucket per microsecond
+ * - 8..15 us: one bucket per microsecond
+ * - 16..31 us: 2 us wide, 32..63 us: 4 us wide, ...
+ * - Values of 2^24 us and above land in the last bucket
+ *
+ * Usage:
+    @code
+    ```c
+    static latency_hist_t hist;
+
+    latency_hist_record(&hist, end_us - start_us);
+
+    uint32_t p99 = latency_hist_percentile(&hist, 990);
+    ```
+    @endcode
+ *
+ * @note Not thread-safe. Writers and readers share one lock, recording is
+ *       short enough to do inside a critical section.
+ */
+
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+#define LATENCY_HIST_SUB_BITS   3                                   /**< Precision: 2^-3 */
+#define LATENCY_HIST_SUB_COUNT  (1u << LATENCY_HIST_SUB_BITS)       /**< Buckets per power of two */
+#define LATENCY_HIST_MAX_BITS   24                                  /**< Range: < 2^24 us (16.7 s) */
+#define LATENCY_HIST_BUCKETS    ((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1) * LATENCY_HIST_SUB_COUNT)
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Histogram of microsecond values
+ */
+typedef struct {
+    uint32_t buckets[LATENCY_HIST_BUCKETS];
+    uint32_t count;         // Values recorded
+    uint32_t max;           // Largest value (exact)
+    uint64_t total;         // Sum, total / count = mean
+} latency_hist_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Clear all counts
+ * @param hist Histogram
+ */
+void latency_hist_reset(latency_hist_t *hist);
+
+/**
+ * @brief Count one value
+ * @param hist Histogram
+ * @param value_us Value in microseconds
+ */
+void latency_hist_record(latency_hist_t *hist, uint32_t value_us);
+
+/**
+ * @brief Bucket a value is counted in
+ * @param value_us Value in microseconds
+ * @return Bucket index, < LATENCY_HIST_BUCKETS
+ */
+size_t latency_hist_bucket_index(uint32_t value_us);
+
+/**
+ * @brief Smallest value of a bucket
+ * @param index Bucket index
+ * @return Lower bound in microseconds (inclusive)
+ */
+uint32_t latency_hist_bucket_lower(size_t index);
+
+/**
+ * @brief Largest value of a bucket
+ * @param index Bucket index
+ * @return Upper bound in microseconds (inclusive), UINT32_MAX for the last
+ */
+uint32_t latency_hist_bucket_upper(size_t index);
+
+/**
+ * @brief Value at a percentile
+ *
+ * Reports the upper bound of the bucket holding the requested rank
+ * (never below the true value), capped at the recorded maximum.
+ *
+ * @param hist Histogram
+ * @param permille Percentile in tenths of a percent (500 = median, 999 = p99.9)
+ * @return Value in microseconds, 0 if the histogram is empty
+ */
+uint32_t latency_hist_percentile(const latency_hist_t *hist, uint32_t permille);
+
+#endif // LATENCY_HIST_H
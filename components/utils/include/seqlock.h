@@ -0,0 +1,130 @@
+/**
+ * @file seqlock.h
+ * @brief Sequence lock - lock-free consistent snapshots of small shared state
+ * @version 2.0
+ *
+ * A writer bumps the sequence to odd, updates the data and bumps it back
+ * to even. A reader copies the data between two reads of the sequence and
+ * retries if a write was in progress or happened meanwhile. Readers never
+ * block writers and nobody disables interrupts.
+ *
+ * Writers:
+ * - Suspend the scheduler of their core, so a reader on the same core can
+ *   not preempt a half-finished write and spin on it
+ * - Claim the odd sequence with a compare-and-swap, so a writer on the
+ *   other core waits for at most one short write
+ *
+ * Usage:
+    @code
+    ```c
+    static seqlock_t lock = SEQLOCK_INITIALIZER;
+    static shared_t shared;
+
+    // Writer (task)
+    seqlock_write_begin(&lock);
+    shared.a = a;
+    shared.b = b;
+    seqlock_write_end(&lock);
+
+    // Reader (task)
+    shared_t copy;
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&lock);
+        copy = shared;
+    } while (seqlock_read_retry(&lock, seq));
+    ```
+    @endcode
+ *
+ * @note Task context only. Keep the write section short: no logging, no
+ *       blocking calls.
+ * @note Readers must only copy the data inside the loop and use the copy
+ *       after it; a torn copy is discarded by the retry.
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Sequence lock, odd while a write is in progress
+ */
+typedef struct {
+    atomic_uint sequence;
+} seqlock_t;
+
+#define SEQLOCK_INITIALIZER { 0 }
+
+/* =========================================================================
+   WRITER
+   ========================================================================= */
+/**
+ * @brief Start a write section
+ * @param lock Lock
+ */
+static inline void seqlock_write_begin(seqlock_t *lock)
+{
+    vTaskSuspendAll();
+
+    unsigned int seq = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    do {
+        while (seq & 1u) {
+            // Writer on the other core, done within a few stores
+            seq = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&lock->sequence, &seq, seq + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    // Data stores must not move above the odd sequence
+    atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * @brief End a write section, publishing the data
+ * @param lock Lock
+ */
+static inline void seqlock_write_end(seqlock_t *lock)
+{
+    atomic_fetch_add_explicit(&lock->sequence, 1, memory_order_release);
+    xTaskResumeAll();
+}
+
+/* =========================================================================
+   READER
+   ========================================================================= */
+/**
+ * @brief Start a read attempt
+ * @param lock Lock
+ * @return Sequence to pass to seqlock_read_retry()
+ */
+static inline uint32_t seqlock_read_begin(const seqlock_t *lock)
+{
+    unsigned int seq;
+    while ((seq = atomic_load_explicit(&lock->sequence, memory_order_acquire)) & 1u) {
+        // Write in progress on the other core
+    }
+    return seq;
+}
+
+/**
+ * @brief Check whether a read attempt has to be repeated
+ * @param lock Lock
+ * @param seq Value from seqlock_read_begin()
+ * @return true if a write overlapped the read
+ */
+static inline bool seqlock_read_retry(const seqlock_t *lock, uint32_t seq)
+{
+    // Data loads must not move below the sequence check
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&lock->sequence, memory_order_relaxed) != seq;
+}
+
+#endif // SEQLOCK_H
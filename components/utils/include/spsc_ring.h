@@ -0,0 +1,139 @@
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free single-producer / single-consumer ring buffer
+ * @version 2.0
+ *
+ * Fixed-size items copied into caller-owned storage. One task pushes, one
+ * task pops, neither takes a lock or enters a critical section: each side
+ * owns one index and publishes it with a release store.
+ *
+ * Design:
+ * - Capacity is a power of two, free-running 32-bit indices are masked
+ *   (no modulo, all slots usable)
+ * - Producer and consumer indices live on separate cache lines so the
+ *   two sides do not invalidate each other's line on every operation
+ * - spsc_ring_pop_batch() drains everything available with at most two
+ *   memcpy() calls
+ * - A push into a full ring fails and is counted, it never overwrites
+ *
+ * Usage:
+    @code
+    ```c
+    static sensor_message_t storage[16];
+    static spsc_ring_t ring;
+    spsc_ring_init(&ring, storage, sizeof(storage[0]), 16);
+
+    // Producer task
+    if (!spsc_ring_push(&ring, &msg)) {
+        // Full, counted in spsc_ring_get_stats()
+    }
+
+    // Consumer task
+    sensor_message_t batch[8];
+    size_t n = spsc_ring_pop_batch(&ring, batch, 8);
+    ```
+    @endcode
+ *
+ * @note Exactly one producer and one consumer context. Several producers
+ *       must serialize their pushes (the consumer stays lock-free).
+ * @note The ring does not block. Pair it with a task notification when the
+ *       consumer has to sleep while the ring is empty.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+#define SPSC_RING_CACHE_LINE 64 /**< Covers ESP32-S3 (32 B) and host CPUs (64 B) */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Ring statistics
+ */
+typedef struct {
+    uint32_t capacity;      // Items
+    uint32_t count;         // Items waiting
+    uint32_t high_water;    // Most items ever waiting
+    uint32_t pushed;        // Items accepted since init
+    uint32_t overflows;     // Pushes rejected because the ring was full
+} spsc_ring_stats_t;
+
+/**
+ * @brief Ring instance (caller-owned, see spsc_ring_init())
+ */
+typedef struct {
+    // Producer side
+    _Alignas(SPSC_RING_CACHE_LINE) _Atomic uint32_t head;       // Next slot to write
+    _Atomic uint32_t overflows;
+    _Atomic uint32_t high_water;
+
+    // Consumer side
+    _Alignas(SPSC_RING_CACHE_LINE) _Atomic uint32_t tail;       // Next slot to read
+
+    // Read-only after init
+    _Alignas(SPSC_RING_CACHE_LINE) uint8_t *storage;
+    size_t item_size;
+    uint32_t mask;          // capacity - 1
+} spsc_ring_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Initialize an empty ring
+ *
+ * @param ring Ring to initialize
+ * @param storage Buffer of `capacity * item_size` bytes, must outlive the ring
+ * @param item_size Bytes per item
+ * @param capacity Number of items, a power of two
+ * @return true on success, false on invalid parameters
+ */
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, size_t item_size, uint32_t capacity);
+
+/**
+ * @brief Copy one item into the ring (producer only)
+ *
+ * @param ring Ring
+ * @param item Item of `item_size` bytes
+ * @return true if stored, false if the ring was full (counted as overflow)
+ */
+bool spsc_ring_push(spsc_ring_t *ring, const void *item);
+
+/**
+ * @brief Copy up to `max_items` of the oldest items out (consumer only)
+ *
+ * @param ring Ring
+ * @param items Output array of at least `max_items` items
+ * @param max_items Maximum items to pop
+ * @return Number of items popped, 0 if the ring is empty
+ */
+size_t spsc_ring_pop_batch(spsc_ring_t *ring, void *items, size_t max_items);
+
+/**
+ * @brief Number of items waiting
+ *
+ * Never more than are really waiting when called from the consumer,
+ * never fewer when called from the producer, a snapshot otherwise.
+ *
+ * @param ring Ring
+ * @return Items waiting
+ */
+uint32_t spsc_ring_count(const spsc_ring_t *ring);
+
+/**
+ * @brief Snapshot of the ring statistics (any task)
+ * @param ring Ring
+ * @param stats Output
+ */
+void spsc_ring_get_stats(const spsc_ring_t *ring, spsc_ring_stats_t *stats);
+
+#endif // SPSC_RING_H
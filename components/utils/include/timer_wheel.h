@@ -0,0 +1,141 @@
+/**
+ * @file timer_wheel.h
+ * @brief Hashed timer wheel - many timers on one tick source
+ * @version 2.0
+ *
+ * Timers are hashed by expiry tick into a fixed number of slots, each an
+ * intrusive doubly-linked list. Scheduling and cancelling are O(1), each
+ * tick only looks at one slot. One periodic esp_timer (or any tick
+ * source) drives any number of timers, no task or esp_timer per timer;
+ * a one-shot source can sleep until timer_wheel_next_expiry() instead.
+ *
+ * Design:
+ * - Timers store their absolute expiry tick, so delays longer than one
+ *   revolution need no round counter: a timer met early stays in its slot
+ * - Timers are caller-owned (static or embedded in a larger struct), the
+ *   wheel never allocates
+ * - Callbacks run from timer_wheel_advance() and may schedule or cancel
+ *   any timer, including the one firing
+ * - Advancing by a whole revolution or more visits every slot once, so a
+ *   late tick source catches up in bounded time
+ *
+ * Usage:
+    @code
+    ```c
+    static timer_wheel_t wheel;
+    static timer_wheel_timer_t relay_off;
+
+    timer_wheel_init(&wheel, now_tick);
+    timer_wheel_schedule(&wheel, &relay_off, 3000, on_relay_off, NULL);
+
+    // Tick source
+    timer_wheel_advance(&wheel, now_tick);
+    ```
+    @endcode
+ *
+ * @note Not thread-safe: serialize all calls on a wheel with one lock.
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* =========================================================================
+   CONSTANTS
+   ========================================================================= */
+#define TIMER_WHEEL_SLOTS 128   /**< Slots per revolution (power of two) */
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+typedef struct timer_wheel_timer timer_wheel_timer_t;
+
+/**
+ * @brief Expiry callback
+ * @param timer The timer that expired (no longer pending)
+ * @param arg Argument given to timer_wheel_schedule()
+ */
+typedef void (*timer_wheel_cb_t)(timer_wheel_timer_t *timer, void *arg);
+
+/**
+ * @brief One timer (caller-owned, zero-initialized before first use)
+ */
+struct timer_wheel_timer {
+    timer_wheel_timer_t *next;
+    timer_wheel_timer_t **pprev;    // Link pointing at this timer, NULL when not pending
+    uint64_t expires;               // Absolute tick
+    timer_wheel_cb_t callback;
+    void *arg;
+};
+
+/**
+ * @brief Wheel
+ */
+typedef struct {
+    timer_wheel_timer_t *slots[TIMER_WHEEL_SLOTS];
+    uint64_t now;                   // Last tick advanced to
+    size_t pending;                 // Timers scheduled
+} timer_wheel_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Initialize an empty wheel
+ * @param wheel Wheel
+ * @param now Current tick
+ */
+void timer_wheel_init(timer_wheel_t *wheel, uint64_t now);
+
+/**
+ * @brief Schedule (or reschedule) a timer
+ *
+ * @param wheel Wheel
+ * @param timer Timer, cancelled first if pending
+ * @param ticks Delay from the wheel's current tick (0 is treated as 1)
+ * @param callback Called on expiry
+ * @param arg Passed to the callback
+ */
+void timer_wheel_schedule(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint64_t ticks,
+                          timer_wheel_cb_t callback, void *arg);
+
+/**
+ * @brief Cancel a timer
+ * @param wheel Wheel
+ * @param timer Timer
+ * @return true if it was pending
+ */
+bool timer_wheel_cancel(timer_wheel_t *wheel, timer_wheel_timer_t *timer);
+
+/**
+ * @brief Check whether a timer is scheduled
+ * @param timer Timer
+ * @return true until it fires or is cancelled
+ */
+bool timer_wheel_is_pending(const timer_wheel_timer_t *timer);
+
+/**
+ * @brief Move the wheel to a tick, firing every timer due by then
+ *
+ * @param wheel Wheel
+ * @param now Current tick (ignored if not after the wheel's tick)
+ * @return Number of callbacks run
+ */
+size_t timer_wheel_advance(timer_wheel_t *wheel, uint64_t now);
+
+/**
+ * @brief Earliest expiry of the pending timers
+ *
+ * Walks every slot (O(TIMER_WHEEL_SLOTS + pending)), meant for re-arming
+ * a one-shot tick source, not for every tick.
+ *
+ * @param wheel Wheel
+ * @param expires Output: absolute tick of the next expiry
+ * @return true if a timer is pending
+ */
+bool timer_wheel_next_expiry(const timer_wheel_t *wheel, uint64_t *expires);
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,98 @@
+/**
+ * @file latency_hist.c
+ * @brief Fixed-bucket log-linear latency histogram (HDR-style)
+ * @version 2.0
+ *
+ * Indexing:
+ * - Values below SUB_COUNT map to themselves
+ * - Otherwise, with e the index of the top set bit, the group is
+ *   e - SUB_BITS + 1 and the sub-bucket is the SUB_BITS bits below the top
+ *   bit: index = group * SUB_COUNT + sub
+ * - Group g >= 1 covers [SUB_COUNT << (g - 1), SUB_COUNT << g) in buckets
+ *   1 << (g - 1) wide
+ */
+
+#include "latency_hist.h"
+#include <string.h>
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+void latency_hist_reset(latency_hist_t *hist)
+{
+    if (hist) {
+        memset(hist, 0, sizeof(*hist));
+    }
+}
+
+size_t latency_hist_bucket_index(uint32_t value_us)
+{
+    if (value_us < LATENCY_HIST_SUB_COUNT) {
+        return value_us;
+    }
+
+    uint32_t top_bit = 31u - (uint32_t)__builtin_clz(value_us);
+    if (top_bit >= LATENCY_HIST_MAX_BITS) {
+        return LATENCY_HIST_BUCKETS - 1;
+    }
+
+    uint32_t group = top_bit - LATENCY_HIST_SUB_BITS + 1;
+    uint32_t sub = (value_us >> (top_bit - LATENCY_HIST_SUB_BITS)) & (LATENCY_HIST_SUB_COUNT - 1);
+    return group * LATENCY_HIST_SUB_COUNT + sub;
+}
+
+uint32_t latency_hist_bucket_lower(size_t index)
+{
+    if (index < LATENCY_HIST_SUB_COUNT) {
+        return (uint32_t)index;
+    }
+
+    uint32_t group = (uint32_t)(index / LATENCY_HIST_SUB_COUNT);
+    uint32_t sub = (uint32_t)(index % LATENCY_HIST_SUB_COUNT);
+    return (LATENCY_HIST_SUB_COUNT + sub) << (group - 1);
+}
+
+uint32_t latency_hist_bucket_upper(size_t index)
+{
+    if (index >= LATENCY_HIST_BUCKETS - 1) {
+        return UINT32_MAX;
+    }
+    return latency_hist_bucket_lower(index + 1) - 1;
+}
+
+void latency_hist_record(latency_hist_t *hist, uint32_t value_us)
+{
+    hist->buckets[latency_hist_bucket_index(value_us)]++;
+    hist->count++;
+    hist->total += value_us;
+    if (value_us > hist->max) {
+        hist->max = value_us;
+    }
+}
+
+uint32_t latency_hist_percentile(const latency_hist_t *hist, uint32_t permille)
+{
+    if (!hist || hist->count == 0) {
+        return 0;
+    }
+    if (permille > 1000) {
+        permille = 1000;
+    }
+
+    // Rank of the requested value, 1-based
+    uint64_t rank = ((uint64_t)hist->count * permille + 999) / 1000;
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = latency_hist_bucket_upper(i);
+            return (upper < hist->max) ? upper : hist->max;
+        }
+    }
+    return hist->max;
+}
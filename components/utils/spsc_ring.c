@@ -0,0 +1,105 @@
+/**
+ * @file spsc_ring.c
+ * @brief Lock-free single-producer / single-consumer ring buffer
+ * @version 2.0
+ *
+ * Ordering:
+ * - The producer copies the item, then publishes `head` with release; the
+ *   consumer reads `head` with acquire before copying, so it never sees a
+ *   half-written slot
+ * - The consumer copies items out, then publishes `tail` with release; the
+ *   producer reads `tail` with acquire, so a slot is never overwritten
+ *   while it is being read
+ * - Each side reads its own index relaxed, only it writes it
+ */
+
+#include "spsc_ring.h"
+#include <string.h>
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, size_t item_size, uint32_t capacity)
+{
+    if (!ring || !storage || item_size == 0 || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->overflows, 0);
+    atomic_init(&ring->high_water, 0);
+    atomic_init(&ring->tail, 0);
+    ring->storage = (uint8_t *)storage;
+    ring->item_size = item_size;
+    ring->mask = capacity - 1;
+    return true;
+}
+
+bool spsc_ring_push(spsc_ring_t *ring, const void *item)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t count = head - tail;
+
+    if (count > ring->mask) {
+        atomic_fetch_add_explicit(&ring->overflows, 1, memory_order_relaxed);
+        return false;
+    }
+
+    memcpy(ring->storage + (size_t)(head & ring->mask) * ring->item_size, item, ring->item_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    // Producer-owned, no read-modify-write needed
+    if (count + 1 > atomic_load_explicit(&ring->high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&ring->high_water, count + 1, memory_order_relaxed);
+    }
+    return true;
+}
+
+size_t spsc_ring_pop_batch(spsc_ring_t *ring, void *items, size_t max_items)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    size_t count = head - tail;
+    if (count > max_items) {
+        count = max_items;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    // At most two copies: up to the end of storage, then from its start
+    uint32_t capacity = ring->mask + 1;
+    uint32_t start = tail & ring->mask;
+    size_t first = (count < capacity - start) ? count : capacity - start;
+
+    memcpy(items, ring->storage + (size_t)start * ring->item_size, first * ring->item_size);
+    if (count > first) {
+        memcpy((uint8_t *)items + first * ring->item_size, ring->storage,
+               (count - first) * ring->item_size);
+    }
+
+    atomic_store_explicit(&ring->tail, tail + (uint32_t)count, memory_order_release);
+    return count;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t *ring)
+{
+    // Tail first: head only moves forward, so the difference never underflows
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t count = head - tail;
+    return (count > ring->mask + 1) ? ring->mask + 1 : count;
+}
+
+void spsc_ring_get_stats(const spsc_ring_t *ring, spsc_ring_stats_t *stats)
+{
+    stats->capacity = ring->mask + 1;
+    stats->count = spsc_ring_count(ring);
+    stats->high_water = atomic_load_explicit(&ring->high_water, memory_order_relaxed);
+    stats->pushed = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    stats->overflows = atomic_load_explicit(&ring->overflows, memory_order_relaxed);
+}
@@ -0,0 +1,159 @@
+/**
+ * @file timer_wheel.c
+ * @brief Hashed timer wheel - many timers on one tick source
+ * @version 2.0
+ *
+ * A timer lives in slot `expires % TIMER_WHEEL_SLOTS`. Visiting a slot
+ * detaches its list first: callbacks can then schedule into that slot, or
+ * cancel timers still waiting in the detached list, without disturbing
+ * the walk. Timers not yet due go back into the slot.
+ */
+
+#include "timer_wheel.h"
+#include <string.h>
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+
+_Static_assert((TIMER_WHEEL_SLOTS & TIMER_WHEEL_MASK) == 0, "slot count must be a power of two");
+
+/* =========================================================================
+   HELPER FUNCTIONS
+   ========================================================================= */
+
+static void timer_link(timer_wheel_timer_t **head, timer_wheel_timer_t *timer)
+{
+    timer->next = *head;
+    if (timer->next) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+}
+
+static void timer_unlink(timer_wheel_timer_t *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/**
+ * @brief Fire the timers of one slot that are due by `due`
+ */
+static size_t timer_wheel_run_slot(timer_wheel_t *wheel, size_t slot, uint64_t due)
+{
+    timer_wheel_timer_t *detached = wheel->slots[slot];
+    size_t fired = 0;
+
+    wheel->slots[slot] = NULL;
+    if (detached) {
+        detached->pprev = &detached;
+    }
+
+    while (detached) {
+        timer_wheel_timer_t *timer = detached;
+        timer_unlink(timer);
+
+        if (timer->expires > due) {
+            timer_link(&wheel->slots[slot], timer);
+            continue;
+        }
+
+        wheel->pending--;
+        fired++;
+        timer->callback(timer, timer->arg);
+    }
+    return fired;
+}
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+
+void timer_wheel_init(timer_wheel_t *wheel, uint64_t now)
+{
+    if (!wheel) {
+        return;
+    }
+
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now = now;
+}
+
+void timer_wheel_schedule(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint64_t ticks,
+                          timer_wheel_cb_t callback, void *arg)
+{
+    if (!wheel || !timer || !callback) {
+        return;
+    }
+
+    timer_wheel_cancel(wheel, timer);
+
+    timer->expires = wheel->now + (ticks ? ticks : 1);
+    timer->callback = callback;
+    timer->arg = arg;
+    timer_link(&wheel->slots[timer->expires & TIMER_WHEEL_MASK], timer);
+    wheel->pending++;
+}
+
+bool timer_wheel_cancel(timer_wheel_t *wheel, timer_wheel_timer_t *timer)
+{
+    if (!wheel || !timer_wheel_is_pending(timer)) {
+        return false;
+    }
+
+    timer_unlink(timer);
+    wheel->pending--;
+    return true;
+}
+
+bool timer_wheel_is_pending(const timer_wheel_timer_t *timer)
+{
+    return timer && timer->pprev != NULL;
+}
+
+size_t timer_wheel_advance(timer_wheel_t *wheel, uint64_t now)
+{
+    if (!wheel || now <= wheel->now) {
+        return 0;
+    }
+
+    size_t fired = 0;
+
+    if (now - wheel->now >= TIMER_WHEEL_SLOTS) {
+        // Catch up: every slot once, everything due by now fires
+        uint64_t from = wheel->now;
+        wheel->now = now;
+        for (uint64_t tick = from + 1; tick <= from + TIMER_WHEEL_SLOTS; tick++) {
+            fired += timer_wheel_run_slot(wheel, tick & TIMER_WHEEL_MASK, now);
+        }
+        return fired;
+    }
+
+    while (wheel->now < now) {
+        wheel->now++;
+        fired += timer_wheel_run_slot(wheel, wheel->now & TIMER_WHEEL_MASK, wheel->now);
+    }
+    return fired;
+}
+
+bool timer_wheel_next_expiry(const timer_wheel_t *wheel, uint64_t *expires)
+{
+    if (!wheel || !expires || wheel->pending == 0) {
+        return false;
+    }
+
+    bool found = false;
+    for (size_t slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+        for (const timer_wheel_timer_t *timer = wheel->slots[slot]; timer; timer = timer->next) {
+            if (!found || timer->expires < *expires) {
+                *expires = timer->expires;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file app_wifi_host.c
+ * @brief Host replacement of app_wifi.c - the network is always up
+ * @version 2.0
+ *
+ * The host build has no esp_wifi/esp_netif. This file implements the
+ * app_wifi.h API directly: init reports the connection from a short-lived
+ * task (like the IP_EVENT_STA_GOT_IP handler would) and the loopback MQTT
+ * client takes over from there.
+ */
+
+#include "app_wifi.h"
+#include "app_common.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "WIFI";
+
+#define HOST_WIFI_RSSI          -55
+#define HOST_WIFI_IP            "127.0.0.1"
+
+typedef struct {
+    app_wifi_config_t config;
+    bool initialized;
+    bool connected;
+} host_wifi_context_t;
+
+static host_wifi_context_t g_wifi_ctx = {0};
+
+static void wifi_connect_task(void *arg)
+{
+    (void)arg;
+
+    vTaskDelay(pdMS_TO_TICKS(10));
+    g_wifi_ctx.connected = true;
+    APP_LOG_INFO(TAG, "Connected (host loopback), IP %s", HOST_WIFI_IP);
+
+    if (g_wifi_ctx.config.on_connected) {
+        g_wifi_ctx.config.on_connected();
+    }
+    vTaskDelete(NULL);
+}
+
+app_err_t app_wifi_init(const app_wifi_config_t *config)
+{
+    if (!config) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (g_wifi_ctx.initialized) {
+        return APP_OK;
+    }
+
+    g_wifi_ctx.config = *config;
+    g_wifi_ctx.initialized = true;
+
+    if (xTaskCreate(wifi_connect_task, "wifi_connect", 2048, NULL, 5, NULL) != pdPASS) {
+        return APP_ERR_NO_MEMORY;
+    }
+    return APP_OK;
+}
+
+bool app_wifi_is_connected(void)
+{
+    return g_wifi_ctx.connected;
+}
+
+int8_t app_wifi_get_rssi(void)
+{
+    return g_wifi_ctx.connected ? HOST_WIFI_RSSI : 0;
+}
+
+app_err_t app_wifi_get_ip_address(char *ip_str, size_t max_len)
+{
+    if (!ip_str || max_len < sizeof(HOST_WIFI_IP)) {
+        return APP_ERR_INVALID_PARAM;
+    }
+
+    if (!g_wifi_ctx.connected) {
+        return APP_ERR_WIFI_CONNECT;
+    }
+
+    strcpy(ip_str, HOST_WIFI_IP);
+    return APP_OK;
+}
+
+app_err_t app_wifi_disconnect(void)
+{
+    bool was_connected = g_wifi_ctx.connected;
+    g_wifi_ctx.connected = false;
+
+    if (was_connected && g_wifi_ctx.config.on_disconnected) {
+        g_wifi_ctx.config.on_disconnected();
+    }
+    return APP_OK;
+}
+
+const char* app_wifi_get_status_string(void)
+{
+    if (!g_wifi_ctx.initialized) {
+        return "INIT";
+    }
+    return g_wifi_ctx.connected ? "CONNECTED" : "DISCONNECTED";
+}
@@ -0,0 +1,139 @@
+// host/hal/esp_partition.c
+// Data partitions from partitions.csv held in RAM with NOR flash rules:
+// erase sets whole sectors to 0xFF, writes can only clear bits.
+
+#include <pthread.h>
+#include <string.h>
+#include "host_internal.h"
+#include "esp_partition.h"
+
+#define HOST_FLASH_SECTOR_SIZE  4096
+
+typedef struct {
+    esp_partition_t info;
+    uint8_t *data;
+} host_partition_t;
+
+static host_partition_t g_partitions[] = {
+    {
+        .info = {
+            .type = ESP_PARTITION_TYPE_DATA,
+            .subtype = (esp_partition_subtype_t)0x40,
+            .address = 0x310000,
+            .size = 0x40000,
+            .erase_size = HOST_FLASH_SECTOR_SIZE,
+            .label = "sensor_log",
+        },
+    },
+};
+
+#define HOST_PARTITION_COUNT (sizeof(g_partitions) / sizeof(g_partitions[0]))
+
+static pthread_mutex_t g_partition_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static host_partition_t *partition_lookup(const esp_partition_t *partition)
+{
+    for (size_t i = 0; i < HOST_PARTITION_COUNT; i++) {
+        if (&g_partitions[i].info == partition) {
+            return &g_partitions[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Backing store of a partition, erased on first use
+ */
+static uint8_t *partition_data(host_partition_t *p)
+{
+    if (!p->data) {
+        p->data = malloc(p->info.size);
+        if (p->data) {
+            memset(p->data, 0xFF, p->info.size);
+        }
+    }
+    return p->data;
+}
+
+void host_partition_reset(void)
+{
+    pthread_mutex_lock(&g_partition_lock);
+    for (size_t i = 0; i < HOST_PARTITION_COUNT; i++) {
+        if (g_partitions[i].data) {
+            memset(g_partitions[i].data, 0xFF, g_partitions[i].info.size);
+        }
+    }
+    pthread_mutex_unlock(&g_partition_lock);
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    for (size_t i = 0; i < HOST_PARTITION_COUNT; i++) {
+        const esp_partition_t *info = &g_partitions[i].info;
+        if (info->type == type &&
+            (subtype == ESP_PARTITION_SUBTYPE_ANY || info->subtype == subtype) &&
+            (!label || strcmp(info->label, label) == 0)) {
+            return info;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset,
+                             void *dst, size_t size)
+{
+    host_partition_t *p = partition_lookup(partition);
+    if (!p || !dst || src_offset > p->info.size || size > p->info.size - src_offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_partition_lock);
+    uint8_t *data = partition_data(p);
+    if (data) {
+        memcpy(dst, data + src_offset, size);
+    }
+    pthread_mutex_unlock(&g_partition_lock);
+    return data ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset,
+                              const void *src, size_t size)
+{
+    host_partition_t *p = partition_lookup(partition);
+    if (!p || !src || dst_offset > p->info.size || size > p->info.size - dst_offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_partition_lock);
+    uint8_t *data = partition_data(p);
+    if (data) {
+        const uint8_t *bytes = src;
+        for (size_t i = 0; i < size; i++) {
+            data[dst_offset + i] &= bytes[i];
+        }
+    }
+    pthread_mutex_unlock(&g_partition_lock);
+    return data ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset,
+                                    size_t size)
+{
+    host_partition_t *p = partition_lookup(partition);
+    if (!p || offset > p->info.size || size > p->info.size - offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (offset % p->info.erase_size != 0 || size % p->info.erase_size != 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    pthread_mutex_lock(&g_partition_lock);
+    uint8_t *data = partition_data(p);
+    if (data) {
+        memset(data + offset, 0xFF, size);
+    }
+    pthread_mutex_unlock(&g_partition_lock);
+    return data ? ESP_OK : ESP_ERR_NO_MEM;
+}
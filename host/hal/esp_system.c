@@ -0,0 +1,70 @@
+// host/hal/esp_system.c
+// Heap capabilities on malloc and fixed heap figures in the range of an
+// ESP32 with 4 MB PSRAM, so the monitor output stays meaningful.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "host_internal.h"
+#include "host_hal.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+
+#define HOST_INTERNAL_HEAP_FREE     (200 * 1024)
+#define HOST_SPIRAM_HEAP_FREE       (4 * 1024 * 1024)
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    (void)caps;
+    return calloc(n, size);
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? HOST_SPIRAM_HEAP_FREE : HOST_INTERNAL_HEAP_FREE;
+}
+
+size_t heap_caps_get_total_size(uint32_t caps)
+{
+    return heap_caps_get_free_size(caps);
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return heap_caps_get_free_size(caps);
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return HOST_INTERNAL_HEAP_FREE;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return HOST_INTERNAL_HEAP_FREE;
+}
+
+void esp_restart(void)
+{
+    fprintf(stderr, "esp_restart() called, exiting\n");
+    exit(0);
+}
+
+void host_hal_reset(void)
+{
+    host_gpio_reset();
+    host_ledc_reset();
+    host_nvs_reset();
+    host_partition_reset();
+    host_mqtt_reset();
+}
@@ -0,0 +1,204 @@
+// host/hal/esp_timer.c
+// esp_timer on CLOCK_MONOTONIC: armed timers sit in a list sorted by
+// expiry, one dispatch thread runs the callbacks (like ESP_TIMER_TASK).
+
+#include <pthread.h>
+#include <stdlib.h>
+#include "host_internal.h"
+#include "esp_timer.h"
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    uint64_t expiry_us;
+    uint64_t period_us;             // 0 = one-shot
+    bool armed;
+    struct esp_timer *next;
+};
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    pthread_t thread;
+    bool started;
+    struct esp_timer *armed;        // Sorted by expiry_us
+} host_timer_context_t;
+
+static host_timer_context_t g_timer_ctx = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static void timer_unlink(struct esp_timer *timer)
+{
+    for (struct esp_timer **p = &g_timer_ctx.armed; *p; p = &(*p)->next) {
+        if (*p == timer) {
+            *p = timer->next;
+            break;
+        }
+    }
+    timer->armed = false;
+}
+
+static void timer_insert(struct esp_timer *timer)
+{
+    struct esp_timer **p = &g_timer_ctx.armed;
+    while (*p && (*p)->expiry_us <= timer->expiry_us) {
+        p = &(*p)->next;
+    }
+    timer->next = *p;
+    *p = timer;
+    timer->armed = true;
+    pthread_cond_signal(&g_timer_ctx.changed);
+}
+
+static void *timer_dispatch(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&g_timer_ctx.lock);
+    for (;;) {
+        struct esp_timer *timer = g_timer_ctx.armed;
+        if (!timer) {
+            pthread_cond_wait(&g_timer_ctx.changed, &g_timer_ctx.lock);
+            continue;
+        }
+
+        if (timer->expiry_us > host_time_us()) {
+            if (host_time_is_frozen()) {
+                // Only host_clock_advance_us()/host_clock_release() move time on
+                pthread_cond_wait(&g_timer_ctx.changed, &g_timer_ctx.lock);
+            } else {
+                struct timespec deadline;
+                host_time_to_timespec(timer->expiry_us, &deadline);
+                pthread_cond_timedwait(&g_timer_ctx.changed, &g_timer_ctx.lock, &deadline);
+            }
+            continue;
+        }
+
+        timer_unlink(timer);
+        if (timer->period_us > 0) {
+            timer->expiry_us += timer->period_us;
+            timer_insert(timer);
+        }
+
+        // The callback may start or stop timers
+        esp_timer_cb_t callback = timer->callback;
+        void *cb_arg = timer->arg;
+        pthread_mutex_unlock(&g_timer_ctx.lock);
+        callback(cb_arg);
+        pthread_mutex_lock(&g_timer_ctx.lock);
+    }
+    return NULL;
+}
+
+void host_timer_kick(void)
+{
+    pthread_mutex_lock(&g_timer_ctx.lock);
+    if (g_timer_ctx.started) {
+        pthread_cond_signal(&g_timer_ctx.changed);
+    }
+    pthread_mutex_unlock(&g_timer_ctx.lock);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)host_time_us();
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle)
+{
+    if (!args || !args->callback || !out_handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct esp_timer *timer = calloc(1, sizeof(*timer));
+    if (!timer) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+
+    pthread_mutex_lock(&g_timer_ctx.lock);
+    if (!g_timer_ctx.started) {
+        host_cond_init(&g_timer_ctx.changed);
+        if (pthread_create(&g_timer_ctx.thread, NULL, timer_dispatch, NULL) != 0) {
+            pthread_mutex_unlock(&g_timer_ctx.lock);
+            free(timer);
+            return ESP_FAIL;
+        }
+        pthread_detach(g_timer_ctx.thread);
+        g_timer_ctx.started = true;
+    }
+    pthread_mutex_unlock(&g_timer_ctx.lock);
+
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t timer_start(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_timer_ctx.lock);
+    if (timer->armed) {
+        pthread_mutex_unlock(&g_timer_ctx.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->expiry_us = host_time_us() + timeout_us;
+    timer->period_us = period_us;
+    timer_insert(timer);
+    pthread_mutex_unlock(&g_timer_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return timer_start(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    return timer_start(timer, period_us, period_us);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_timer_ctx.lock);
+    esp_err_t ret = timer->armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+    if (timer->armed) {
+        timer_unlink(timer);
+        pthread_cond_signal(&g_timer_ctx.changed);
+    }
+    pthread_mutex_unlock(&g_timer_ctx.lock);
+    return ret;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_timer_ctx.lock);
+    if (timer->armed) {
+        pthread_mutex_unlock(&g_timer_ctx.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    pthread_mutex_unlock(&g_timer_ctx.lock);
+    free(timer);
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    pthread_mutex_lock(&g_timer_ctx.lock);
+    bool armed = timer && timer->armed;
+    pthread_mutex_unlock(&g_timer_ctx.lock);
+    return armed;
+}
@@ -0,0 +1,684 @@
+// host/hal/freertos_posix.c
+// FreeRTOS subset on POSIX threads: tasks, notifications, queues,
+// semaphores, event groups, critical sections and the tick clock.
+//
+// Scheduling is left to the OS, priorities are recorded but not enforced.
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "host_internal.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+/* ============================================================================
+   CLOCK
+   ============================================================================ */
+
+static struct timespec g_start_time;
+
+// Virtual clock: host_time_us() = real time + offset, or a fixed value while frozen
+static pthread_mutex_t g_clock_lock = PTHREAD_MUTEX_INITIALIZER;
+static int64_t g_clock_offset_us = 0;
+static bool g_clock_frozen = false;
+static uint64_t g_clock_frozen_us = 0;
+
+__attribute__((constructor))
+static void host_clock_init(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &g_start_time);
+}
+
+static uint64_t host_real_time_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - g_start_time.tv_sec) * 1000000ULL +
+           (uint64_t)((now.tv_nsec - g_start_time.tv_nsec) / 1000);
+}
+
+uint64_t host_time_us(void)
+{
+    pthread_mutex_lock(&g_clock_lock);
+    uint64_t now = g_clock_frozen ? g_clock_frozen_us
+                                  : (uint64_t)((int64_t)host_real_time_us() + g_clock_offset_us);
+    pthread_mutex_unlock(&g_clock_lock);
+    return now;
+}
+
+bool host_time_is_frozen(void)
+{
+    pthread_mutex_lock(&g_clock_lock);
+    bool frozen = g_clock_frozen;
+    pthread_mutex_unlock(&g_clock_lock);
+    return frozen;
+}
+
+void host_time_to_timespec(uint64_t time_us, struct timespec *ts)
+{
+    pthread_mutex_lock(&g_clock_lock);
+    int64_t real_us = (int64_t)time_us - g_clock_offset_us;
+    pthread_mutex_unlock(&g_clock_lock);
+    if (real_us < 0) {
+        real_us = 0;
+    }
+
+    uint64_t nsec = (uint64_t)g_start_time.tv_nsec + ((uint64_t)real_us % 1000000ULL) * 1000ULL;
+    ts->tv_sec = g_start_time.tv_sec + (time_t)((uint64_t)real_us / 1000000ULL) + (time_t)(nsec / 1000000000ULL);
+    ts->tv_nsec = (long)(nsec % 1000000000ULL);
+}
+
+void host_clock_freeze(void)
+{
+    pthread_mutex_lock(&g_clock_lock);
+    if (!g_clock_frozen) {
+        g_clock_frozen_us = (uint64_t)((int64_t)host_real_time_us() + g_clock_offset_us);
+        g_clock_frozen = true;
+    }
+    pthread_mutex_unlock(&g_clock_lock);
+}
+
+void host_clock_advance_us(uint64_t us)
+{
+    pthread_mutex_lock(&g_clock_lock);
+    g_clock_offset_us += (int64_t)us;
+    g_clock_frozen_us += us;
+    pthread_mutex_unlock(&g_clock_lock);
+    host_timer_kick();
+}
+
+void host_clock_release(void)
+{
+    pthread_mutex_lock(&g_clock_lock);
+    if (g_clock_frozen) {
+        // Resume from the frozen value: time stood still while frozen
+        g_clock_offset_us = (int64_t)g_clock_frozen_us - (int64_t)host_real_time_us();
+        g_clock_frozen = false;
+    }
+    pthread_mutex_unlock(&g_clock_lock);
+    host_timer_kick();
+}
+
+bool host_deadline(TickType_t ticks, struct timespec *deadline)
+{
+    if (ticks == portMAX_DELAY) {
+        return false;
+    }
+    host_time_to_timespec(host_time_us() + (uint64_t)pdTICKS_TO_MS(ticks) * 1000ULL, deadline);
+    return true;
+}
+
+void host_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/**
+ * @brief Wait on `cond` until signalled or the deadline passes
+ * @return false on timeout
+ */
+static bool host_cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock,
+                           bool timed, const struct timespec *deadline)
+{
+    if (!timed) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+/* ============================================================================
+   CRITICAL SECTIONS
+   ============================================================================ */
+
+static pthread_mutex_t g_critical_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+void host_critical_enter(void)
+{
+    pthread_mutex_lock(&g_critical_lock);
+}
+
+void host_critical_exit(void)
+{
+    pthread_mutex_unlock(&g_critical_lock);
+}
+
+/* ============================================================================
+   TASKS
+   ============================================================================ */
+
+struct tskTaskControlBlock {
+    pthread_t thread;
+    UBaseType_t number;
+    char name[configMAX_TASK_NAME_LEN];
+    TaskFunction_t function;
+    void *param;
+    uint32_t stack_depth;
+    UBaseType_t priority;
+
+    pthread_mutex_t lock;
+    pthread_cond_t notified;
+    uint32_t notify_value;
+
+    struct tskTaskControlBlock *next;
+};
+
+static __thread TaskHandle_t t_current_task = NULL;
+static TaskHandle_t g_task_list = NULL;
+static UBaseType_t g_task_count = 0;
+static UBaseType_t g_task_numbers = 0;
+static pthread_mutex_t g_task_list_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static TaskHandle_t task_alloc(const char *name, uint32_t stack_depth, UBaseType_t priority)
+{
+    TaskHandle_t task = calloc(1, sizeof(*task));
+    if (!task) {
+        return NULL;
+    }
+
+    snprintf(task->name, sizeof(task->name), "%s", name ? name : "");
+    task->stack_depth = stack_depth;
+    task->priority = priority;
+    pthread_mutex_init(&task->lock, NULL);
+    host_cond_init(&task->notified);
+
+    pthread_mutex_lock(&g_task_list_lock);
+    task->number = ++g_task_numbers;
+    task->next = g_task_list;
+    g_task_list = task;
+    g_task_count++;
+    pthread_mutex_unlock(&g_task_list_lock);
+    return task;
+}
+
+static void task_unlink(TaskHandle_t task)
+{
+    pthread_mutex_lock(&g_task_list_lock);
+    for (TaskHandle_t *p = &g_task_list; *p; p = &(*p)->next) {
+        if (*p == task) {
+            *p = task->next;
+            g_task_count--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_task_list_lock);
+}
+
+static void *task_entry(void *arg)
+{
+    TaskHandle_t task = arg;
+    t_current_task = task;
+    task->function(task->param);
+
+    // FreeRTOS tasks must not return, behave like vTaskDelete(NULL)
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_depth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *created_task,
+                                   BaseType_t core_id)
+{
+    (void)core_id;
+
+    TaskHandle_t task = task_alloc(name, stack_depth, priority);
+    if (!task) {
+        return pdFAIL;
+    }
+    task->function = function;
+    task->param = param;
+
+    if (created_task) {
+        *created_task = task;
+    }
+
+    if (pthread_create(&task->thread, NULL, task_entry, task) != 0) {
+        task_unlink(task);
+        free(task);
+        if (created_task) {
+            *created_task = NULL;
+        }
+        return pdFAIL;
+    }
+    pthread_detach(task->thread);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_depth,
+                       void *param, UBaseType_t priority, TaskHandle_t *created_task)
+{
+    return xTaskCreatePinnedToCore(function, name, stack_depth, param, priority, created_task, 0);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (!task) {
+        task = self;
+    }
+
+    task_unlink(task);
+    if (task == self) {
+        // The TCB is kept: other tasks may still hold the handle
+        pthread_exit(NULL);
+    }
+    pthread_cancel(task->thread);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec deadline;
+    host_deadline(ticks, &deadline);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+}
+
+void vPortYield(void)
+{
+    sched_yield();
+}
+
+/* Host threads are preempted by the OS and never starve each other, so
+ * suspending the scheduler has nothing to protect against. */
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdFALSE;
+}
+
+void vTaskDelayUntil(TickType_t *previous_wake_time, TickType_t increment)
+{
+    *previous_wake_time += increment;
+
+    struct timespec deadline;
+    host_time_to_timespec((uint64_t)pdTICKS_TO_MS(*previous_wake_time) * 1000ULL, &deadline);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return pdMS_TO_TICKS(host_time_us() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    // Threads not created by xTaskCreate (main, timer, MQTT) get a TCB on first use
+    if (!t_current_task) {
+        t_current_task = task_alloc("main", 0, 1);
+        if (t_current_task) {
+            t_current_task->thread = pthread_self();
+        }
+    }
+    return t_current_task;
+}
+
+const char *pcTaskGetName(TaskHandle_t task)
+{
+    if (!task) {
+        task = xTaskGetCurrentTaskHandle();
+    }
+    return task->name;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    // Host threads have megabytes of stack, report the requested depth as unused
+    if (!task) {
+        task = xTaskGetCurrentTaskHandle();
+    }
+    return task->stack_depth;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+    pthread_mutex_lock(&g_task_list_lock);
+    UBaseType_t count = g_task_count;
+    pthread_mutex_unlock(&g_task_list_lock);
+    return count;
+}
+
+static uint32_t task_cpu_time_us(TaskHandle_t task)
+{
+    clockid_t clock;
+    struct timespec ts;
+    if (pthread_getcpuclockid(task->thread, &clock) != 0 || clock_gettime(clock, &ts) != 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000);
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status_array, UBaseType_t array_size,
+                                 uint32_t *total_run_time)
+{
+    pthread_mutex_lock(&g_task_list_lock);
+    if (!status_array || array_size < g_task_count) {
+        pthread_mutex_unlock(&g_task_list_lock);
+        return 0;
+    }
+
+    // No scheduler states on the host: the caller runs, the rest is blocked
+    TaskHandle_t self = t_current_task;
+    UBaseType_t n = 0;
+    for (TaskHandle_t task = g_task_list; task; task = task->next) {
+        status_array[n++] = (TaskStatus_t){
+            .xHandle = task,
+            .pcTaskName = task->name,
+            .xTaskNumber = task->number,
+            .eCurrentState = (task == self) ? eRunning : eBlocked,
+            .uxCurrentPriority = task->priority,
+            .uxBasePriority = task->priority,
+            .ulRunTimeCounter = task_cpu_time_us(task),
+            .pxStackBase = NULL,
+            .usStackHighWaterMark = task->stack_depth,
+            .xCoreID = 0
+        };
+    }
+    pthread_mutex_unlock(&g_task_list_lock);
+
+    if (total_run_time) {
+        *total_run_time = (uint32_t)host_real_time_us();
+    }
+    return n;
+}
+
+/* ============================================================================
+   TASK NOTIFICATIONS
+   ============================================================================ */
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    struct timespec deadline;
+    bool timed = host_deadline(ticks_to_wait, &deadline);
+
+    pthread_mutex_lock(&self->lock);
+    while (self->notify_value == 0 && ticks_to_wait > 0) {
+        if (!host_cond_wait(&self->notified, &self->lock, timed, &deadline)) {
+            break;
+        }
+    }
+
+    uint32_t value = self->notify_value;
+    if (value > 0) {
+        self->notify_value = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&self->lock);
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify_value++;
+    pthread_cond_signal(&task->notified);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    xTaskNotifyGive(task);
+    if (higher_priority_task_woken) {
+        *higher_priority_task_woken = pdFALSE;
+    }
+}
+
+/* ============================================================================
+   QUEUES AND SEMAPHORES
+   ============================================================================ */
+
+struct QueueDefinition {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t *storage;           // NULL for semaphores (item_size 0)
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t count;
+    UBaseType_t head;           // Oldest item
+};
+
+static QueueHandle_t queue_alloc(UBaseType_t length, UBaseType_t item_size, UBaseType_t initial_count)
+{
+    if (length == 0) {
+        return NULL;
+    }
+
+    QueueHandle_t queue = calloc(1, sizeof(*queue));
+    if (!queue) {
+        return NULL;
+    }
+
+    if (item_size > 0) {
+        queue->storage = malloc((size_t)length * item_size);
+        if (!queue->storage) {
+            free(queue);
+            return NULL;
+        }
+    }
+
+    pthread_mutex_init(&queue->lock, NULL);
+    host_cond_init(&queue->not_empty);
+    host_cond_init(&queue->not_full);
+    queue->length = length;
+    queue->item_size = item_size;
+    queue->count = initial_count;
+    return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return queue_alloc(length, item_size, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return queue_alloc(1, 0, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return queue_alloc(1, 0, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    return queue_alloc(max_count, 0, initial_count);
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (!queue) {
+        return;
+    }
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_cond_destroy(&queue->not_full);
+    free(queue->storage);
+    free(queue);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    struct timespec deadline;
+    bool timed = host_deadline(ticks_to_wait, &deadline);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length) {
+        if (ticks_to_wait == 0 || !host_cond_wait(&queue->not_full, &queue->lock, timed, &deadline)) {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFALSE;
+        }
+    }
+
+    if (queue->storage) {
+        UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        memcpy(queue->storage + (size_t)tail * queue->item_size, item, queue->item_size);
+    }
+    queue->count++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    return xQueueSend(queue, item, ticks_to_wait);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken) {
+        *higher_priority_task_woken = pdFALSE;
+    }
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    struct timespec deadline;
+    bool timed = host_deadline(ticks_to_wait, &deadline);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0) {
+        if (ticks_to_wait == 0 || !host_cond_wait(&queue->not_empty, &queue->lock, timed, &deadline)) {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFALSE;
+        }
+    }
+
+    if (queue->storage) {
+        memcpy(item, queue->storage + (size_t)queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+    }
+    queue->count--;
+    pthread_cond_signal(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t spaces = queue->length - queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return spaces;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->count = 0;
+    queue->head = 0;
+    pthread_cond_broadcast(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+/* ============================================================================
+   EVENT GROUPS
+   ============================================================================ */
+
+struct EventGroupDef_t {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    EventBits_t bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    EventGroupHandle_t group = calloc(1, sizeof(*group));
+    if (!group) {
+        return NULL;
+    }
+    pthread_mutex_init(&group->lock, NULL);
+    host_cond_init(&group->changed);
+    return group;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group)
+{
+    if (!group) {
+        return;
+    }
+    pthread_mutex_destroy(&group->lock);
+    pthread_cond_destroy(&group->changed);
+    free(group);
+}
+
+static bool event_bits_satisfied(EventBits_t bits, EventBits_t wanted, BaseType_t wait_for_all)
+{
+    return wait_for_all ? (bits & wanted) == wanted : (bits & wanted) != 0;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits_to_wait_for,
+                                BaseType_t clear_on_exit, BaseType_t wait_for_all_bits,
+                                TickType_t ticks_to_wait)
+{
+    struct timespec deadline;
+    bool timed = host_deadline(ticks_to_wait, &deadline);
+
+    pthread_mutex_lock(&group->lock);
+    while (!event_bits_satisfied(group->bits, bits_to_wait_for, wait_for_all_bits) && ticks_to_wait > 0) {
+        if (!host_cond_wait(&group->changed, &group->lock, timed, &deadline)) {
+            break;
+        }
+    }
+
+    EventBits_t bits = group->bits;
+    if (clear_on_exit && event_bits_satisfied(bits, bits_to_wait_for, wait_for_all_bits)) {
+        group->bits &= ~bits_to_wait_for;
+    }
+    pthread_mutex_unlock(&group->lock);
+    return bits;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->lock);
+    group->bits |= bits;
+    EventBits_t result = group->bits;
+    pthread_cond_broadcast(&group->changed);
+    pthread_mutex_unlock(&group->lock);
+    return result;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->lock);
+    EventBits_t previous = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->lock);
+    return previous;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    pthread_mutex_lock(&group->lock);
+    EventBits_t bits = group->bits;
+    pthread_mutex_unlock(&group->lock);
+    return bits;
+}
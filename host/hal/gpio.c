@@ -0,0 +1,302 @@
+// host/hal/gpio.c
+// Simulated GPIO matrix. Each pin is an open-drain line with a pull-up:
+// level = firmware output AND external drive. Edges matching the
+// interrupt type call the ISR handler on the thread that made the edge.
+
+#include <pthread.h>
+#include <string.h>
+#include "host_internal.h"
+#include "host_hal.h"
+#include "driver/gpio.h"
+
+typedef struct {
+    gpio_mode_t mode;
+    int out_level;
+    int ext_level;
+    gpio_int_type_t intr_type;
+    bool intr_enabled;
+    gpio_isr_t isr;
+    void *isr_arg;
+    host_gpio_listener_t listener;
+    void *listener_ctx;
+} host_pin_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    host_pin_t pins[GPIO_NUM_MAX];
+    bool isr_service;
+} host_gpio_context_t;
+
+static host_gpio_context_t g_gpio_ctx = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static bool gpio_valid(gpio_num_t pin)
+{
+    return pin >= 0 && pin < GPIO_NUM_MAX;
+}
+
+static int pin_level(const host_pin_t *pin)
+{
+    bool drives = (pin->mode & GPIO_MODE_OUTPUT) != 0;
+    int out = drives ? pin->out_level : 1;
+    return out & pin->ext_level;
+}
+
+static bool edge_matches(gpio_int_type_t type, int old_level, int new_level)
+{
+    if (old_level == new_level) {
+        return false;
+    }
+    switch (type) {
+        case GPIO_INTR_POSEDGE: return new_level == 1;
+        case GPIO_INTR_NEGEDGE: return new_level == 0;
+        case GPIO_INTR_ANYEDGE: return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Apply a level change and run the ISR outside the lock
+ */
+static void pin_update(gpio_num_t num, int old_level)
+{
+    host_pin_t *pin = &g_gpio_ctx.pins[num];
+    int new_level = pin_level(pin);
+    gpio_isr_t isr = NULL;
+    void *isr_arg = NULL;
+
+    if (pin->intr_enabled && pin->isr && edge_matches(pin->intr_type, old_level, new_level)) {
+        isr = pin->isr;
+        isr_arg = pin->isr_arg;
+    }
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+
+    if (isr) {
+        isr(isr_arg);
+    }
+}
+
+void host_gpio_reset(void)
+{
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    memset(g_gpio_ctx.pins, 0, sizeof(g_gpio_ctx.pins));
+    for (int i = 0; i < GPIO_NUM_MAX; i++) {
+        g_gpio_ctx.pins[i].out_level = 1;
+        g_gpio_ctx.pins[i].ext_level = 1;
+    }
+    g_gpio_ctx.isr_service = false;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+}
+
+__attribute__((constructor))
+static void host_gpio_init(void)
+{
+    host_gpio_reset();
+}
+
+/* ============================================================================
+   DRIVER API
+   ============================================================================ */
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    if (!config || (config->pin_bit_mask >> GPIO_NUM_MAX) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < GPIO_NUM_MAX; i++) {
+        if (config->pin_bit_mask & (1ULL << i)) {
+            gpio_set_direction(i, config->mode);
+            gpio_set_intr_type(i, config->intr_type);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    if (!gpio_valid(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    host_pin_t *pin = &g_gpio_ctx.pins[gpio_num];
+    int old_level = pin_level(pin);
+    pin->mode = GPIO_MODE_INPUT;
+    pin->out_level = 1;
+    pin->intr_type = GPIO_INTR_DISABLE;
+    pin_update(gpio_num, old_level);
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    if (!gpio_valid(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    host_pin_t *pin = &g_gpio_ctx.pins[gpio_num];
+    int old_level = pin_level(pin);
+    pin->mode = mode;
+    pin_update(gpio_num, old_level);
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (!gpio_valid(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    host_pin_t *pin = &g_gpio_ctx.pins[gpio_num];
+    int old_level = pin_level(pin);
+    int old_out = pin->out_level;
+    pin->out_level = level ? 1 : 0;
+    host_gpio_listener_t listener = (old_out != pin->out_level) ? pin->listener : NULL;
+    void *listener_ctx = pin->listener_ctx;
+    pin_update(gpio_num, old_level);
+
+    // Device models react after the firmware's own edge has been processed
+    if (listener) {
+        listener(gpio_num, level ? 1 : 0, listener_ctx);
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    if (!gpio_valid(gpio_num)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    int level = pin_level(&g_gpio_ctx.pins[gpio_num]);
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+    return level;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+{
+    if (!gpio_valid(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    g_gpio_ctx.pins[gpio_num].intr_type = intr_type;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+    return ESP_OK;
+}
+
+static esp_err_t gpio_intr_set(gpio_num_t gpio_num, bool enabled)
+{
+    if (!gpio_valid(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    g_gpio_ctx.pins[gpio_num].intr_enabled = enabled;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num)
+{
+    return gpio_intr_set(gpio_num, true);
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num)
+{
+    return gpio_intr_set(gpio_num, false);
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    esp_err_t ret = g_gpio_ctx.isr_service ? ESP_ERR_INVALID_STATE : ESP_OK;
+    g_gpio_ctx.isr_service = true;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+    return ret;
+}
+
+void gpio_uninstall_isr_service(void)
+{
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    g_gpio_ctx.isr_service = false;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (!gpio_valid(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    if (!g_gpio_ctx.isr_service) {
+        pthread_mutex_unlock(&g_gpio_ctx.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_gpio_ctx.pins[gpio_num].isr = isr_handler;
+    g_gpio_ctx.pins[gpio_num].isr_arg = args;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    if (!gpio_valid(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    g_gpio_ctx.pins[gpio_num].isr = NULL;
+    g_gpio_ctx.pins[gpio_num].isr_arg = NULL;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+    return ESP_OK;
+}
+
+/* ============================================================================
+   TEST HOOKS
+   ============================================================================ */
+
+void host_gpio_drive(gpio_num_t pin, int level)
+{
+    if (!gpio_valid(pin)) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    int old_level = pin_level(&g_gpio_ctx.pins[pin]);
+    g_gpio_ctx.pins[pin].ext_level = level ? 1 : 0;
+    pin_update(pin, old_level);
+}
+
+int host_gpio_get_output(gpio_num_t pin)
+{
+    if (!gpio_valid(pin)) {
+        return 1;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    const host_pin_t *p = &g_gpio_ctx.pins[pin];
+    int level = (p->mode & GPIO_MODE_OUTPUT) ? p->out_level : 1;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+    return level;
+}
+
+void host_gpio_set_listener(gpio_num_t pin, host_gpio_listener_t listener, void *ctx)
+{
+    if (!gpio_valid(pin)) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_gpio_ctx.lock);
+    g_gpio_ctx.pins[pin].listener = listener;
+    g_gpio_ctx.pins[pin].listener_ctx = ctx;
+    pthread_mutex_unlock(&g_gpio_ctx.lock);
+}
@@ -0,0 +1,40 @@
+// host/hal/host_internal.h
+// Shared helpers of the host HAL implementation (not a public header).
+#ifndef HOST_INTERNAL_H
+#define HOST_INTERNAL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+
+/** Microseconds since process start: CLOCK_MONOTONIC plus virtual clock adjustments */
+uint64_t host_time_us(void);
+
+/** Condition variable waiting on CLOCK_MONOTONIC */
+void host_cond_init(pthread_cond_t *cond);
+
+/**
+ * @brief Absolute CLOCK_MONOTONIC deadline `ticks` from now
+ * @return false for portMAX_DELAY (wait forever)
+ */
+bool host_deadline(TickType_t ticks, struct timespec *deadline);
+
+/** Absolute CLOCK_MONOTONIC time for a host_time_us() value */
+void host_time_to_timespec(uint64_t time_us, struct timespec *ts);
+
+/** True between host_clock_freeze() and host_clock_release() */
+bool host_time_is_frozen(void);
+
+/** Wake the esp_timer thread to re-check expiries after a clock change */
+void host_timer_kick(void);
+
+/** Reset hooks of the individual fakes (host_hal_reset) */
+void host_gpio_reset(void);
+void host_ledc_reset(void);
+void host_nvs_reset(void);
+void host_partition_reset(void);
+void host_mqtt_reset(void);
+
+#endif // HOST_INTERNAL_H
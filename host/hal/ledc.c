@@ -0,0 +1,295 @@
+// host/hal/ledc.c
+// LEDC channels as duty registers. set_duty latches, update_duty applies.
+// A fade moves the duty linearly over its time (ledc_get_duty interpolates)
+// and ends on an esp_timer, which calls the fade callback like the ISR.
+
+#include <pthread.h>
+#include <string.h>
+#include "host_internal.h"
+#include "driver/ledc.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+typedef struct {
+    bool configured;
+    uint32_t pending_duty;
+    uint32_t duty;              // Fade start duty while fading
+
+    // Fade
+    uint32_t fade_target;
+    uint32_t fade_time_ms;
+    bool fading;
+    uint64_t fade_start_us;
+    uint64_t fade_end_us;
+    esp_timer_handle_t fade_timer;
+    ledc_cbs_t cbs;
+    void *cb_arg;
+} host_ledc_channel_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    host_ledc_channel_t channels[LEDC_CHANNEL_MAX];
+    bool fade_installed;
+} host_ledc_context_t;
+
+static host_ledc_context_t g_ledc_ctx = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static bool ledc_valid(ledc_mode_t mode, ledc_channel_t channel)
+{
+    return mode < LEDC_SPEED_MODE_MAX && channel < LEDC_CHANNEL_MAX;
+}
+
+/** Current duty, interpolated during a fade (lock held) */
+static uint32_t ledc_current_duty(const host_ledc_channel_t *ch)
+{
+    if (!ch->fading) {
+        return ch->duty;
+    }
+
+    uint64_t now = host_time_us();
+    if (now >= ch->fade_end_us) {
+        return ch->fade_target;
+    }
+
+    int64_t span = (int64_t)(ch->fade_end_us - ch->fade_start_us);
+    int64_t delta = (int64_t)ch->fade_target - (int64_t)ch->duty;
+    return (uint32_t)((int64_t)ch->duty + delta * (int64_t)(now - ch->fade_start_us) / span);
+}
+
+static void ledc_fade_end(void *arg)
+{
+    host_ledc_channel_t *ch = (host_ledc_channel_t *)arg;
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    // Stopped, or restarted since this expiry was armed
+    if (!ch->fading || host_time_us() < ch->fade_end_us) {
+        pthread_mutex_unlock(&g_ledc_ctx.lock);
+        return;
+    }
+    ch->fading = false;
+    ch->duty = ch->fade_target;
+    ch->pending_duty = ch->fade_target;
+
+    ledc_cb_param_t param = {
+        .event = LEDC_FADE_END_EVT,
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .channel = (uint32_t)(ch - g_ledc_ctx.channels),
+        .duty = ch->duty,
+    };
+    ledc_cb_t fade_cb = ch->cbs.fade_cb;
+    void *cb_arg = ch->cb_arg;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+
+    if (fade_cb) {
+        fade_cb(&param, cb_arg);
+    }
+}
+
+void host_ledc_reset(void)
+{
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    for (int i = 0; i < LEDC_CHANNEL_MAX; i++) {
+        esp_timer_handle_t timer = g_ledc_ctx.channels[i].fade_timer;
+        memset(&g_ledc_ctx.channels[i], 0, sizeof(g_ledc_ctx.channels[i]));
+        g_ledc_ctx.channels[i].fade_timer = timer;     // Reused, stale expiries are ignored
+    }
+    g_ledc_ctx.fade_installed = false;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf)
+{
+    if (!timer_conf || timer_conf->timer_num >= LEDC_TIMER_MAX || timer_conf->freq_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf)
+{
+    if (!ledc_conf || !ledc_valid(ledc_conf->speed_mode, ledc_conf->channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    host_ledc_channel_t *ch = &g_ledc_ctx.channels[ledc_conf->channel];
+    ch->configured = true;
+    ch->pending_duty = ledc_conf->duty;
+    ch->duty = ledc_conf->duty;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty)
+{
+    if (!ledc_valid(speed_mode, channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    g_ledc_ctx.channels[channel].pending_duty = duty;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    if (!ledc_valid(speed_mode, channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    host_ledc_channel_t *ch = &g_ledc_ctx.channels[channel];
+    ch->fading = false;
+    ch->duty = ch->pending_duty;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    if (!ledc_valid(speed_mode, channel)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    uint32_t duty = ledc_current_duty(&g_ledc_ctx.channels[channel]);
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+    return duty;
+}
+
+esp_err_t ledc_stop(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t idle_level)
+{
+    (void)idle_level;
+
+    if (!ledc_valid(speed_mode, channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    g_ledc_ctx.channels[channel].fading = false;
+    g_ledc_ctx.channels[channel].duty = 0;
+    g_ledc_ctx.channels[channel].pending_duty = 0;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    esp_err_t ret = g_ledc_ctx.fade_installed ? ESP_ERR_INVALID_STATE : ESP_OK;
+    g_ledc_ctx.fade_installed = true;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+    return ret;
+}
+
+void ledc_fade_func_uninstall(void)
+{
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    g_ledc_ctx.fade_installed = false;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode, ledc_channel_t channel,
+                                  uint32_t target_duty, int max_fade_time_ms)
+{
+    if (!ledc_valid(speed_mode, channel) || max_fade_time_ms < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    if (!g_ledc_ctx.fade_installed) {
+        pthread_mutex_unlock(&g_ledc_ctx.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    host_ledc_channel_t *ch = &g_ledc_ctx.channels[channel];
+    ch->duty = ledc_current_duty(ch);
+    ch->fading = false;
+    ch->fade_target = target_duty;
+    ch->fade_time_ms = (uint32_t)max_fade_time_ms;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel,
+                          ledc_fade_mode_t fade_mode)
+{
+    if (!ledc_valid(speed_mode, channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    if (!g_ledc_ctx.fade_installed) {
+        pthread_mutex_unlock(&g_ledc_ctx.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    host_ledc_channel_t *ch = &g_ledc_ctx.channels[channel];
+    if (!ch->fade_timer) {
+        esp_timer_create_args_t args = {
+            .callback = ledc_fade_end,
+            .arg = ch,
+            .name = "ledc_fade",
+        };
+        if (esp_timer_create(&args, &ch->fade_timer) != ESP_OK) {
+            pthread_mutex_unlock(&g_ledc_ctx.lock);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    ch->fading = true;
+    ch->fade_start_us = host_time_us();
+    ch->fade_end_us = ch->fade_start_us + (uint64_t)ch->fade_time_ms * 1000;
+    esp_timer_handle_t timer = ch->fade_timer;
+    uint32_t fade_time_ms = ch->fade_time_ms;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+
+    if (fade_mode == LEDC_FADE_WAIT_DONE) {
+        vTaskDelay(pdMS_TO_TICKS(fade_time_ms));
+        ledc_fade_end(ch);
+        return ESP_OK;
+    }
+
+    esp_timer_stop(timer);
+    return (esp_timer_start_once(timer, (uint64_t)fade_time_ms * 1000) == ESP_OK) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t ledc_fade_stop(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    if (!ledc_valid(speed_mode, channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    host_ledc_channel_t *ch = &g_ledc_ctx.channels[channel];
+    ch->duty = ledc_current_duty(ch);
+    ch->pending_duty = ch->duty;
+    ch->fading = false;
+    esp_timer_handle_t timer = ch->fade_timer;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+
+    if (timer) {
+        esp_timer_stop(timer);
+    }
+    return ESP_OK;
+}
+
+esp_err_t ledc_cb_register(ledc_mode_t speed_mode, ledc_channel_t channel,
+                           ledc_cbs_t *cbs, void *user_arg)
+{
+    if (!ledc_valid(speed_mode, channel) || !cbs) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_ledc_ctx.lock);
+    if (!g_ledc_ctx.fade_installed) {
+        pthread_mutex_unlock(&g_ledc_ctx.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_ledc_ctx.channels[channel].cbs = *cbs;
+    g_ledc_ctx.channels[channel].cb_arg = user_arg;
+    pthread_mutex_unlock(&g_ledc_ctx.lock);
+    return ESP_OK;
+}
@@ -0,0 +1,389 @@
+// host/hal/mqtt_client.c
+// Loopback esp-mqtt client. Events (CONNECTED, DISCONNECTED, DATA, ...)
+// are queued and delivered from one event thread like the real client
+// task; publishes are counted and handed to the test hook.
+
+#include <pthread.h>
+#include <string.h>
+#include "host_internal.h"
+#include "host_hal.h"
+#include "mqtt_client.h"
+
+#define HOST_MQTT_TOPIC_MAX     128
+#define HOST_MQTT_DATA_MAX      1024
+
+typedef struct host_mqtt_event {
+    esp_mqtt_event_id_t id;
+    int msg_id;
+    char topic[HOST_MQTT_TOPIC_MAX];
+    char data[HOST_MQTT_DATA_MAX];
+    int topic_len;
+    int data_len;
+    struct host_mqtt_event *next;
+} host_mqtt_event_t;
+
+struct esp_mqtt_client {
+    esp_event_handler_t handler;
+    void *handler_arg;
+    bool started;
+    bool connected;
+    int next_msg_id;
+
+    pthread_t thread;
+    bool stopping;
+    host_mqtt_event_t *head;
+    host_mqtt_event_t *tail;
+};
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t pending;
+    esp_mqtt_client_handle_t client;     // Single client, as in the firmware
+    bool broker_up;
+    uint32_t publish_count;
+    host_mqtt_publish_hook_t hook;
+    void *hook_ctx;
+} host_mqtt_context_t;
+
+static host_mqtt_context_t g_mqtt_ctx = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .pending = PTHREAD_COND_INITIALIZER,
+    .broker_up = true,
+};
+
+/* ============================================================================
+   EVENT QUEUE
+   ============================================================================ */
+
+/**
+ * @brief Queue an event for the client thread (caller holds the lock)
+ */
+static bool mqtt_post(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t id, int msg_id,
+                      const char *topic, int topic_len, const char *data, int data_len)
+{
+    if (topic_len > HOST_MQTT_TOPIC_MAX || data_len > HOST_MQTT_DATA_MAX) {
+        return false;
+    }
+
+    host_mqtt_event_t *event = calloc(1, sizeof(*event));
+    if (!event) {
+        return false;
+    }
+    event->id = id;
+    event->msg_id = msg_id;
+    if (topic) {
+        memcpy(event->topic, topic, (size_t)topic_len);
+        event->topic_len = topic_len;
+    }
+    if (data) {
+        memcpy(event->data, data, (size_t)data_len);
+        event->data_len = data_len;
+    }
+
+    if (client->tail) {
+        client->tail->next = event;
+    } else {
+        client->head = event;
+    }
+    client->tail = event;
+    pthread_cond_signal(&g_mqtt_ctx.pending);
+    return true;
+}
+
+static void *mqtt_event_thread(void *arg)
+{
+    esp_mqtt_client_handle_t client = arg;
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    while (!client->stopping) {
+        host_mqtt_event_t *event = client->head;
+        if (!event) {
+            pthread_cond_wait(&g_mqtt_ctx.pending, &g_mqtt_ctx.lock);
+            continue;
+        }
+        client->head = event->next;
+        if (!client->head) {
+            client->tail = NULL;
+        }
+
+        if (event->id == MQTT_EVENT_CONNECTED) {
+            client->connected = true;
+        } else if (event->id == MQTT_EVENT_DISCONNECTED) {
+            client->connected = false;
+        }
+        esp_event_handler_t handler = client->handler;
+        void *handler_arg = client->handler_arg;
+        pthread_mutex_unlock(&g_mqtt_ctx.lock);
+
+        if (handler) {
+            esp_mqtt_event_t e = {
+                .event_id = event->id,
+                .client = client,
+                .data = event->data,
+                .data_len = event->data_len,
+                .total_data_len = event->data_len,
+                .topic = event->topic,
+                .topic_len = event->topic_len,
+                .msg_id = event->msg_id,
+            };
+            handler(handler_arg, "MQTT_EVENTS", event->id, &e);
+        }
+        free(event);
+
+        pthread_mutex_lock(&g_mqtt_ctx.lock);
+    }
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    return NULL;
+}
+
+static void mqtt_drain(esp_mqtt_client_handle_t client)
+{
+    while (client->head) {
+        host_mqtt_event_t *event = client->head;
+        client->head = event->next;
+        free(event);
+    }
+    client->tail = NULL;
+}
+
+/* ============================================================================
+   CLIENT API
+   ============================================================================ */
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config)
+{
+    if (!config) {
+        return NULL;
+    }
+
+    esp_mqtt_client_handle_t client = calloc(1, sizeof(*client));
+    if (!client) {
+        return NULL;
+    }
+    client->next_msg_id = 1;
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    g_mqtt_ctx.client = client;
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    return client;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t event_handler, void *event_handler_arg)
+{
+    (void)event;
+
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    client->handler = event_handler;
+    client->handler_arg = event_handler_arg;
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    if (client->started) {
+        pthread_mutex_unlock(&g_mqtt_ctx.lock);
+        return ESP_FAIL;
+    }
+
+    client->stopping = false;
+    if (pthread_create(&client->thread, NULL, mqtt_event_thread, client) != 0) {
+        pthread_mutex_unlock(&g_mqtt_ctx.lock);
+        return ESP_FAIL;
+    }
+    client->started = true;
+    if (g_mqtt_ctx.broker_up) {
+        mqtt_post(client, MQTT_EVENT_CONNECTED, 0, NULL, 0, NULL, 0);
+    }
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    if (!client->started) {
+        pthread_mutex_unlock(&g_mqtt_ctx.lock);
+        return ESP_FAIL;
+    }
+    client->stopping = true;
+    pthread_cond_broadcast(&g_mqtt_ctx.pending);
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+
+    // Called from the event handler itself: the thread exits on its own
+    if (!pthread_equal(pthread_self(), client->thread)) {
+        pthread_join(client->thread, NULL);
+    } else {
+        pthread_detach(client->thread);
+    }
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    mqtt_drain(client);
+    client->started = false;
+    client->connected = false;
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (client->started) {
+        esp_mqtt_client_stop(client);
+    }
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    if (g_mqtt_ctx.client == client) {
+        g_mqtt_ctx.client = NULL;
+    }
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    free(client);
+    return ESP_OK;
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data,
+                            int len, int qos, int retain)
+{
+    (void)retain;
+
+    if (!client || !topic) {
+        return -1;
+    }
+    if (len <= 0) {
+        len = data ? (int)strlen(data) : 0;
+    }
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    if (!client->connected) {
+        pthread_mutex_unlock(&g_mqtt_ctx.lock);
+        return -1;
+    }
+    int msg_id = (qos > 0) ? client->next_msg_id++ : 0;
+    g_mqtt_ctx.publish_count++;
+    host_mqtt_publish_hook_t hook = g_mqtt_ctx.hook;
+    void *hook_ctx = g_mqtt_ctx.hook_ctx;
+    if (qos > 0) {
+        mqtt_post(client, MQTT_EVENT_PUBLISHED, msg_id, NULL, 0, NULL, 0);
+    }
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+
+    if (hook) {
+        hook(topic, data, len, hook_ctx);
+    }
+    return msg_id;
+}
+
+static int mqtt_subscription(esp_mqtt_client_handle_t client, const char *topic,
+                             esp_mqtt_event_id_t ack)
+{
+    if (!client || !topic) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    if (!client->connected) {
+        pthread_mutex_unlock(&g_mqtt_ctx.lock);
+        return -1;
+    }
+    int msg_id = client->next_msg_id++;
+    mqtt_post(client, ack, msg_id, NULL, 0, NULL, 0);
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    return msg_id;
+}
+
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client, const char *topic, int qos)
+{
+    (void)qos;
+    return mqtt_subscription(client, topic, MQTT_EVENT_SUBSCRIBED);
+}
+
+int esp_mqtt_client_unsubscribe(esp_mqtt_client_handle_t client, const char *topic)
+{
+    return mqtt_subscription(client, topic, MQTT_EVENT_UNSUBSCRIBED);
+}
+
+/* ============================================================================
+   TEST HOOKS
+   ============================================================================ */
+
+void host_mqtt_reset(void)
+{
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    g_mqtt_ctx.publish_count = 0;
+    g_mqtt_ctx.hook = NULL;
+    g_mqtt_ctx.hook_ctx = NULL;
+    g_mqtt_ctx.broker_up = true;
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+}
+
+void host_mqtt_set_publish_hook(host_mqtt_publish_hook_t hook, void *ctx)
+{
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    g_mqtt_ctx.hook = hook;
+    g_mqtt_ctx.hook_ctx = ctx;
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+}
+
+uint32_t host_mqtt_get_publish_count(void)
+{
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    uint32_t count = g_mqtt_ctx.publish_count;
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    return count;
+}
+
+void host_mqtt_set_connected(bool connected)
+{
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    bool changed = (g_mqtt_ctx.broker_up != connected);
+    g_mqtt_ctx.broker_up = connected;
+
+    esp_mqtt_client_handle_t client = g_mqtt_ctx.client;
+    if (changed && client && client->started) {
+        if (!connected) {
+            // Publishing fails at once, not only after the event is handled
+            client->connected = false;
+        }
+        mqtt_post(client, connected ? MQTT_EVENT_CONNECTED : MQTT_EVENT_DISCONNECTED,
+                  0, NULL, 0, NULL, 0);
+    }
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+}
+
+esp_err_t host_mqtt_inject(const char *topic, const char *data, int len)
+{
+    if (!topic || !data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len < 0) {
+        len = (int)strlen(data);
+    }
+
+    pthread_mutex_lock(&g_mqtt_ctx.lock);
+    esp_mqtt_client_handle_t client = g_mqtt_ctx.client;
+    esp_err_t ret = ESP_OK;
+    if (!client || !client->started || !g_mqtt_ctx.broker_up) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else if (!mqtt_post(client, MQTT_EVENT_DATA, 0, topic, (int)strlen(topic), data, len)) {
+        ret = ESP_ERR_INVALID_SIZE;
+    }
+    pthread_mutex_unlock(&g_mqtt_ctx.lock);
+    return ret;
+}
@@ -0,0 +1,334 @@
+// host/hal/nvs.c
+// In-memory NVS: a flat list of (namespace, key, type, value) entries.
+// Like the real thing, keys are typed and opening a missing namespace
+// read-only fails with ESP_ERR_NVS_NOT_FOUND.
+
+#include <pthread.h>
+#include <string.h>
+#include "host_internal.h"
+#include "nvs_flash.h"
+
+#define HOST_NVS_KEY_MAX        16      // 15 characters + NUL, as on device
+#define HOST_NVS_MAX_HANDLES    16
+
+typedef enum {
+    NVS_ENTRY_U8,
+    NVS_ENTRY_U16,
+    NVS_ENTRY_U32,
+    NVS_ENTRY_STR,
+    NVS_ENTRY_BLOB,
+} nvs_entry_type_t;
+
+typedef struct nvs_entry {
+    char name_space[HOST_NVS_KEY_MAX];
+    char key[HOST_NVS_KEY_MAX];
+    nvs_entry_type_t type;
+    void *data;
+    size_t length;
+    struct nvs_entry *next;
+} nvs_entry_t;
+
+typedef struct {
+    bool open;
+    bool writable;
+    char name_space[HOST_NVS_KEY_MAX];
+} nvs_open_handle_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    nvs_entry_t *entries;
+    nvs_open_handle_t handles[HOST_NVS_MAX_HANDLES];   // nvs_handle_t = index + 1
+} host_nvs_context_t;
+
+static host_nvs_context_t g_nvs_ctx = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* ============================================================================
+   HELPERS (caller holds the lock)
+   ============================================================================ */
+
+static nvs_open_handle_t *nvs_lookup_handle(nvs_handle_t handle)
+{
+    if (handle == 0 || handle > HOST_NVS_MAX_HANDLES || !g_nvs_ctx.handles[handle - 1].open) {
+        return NULL;
+    }
+    return &g_nvs_ctx.handles[handle - 1];
+}
+
+static nvs_entry_t **nvs_find(const char *name_space, const char *key)
+{
+    nvs_entry_t **p = &g_nvs_ctx.entries;
+    while (*p) {
+        if (strcmp((*p)->name_space, name_space) == 0 &&
+            (!key || strcmp((*p)->key, key) == 0)) {
+            break;
+        }
+        p = &(*p)->next;
+    }
+    return p;
+}
+
+static void nvs_free_entry(nvs_entry_t **link)
+{
+    nvs_entry_t *entry = *link;
+    *link = entry->next;
+    free(entry->data);
+    free(entry);
+}
+
+static esp_err_t nvs_set(nvs_handle_t handle, const char *key, nvs_entry_type_t type,
+                         const void *value, size_t length)
+{
+    if (!key || strlen(key) >= HOST_NVS_KEY_MAX || (!value && length > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    nvs_open_handle_t *h = nvs_lookup_handle(handle);
+    if (!h || !h->writable) {
+        pthread_mutex_unlock(&g_nvs_ctx.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    void *data = malloc(length ? length : 1);
+    if (!data) {
+        pthread_mutex_unlock(&g_nvs_ctx.lock);
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(data, value, length);
+
+    nvs_entry_t **link = nvs_find(h->name_space, key);
+    nvs_entry_t *entry = *link;
+    if (!entry) {
+        entry = calloc(1, sizeof(*entry));
+        if (!entry) {
+            free(data);
+            pthread_mutex_unlock(&g_nvs_ctx.lock);
+            return ESP_ERR_NO_MEM;
+        }
+        strcpy(entry->name_space, h->name_space);
+        strcpy(entry->key, key);
+        *link = entry;
+    }
+
+    free(entry->data);
+    entry->type = type;
+    entry->data = data;
+    entry->length = length;
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Copy a value out
+ *
+ * With `length` set, behaves like nvs_get_str/blob: NULL `out` only
+ * reports the size, a short buffer fails with ESP_ERR_NVS_INVALID_LENGTH.
+ */
+static esp_err_t nvs_get(nvs_handle_t handle, const char *key, nvs_entry_type_t type,
+                         void *out, size_t fixed_size, size_t *length)
+{
+    if (!key) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    nvs_open_handle_t *h = nvs_lookup_handle(handle);
+    if (!h) {
+        pthread_mutex_unlock(&g_nvs_ctx.lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    nvs_entry_t *entry = *nvs_find(h->name_space, key);
+    esp_err_t ret = ESP_OK;
+    if (!entry || entry->type != type) {
+        ret = ESP_ERR_NVS_NOT_FOUND;
+    } else if (!length) {
+        memcpy(out, entry->data, fixed_size);
+    } else if (!out) {
+        *length = entry->length;
+    } else if (*length < entry->length) {
+        *length = entry->length;
+        ret = ESP_ERR_NVS_INVALID_LENGTH;
+    } else {
+        memcpy(out, entry->data, entry->length);
+        *length = entry->length;
+    }
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+    return ret;
+}
+
+/* ============================================================================
+   FLASH AND HANDLES
+   ============================================================================ */
+
+void host_nvs_reset(void)
+{
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    while (g_nvs_ctx.entries) {
+        nvs_free_entry(&g_nvs_ctx.entries);
+    }
+    memset(g_nvs_ctx.handles, 0, sizeof(g_nvs_ctx.handles));
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    while (g_nvs_ctx.entries) {
+        nvs_free_entry(&g_nvs_ctx.entries);
+    }
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!name || strlen(name) >= HOST_NVS_KEY_MAX || !out_handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    if (open_mode == NVS_READONLY && !*nvs_find(name, NULL)) {
+        pthread_mutex_unlock(&g_nvs_ctx.lock);
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    for (nvs_handle_t i = 0; i < HOST_NVS_MAX_HANDLES; i++) {
+        nvs_open_handle_t *h = &g_nvs_ctx.handles[i];
+        if (!h->open) {
+            h->open = true;
+            h->writable = (open_mode == NVS_READWRITE);
+            strcpy(h->name_space, name);
+            *out_handle = i + 1;
+            pthread_mutex_unlock(&g_nvs_ctx.lock);
+            return ESP_OK;
+        }
+    }
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+    return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    nvs_open_handle_t *h = nvs_lookup_handle(handle);
+    if (h) {
+        h->open = false;
+    }
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    esp_err_t ret = nvs_lookup_handle(handle) ? ESP_OK : ESP_ERR_INVALID_STATE;
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+    return ret;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    if (!key) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    nvs_open_handle_t *h = nvs_lookup_handle(handle);
+    esp_err_t ret = ESP_OK;
+    if (!h || !h->writable) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        nvs_entry_t **link = nvs_find(h->name_space, key);
+        if (*link) {
+            nvs_free_entry(link);
+        } else {
+            ret = ESP_ERR_NVS_NOT_FOUND;
+        }
+    }
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+    return ret;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    pthread_mutex_lock(&g_nvs_ctx.lock);
+    nvs_open_handle_t *h = nvs_lookup_handle(handle);
+    esp_err_t ret = ESP_OK;
+    if (!h || !h->writable) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        nvs_entry_t **link;
+        while (*(link = nvs_find(h->name_space, NULL))) {
+            nvs_free_entry(link);
+        }
+    }
+    pthread_mutex_unlock(&g_nvs_ctx.lock);
+    return ret;
+}
+
+/* ============================================================================
+   TYPED ACCESSORS
+   ============================================================================ */
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value)
+{
+    return out_value ? nvs_get(handle, key, NVS_ENTRY_U8, out_value, sizeof(*out_value), NULL)
+                     : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value)
+{
+    return nvs_set(handle, key, NVS_ENTRY_U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char *key, uint16_t *out_value)
+{
+    return out_value ? nvs_get(handle, key, NVS_ENTRY_U16, out_value, sizeof(*out_value), NULL)
+                     : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char *key, uint16_t value)
+{
+    return nvs_set(handle, key, NVS_ENTRY_U16, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    return out_value ? nvs_get(handle, key, NVS_ENTRY_U32, out_value, sizeof(*out_value), NULL)
+                     : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return nvs_set(handle, key, NVS_ENTRY_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return length ? nvs_get(handle, key, NVS_ENTRY_STR, out_value, 0, length)
+                  : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return value ? nvs_set(handle, key, NVS_ENTRY_STR, value, strlen(value) + 1)
+                 : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return length ? nvs_get(handle, key, NVS_ENTRY_BLOB, out_value, 0, length)
+                  : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return nvs_set(handle, key, NVS_ENTRY_BLOB, value, length);
+}
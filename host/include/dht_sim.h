@@ -0,0 +1,153 @@
+/**
+ * @file dht_sim.h
+ * @brief Simulated DHT11/DHT21/DHT22/AM2302 on a host GPIO - test fixture
+ * @version 2.0
+ *
+ * A device model attached to a pin with host_gpio_set_listener(). When
+ * the firmware releases the line after a valid start pulse, the model
+ * plays a complete frame (response, 40 bits, end pulse) with
+ * host_gpio_drive() while the clock is frozen, so every edge the driver's
+ * ISR timestamps is exactly the synthesized one.
+ *
+ * Timing follows the datasheets (80/80 us response, 50 us bit LOW,
+ * 26 us "0" / 70 us HIGH "1"). Imperfections:
+ * - clock_scale: sensor oscillator error, stretches every phase
+ * - jitter_us: uniform +/- offset on every edge (cable ringing, noise)
+ * - faults: no response, a lost falling edge, a glitch pulse, a
+ *   corrupted checksum
+ *
+ * Usage:
+    @code
+    ```c
+    dht_sim_t sim;
+    dht_sim_config_t cfg = DHT_SIM_CONFIG_DEFAULT(DHT_TYPE_DHT22);
+    cfg.jitter_us = 4;
+    dht_sim_attach(&sim, 4, &cfg);
+    dht_sim_set_reading(&sim, 21.5f, 48.2f);
+
+    sensor_dht_init(DHT_TYPE_DHT22, 0, 4, &dht);
+    sensor_dht_read(dht, &reading);        // Decodes the simulated frame
+    ```
+    @endcode
+ *
+ * @note Host build only. Random choices use a seeded generator, a given
+ *       configuration always produces the same waveforms.
+ */
+
+#ifndef DHT_SIM_H
+#define DHT_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driver/gpio.h"
+
+/* =========================================================================
+   TYPES
+   ========================================================================= */
+/**
+ * @brief Fault injected into the next frames
+ */
+typedef enum {
+    DHT_SIM_FAULT_NONE = 0,
+    DHT_SIM_FAULT_NO_RESPONSE,      // Sensor ignores the start pulse
+    DHT_SIM_FAULT_MISSING_EDGE,     // One data bit loses its falling edge
+    DHT_SIM_FAULT_GLITCH,           // Short extra LOW pulse inside a bit
+    DHT_SIM_FAULT_BAD_CHECKSUM,     // One checksum bit flipped
+    DHT_SIM_FAULT_COUNT
+} dht_sim_fault_t;
+
+/**
+ * @brief Model and signal quality
+ */
+typedef struct {
+    uint8_t type;                   // DHT_TYPE_* (data layout, start pulse)
+    float clock_scale;              // 1.0 = nominal timing, 1.2 = 20 % slow
+    uint32_t jitter_us;             // Max edge offset, uniform in [-j, +j]
+    uint32_t seed;                  // Random generator seed
+} dht_sim_config_t;
+
+#define DHT_SIM_CONFIG_DEFAULT(dht_type) \
+    { .type = (dht_type), .clock_scale = 1.0f, .jitter_us = 0, .seed = 1 }
+
+/**
+ * @brief Counters since attach
+ */
+typedef struct {
+    uint32_t frames;                // Frames played
+    uint32_t ignored_starts;        // Start pulses too short for the model
+    uint32_t zero_period_min_us;    // Falling-edge periods of "0" bits
+    uint32_t zero_period_max_us;
+    uint32_t one_period_min_us;     // Falling-edge periods of "1" bits
+    uint32_t one_period_max_us;
+    uint64_t isr_ns_max;            // Longest single edge (ISR) on the host
+    uint64_t isr_ns_total;
+    uint32_t isr_edges;
+} dht_sim_stats_t;
+
+/**
+ * @brief Simulator instance (caller-owned storage)
+ */
+typedef struct {
+    gpio_num_t pin;
+    dht_sim_config_t config;
+    dht_sim_fault_t fault;
+    uint8_t frame[5];               // Bytes of the next frame
+    uint64_t start_low_us;          // When the firmware pulled the line LOW
+    bool start_pending;
+    uint32_t rng;
+    dht_sim_stats_t stats;
+} dht_sim_t;
+
+/* =========================================================================
+   PUBLIC API
+   ========================================================================= */
+/**
+ * @brief Attach the model to a pin (replaces any listener on it)
+ * @param sim Simulator storage
+ * @param pin GPIO the driver uses
+ * @param config Model and signal quality
+ */
+void dht_sim_attach(dht_sim_t *sim, gpio_num_t pin, const dht_sim_config_t *config);
+
+/**
+ * @brief Detach the model, the line idles high
+ * @param sim Simulator
+ */
+void dht_sim_detach(dht_sim_t *sim);
+
+/**
+ * @brief Set the values encoded in the next frames
+ *
+ * Values are encoded in the model's layout (DHT11 rounds to 0.1 in its
+ * decimal byte, DHT22 family to 0.1 with a sign bit).
+ *
+ * @param sim Simulator
+ * @param temperature Temperature in C
+ * @param humidity Relative humidity in %
+ */
+void dht_sim_set_reading(dht_sim_t *sim, float temperature, float humidity);
+
+/**
+ * @brief Inject a fault into the next frames (DHT_SIM_FAULT_NONE to stop)
+ * @param sim Simulator
+ * @param fault Fault
+ */
+void dht_sim_set_fault(dht_sim_t *sim, dht_sim_fault_t fault);
+
+/**
+ * @brief Encode a reading into the 5 frame bytes of a model
+ * @param type DHT_TYPE_*
+ * @param temperature Temperature in C
+ * @param humidity Relative humidity in %
+ * @param frame Output bytes, checksum included
+ */
+void dht_sim_encode(uint8_t type, float temperature, float humidity, uint8_t *frame);
+
+/**
+ * @brief Short fault name for reports
+ * @param fault Fault
+ * @return Name ("none", "no_response", ...)
+ */
+const char *dht_sim_fault_to_string(dht_sim_fault_t fault);
+
+#endif // DHT_SIM_H
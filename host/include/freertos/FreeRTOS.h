@@ -0,0 +1,59 @@
+// host/include/freertos/FreeRTOS.h
+// Host build: FreeRTOS subset on POSIX threads (1 tick = 1 ms).
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "esp_err.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+
+#define configTICK_RATE_HZ      1000
+#define configMAX_TASK_NAME_LEN 16
+#define portTICK_PERIOD_MS      (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           ((TickType_t)0xffffffffu)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTICKS_TO_MS(ticks)    ((uint32_t)(((uint64_t)(ticks) * 1000) / configTICK_RATE_HZ))
+
+#define configASSERT(x)         do { if (!(x)) abort(); } while (0)
+
+/* Critical sections: one process-wide recursive lock. Code called from
+ * "ISR" context (GPIO edges, timer callbacks) runs on ordinary threads. */
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { 0 }
+
+void host_critical_enter(void);
+void host_critical_exit(void);
+
+#define portENTER_CRITICAL(mux)         do { (void)(mux); host_critical_enter(); } while (0)
+#define portEXIT_CRITICAL(mux)          do { (void)(mux); host_critical_exit(); } while (0)
+#define portENTER_CRITICAL_ISR(mux)     portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux)      portEXIT_CRITICAL(mux)
+#define portYIELD_FROM_ISR(woken)       do { (void)(woken); } while (0)
+#define portYIELD()                     vPortYield()
+#define portNUM_PROCESSORS              1
+
+void vPortYield(void);
+
+static inline BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+#endif // FREERTOS_H
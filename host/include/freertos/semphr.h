@@ -0,0 +1,19 @@
+// host/include/freertos/semphr.h
+// Host build: semaphores are zero-size queues, as in FreeRTOS.
+#ifndef FREERTOS_SEMPHR_H
+#define FREERTOS_SEMPHR_H
+
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+
+#define xSemaphoreTake(sem, ticks)              xQueueReceive((sem), NULL, (ticks))
+#define xSemaphoreGive(sem)                     xQueueSend((sem), NULL, 0)
+#define xSemaphoreGiveFromISR(sem, woken)       xQueueSendFromISR((sem), NULL, (woken))
+#define vSemaphoreDelete(sem)                   vQueueDelete(sem)
+
+#endif // FREERTOS_SEMPHR_H
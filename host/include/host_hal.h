@@ -0,0 +1,163 @@
+/**
+ * @file host_hal.h
+ * @brief Host (Linux) hardware abstraction layer - test and simulation hooks
+ * @version 2.0
+ *
+ * The host build replaces ESP-IDF with fakes that keep the same headers
+ * (driver/gpio.h, driver/ledc.h, esp_timer.h, nvs.h, esp_partition.h,
+ * mqtt_client.h, freertos/...). Firmware code compiles unchanged; this
+ * header is the other side of the fakes, for tests, benchmarks and
+ * device models:
+ *
+ * - GPIO: an external device can drive a pin (open-drain wired-AND with the
+ *   firmware output) and observe the firmware output level
+ * - MQTT: the loopback client records publishes, injects received messages
+ *   and simulates broker loss
+ * - NVS / flash: contents live in RAM and can be reset between tests
+ * - Clock: esp_timer_get_time() and the tick count can be frozen and
+ *   stepped, so device models produce exact edge timestamps
+ *
+ * Usage:
+    @code
+    ```c
+    host_hal_reset();
+    host_mqtt_set_publish_hook(on_publish, NULL);
+    host_mqtt_inject("room_1/commands", "{\"type\":\"fan\",\"value\":128}", -1);
+    ```
+    @endcode
+ *
+ * @note FreeRTOS tasks are POSIX threads (1 tick = 1 ms). "ISR" callbacks
+ *       (GPIO edges, esp_timer) run on ordinary threads.
+ */
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* =========================================================================
+   GLOBAL
+   ========================================================================= */
+/**
+ * @brief Clear NVS, flash partitions, GPIO/LEDC state and MQTT recorder
+ *
+ * Call between tests, while no firmware task is running.
+ */
+void host_hal_reset(void);
+
+/* =========================================================================
+   CLOCK
+   ========================================================================= */
+/**
+ * @brief Stop the clock seen by the firmware (esp_timer, ticks)
+ *
+ * While frozen, time only moves with host_clock_advance_us(). Keep freezes
+ * short: blocking waits keep their real-time deadlines.
+ */
+void host_clock_freeze(void);
+
+/**
+ * @brief Move the firmware clock forward
+ *
+ * Frozen: steps the frozen time. Running: skips ahead (due esp_timers
+ * fire at once, sleeping tasks still wake at their real deadline).
+ *
+ * @param us Microseconds to add
+ */
+void host_clock_advance_us(uint64_t us);
+
+/**
+ * @brief Let the clock run again from the frozen value
+ */
+void host_clock_release(void);
+
+/* =========================================================================
+   GPIO
+   ========================================================================= */
+/**
+ * @brief Called when the firmware changes the output level of a pin
+ * @param pin GPIO number
+ * @param level New firmware output level (0 = pulled low)
+ * @param ctx Listener context
+ */
+typedef void (*host_gpio_listener_t)(gpio_num_t pin, int level, void *ctx);
+
+/**
+ * @brief Drive a pin from outside (sensor, button, ...)
+ *
+ * The line level is the AND of the firmware output (open-drain or
+ * push-pull) and the external level; the pull-up idles high. An edge that
+ * matches the pin's interrupt type calls its ISR handler on this thread.
+ *
+ * @param pin GPIO number
+ * @param level 0 = pull low, 1 = release
+ */
+void host_gpio_drive(gpio_num_t pin, int level);
+
+/**
+ * @brief Firmware output level of a pin (1 if released or input)
+ * @param pin GPIO number
+ * @return Output level
+ */
+int host_gpio_get_output(gpio_num_t pin);
+
+/**
+ * @brief Register a device model on a pin (NULL to remove)
+ * @param pin GPIO number
+ * @param listener Called on every firmware output change
+ * @param ctx Listener context
+ */
+void host_gpio_set_listener(gpio_num_t pin, host_gpio_listener_t listener, void *ctx);
+
+/* =========================================================================
+   MQTT
+   ========================================================================= */
+/**
+ * @brief Called for every message the firmware publishes
+ */
+typedef void (*host_mqtt_publish_hook_t)(const char *topic, const char *data, int len, void *ctx);
+
+/**
+ * @brief Observe published messages (NULL to remove)
+ * @param hook Publish hook, runs on the publishing task
+ * @param ctx Hook context
+ */
+void host_mqtt_set_publish_hook(host_mqtt_publish_hook_t hook, void *ctx);
+
+/**
+ * @brief Number of messages published since the last reset
+ * @return Publish count
+ */
+uint32_t host_mqtt_get_publish_count(void);
+
+/**
+ * @brief Simulate broker availability
+ *
+ * While down, esp_mqtt_client_publish() fails and a DISCONNECTED event is
+ * delivered; going up again delivers CONNECTED.
+ *
+ * @param connected Broker reachable
+ */
+void host_mqtt_set_connected(bool connected);
+
+/**
+ * @brief Deliver a message to the firmware as if received from the broker
+ * @param topic Topic
+ * @param data Payload
+ * @param len Payload length, -1 for a NUL-terminated string
+ * @return `ESP_OK` if queued, `ESP_ERR_INVALID_STATE` if no client runs
+ */
+esp_err_t host_mqtt_inject(const char *topic, const char *data, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_HAL_H
@@ -0,0 +1,10 @@
+// host/include/sdkconfig.h
+// Host build: no menuconfig options (WiFi credentials come from NVS only).
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+#define CONFIG_IDF_TARGET_LINUX 1
+#define CONFIG_FREERTOS_USE_TRACE_FACILITY 1
+#define CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS 1
+
+#endif // SDKCONFIG_H
@@ -0,0 +1,266 @@
+// host/sim/dht_sim.c
+// DHT single-wire device model on the host GPIO shim (see dht_sim.h).
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include "dht_sim.h"
+#include "host_hal.h"
+#include "sensor_dht.h"
+#include "esp_timer.h"
+
+/* ============================================================================
+   PROTOCOL TIMING (datasheet nominal values, microseconds)
+   ============================================================================ */
+#define SIM_RESPONSE_DELAY_US   30      // Host release -> sensor pulls LOW (20-40)
+#define SIM_RESPONSE_LOW_US     80
+#define SIM_RESPONSE_HIGH_US    80
+#define SIM_BIT_LOW_US          50
+#define SIM_ZERO_HIGH_US        26
+#define SIM_ONE_HIGH_US         70
+#define SIM_END_LOW_US          50
+#define SIM_GLITCH_US           2
+
+#define SIM_DHT11_MIN_START_US  18000
+#define SIM_DHT22_MIN_START_US  1000
+
+// Response (2) + 40 bits (2 each) + end pulse (2) + one glitch (2)
+#define SIM_MAX_TRANSITIONS     86
+
+typedef struct {
+    uint64_t at_us;                 // Offset from the host release
+    int level;
+} sim_transition_t;
+
+/* ============================================================================
+   HELPERS
+   ============================================================================ */
+
+static uint32_t sim_random(dht_sim_t *sim)
+{
+    // xorshift32, never seeded with 0
+    uint32_t x = sim->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+static int32_t sim_jitter(dht_sim_t *sim)
+{
+    uint32_t j = sim->config.jitter_us;
+    return j ? (int32_t)(sim_random(sim) % (2 * j + 1)) - (int32_t)j : 0;
+}
+
+static uint64_t sim_scaled(const dht_sim_t *sim, uint32_t us)
+{
+    return (uint64_t)lroundf((float)us * sim->config.clock_scale);
+}
+
+static uint64_t sim_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void sim_track_period(dht_sim_stats_t *stats, int bit, uint32_t period_us)
+{
+    uint32_t *min = bit ? &stats->one_period_min_us : &stats->zero_period_min_us;
+    uint32_t *max = bit ? &stats->one_period_max_us : &stats->zero_period_max_us;
+    if (*min == 0 || period_us < *min) *min = period_us;
+    if (period_us > *max) *max = period_us;
+}
+
+/**
+ * @brief Build the transitions of one frame, faults and jitter applied
+ * @return Number of transitions
+ */
+static size_t sim_build_frame(dht_sim_t *sim, sim_transition_t *out)
+{
+    uint8_t frame[5];
+    memcpy(frame, sim->frame, sizeof(frame));
+    if (sim->fault == DHT_SIM_FAULT_BAD_CHECKSUM) {
+        frame[4] ^= (uint8_t)(1u << (sim_random(sim) % 8));
+    }
+
+    // Fault position: any data bit but the first
+    int fault_bit = 1 + (int)(sim_random(sim) % 39);
+
+    size_t n = 0;
+    uint64_t t = sim_scaled(sim, SIM_RESPONSE_DELAY_US);
+    out[n++] = (sim_transition_t){ t, 0 };
+    t += sim_scaled(sim, SIM_RESPONSE_LOW_US);
+    out[n++] = (sim_transition_t){ t, 1 };
+    t += sim_scaled(sim, SIM_RESPONSE_HIGH_US);
+
+    int falls[41];                  // Transition index of each bit start / end pulse, -1 if lost
+    for (int i = 0; i < 40; i++) {
+        int bit = (frame[i / 8] >> (7 - i % 8)) & 1;
+        uint64_t high_us = sim_scaled(sim, bit ? SIM_ONE_HIGH_US : SIM_ZERO_HIGH_US);
+
+        falls[i] = -1;
+        if (!(sim->fault == DHT_SIM_FAULT_MISSING_EDGE && i == fault_bit)) {
+            falls[i] = (int)n;
+            out[n++] = (sim_transition_t){ t, 0 };
+        }
+        t += sim_scaled(sim, SIM_BIT_LOW_US);
+        out[n++] = (sim_transition_t){ t, 1 };
+
+        if (sim->fault == DHT_SIM_FAULT_GLITCH && i == fault_bit) {
+            out[n++] = (sim_transition_t){ t + high_us / 2, 0 };
+            out[n++] = (sim_transition_t){ t + high_us / 2 + SIM_GLITCH_US, 1 };
+        }
+        t += high_us;
+    }
+
+    falls[40] = (int)n;
+    out[n++] = (sim_transition_t){ t, 0 };
+    t += sim_scaled(sim, SIM_END_LOW_US);
+    out[n++] = (sim_transition_t){ t, 1 };
+
+    // Jitter every edge independently, keep the order
+    uint64_t prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t at = (int64_t)out[i].at_us + sim_jitter(sim);
+        out[i].at_us = (at <= (int64_t)prev) ? prev + 1 : (uint64_t)at;
+        prev = out[i].at_us;
+    }
+
+    // Bit periods as the falling-edge ISR will see them
+    for (int i = 0; i < 40; i++) {
+        if (falls[i] < 0 || falls[i + 1] < 0) {
+            continue;
+        }
+        int bit = (frame[i / 8] >> (7 - i % 8)) & 1;
+        sim_track_period(&sim->stats, bit, (uint32_t)(out[falls[i + 1]].at_us - out[falls[i]].at_us));
+    }
+    return n;
+}
+
+/**
+ * @brief Play one frame on the line with the clock frozen
+ */
+static void sim_play_frame(dht_sim_t *sim)
+{
+    sim_transition_t transitions[SIM_MAX_TRANSITIONS];
+    size_t n = sim_build_frame(sim, transitions);
+
+    host_clock_freeze();
+    uint64_t elapsed = 0;
+    for (size_t i = 0; i < n; i++) {
+        host_clock_advance_us(transitions[i].at_us - elapsed);
+        elapsed = transitions[i].at_us;
+
+        uint64_t t0 = sim_now_ns();
+        host_gpio_drive(sim->pin, transitions[i].level);
+        uint64_t dt = sim_now_ns() - t0;
+
+        if (transitions[i].level == 0) {
+            sim->stats.isr_edges++;
+            sim->stats.isr_ns_total += dt;
+            if (dt > sim->stats.isr_ns_max) {
+                sim->stats.isr_ns_max = dt;
+            }
+        }
+    }
+    host_clock_release();
+    sim->stats.frames++;
+}
+
+static void sim_on_output(gpio_num_t pin, int level, void *ctx)
+{
+    dht_sim_t *sim = ctx;
+    (void)pin;
+
+    if (level == 0) {
+        sim->start_low_us = (uint64_t)esp_timer_get_time();
+        sim->start_pending = true;
+        return;
+    }
+
+    if (!sim->start_pending) {
+        return;
+    }
+    sim->start_pending = false;
+
+    uint64_t min_start_us = (sim->config.type == DHT_TYPE_DHT11) ? SIM_DHT11_MIN_START_US
+                                                                  : SIM_DHT22_MIN_START_US;
+    if ((uint64_t)esp_timer_get_time() - sim->start_low_us < min_start_us) {
+        sim->stats.ignored_starts++;
+        return;
+    }
+
+    if (sim->fault != DHT_SIM_FAULT_NO_RESPONSE) {
+        sim_play_frame(sim);
+    }
+}
+
+/* ============================================================================
+   PUBLIC API
+   ============================================================================ */
+
+void dht_sim_attach(dht_sim_t *sim, gpio_num_t pin, const dht_sim_config_t *config)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->pin = pin;
+    sim->config = *config;
+    if (sim->config.clock_scale <= 0.0f) {
+        sim->config.clock_scale = 1.0f;
+    }
+    sim->rng = config->seed ? config->seed : 1;
+    dht_sim_set_reading(sim, 0.0f, 0.0f);
+
+    host_gpio_drive(pin, 1);
+    host_gpio_set_listener(pin, sim_on_output, sim);
+}
+
+void dht_sim_detach(dht_sim_t *sim)
+{
+    host_gpio_set_listener(sim->pin, NULL, NULL);
+    host_gpio_drive(sim->pin, 1);
+}
+
+void dht_sim_set_reading(dht_sim_t *sim, float temperature, float humidity)
+{
+    dht_sim_encode(sim->config.type, temperature, humidity, sim->frame);
+}
+
+void dht_sim_set_fault(dht_sim_t *sim, dht_sim_fault_t fault)
+{
+    sim->fault = fault;
+}
+
+void dht_sim_encode(uint8_t type, float temperature, float humidity, uint8_t *frame)
+{
+    if (type == DHT_TYPE_DHT11) {
+        // Integer byte + tenths byte, no negative temperatures
+        long hum_x10 = lroundf(fmaxf(humidity, 0.0f) * 10.0f);
+        long temp_x10 = lroundf(fmaxf(temperature, 0.0f) * 10.0f);
+        frame[0] = (uint8_t)(hum_x10 / 10);
+        frame[1] = (uint8_t)(hum_x10 % 10);
+        frame[2] = (uint8_t)(temp_x10 / 10);
+        frame[3] = (uint8_t)(temp_x10 % 10);
+    } else {
+        uint16_t hum_x10 = (uint16_t)lroundf(fmaxf(humidity, 0.0f) * 10.0f);
+        uint16_t temp_x10 = (uint16_t)lroundf(fabsf(temperature) * 10.0f);
+        frame[0] = (uint8_t)(hum_x10 >> 8);
+        frame[1] = (uint8_t)(hum_x10 & 0xFF);
+        frame[2] = (uint8_t)((temp_x10 >> 8) & 0x7F) | (temperature < 0.0f ? 0x80 : 0x00);
+        frame[3] = (uint8_t)(temp_x10 & 0xFF);
+    }
+    frame[4] = (uint8_t)(frame[0] + frame[1] + frame[2] + frame[3]);
+}
+
+const char *dht_sim_fault_to_string(dht_sim_fault_t fault)
+{
+    switch (fault) {
+        case DHT_SIM_FAULT_NONE: return "none";
+        case DHT_SIM_FAULT_NO_RESPONSE: return "no_response";
+        case DHT_SIM_FAULT_MISSING_EDGE: return "missing_edge";
+        case DHT_SIM_FAULT_GLITCH: return "glitch";
+        case DHT_SIM_FAULT_BAD_CHECKSUM: return "bad_checksum";
+        default: return "unknown";
+    }
+}
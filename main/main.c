@@ -18,6 +18,8 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
+#include <time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
@@ -27,10 +29,16 @@
 #include "app_config.h"
 #include "app_common.h"
 #include "app_output.h"
-#include "sensor_dht.h"
+#include "controller.h"
+#include "output_schedule.h"
+#include "sensor_bus.h"
 #include "app_mqtt.h"
 #include "app_wifi.h"
 #include "system_task.h"
+#include "sensor_store.h"
+#include "sensor_history.h"
+#include "utils.h"
+#include "log_deferred.h"
 
 static const char *TAG = "MAIN";
 
@@ -92,6 +100,18 @@ const char* system_state_to_string(system_state_t state)
     }
 }
 
+/**
+ * @brief Binary log frames to the console UART (DEFAULT_LOG_BINARY)
+ * 
+ * Decode with tools/log_decoder, plain ESP_LOGx lines pass through.
+ */
+static void log_console_sink(const uint8_t *data, size_t len, void *ctx)
+{
+    (void)ctx;
+    fwrite(data, 1, len, stdout);
+    fflush(stdout);
+}
+
 /* =========================================================================
    PHASE 1: CONFIGURATION LOAD
    ========================================================================= */
@@ -145,26 +165,111 @@ static app_err_t config_init(app_config_t **config_out) {
 static app_err_t hardware_init(const app_config_t *config) {
     APP_LOG_INFO(TAG, "=== PHASE 2: HARDWARE INITIALIZATION ===");
 
-    // Initialization output module (relay, fan)
-    app_err_t ret = app_output_init(config->relay_pin, config->fan_pin);
+    // Initialization output module: channel 0 = relay, 1 = fan, then the
+    // configured extra fans and relays (channel ids of "output"/"outputs")
+    output_channel_config_t channels[OUTPUT_MAX_CHANNELS];
+    size_t channel_count = 0;
+    channels[channel_count++] = (output_channel_config_t){ OUTPUT_TYPE_RELAY, config->relay_pin };
+    channels[channel_count++] = (output_channel_config_t){ OUTPUT_TYPE_PWM, config->fan_pin };
+    for (size_t i = 0; i < APP_MAX_FANS - 1; i++) {
+        if (config->fan_extra_pins[i] != DEFAULT_OUTPUT_EXTRA_PIN) {
+            channels[channel_count++] = (output_channel_config_t){ OUTPUT_TYPE_PWM, config->fan_extra_pins[i] };
+        }
+    }
+    for (size_t i = 0; i < APP_MAX_RELAYS - 1; i++) {
+        if (config->relay_extra_pins[i] != DEFAULT_OUTPUT_EXTRA_PIN) {
+            channels[channel_count++] = (output_channel_config_t){ OUTPUT_TYPE_RELAY, config->relay_extra_pins[i] };
+        }
+    }
+
+    app_err_t ret = app_output_init_channels(channels, channel_count);
     if (ret != APP_OK) {
         APP_LOG_ERROR(TAG, "Output module init failed: %s", app_err_to_string(ret));
         return ret;
     }
-    APP_LOG_INFO(TAG, ":))) Output module initialized (Relay GPIO%d, Fan GPIO%d)",
-        config->relay_pin, config->fan_pin);
+    APP_LOG_INFO(TAG, ":))) Output module initialized (%u channels, Relay GPIO%d, Fan GPIO%d)",
+        (unsigned)channel_count, config->relay_pin, config->fan_pin);
+
+    // Local control loop (manual until a "mode" command, see controller.h)
+    control_config_t control_cfg = {
+        .mode = DEFAULT_CONTROL_MODE,
+        .sensor_id = DEFAULT_CONTROL_SENSOR_ID,
+        .setpoint_hum = DEFAULT_CONTROL_SETPOINT_HUM,
+        .setpoint_temp = DEFAULT_CONTROL_SETPOINT_TEMP,
+        .humidity = {
+            .kp = PID_GAIN_MILLI(DEFAULT_CONTROL_HUM_KP_MILLI),
+            .ki = PID_GAIN_MILLI(DEFAULT_CONTROL_HUM_KI_MILLI),
+            .kd = PID_GAIN_MILLI(DEFAULT_CONTROL_HUM_KD_MILLI),
+            .direction = PID_REVERSE,
+        },
+        .temperature = {
+            .kp = PID_GAIN_MILLI(DEFAULT_CONTROL_TEMP_KP_MILLI),
+            .ki = PID_GAIN_MILLI(DEFAULT_CONTROL_TEMP_KI_MILLI),
+            .kd = PID_GAIN_MILLI(DEFAULT_CONTROL_TEMP_KD_MILLI),
+            .direction = PID_REVERSE,
+        },
+        .relay_on_duty = DEFAULT_CONTROL_RELAY_ON_DUTY,
+        .relay_off_duty = DEFAULT_CONTROL_RELAY_OFF_DUTY,
+    };
+    ret = controller_init(&control_cfg);
+    if (ret != APP_OK) {
+        APP_LOG_ERROR(TAG, "Controller init failed: %s", app_err_to_string(ret));
+        return ret;
+    }
+
+    // Initialize DHT sensors (sensor 0 on dht_pin, others on dht_extra_pins)
+    uint8_t dht_pins[APP_MAX_DHT_SENSORS];
+    size_t dht_count = utils_clamp_int(config->dht_sensor_count, 1, APP_MAX_DHT_SENSORS);
+    dht_pins[0] = config->dht_pin;
+    for (size_t i = 1; i < dht_count; i++) {
+        dht_pins[i] = config->dht_extra_pins[i - 1];
+    }
+
+    const sensor_driver_t *dht_driver = sensor_dht_get_driver(config->dht_type);
+    if (!dht_driver) {
+        APP_LOG_WARN(TAG, "Unknown DHT type %d, using DHT11", config->dht_type);
+        dht_driver = &sensor_driver_dht11;
+    }
 
-    // Initialize DHT sensor
-    ret = sensor_dht_init(config->dht_pin);
+    ret = sensor_bus_init(dht_driver, dht_pins, dht_count, config->sensor_read_interval_ms);
     if (ret != APP_OK) {
         APP_LOG_ERROR(TAG, "DHT sensor init failed: %s", app_err_to_string(ret));
         return ret;
     }
-    APP_LOG_INFO(TAG, ":))) DHT sensor intialized on GPIO%d", config->dht_pin);
+    APP_LOG_INFO(TAG, ":))) %u of %u %s sensor(s) intialized (first on GPIO%d)",
+        (unsigned)sensor_bus_ready_count(), (unsigned)sensor_bus_count(), dht_driver->name, config->dht_pin);
+
+    // Read slower while readings are stable (fixed rate if the ceiling is not above the interval)
+    sensor_bus_adaptive_t adaptive = {
+        .max_interval_ms = config->sensor_read_interval_max_ms,
+        .temp_threshold = DEFAULT_SENSOR_TEMP_CHANGE_C,
+        .hum_threshold = DEFAULT_SENSOR_HUM_CHANGE_PCT,
+    };
+    ret = sensor_bus_set_adaptive(&adaptive);
+    if (ret != APP_OK) {
+        APP_LOG_WARN(TAG, "Adaptive sampling unavailable: %s", app_err_to_string(ret));
+    }
+
+    // Mount offline store (readings are dropped while offline if this fails)
+    ret = sensor_store_init();
+    if (ret != APP_OK) {
+        APP_LOG_WARN(TAG, "Offline sensor store unavailable: %s", app_err_to_string(ret));
+    } else {
+        APP_LOG_INFO(TAG, ":))) Offline sensor store mounted (%lu readings pending)",
+            sensor_store_pending());
+    }
+
+    // Allocate PSRAM history (on-demand aggregates are unavailable if this fails)
+    ret = sensor_history_init(sensor_bus_count());
+    if (ret != APP_OK) {
+        APP_LOG_WARN(TAG, "Sensor history unavailable: %s", app_err_to_string(ret));
+    } else {
+        APP_LOG_INFO(TAG, ":))) Sensor history allocated in PSRAM");
+    }
 
     // Do a quick test read
     sensor_data_t test_reading = {0};
-    ret = sensor_dht_read(&test_reading);
+    ret = sensor_bus_read_sensor(0, &test_reading);
     if (ret != APP_OK) {
         APP_LOG_WARN(TAG, "Initial DHT sensor read failed: %s", app_err_to_string(ret));
     } else if (test_reading.is_valid) {
@@ -196,6 +301,15 @@ static app_err_t task_system_init(const app_config_t *config)
     }
     APP_LOG_INFO(TAG, ":))) Task system initialized successfully.");
 
+    // Timed/daily output actions, written through the output task's queue
+    output_schedule_config_t schedule_cfg = {
+        .submit = system_task_submit_command,
+    };
+    ret = output_schedule_init(&schedule_cfg);
+    if (ret != APP_OK) {
+        APP_LOG_WARN(TAG, "Output scheduler unavailable: %s", app_err_to_string(ret));
+    }
+
     // Start all application tasks
     ret = system_task_start_all(config);
     if (ret != APP_OK) {
@@ -272,6 +386,7 @@ static app_err_t mqtt_connection_init(const app_config_t *config)
         .keepalive_sec = 60,
         .reconnect_timeout_ms = 5000,
         .on_message = on_mqtt_command_received,
+        .on_command = system_task_submit_command,
         .on_connected = on_mqtt_connected,
         .on_disconnected = on_mqtt_disconnected,
         .on_publish_failed = NULL
@@ -340,12 +455,13 @@ void on_mqtt_disconnected(void)
  * @param payload Pointer to payload data
  * @param payload_len Length of payload data
  * 
- * This will be processed in the mqtt_rx_task() via queue
- * There will have no processing here.
+ * Commands are parsed by the MQTT client and queued to the output task
+ * (system_task_submit_command()). There will have no processing here.
  */
 void on_mqtt_command_received(const char *topic, const char *payload, int payload_len)
 {
-    APP_LOG_DEBUG(TAG, "MQTT command received on %s: %.*s", topic, payload_len, payload);
+    (void)topic;    // Not NUL-terminated
+    APP_LOG_DEBUG(TAG, "MQTT command received: %.*s", payload_len, payload);
 }
 
 /* =========================================================================
@@ -358,6 +474,18 @@ void app_main(void)
     app_err_t ret = APP_OK;
     app_config_t *config = NULL;
 
+    // Deferred logger behind the APP_LOG_DEFER_* call sites
+    log_deferred_config_t log_cfg = {
+        .binary = DEFAULT_LOG_BINARY,
+        .sink = DEFAULT_LOG_BINARY ? log_console_sink : NULL,
+        .task_stack = DEFAULT_LOG_TASK_STACK,
+        .task_priority = DEFAULT_LOG_TASK_PRIORITY
+    };
+    ret = log_deferred_start(&log_cfg);
+    if (ret != APP_OK) {
+        APP_LOG_WARN(TAG, "Deferred logger unavailable, logging inline: %s", app_err_to_string(ret));
+    }
+
     // ========================================================================
     // PHASE 1: LOAD CONFIGURATION
     // ========================================================================
@@ -372,6 +500,10 @@ void app_main(void)
         return;
     }
 
+    // Local time of daily schedules (the clock itself comes from SNTP)
+    setenv("TZ", config->timezone, 1);
+    tzset();
+
     // ========================================================================
     // PHASE 2: INITIALIZATION HARDWARE
     // ========================================================================
@@ -0,0 +1,262 @@
+// tests/benchmark/bench_dht_decode.c
+
+/*
+ * Host-side benchmark: DHT edge-capture decoder against simulated
+ * waveforms (host/sim/dht_sim.c) with jitter, sensor clock error and
+ * injected faults.
+ *
+ * For every scenario it reports:
+ * - classification: frames decoded correctly / rejected / timed out, and
+ *   frames accepted with WRONG values (the failure that must never happen)
+ * - reader CPU time per sensor_dht_read() (setup + decode + checksum,
+ *   excluding the time blocked on the frame)
+ * - ISR time per captured edge (mean and worst case)
+ * - falling-edge periods of "0" and "1" bits seen by the ISR, to place
+ *   DHT_BIT_THRESHOLD_US between them
+ *
+ * Exits non-zero if a scenario marked "strict" misclassifies any frame.
+ * The others are stress cases past the decoder's tolerance: they show
+ * where decoding breaks down and how often several bit errors slip
+ * through the 8-bit additive checksum (WRONG).
+ *
+ * Driver logs (a checksum error per rejected frame) are muted while a
+ * scenario runs.
+ *
+ * Build and run (host build):
+ *   cmake -S host -B build-host && cmake --build build-host
+ *   ./build-host/bench_dht_decode
+ *
+ * Try another threshold:
+ *   cmake -S host -B build-host -DCMAKE_C_FLAGS=-DDHT_BIT_THRESHOLD_US=100
+ */
+
+#define _GNU_SOURCE
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "host_hal.h"
+#include "dht_sim.h"
+#include "sensor_dht.h"
+
+#define BENCH_PIN_DHT11     4
+#define BENCH_PIN_DHT22     5
+
+/* ============================================================================
+   SCENARIOS
+   ============================================================================ */
+
+typedef struct {
+    const char *name;
+    uint8_t type;
+    float clock_scale;
+    uint32_t jitter_us;
+    dht_sim_fault_t fault;
+    uint32_t frames;
+    bool strict;                // Every frame must be classified as expected
+} bench_scenario_t;
+
+static const bench_scenario_t g_scenarios[] = {
+    { "dht22 clean",            DHT_TYPE_DHT22, 1.00f, 0,  DHT_SIM_FAULT_NONE,         500, true  },
+    { "dht22 jitter 4us",       DHT_TYPE_DHT22, 1.00f, 4,  DHT_SIM_FAULT_NONE,         500, true  },
+    { "dht22 jitter 8us",       DHT_TYPE_DHT22, 1.00f, 8,  DHT_SIM_FAULT_NONE,         500, true  },
+    { "dht22 jitter 12us",      DHT_TYPE_DHT22, 1.00f, 12, DHT_SIM_FAULT_NONE,         500, false },
+    { "dht22 clock -15%",       DHT_TYPE_DHT22, 0.85f, 2,  DHT_SIM_FAULT_NONE,         500, true  },
+    { "dht22 clock +15%",       DHT_TYPE_DHT22, 1.15f, 2,  DHT_SIM_FAULT_NONE,         500, true  },
+    { "dht22 clock -20%",       DHT_TYPE_DHT22, 0.80f, 2,  DHT_SIM_FAULT_NONE,         500, false },
+    { "dht22 clock +20%",       DHT_TYPE_DHT22, 1.20f, 2,  DHT_SIM_FAULT_NONE,         500, false },
+    { "dht11 clean",            DHT_TYPE_DHT11, 1.00f, 0,  DHT_SIM_FAULT_NONE,         100, true  },
+    { "dht22 no response",      DHT_TYPE_DHT22, 1.00f, 0,  DHT_SIM_FAULT_NO_RESPONSE,  20,  true  },
+    { "dht22 missing edge",     DHT_TYPE_DHT22, 1.00f, 0,  DHT_SIM_FAULT_MISSING_EDGE, 20,  true  },
+    { "dht22 glitch",           DHT_TYPE_DHT22, 1.00f, 0,  DHT_SIM_FAULT_GLITCH,       200, true  },
+    { "dht22 bad checksum",     DHT_TYPE_DHT22, 1.00f, 0,  DHT_SIM_FAULT_BAD_CHECKSUM, 200, true  },
+};
+
+#define BENCH_SCENARIO_COUNT (sizeof(g_scenarios) / sizeof(g_scenarios[0]))
+
+typedef struct {
+    uint32_t correct;           // APP_OK, values match
+    uint32_t wrong;             // APP_OK, values differ
+    uint32_t rejected;          // APP_ERR_SENSOR_READ
+    uint32_t timeouts;          // APP_ERR_TIMEOUT
+    uint32_t expected;          // Outcome matched the scenario
+    uint64_t cpu_ns_total;
+} bench_result_t;
+
+/* ============================================================================
+   HELPERS
+   ============================================================================ */
+
+static uint32_t g_bench_rng = 12345;
+
+static float bench_uniform(float lo, float hi)
+{
+    g_bench_rng ^= g_bench_rng << 13;
+    g_bench_rng ^= g_bench_rng >> 17;
+    g_bench_rng ^= g_bench_rng << 5;
+    return lo + (hi - lo) * (float)(g_bench_rng % 10000) / 10000.0f;
+}
+
+static uint64_t bench_thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Send stderr (host driver logs) to /dev/null
+ * @return Saved stderr for bench_unmute_logs(), -1 if not muted
+ */
+static int bench_mute_logs(void)
+{
+    fflush(stderr);
+    int saved = dup(STDERR_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved < 0 || null_fd < 0) {
+        if (saved >= 0) close(saved);
+        if (null_fd >= 0) close(null_fd);
+        return -1;
+    }
+    dup2(null_fd, STDERR_FILENO);
+    close(null_fd);
+    return saved;
+}
+
+static void bench_unmute_logs(int saved)
+{
+    if (saved < 0) {
+        return;
+    }
+    fflush(stderr);
+    dup2(saved, STDERR_FILENO);
+    close(saved);
+}
+
+static app_err_t bench_expected_error(dht_sim_fault_t fault)
+{
+    switch (fault) {
+        case DHT_SIM_FAULT_NONE: return APP_OK;
+        case DHT_SIM_FAULT_NO_RESPONSE: return APP_ERR_TIMEOUT;
+        default: return APP_ERR_SENSOR_READ;
+    }
+}
+
+static void bench_run(const bench_scenario_t *sc, bench_result_t *res, dht_sim_stats_t *stats)
+{
+    uint8_t pin = (sc->type == DHT_TYPE_DHT11) ? BENCH_PIN_DHT11 : BENCH_PIN_DHT22;
+    uint32_t interval_ms = sensor_dht_get_driver(sc->type)->min_read_interval_ms;
+
+    dht_sim_t sim;
+    dht_sim_config_t cfg = DHT_SIM_CONFIG_DEFAULT(sc->type);
+    cfg.clock_scale = sc->clock_scale;
+    cfg.jitter_us = sc->jitter_us;
+    cfg.seed = 0xC0FFEE;
+    dht_sim_attach(&sim, pin, &cfg);
+    dht_sim_set_fault(&sim, sc->fault);
+
+    sensor_dht_handle_t dht;
+    int saved_stderr = bench_mute_logs();
+    if (sensor_dht_init(sc->type, 0, pin, &dht) != APP_OK) {
+        bench_unmute_logs(saved_stderr);
+        fprintf(stderr, "sensor_dht_init failed for %s\n", sc->name);
+        exit(2);
+    }
+
+    app_err_t expected = bench_expected_error(sc->fault);
+    for (uint32_t i = 0; i < sc->frames; i++) {
+        float temp = (sc->type == DHT_TYPE_DHT11) ? bench_uniform(0.0f, 50.0f)
+                                                  : bench_uniform(-20.0f, 60.0f);
+        float hum = bench_uniform(5.0f, 95.0f);
+        dht_sim_set_reading(&sim, temp, hum);
+
+        // Past the model's minimum interval, otherwise the cached reading comes back
+        host_clock_advance_us((uint64_t)(interval_ms + 1) * 1000);
+
+        sensor_data_t reading = {0};
+        uint64_t t0 = bench_thread_cpu_ns();
+        app_err_t ret = sensor_dht_read(dht, &reading);
+        res->cpu_ns_total += bench_thread_cpu_ns() - t0;
+
+        if (ret == APP_OK) {
+            // Frame encoding rounds to 0.1
+            bool match = fabsf(reading.temperature - roundf(temp * 10.0f) / 10.0f) < 0.051f &&
+                         fabsf(reading.humidity - roundf(hum * 10.0f) / 10.0f) < 0.051f;
+            if (match) {
+                res->correct++;
+            } else {
+                res->wrong++;
+            }
+            // A glitch in the last bit's HIGH phase only splits a "0" that
+            // still decodes correctly, accepting it is right
+            res->expected += (match && (expected == APP_OK || sc->fault == DHT_SIM_FAULT_GLITCH));
+        } else {
+            if (ret == APP_ERR_TIMEOUT) {
+                res->timeouts++;
+            } else if (ret == APP_ERR_SENSOR_READ) {
+                res->rejected++;
+            }
+            res->expected += (ret == expected);
+        }
+    }
+
+    bench_unmute_logs(saved_stderr);
+
+    *stats = sim.stats;
+    dht_sim_detach(&sim);
+}
+
+/* ============================================================================
+   MAIN
+   ============================================================================ */
+
+int main(void)
+{
+    int failures = 0;
+    uint32_t zero_max = 0;
+    uint32_t one_min = UINT32_MAX;
+
+    printf("%-20s %6s %6s %6s %6s %6s %8s %8s %8s %8s %11s %11s\n",
+           "scenario", "frames", "ok", "WRONG", "reject", "tmo", "accuracy",
+           "cpu us", "isr avg", "isr max", "'0' period", "'1' period");
+
+    for (size_t i = 0; i < BENCH_SCENARIO_COUNT; i++) {
+        const bench_scenario_t *sc = &g_scenarios[i];
+        bench_result_t res = {0};
+        dht_sim_stats_t stats = {0};
+        bench_run(sc, &res, &stats);
+
+        double accuracy = 100.0 * res.expected / sc->frames;
+        double isr_avg_us = stats.isr_edges ? stats.isr_ns_total / 1000.0 / stats.isr_edges : 0.0;
+        double isr_max_us = stats.isr_ns_max / 1000.0;
+        printf("%-20s %6lu %6lu %6lu %6lu %6lu %7.1f%% %8.2f %8.2f %8.2f %5lu-%-5lu %5lu-%-5lu%s\n",
+               sc->name, (unsigned long)sc->frames, (unsigned long)res.correct,
+               (unsigned long)res.wrong, (unsigned long)res.rejected,
+               (unsigned long)res.timeouts, accuracy,
+               res.cpu_ns_total / 1000.0 / sc->frames, isr_avg_us, isr_max_us,
+               (unsigned long)stats.zero_period_min_us, (unsigned long)stats.zero_period_max_us,
+               (unsigned long)stats.one_period_min_us, (unsigned long)stats.one_period_max_us,
+               (sc->strict && res.expected != sc->frames) ? "  <-- FAIL" : "");
+
+        if (sc->strict && res.expected != sc->frames) {
+            failures++;
+        }
+        if (sc->strict && sc->fault == DHT_SIM_FAULT_NONE && stats.frames > 0) {
+            if (stats.zero_period_max_us > zero_max) zero_max = stats.zero_period_max_us;
+            if (stats.one_period_min_us < one_min) one_min = stats.one_period_min_us;
+        }
+    }
+
+    printf("\nStrict scenarios: worst '0' period %lu us, best '1' period %lu us",
+           (unsigned long)zero_max, (unsigned long)one_min);
+    if (one_min > zero_max) {
+        printf(" -> threshold midpoint %lu us\n",
+               (unsigned long)((zero_max + one_min) / 2));
+    } else {
+        printf(" -> overlapping, no threshold separates all scenarios\n");
+    }
+
+    return failures ? 1 : 0;
+}
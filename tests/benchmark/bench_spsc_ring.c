@@ -0,0 +1,228 @@
+// tests/benchmark/bench_spsc_ring.c
+
+/*
+ * Host-side benchmark: spsc_ring vs FreeRTOS queue for sensor messages
+ * (sensor_data_t + sequence, as between the sensor and publisher tasks).
+ *
+ * Three cases:
+ * - single:  one task, send one / receive one
+ * - batch:   one task, send BENCH_BATCH then receive them all
+ *            (the ring pops them with one call)
+ * - stream:  producer and consumer tasks, BENCH_STREAM_ITEMS messages,
+ *            the consumer sleeps while empty (queue: blocking receive,
+ *            ring: task notification, as in system_task.c); message
+ *            order is checked
+ *
+ * The host FreeRTOS queue is a pthread mutex + condition variables, so
+ * absolute numbers differ from the ESP32 (critical section + scheduler),
+ * the per-item kernel call pattern is the same.
+ *
+ * Build and run (host build):
+ *   cmake -S host -B build-host && cmake --build build-host
+ *   ./build-host/bench_spsc_ring
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "app_common.h"
+#include "spsc_ring.h"
+
+#define BENCH_ITERATIONS        200000
+#define BENCH_BATCH             8
+#define BENCH_CAPACITY          16
+#define BENCH_STREAM_ITEMS      200000
+
+typedef struct {
+    sensor_data_t data;
+    uint32_t sequence;
+} bench_message_t;
+
+static QueueHandle_t g_queue;
+static spsc_ring_t g_ring;
+static bench_message_t g_ring_storage[BENCH_CAPACITY];
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* ============================================================================
+   SINGLE TASK
+   ============================================================================ */
+
+static double bench_queue_single(void)
+{
+    bench_message_t in = {0}, out;
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        in.sequence = i;
+        xQueueSend(g_queue, &in, 0);
+        xQueueReceive(g_queue, &out, 0);
+    }
+    return (double)(bench_now_ns() - t0) / BENCH_ITERATIONS;
+}
+
+static double bench_ring_single(void)
+{
+    bench_message_t in = {0}, out;
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        in.sequence = i;
+        spsc_ring_push(&g_ring, &in);
+        spsc_ring_pop_batch(&g_ring, &out, 1);
+    }
+    return (double)(bench_now_ns() - t0) / BENCH_ITERATIONS;
+}
+
+static double bench_queue_batch(void)
+{
+    bench_message_t in = {0}, out[BENCH_BATCH];
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+        for (int j = 0; j < BENCH_BATCH; j++) {
+            xQueueSend(g_queue, &in, 0);
+        }
+        for (int j = 0; j < BENCH_BATCH; j++) {
+            xQueueReceive(g_queue, &out[j], 0);
+        }
+    }
+    return (double)(bench_now_ns() - t0) / BENCH_ITERATIONS;
+}
+
+static double bench_ring_batch(void)
+{
+    bench_message_t in = {0}, out[BENCH_BATCH];
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+        for (int j = 0; j < BENCH_BATCH; j++) {
+            spsc_ring_push(&g_ring, &in);
+        }
+        spsc_ring_pop_batch(&g_ring, out, BENCH_BATCH);
+    }
+    return (double)(bench_now_ns() - t0) / BENCH_ITERATIONS;
+}
+
+/* ============================================================================
+   PRODUCER / CONSUMER TASKS
+   ============================================================================ */
+
+typedef struct {
+    bool use_ring;
+    TaskHandle_t consumer;
+    SemaphoreHandle_t done;
+    uint32_t out_of_order;
+    uint32_t wakeups;           // Consumer returns from a blocking call
+} bench_stream_t;
+
+static void bench_producer_task(void *arg)
+{
+    bench_stream_t *st = arg;
+    bench_message_t msg = {0};
+
+    for (uint32_t i = 0; i < BENCH_STREAM_ITEMS; i++) {
+        msg.sequence = i;
+        if (st->use_ring) {
+            while (!spsc_ring_push(&g_ring, &msg)) {
+                taskYIELD();
+            }
+            xTaskNotifyGive(st->consumer);
+        } else {
+            xQueueSend(g_queue, &msg, portMAX_DELAY);
+        }
+    }
+    vTaskDelete(NULL);
+}
+
+static void bench_consumer_task(void *arg)
+{
+    bench_stream_t *st = arg;
+    bench_message_t batch[BENCH_CAPACITY];
+    uint32_t expected = 0;
+
+    while (expected < BENCH_STREAM_ITEMS) {
+        size_t n;
+        if (st->use_ring) {
+            if (spsc_ring_count(&g_ring) == 0) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                st->wakeups++;
+            }
+            n = spsc_ring_pop_batch(&g_ring, batch, BENCH_CAPACITY);
+        } else {
+            n = (xQueueReceive(g_queue, &batch[0], portMAX_DELAY) == pdTRUE) ? 1 : 0;
+            st->wakeups++;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            if (batch[i].sequence != expected) {
+                st->out_of_order++;
+            }
+            expected = batch[i].sequence + 1;
+        }
+    }
+    xSemaphoreGive(st->done);
+    vTaskDelete(NULL);
+}
+
+static double bench_stream(bool use_ring, bench_stream_t *st)
+{
+    st->use_ring = use_ring;
+    st->out_of_order = 0;
+    st->wakeups = 0;
+    st->done = xSemaphoreCreateBinary();
+
+    uint64_t t0 = bench_now_ns();
+    xTaskCreate(bench_consumer_task, "consumer", 4096, st, 5, &st->consumer);
+    xTaskCreate(bench_producer_task, "producer", 4096, st, 5, NULL);
+    xSemaphoreTake(st->done, portMAX_DELAY);
+    double ns = (double)(bench_now_ns() - t0) / BENCH_STREAM_ITEMS;
+
+    vSemaphoreDelete(st->done);
+    return ns;
+}
+
+/* ============================================================================
+   MAIN
+   ============================================================================ */
+
+int main(void)
+{
+    g_queue = xQueueCreate(BENCH_CAPACITY, sizeof(bench_message_t));
+    if (!g_queue || !spsc_ring_init(&g_ring, g_ring_storage, sizeof(g_ring_storage[0]),
+                                    BENCH_CAPACITY)) {
+        fprintf(stderr, "init failed\n");
+        return 2;
+    }
+
+    printf("Message: %u bytes, capacity %d\n\n", (unsigned)sizeof(bench_message_t), BENCH_CAPACITY);
+    printf("%-28s %12s %12s\n", "case", "queue ns/msg", "ring ns/msg");
+    printf("%-28s %12.1f %12.1f\n", "single (send + receive)", bench_queue_single(), bench_ring_single());
+    printf("%-28s %12.1f %12.1f\n", "batch of 8", bench_queue_batch(), bench_ring_batch());
+
+    bench_stream_t queue_st = {0}, ring_st = {0};
+    double queue_ns = bench_stream(false, &queue_st);
+    double ring_ns = bench_stream(true, &ring_st);
+    printf("%-28s %12.1f %12.1f\n", "stream (2 tasks)", queue_ns, ring_ns);
+    printf("%-28s %12lu %12lu\n", "  consumer wakeups",
+           (unsigned long)queue_st.wakeups, (unsigned long)ring_st.wakeups);
+
+    spsc_ring_stats_t stats;
+    spsc_ring_get_stats(&g_ring, &stats);
+    printf("\nRing: pushed %lu, high water %lu/%lu, overflows %lu\n",
+           (unsigned long)stats.pushed, (unsigned long)stats.high_water,
+           (unsigned long)stats.capacity, (unsigned long)stats.overflows);
+
+    if (queue_st.out_of_order || ring_st.out_of_order) {
+        printf("FAIL: out of order messages (queue %lu, ring %lu)\n",
+               (unsigned long)queue_st.out_of_order, (unsigned long)ring_st.out_of_order);
+        return 1;
+    }
+    return 0;
+}
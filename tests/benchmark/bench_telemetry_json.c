@@ -0,0 +1,182 @@
+// tests/benchmark/bench_telemetry_json.c
+
+/*
+ * Host-side benchmark: telemetry_json vs cJSON for the sensor payload
+ * (encode) and the {type,value} command (decode).
+ *
+ * Reports ns/op, cycles/op (x86 only) and heap calls/op. Heap calls are
+ * counted by interposing malloc/calloc/realloc/free (glibc).
+ *
+ * Build (cJSON sources ship with ESP-IDF):
+ *   gcc -O2 -I host/include -I components/app_config/include \
+ *       -I components/telemetry/include -I $IDF_PATH/components/json/cJSON \
+ *       tests/benchmark/bench_telemetry_json.c components/telemetry/telemetry_json.c \
+ *       $IDF_PATH/components/json/cJSON/cJSON.c -o bench_telemetry_json
+ *   ./bench_telemetry_json
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cJSON.h"
+#include "telemetry_json.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+#define BENCH_ITERATIONS 200000
+
+/* ============================================================================
+   HEAP CALL COUNTING
+   ============================================================================ */
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static unsigned long g_heap_calls = 0;
+
+void *malloc(size_t size) { g_heap_calls++; return __libc_malloc(size); }
+void *calloc(size_t n, size_t size) { g_heap_calls++; return __libc_calloc(n, size); }
+void *realloc(void *ptr, size_t size) { g_heap_calls++; return __libc_realloc(ptr, size); }
+void free(void *ptr) { if (ptr) { g_heap_calls++; } __libc_free(ptr); }
+
+/* ============================================================================
+   TIMING
+   ============================================================================ */
+
+typedef struct {
+    const char *name;
+    double ns_per_op;
+    double cycles_per_op;
+    double heap_per_op;
+} bench_result_t;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t bench_cycles(void)
+{
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static volatile size_t g_sink;
+
+static bench_result_t bench_run(const char *name, size_t (*fn)(void))
+{
+    // Warm up caches and allocator
+    for (int i = 0; i < 1000; i++) {
+        g_sink += fn();
+    }
+
+    unsigned long heap_start = g_heap_calls;
+    uint64_t t0 = bench_now_ns();
+    uint64_t c0 = bench_cycles();
+
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        g_sink += fn();
+    }
+
+    uint64_t c1 = bench_cycles();
+    uint64_t t1 = bench_now_ns();
+
+    bench_result_t r = {
+        .name = name,
+        .ns_per_op = (double)(t1 - t0) / BENCH_ITERATIONS,
+        .cycles_per_op = (double)(c1 - c0) / BENCH_ITERATIONS,
+        .heap_per_op = (double)(g_heap_calls - heap_start) / BENCH_ITERATIONS,
+    };
+    return r;
+}
+
+/* ============================================================================
+   WORKLOADS
+   ============================================================================ */
+
+static const sensor_data_t g_reading = {
+    .temperature = 24.7f,
+    .humidity = 58.3f,
+    .timestamp_ms = 86400123ull,
+    .is_valid = true,
+};
+
+static const char g_command[] = "{\"type\":\"fan\",\"value\":200}";
+
+static size_t encode_cjson(void)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "id", g_reading.sensor_id);
+    cJSON_AddNumberToObject(root, "ts", (double)g_reading.timestamp_ms);
+    cJSON_AddNumberToObject(root, "t", g_reading.temperature);
+    cJSON_AddNumberToObject(root, "h", g_reading.humidity);
+
+    char *out = cJSON_PrintUnformatted(root);
+    size_t len = out ? strlen(out) : 0;
+
+    cJSON_free(out);
+    cJSON_Delete(root);
+    return len;
+}
+
+static size_t encode_telemetry(void)
+{
+    char buf[64];
+    telemetry_json_writer_t w;
+    telemetry_json_init(&w, buf, sizeof(buf));
+    telemetry_json_write_reading(&w, &g_reading);
+    return telemetry_json_finish(&w);
+}
+
+static size_t decode_cjson(void)
+{
+    cJSON *json = cJSON_ParseWithLength(g_command, sizeof(g_command) - 1);
+    cJSON *type = cJSON_GetObjectItem(json, "type");
+    cJSON *value = cJSON_GetObjectItem(json, "value");
+    size_t r = (cJSON_IsString(type) && cJSON_IsNumber(value)) ? (size_t)value->valueint : 0;
+    cJSON_Delete(json);
+    return r;
+}
+
+static size_t decode_telemetry(void)
+{
+    telemetry_command_t cmd;
+    if (telemetry_json_decode_command(g_command, sizeof(g_command) - 1, &cmd) != APP_OK) {
+        return 0;
+    }
+    return (size_t)cmd.value;
+}
+
+/* ============================================================================
+   MAIN
+   ============================================================================ */
+
+int main(void)
+{
+    bench_result_t results[] = {
+        bench_run("encode cJSON", encode_cjson),
+        bench_run("encode telemetry_json", encode_telemetry),
+        bench_run("decode cJSON", decode_cjson),
+        bench_run("decode telemetry_json", decode_telemetry),
+    };
+
+    printf("%-24s %10s %12s %10s\n", "benchmark", "ns/op", "cycles/op", "heap/op");
+    for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+        printf("%-24s %10.1f %12.1f %10.2f\n", results[i].name,
+               results[i].ns_per_op, results[i].cycles_per_op, results[i].heap_per_op);
+    }
+
+    return 0;
+}
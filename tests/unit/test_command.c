@@ -0,0 +1,164 @@
+// tests/unit/test_command.c
+#include "unity.h"
+#include <string.h>
+#include "command.h"
+
+static int32_t g_last_value;
+static int g_calls;
+
+static app_err_t record_handler(const command_t *cmd, void *ctx) {
+    (void)ctx;
+    g_last_value = cmd->value;
+    g_calls++;
+    return APP_OK;
+}
+
+void test_command_lookup_resolves_every_name(void) {
+    for (int id = 0; id < COMMAND_COUNT; id++) {
+        const char *name = command_to_string((command_id_t)id);
+        TEST_ASSERT_EQUAL_INT(id, command_lookup(name, strlen(name)));
+    }
+
+    // Not NUL-terminated, as it comes out of the JSON decoder
+    TEST_ASSERT_EQUAL_INT(COMMAND_FAN, command_lookup("fan\", \"value\"", 3));
+    TEST_ASSERT_EQUAL_INT(COMMAND_INVALID, command_lookup("fa", 2));
+    TEST_ASSERT_EQUAL_INT(COMMAND_INVALID, command_lookup("fans", 4));
+    TEST_ASSERT_EQUAL_INT(COMMAND_INVALID, command_lookup("reboot", 6));
+}
+
+void test_command_dispatch_checks_registered_range(void) {
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_register(COMMAND_HEARTBEAT, 0, 60, record_handler, NULL));
+    g_calls = 0;
+
+    command_t cmd = { .id = COMMAND_HEARTBEAT, .value = 30 };
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_dispatch(&cmd));
+    TEST_ASSERT_EQUAL_INT(30, g_last_value);
+
+    cmd.value = 61;
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_VALUE, command_dispatch(&cmd));
+    cmd.value = -1;
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_VALUE, command_dispatch(&cmd));
+    TEST_ASSERT_EQUAL_INT(1, g_calls);
+
+    cmd.id = COMMAND_INVALID;
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM, command_dispatch(&cmd));
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM, command_register(COMMAND_FAN, 10, 0, record_handler, NULL));
+}
+
+void test_command_dispatch_checks_group_changes(void) {
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_register(COMMAND_OUTPUTS, 0, 255, record_handler, NULL));
+    g_calls = 0;
+
+    command_change_t changes[COMMAND_MAX_CHANGES + 1] = {
+        { .channel = 0, .value = 1 }, { .channel = 2, .value = 200 }
+    };
+    command_t cmd = { .id = COMMAND_OUTPUTS };
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_set_group(&cmd, changes, 2));
+    TEST_ASSERT_EQUAL_INT(2, command_get_group(&cmd)->count);
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_dispatch(&cmd));
+
+    // One bad change rejects the whole group
+    changes[1].value = 256;
+    cmd.group = COMMAND_GROUP_NONE;
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_set_group(&cmd, changes, 2));
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_VALUE, command_dispatch(&cmd));
+
+    cmd.group = COMMAND_GROUP_NONE;
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM, command_set_group(&cmd, changes, COMMAND_MAX_CHANGES + 1));
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM, command_set_group(&cmd, changes, 0));
+    TEST_ASSERT_NULL(command_get_group(&cmd));
+    TEST_ASSERT_EQUAL_INT(1, g_calls);
+}
+
+void test_command_groups_are_released(void) {
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_register(COMMAND_OUTPUTS, 0, 255, record_handler, NULL));
+    command_change_t change = { .channel = 1, .value = 100 };
+    command_t cmds[COMMAND_GROUP_SLOTS];
+
+    // Every slot taken: the next group is refused
+    for (int i = 0; i < COMMAND_GROUP_SLOTS; i++) {
+        cmds[i] = (command_t){ .id = COMMAND_OUTPUTS };
+        TEST_ASSERT_EQUAL_INT(APP_OK, command_set_group(&cmds[i], &change, 1));
+    }
+    command_t extra = { .id = COMMAND_OUTPUTS };
+    TEST_ASSERT_EQUAL_INT(APP_ERR_NO_MEMORY, command_set_group(&extra, &change, 1));
+
+    // Dispatch (even a failed one) and release give slots back
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_dispatch(&cmds[0]));
+    cmds[1].id = COMMAND_INVALID;
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM, command_dispatch(&cmds[1]));
+    for (int i = 2; i < COMMAND_GROUP_SLOTS; i++) {
+        command_release(&cmds[i]);
+    }
+    for (int i = 0; i < COMMAND_GROUP_SLOTS; i++) {
+        cmds[i] = (command_t){ .id = COMMAND_OUTPUTS };
+        TEST_ASSERT_EQUAL_INT(APP_OK, command_set_group(&cmds[i], &change, 1));
+    }
+    for (int i = 0; i < COMMAND_GROUP_SLOTS; i++) {
+        command_release(&cmds[i]);
+    }
+
+    // Commands without a group are ignored
+    command_release(&extra);
+    TEST_ASSERT_TRUE(sizeof(command_t) <= 32);
+}
+
+static app_err_t actuating_handler(const command_t *cmd, void *ctx) {
+    (void)cmd;
+    (void)ctx;
+    command_mark_actuated();
+    return APP_OK;
+}
+
+void test_command_dispatch_records_stage_latency(void) {
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_register(COMMAND_HEARTBEAT, 0, 60, actuating_handler, NULL));
+
+    command_stage_stats_t before, after;
+    command_get_stage_latency(COMMAND_STAGE_TOTAL, &before);
+
+    // Unstamped commands are not counted
+    command_t cmd = { .id = COMMAND_HEARTBEAT, .value = 5 };
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_dispatch(&cmd));
+    command_get_stage_latency(COMMAND_STAGE_TOTAL, &after);
+    TEST_ASSERT_EQUAL_UINT32(before.hist.count, after.hist.count);
+
+    uint32_t now = command_now_us();
+    cmd.stamps.received_us = now - 300;
+    cmd.stamps.queued_us = now - 200;
+    cmd.stamps.dequeued_us = now - 50;
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_dispatch(&cmd));
+
+    command_get_stage_latency(COMMAND_STAGE_TOTAL, &after);
+    TEST_ASSERT_EQUAL_UINT32(before.hist.count + 1, after.hist.count);
+    TEST_ASSERT_TRUE(after.last_us >= 300);
+    command_get_stage_latency(COMMAND_STAGE_PARSE, &after);
+    TEST_ASSERT_EQUAL_UINT32(100, after.last_us);
+    command_get_stage_latency(COMMAND_STAGE_QUEUE, &after);
+    TEST_ASSERT_EQUAL_UINT32(150, after.last_us);
+    command_get_stage_latency(COMMAND_STAGE_ACTUATE, &after);
+    TEST_ASSERT_TRUE(after.last_us >= 50);
+
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM, command_get_stage_latency(COMMAND_STAGE_COUNT, &after));
+}
+
+void test_command_without_actuation_skips_stage_latency(void) {
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_register(COMMAND_HEARTBEAT, 0, 60, record_handler, NULL));
+
+    command_stage_stats_t before[COMMAND_STAGE_COUNT], after;
+    for (int stage = 0; stage < COMMAND_STAGE_COUNT; stage++) {
+        command_get_stage_latency((command_stage_t)stage, &before[stage]);
+    }
+
+    // Stamped, but the handler writes no output
+    uint32_t now = command_now_us();
+    command_t cmd = { .id = COMMAND_HEARTBEAT, .value = 5 };
+    cmd.stamps.received_us = now - 300;
+    cmd.stamps.queued_us = now - 200;
+    cmd.stamps.dequeued_us = now - 50;
+    TEST_ASSERT_EQUAL_INT(APP_OK, command_dispatch(&cmd));
+
+    for (int stage = 0; stage < COMMAND_STAGE_COUNT; stage++) {
+        command_get_stage_latency((command_stage_t)stage, &after);
+        TEST_ASSERT_EQUAL_UINT32(before[stage].hist.count, after.hist.count);
+    }
+}
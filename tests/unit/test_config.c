@@ -1,6 +1,7 @@
 // tests/unit/test_config.c
 #include "unity.h"
 #include "app_config.h"
+#include "nvs.h"
 
 void test_config_load_defaults(void) {
     app_config_t *cfg = app_config_get();
@@ -14,4 +15,18 @@ void test_config_save_wifi(void) {
     
     app_config_t *cfg = app_config_get();
     TEST_ASSERT_EQUAL_STRING("TestSSID", cfg->wifi_ssid);
-}
\ No newline at end of file
+}
+
+void test_config_timezone_from_nvs(void) {
+    app_config_t *cfg = app_config_get();
+    TEST_ASSERT_EQUAL_STRING(DEFAULT_TIMEZONE, cfg->timezone);
+
+    nvs_handle_t handle;
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, nvs_set_str(handle, NVS_KEY_TIMEZONE, "CET-1CEST,M3.5.0,M10.5.0/3"));
+    nvs_commit(handle);
+    nvs_close(handle);
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_config_load());
+    TEST_ASSERT_EQUAL_STRING("CET-1CEST,M3.5.0,M10.5.0/3", cfg->timezone);
+}
@@ -0,0 +1,44 @@
+// tests/unit/test_latency_hist.c
+#include "unity.h"
+#include "latency_hist.h"
+
+void test_latency_hist_buckets_are_contiguous(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, latency_hist_bucket_lower(0));
+    for (size_t i = 1; i < LATENCY_HIST_BUCKETS; i++) {
+        TEST_ASSERT_EQUAL_UINT32(latency_hist_bucket_upper(i - 1) + 1, latency_hist_bucket_lower(i));
+        TEST_ASSERT_EQUAL_UINT32(i, latency_hist_bucket_index(latency_hist_bucket_lower(i)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(LATENCY_HIST_BUCKETS - 1, latency_hist_bucket_index(UINT32_MAX));
+}
+
+void test_latency_hist_bucket_width_within_precision(void) {
+    // Below 16 us every bucket is exact, above it at most 1/8 of its lower bound wide
+    TEST_ASSERT_EQUAL_UINT32(15, latency_hist_bucket_index(15));
+    for (size_t i = 2 * LATENCY_HIST_SUB_COUNT; i < LATENCY_HIST_BUCKETS - 1; i++) {
+        uint32_t lower = latency_hist_bucket_lower(i);
+        uint32_t width = latency_hist_bucket_upper(i) - lower + 1;
+        TEST_ASSERT_TRUE(width * LATENCY_HIST_SUB_COUNT <= lower);
+    }
+}
+
+void test_latency_hist_percentiles(void) {
+    latency_hist_t hist;
+    latency_hist_reset(&hist);
+    TEST_ASSERT_EQUAL_UINT32(0, latency_hist_percentile(&hist, 500));
+
+    // 90 fast, 10 slow
+    for (int i = 0; i < 90; i++) {
+        latency_hist_record(&hist, 1000);
+    }
+    for (int i = 0; i < 10; i++) {
+        latency_hist_record(&hist, 20000);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(100, hist.count);
+    TEST_ASSERT_EQUAL_UINT32(20000, hist.max);
+    uint32_t p50 = latency_hist_percentile(&hist, 500);
+    TEST_ASSERT_TRUE(p50 >= 1000 && p50 < 1000 + 1000 / 8);
+    TEST_ASSERT_EQUAL_UINT32(p50, latency_hist_percentile(&hist, 900));
+    TEST_ASSERT_EQUAL_UINT32(20000, latency_hist_percentile(&hist, 910));
+    TEST_ASSERT_EQUAL_UINT32(20000, latency_hist_percentile(&hist, 1000));
+}
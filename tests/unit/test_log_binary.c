@@ -0,0 +1,67 @@
+// tests/unit/test_log_binary.c
+#include "unity.h"
+#include "log_binary.h"
+#include <string.h>
+
+void test_log_binary_render_matches_printf(void) {
+    log_arg_t args[] = { { .i = -7 }, { .u = 4000000000u }, { .d = 21.25 }, { .p = "fan" }, { .i = 'x' } };
+    char line[128];
+    char expected[128];
+
+    size_t len = log_binary_render("%d|%lu|%5.1f|%-4s|%c|100%%", args, 5, line, sizeof(line));
+    snprintf(expected, sizeof(expected), "%d|%lu|%5.1f|%-4s|%c|100%%", -7, 4000000000ul, 21.25, "fan", 'x');
+    TEST_ASSERT_EQUAL_STRING(expected, line);
+    TEST_ASSERT_EQUAL_size_t(strlen(expected), len);
+
+    // Star width, missing argument, truncation
+    log_arg_t star[] = { { .i = 6 }, { .i = 42 } };
+    log_binary_render("[%*d] %d", star, 2, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("[    42] ?", line);
+    TEST_ASSERT_EQUAL_size_t(4, log_binary_render("%d-%d-%d", star, 2, line, 5));
+    TEST_ASSERT_EQUAL_STRING("6-42", line);
+}
+
+void test_log_binary_arg_kinds(void) {
+    log_arg_kind_t kinds[LOG_BINARY_MAX_ARGS];
+    TEST_ASSERT_EQUAL(4, log_binary_arg_kinds("%s %.*f %% %p", kinds, LOG_BINARY_MAX_ARGS));
+    TEST_ASSERT_EQUAL(LOG_ARG_KIND_STRING, kinds[0]);
+    TEST_ASSERT_EQUAL(LOG_ARG_KIND_INT, kinds[1]);
+    TEST_ASSERT_EQUAL(LOG_ARG_KIND_DOUBLE, kinds[2]);
+    TEST_ASSERT_EQUAL(LOG_ARG_KIND_POINTER, kinds[3]);
+    TEST_ASSERT_EQUAL(LOG_BINARY_ERR_NO_SPACE, log_binary_arg_kinds("%d %d", kinds, 1));
+}
+
+void test_log_binary_frames_roundtrip(void) {
+    const char *fmt = "Sensor %d: %.1f C (%s)";
+    uint8_t buf[2 * LOG_BINARY_MAX_FRAME];
+    log_binary_frame_t frame;
+
+    int format_len = log_binary_encode_format(3, LOG_BINARY_LEVEL_INFO, "SYSTEM", fmt, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(format_len > 0);
+
+    char name[8] = "dht22";
+    log_arg_t args[] = { { .i = 1 }, { .d = 23.5 }, { .p = name } };
+    int record_len = log_binary_encode_record(3, 5000, fmt, args, 3, buf + format_len,
+                                              sizeof(buf) - (size_t)format_len);
+    TEST_ASSERT_TRUE(record_len > 0);
+    strcpy(name, "gone");   // Frame holds a copy
+
+    TEST_ASSERT_EQUAL(format_len, log_binary_decode(buf, (size_t)(format_len + record_len), &frame));
+    TEST_ASSERT_EQUAL(LOG_BINARY_FRAME_FORMAT, frame.type);
+    TEST_ASSERT_EQUAL_STRING("SYSTEM", frame.tag);
+    TEST_ASSERT_EQUAL_STRING(fmt, frame.text);
+
+    TEST_ASSERT_EQUAL(record_len, log_binary_decode(buf + format_len, (size_t)record_len, &frame));
+    TEST_ASSERT_EQUAL(LOG_BINARY_FRAME_RECORD, frame.type);
+    TEST_ASSERT_EQUAL_UINT32(5000, frame.time_ms);
+
+    char line[64];
+    log_binary_render(fmt, frame.args, frame.argc, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("Sensor 1: 23.5 C (dht22)", line);
+
+    // Truncated and corrupted input
+    TEST_ASSERT_EQUAL(LOG_BINARY_ERR_INCOMPLETE, log_binary_decode(buf, 3, &frame));
+    TEST_ASSERT_EQUAL(LOG_BINARY_ERR_INCOMPLETE, log_binary_decode(buf, (size_t)format_len - 1, &frame));
+    buf[LOG_BINARY_HEADER_SIZE] ^= 0x01;
+    TEST_ASSERT_EQUAL(LOG_BINARY_ERR_MALFORMED, log_binary_decode(buf, (size_t)format_len, &frame));
+}
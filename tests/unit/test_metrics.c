@@ -0,0 +1,50 @@
+// tests/unit/test_metrics.c
+#include "unity.h"
+#include "metrics.h"
+#include <string.h>
+
+static metrics_counter_t g_test_counter;
+static metrics_gauge_t g_test_gauge;
+METRICS_HISTOGRAM_DEFINE(g_test_hist, 10, 100);
+
+void test_metrics_counter_and_gauge(void) {
+    TEST_ASSERT_EQUAL(APP_OK, metrics_register_counter(&g_test_counter, "test_events_total"));
+    TEST_ASSERT_EQUAL(APP_OK, metrics_register_gauge(&g_test_gauge, "test_level"));
+    // Registering again is harmless
+    TEST_ASSERT_EQUAL(APP_OK, metrics_register_counter(&g_test_counter, "test_events_total"));
+
+    metrics_counter_inc(&g_test_counter);
+    metrics_counter_add(&g_test_counter, 4);
+    metrics_gauge_set(&g_test_gauge, 7);
+    metrics_gauge_add(&g_test_gauge, -9);
+
+    int64_t value = 0;
+    TEST_ASSERT_EQUAL_UINT32(5, metrics_counter_get(&g_test_counter));
+    TEST_ASSERT_EQUAL(APP_OK, metrics_read("test_events_total", &value));
+    TEST_ASSERT_EQUAL_INT64(5, value);
+    TEST_ASSERT_EQUAL(APP_OK, metrics_read("test_level", &value));
+    TEST_ASSERT_EQUAL_INT64(-2, value);
+    TEST_ASSERT_EQUAL(APP_ERR_INVALID_PARAM, metrics_read("test_missing", &value));
+}
+
+void test_metrics_prometheus_export(void) {
+    TEST_ASSERT_EQUAL(APP_OK, metrics_register_histogram(&g_test_hist, "test_duration_us"));
+    metrics_histogram_observe(&g_test_hist, 5);
+    metrics_histogram_observe(&g_test_hist, 10);
+    metrics_histogram_observe(&g_test_hist, 50);
+    metrics_histogram_observe(&g_test_hist, 500);
+
+    char buffer[1024];
+    size_t len = metrics_export_prometheus(buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(len > 0);
+    TEST_ASSERT_EQUAL_size_t(strlen(buffer), len);
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "# TYPE test_duration_us histogram\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "test_duration_us_bucket{le=\"10\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "test_duration_us_bucket{le=\"100\"} 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "test_duration_us_bucket{le=\"+Inf\"} 4\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "test_duration_us_sum 565\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "test_duration_us_count 4\n"));
+
+    // Too small: nothing, not a truncated payload
+    TEST_ASSERT_EQUAL_size_t(0, metrics_export_prometheus(buffer, 32));
+}
@@ -0,0 +1,119 @@
+// tests/unit/test_output_ramp.c
+#include "unity.h"
+#include <time.h>
+#include "app_output.h"
+#include "host_hal.h"
+#include "driver/ledc.h"
+
+#define RELAY_PIN   5
+#define FAN_PIN     18
+#define FAN_LEDC    LEDC_CHANNEL_0      // First PWM channel takes the lowest LEDC channel
+
+// Let the esp_timer thread and the ramp task handle a fade end (real time,
+// the frozen clock does not move meanwhile)
+static void settle(void) {
+    struct timespec ts = { .tv_sec = 0, .tv_nsec = 20 * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void advance_ms(uint32_t ms) {
+    host_clock_advance_us((uint64_t)ms * 1000);
+    settle();
+}
+
+static void output_start(void) {
+    app_output_deinit();
+    host_clock_freeze();
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_init(RELAY_PIN, FAN_PIN));
+}
+
+static void output_stop(void) {
+    app_output_deinit();
+    host_clock_release();
+}
+
+void test_output_ramp_linear_completes(void) {
+    output_start();
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_ramp_fan_speed(200, 1000, FAN_RAMP_LINEAR));
+    TEST_ASSERT_TRUE(app_output_fan_is_ramping());
+
+    // One hardware fade: halfway at half the time
+    advance_ms(500);
+    TEST_ASSERT_TRUE(app_output_fan_is_ramping());
+    TEST_ASSERT_UINT8_WITHIN(1, 100, app_output_get_fan_speed());
+
+    advance_ms(500);
+    TEST_ASSERT_FALSE(app_output_fan_is_ramping());
+    TEST_ASSERT_EQUAL_UINT8(200, app_output_get_fan_speed());
+    TEST_ASSERT_EQUAL_UINT32(200, ledc_get_duty(LEDC_LOW_SPEED_MODE, FAN_LEDC));
+
+    output_stop();
+}
+
+void test_output_ramp_eased_segment_endpoints(void) {
+    // Ease-in 0 -> 255 over 800 ms: 8 segments of 100 ms ending on
+    // 255 * t^2 (t = k/8, in 1/256ths)
+    static const uint8_t endpoints[8] = { 3, 15, 35, 63, 99, 143, 195, 255 };
+    output_start();
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_ramp_fan_speed(255, 800, FAN_RAMP_EASE_IN));
+
+    for (int k = 0; k < 8; k++) {
+        advance_ms(100);
+        TEST_ASSERT_EQUAL_UINT8(endpoints[k], app_output_get_fan_speed());
+        TEST_ASSERT_EQUAL(k < 7, app_output_fan_is_ramping());
+    }
+
+    // Midway through a segment the duty is on the chord between its endpoints
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_ramp_fan_speed(0, 800, FAN_RAMP_EASE_IN));
+    advance_ms(50);
+    TEST_ASSERT_UINT8_WITHIN(1, (255 + 252) / 2, app_output_get_fan_speed());
+
+    output_stop();
+}
+
+void test_output_ramp_cancelled_by_set_fan_speed(void) {
+    output_start();
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_ramp_fan_speed(200, 1000, FAN_RAMP_LINEAR));
+    advance_ms(300);
+    TEST_ASSERT_UINT8_WITHIN(1, 60, app_output_get_fan_speed());
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_set_fan_speed(50));
+    TEST_ASSERT_FALSE(app_output_fan_is_ramping());
+    TEST_ASSERT_EQUAL_UINT8(50, app_output_get_fan_speed());
+
+    // The stopped fade does not come back
+    advance_ms(1000);
+    TEST_ASSERT_EQUAL_UINT8(50, app_output_get_fan_speed());
+    TEST_ASSERT_EQUAL_UINT32(50, ledc_get_duty(LEDC_LOW_SPEED_MODE, FAN_LEDC));
+
+    // A new ramp starts from where the fan is
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_ramp_fan_speed(150, 1000, FAN_RAMP_LINEAR));
+    advance_ms(500);
+    TEST_ASSERT_UINT8_WITHIN(1, 100, app_output_get_fan_speed());
+
+    output_stop();
+}
+
+void test_output_ramp_ignores_stale_fade_end(void) {
+    output_start();
+
+    // A fade end while no ramp runs (ramp stopped after the interrupt)
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_set_fan_speed(50));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, FAN_LEDC, 80, 100));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, ledc_fade_start(LEDC_LOW_SPEED_MODE, FAN_LEDC, LEDC_FADE_NO_WAIT));
+    advance_ms(100);
+    TEST_ASSERT_FALSE(app_output_fan_is_ramping());
+    TEST_ASSERT_EQUAL_UINT8(50, app_output_get_fan_speed());
+
+    // A fade end at another duty than the running segment's target
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_ramp_fan_speed(200, 1000, FAN_RAMP_LINEAR));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, FAN_LEDC, 120, 100));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, ledc_fade_start(LEDC_LOW_SPEED_MODE, FAN_LEDC, LEDC_FADE_NO_WAIT));
+    advance_ms(100);
+    TEST_ASSERT_TRUE(app_output_fan_is_ramping());
+
+    output_stop();
+}
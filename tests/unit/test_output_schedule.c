@@ -0,0 +1,229 @@
+// tests/unit/test_output_schedule.c
+#include "unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "output_schedule.h"
+#include "app_output.h"
+#include "command.h"
+#include "host_hal.h"
+
+#define RELAY_PIN   5
+#define FAN_PIN     18
+#define RELAY_CH    0
+#define FAN_CH      1
+#define MAX_WRITES  16
+
+// Lives in main.c, which the unit tests do not link
+const char *app_err_to_string(app_err_t err) {
+    (void)err;
+    return "error";
+}
+
+// What the scheduler queued, in order
+static command_change_t g_writes[MAX_WRITES];
+static volatile int g_write_count;
+
+// Stands in for the output task: record the changes, then run the command
+// at once so the scheduler reads back the values it wrote
+static app_err_t fake_submit(const command_t *cmd) {
+    const command_group_t *group = command_get_group(cmd);
+    if (group && group->count == 1 && g_write_count < MAX_WRITES) {
+        g_writes[g_write_count] = group->changes[0];
+        g_write_count = g_write_count + 1;
+    }
+    command_dispatch(cmd);
+    return APP_OK;
+}
+
+// Let the esp_timer thread handle a due tick (real time, the frozen clock
+// does not move meanwhile)
+static void settle(void) {
+    struct timespec ts = { .tv_sec = 0, .tv_nsec = 20 * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// The host wall clock is the real one: pick a zone in which it reads the
+// wanted local time. Stays away from the end of a real second so the time
+// does not tick over before the scheduler reads it.
+static void set_local_time(int minute, int second) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    if (now.tv_nsec > 900 * 1000000L) {
+        struct timespec ts = { .tv_sec = 0, .tv_nsec = 1000000000L - now.tv_nsec };
+        nanosleep(&ts, NULL);
+        clock_gettime(CLOCK_REALTIME, &now);
+    }
+
+    long east = ((long)minute * 60 + second - (long)(now.tv_sec % 86400) + 86400) % 86400;
+    char tz[32];
+    snprintf(tz, sizeof(tz), "LOC-%02ld:%02ld:%02ld", east / 3600, east / 60 % 60, east % 60);
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+// Move the wall clock to a local time, then the firmware clock by seconds
+static void advance_to(int minute, int second, uint32_t seconds) {
+    set_local_time(minute, second);
+    host_clock_advance_us((uint64_t)seconds * 1000000ULL);
+    settle();
+}
+
+static void schedule_start(void) {
+    static bool started = false;
+    output_schedule_config_t cfg = { .submit = fake_submit };
+
+    app_output_deinit();
+    host_clock_freeze();
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_init(RELAY_PIN, FAN_PIN));
+    if (!started) {
+        TEST_ASSERT_EQUAL_INT(APP_OK, output_schedule_init(&cfg));
+        started = true;
+    }
+    g_write_count = 0;
+}
+
+static void schedule_stop(void) {
+    output_schedule_cancel(OUTPUT_SCHEDULE_ALL_CHANNELS);
+    app_output_deinit();
+    host_clock_release();
+    setenv("TZ", "UTC0", 1);
+    tzset();
+}
+
+static uint8_t output_value(uint8_t channel) {
+    uint8_t value = 0;
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_get(channel, &value));
+    return value;
+}
+
+static void assert_write(int index, uint8_t channel, int16_t value) {
+    TEST_ASSERT_TRUE(index < g_write_count);
+    TEST_ASSERT_EQUAL_UINT8(channel, g_writes[index].channel);
+    TEST_ASSERT_EQUAL_INT(value, g_writes[index].value);
+}
+
+void test_schedule_daily_window_spans_midnight(void) {
+    output_change_t fan = { .channel = FAN_CH, .value = 153 };
+    schedule_start();
+
+    // 22:00-06:00 does not contain noon
+    set_local_time(12 * 60, 0);
+    TEST_ASSERT_EQUAL_INT(APP_OK, output_schedule_add_daily(&fan, 1, 22 * 60, 6 * 60));
+    TEST_ASSERT_EQUAL_INT(0, g_write_count);
+    TEST_ASSERT_EQUAL_INT(1, output_schedule_cancel(FAN_CH));
+    TEST_ASSERT_EQUAL_INT(0, g_write_count);
+
+    // It contains 23:00, and still contains midnight
+    set_local_time(23 * 60, 0);
+    TEST_ASSERT_EQUAL_INT(APP_OK, output_schedule_add_daily(&fan, 1, 22 * 60, 6 * 60));
+    TEST_ASSERT_EQUAL_INT(1, g_write_count);
+    assert_write(0, FAN_CH, 153);
+    TEST_ASSERT_EQUAL_UINT8(153, app_output_get_fan_speed());
+
+    // Seven hours to the end: wakes hourly to follow clock corrections
+    advance_to(0, 0, 3600);
+    TEST_ASSERT_EQUAL_INT(1, g_write_count);
+
+    // Ends at 06:00
+    advance_to(6 * 60, 0, 3600);
+    TEST_ASSERT_EQUAL_INT(2, g_write_count);
+    assert_write(1, FAN_CH, 0);
+    TEST_ASSERT_EQUAL_UINT8(0, app_output_get_fan_speed());
+    TEST_ASSERT_EQUAL_INT(1, output_schedule_count());
+
+    schedule_stop();
+}
+
+void test_schedule_daily_boundary_delay(void) {
+    output_change_t relay = { .channel = RELAY_CH, .value = RELAY_ON };
+    schedule_start();
+
+    // 30 s before the start: sleeps exactly until it
+    set_local_time(8 * 60 - 1, 30);
+    TEST_ASSERT_EQUAL_INT(APP_OK, output_schedule_add_daily(&relay, 1, 8 * 60, 9 * 60));
+    TEST_ASSERT_EQUAL_INT(0, g_write_count);
+
+    advance_to(8 * 60 - 1, 59, 29);
+    TEST_ASSERT_EQUAL_INT(0, g_write_count);
+
+    advance_to(8 * 60, 0, 1);
+    TEST_ASSERT_EQUAL_INT(1, g_write_count);
+    assert_write(0, RELAY_CH, RELAY_ON);
+    TEST_ASSERT_EQUAL_UINT8(RELAY_ON, output_value(RELAY_CH));
+
+    // A one-hour window ends one hour later, not a tick earlier
+    advance_to(9 * 60 - 1, 59, 3599);
+    TEST_ASSERT_EQUAL_INT(1, g_write_count);
+
+    advance_to(9 * 60, 0, 1);
+    TEST_ASSERT_EQUAL_INT(2, g_write_count);
+    assert_write(1, RELAY_CH, RELAY_OFF);
+    TEST_ASSERT_EQUAL_UINT8(RELAY_OFF, output_value(RELAY_CH));
+
+    schedule_stop();
+}
+
+void test_schedule_replace_inherits_baseline(void) {
+    output_change_t first = { .channel = FAN_CH, .value = 200 };
+    output_change_t second = { .channel = FAN_CH, .value = 100 };
+    schedule_start();
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_set_fan_speed(40));
+    TEST_ASSERT_EQUAL_INT(APP_OK, output_schedule_add_timed(&first, 1, 60));
+    TEST_ASSERT_EQUAL_UINT8(200, app_output_get_fan_speed());
+
+    // The fan reads 200 when the second action starts, but 40 is what it
+    // goes back to
+    advance_to(0, 0, 10);
+    TEST_ASSERT_EQUAL_INT(APP_OK, output_schedule_add_timed(&second, 1, 30));
+    TEST_ASSERT_EQUAL_INT(1, output_schedule_count());
+    TEST_ASSERT_EQUAL_INT(3, g_write_count);
+    assert_write(1, FAN_CH, 40);
+    assert_write(2, FAN_CH, 100);
+
+    advance_to(0, 0, 29);
+    TEST_ASSERT_EQUAL_INT(3, g_write_count);
+
+    advance_to(0, 0, 1);
+    TEST_ASSERT_EQUAL_INT(4, g_write_count);
+    assert_write(3, FAN_CH, 40);
+    TEST_ASSERT_EQUAL_UINT8(40, app_output_get_fan_speed());
+    TEST_ASSERT_EQUAL_INT(0, output_schedule_count());
+
+    // The replaced action's timer went with it
+    advance_to(0, 0, 60);
+    TEST_ASSERT_EQUAL_INT(4, g_write_count);
+
+    schedule_stop();
+}
+
+void test_schedule_cancel_restores(void) {
+    output_change_t fan = { .channel = FAN_CH, .value = 200 };
+    output_change_t relay = { .channel = RELAY_CH, .value = RELAY_ON };
+    schedule_start();
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, app_output_set_fan_speed(40));
+    TEST_ASSERT_EQUAL_INT(APP_OK, output_schedule_add_timed(&fan, 1, 60));
+    set_local_time(12 * 60, 0);
+    TEST_ASSERT_EQUAL_INT(APP_OK, output_schedule_add_daily(&relay, 1, 11 * 60, 13 * 60));
+    TEST_ASSERT_EQUAL_INT(2, output_schedule_count());
+    TEST_ASSERT_EQUAL_UINT8(RELAY_ON, output_value(RELAY_CH));
+
+    // Only the fan's action
+    TEST_ASSERT_EQUAL_INT(1, output_schedule_cancel(FAN_CH));
+    TEST_ASSERT_EQUAL_UINT8(40, app_output_get_fan_speed());
+    TEST_ASSERT_EQUAL_UINT8(RELAY_ON, output_value(RELAY_CH));
+
+    TEST_ASSERT_EQUAL_INT(1, output_schedule_cancel(OUTPUT_SCHEDULE_ALL_CHANNELS));
+    TEST_ASSERT_EQUAL_UINT8(RELAY_OFF, output_value(RELAY_CH));
+    TEST_ASSERT_EQUAL_INT(0, output_schedule_count());
+    TEST_ASSERT_EQUAL_INT(4, g_write_count);
+
+    // Nothing left to fire
+    advance_to(13 * 60, 0, 3600);
+    TEST_ASSERT_EQUAL_INT(4, g_write_count);
+    TEST_ASSERT_EQUAL_UINT8(40, app_output_get_fan_speed());
+
+    schedule_stop();
+}
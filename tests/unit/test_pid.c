@@ -0,0 +1,94 @@
+// tests/unit/test_pid.c
+#include "unity.h"
+#include "pid.h"
+
+static pid_controller_t make_pid(int32_t kp_milli, int32_t ki_milli, int32_t kd_milli, pid_direction_t direction) {
+    pid_controller_t pid;
+    pid_config_t cfg = {
+        .kp = PID_GAIN_MILLI(kp_milli),
+        .ki = PID_GAIN_MILLI(ki_milli),
+        .kd = PID_GAIN_MILLI(kd_milli),
+        .out_min = 0,
+        .out_max = 255,
+        .direction = direction
+    };
+    TEST_ASSERT_EQUAL_INT(APP_OK, pid_init(&pid, &cfg));
+    return pid;
+}
+
+void test_pid_proportional_and_direction(void) {
+    pid_controller_t pid = make_pid(2500, 0, 0, PID_REVERSE);
+
+    // 4.0 % too humid -> 40 tenths * 2.5 = 100
+    TEST_ASSERT_EQUAL_INT32(100, pid_update(&pid, 600, 640, 5000));
+    // Below setpoint: clamped at 0
+    TEST_ASSERT_EQUAL_INT32(0, pid_update(&pid, 600, 550, 5000));
+    // Far above: clamped at 255
+    TEST_ASSERT_EQUAL_INT32(255, pid_update(&pid, 600, 900, 5000));
+
+    pid_controller_t heater = make_pid(2500, 0, 0, PID_DIRECT);
+    TEST_ASSERT_EQUAL_INT32(100, pid_update(&heater, 250, 210, 5000));
+
+    pid_config_t bad = { .out_min = 10, .out_max = 10 };
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM, pid_init(&pid, &bad));
+}
+
+void test_pid_integral_does_not_wind_up(void) {
+    pid_controller_t pid = make_pid(1000, 100, 0, PID_REVERSE);
+
+    // Long saturation: 10 minutes far above the setpoint, integral frozen
+    for (int i = 0; i < 120; i++) {
+        TEST_ASSERT_EQUAL_INT32(255, pid_update(&pid, 600, 900, 5000));
+    }
+    TEST_ASSERT_EQUAL_INT64(0, pid.integral);
+
+    // Slightly too dry: the fan stops at once instead of unwinding
+    TEST_ASSERT_EQUAL_INT32(0, pid_update(&pid, 600, 590, 5000));
+
+    // Inside the range the integral accumulates: 1 % too humid for 10 s
+    pid_reset(&pid, 100);
+    TEST_ASSERT_EQUAL_INT32(100, pid_update(&pid, 600, 610, 5000));
+    TEST_ASSERT_EQUAL_INT32(100 + 10, pid_update(&pid, 600, 610, 10000));
+}
+
+void test_pid_reset_is_bumpless(void) {
+    pid_controller_t pid = make_pid(2500, 25, 0, PID_REVERSE);
+
+    pid_reset(&pid, 128);
+    TEST_ASSERT_EQUAL_INT32(128, pid.output);
+    // At the setpoint, the first step keeps the current output
+    TEST_ASSERT_EQUAL_INT32(128, pid_update(&pid, 600, 600, 5000));
+    TEST_ASSERT_EQUAL_INT32(128, pid_update(&pid, 600, 600, 5000));
+
+    pid_reset(&pid, 1000);
+    TEST_ASSERT_EQUAL_INT32(255, pid.output);
+}
+
+void test_pid_reset_is_bumpless_with_error(void) {
+    pid_controller_t pid = make_pid(2500, 25, 0, PID_REVERSE);
+
+    // 2.0 % too humid: P term 50, the integral takes 128 - 50
+    pid_reset(&pid, 128);
+    TEST_ASSERT_EQUAL_INT32(128, pid_update(&pid, 600, 620, 5000));
+    TEST_ASSERT_EQUAL_INT64((int64_t)78 * PID_GAIN_ONE, pid.integral);
+    // Then the loop moves on from there: 20 * 0.025 * 5 s, just under 2.5 counts
+    TEST_ASSERT_EQUAL_INT32(130, pid_update(&pid, 600, 620, 5000));
+
+    // Too dry: the integral takes up a negative P term as well
+    pid_reset(&pid, 100);
+    TEST_ASSERT_EQUAL_INT32(100, pid_update(&pid, 600, 580, 5000));
+
+    // Beyond the integral's range the step is as close as it gets
+    pid_reset(&pid, 20);
+    TEST_ASSERT_EQUAL_INT32(50, pid_update(&pid, 600, 620, 5000));
+}
+
+void test_pid_derivative_on_measurement(void) {
+    pid_controller_t pid = make_pid(0, 0, 1000, PID_REVERSE);
+
+    TEST_ASSERT_EQUAL_INT32(0, pid_update(&pid, 600, 600, 1000));
+    // Setpoint step, measurement steady: no kick
+    TEST_ASSERT_EQUAL_INT32(0, pid_update(&pid, 500, 600, 1000));
+    // Humidity rising 2 tenths/s: reverse process, output rises
+    TEST_ASSERT_EQUAL_INT32(2, pid_update(&pid, 500, 602, 1000));
+}
@@ -0,0 +1,51 @@
+// tests/unit/test_seqlock.c
+#include "unity.h"
+#include "seqlock.h"
+#include <pthread.h>
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;     // Always a * 3
+} pair_t;
+
+static seqlock_t g_lock = SEQLOCK_INITIALIZER;
+static pair_t g_pair;
+static atomic_bool g_done;
+
+static void *writer(void *arg) {
+    (void)arg;
+    for (uint32_t i = 1; i <= 200000; i++) {
+        seqlock_write_begin(&g_lock);
+        g_pair.a = i;
+        g_pair.b = i * 3;
+        seqlock_write_end(&g_lock);
+    }
+    atomic_store(&g_done, true);
+    return NULL;
+}
+
+void test_seqlock_snapshots_are_consistent(void) {
+    pthread_t thread;
+    atomic_store(&g_done, false);
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, writer, NULL));
+
+    uint32_t reads = 0;
+    uint32_t last = 0;
+    while (!atomic_load(&g_done)) {
+        pair_t copy;
+        uint32_t seq;
+        do {
+            seq = seqlock_read_begin(&g_lock);
+            copy = g_pair;
+        } while (seqlock_read_retry(&g_lock, seq));
+
+        TEST_ASSERT_EQUAL_UINT32(copy.a * 3, copy.b);
+        TEST_ASSERT_TRUE(copy.a >= last);
+        last = copy.a;
+        reads++;
+    }
+    pthread_join(thread, NULL);
+
+    TEST_ASSERT_TRUE(reads > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, seqlock_read_begin(&g_lock) & 1u);
+}
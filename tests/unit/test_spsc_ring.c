@@ -0,0 +1,67 @@
+// tests/unit/test_spsc_ring.c
+#include "unity.h"
+#include "spsc_ring.h"
+
+void test_spsc_ring_rejects_bad_capacity(void) {
+    spsc_ring_t ring;
+    uint32_t storage[6];
+
+    TEST_ASSERT_FALSE(spsc_ring_init(&ring, storage, sizeof(storage[0]), 6));
+    TEST_ASSERT_FALSE(spsc_ring_init(&ring, storage, sizeof(storage[0]), 0));
+    TEST_ASSERT_TRUE(spsc_ring_init(&ring, storage, sizeof(storage[0]), 4));
+}
+
+void test_spsc_ring_counts_overflows_when_full(void) {
+    spsc_ring_t ring;
+    uint32_t storage[4];
+    spsc_ring_init(&ring, storage, sizeof(storage[0]), 4);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(spsc_ring_push(&ring, &i));
+    }
+    uint32_t extra = 99;
+    TEST_ASSERT_FALSE(spsc_ring_push(&ring, &extra));
+    TEST_ASSERT_FALSE(spsc_ring_push(&ring, &extra));
+
+    spsc_ring_stats_t stats;
+    spsc_ring_get_stats(&ring, &stats);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.high_water);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.pushed);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.overflows);
+
+    // Oldest items are kept, never overwritten
+    uint32_t out[4];
+    TEST_ASSERT_EQUAL_UINT32(4, spsc_ring_pop_batch(&ring, out, 8));
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, out[i]);
+    }
+}
+
+void test_spsc_ring_batch_pop_wraps_in_order(void) {
+    spsc_ring_t ring;
+    uint32_t storage[4];
+    uint32_t out[4];
+    uint32_t next_in = 0, next_out = 0;
+    spsc_ring_init(&ring, storage, sizeof(storage[0]), 4);
+
+    // 3 in, 2 out per round: the read position walks over the wrap point
+    for (int round = 0; round < 10; round++) {
+        while (spsc_ring_count(&ring) < 3) {
+            spsc_ring_push(&ring, &next_in);
+            next_in++;
+        }
+        size_t n = spsc_ring_pop_batch(&ring, out, 2);
+        TEST_ASSERT_EQUAL_UINT32(2, n);
+        for (size_t i = 0; i < n; i++) {
+            TEST_ASSERT_EQUAL_UINT32(next_out++, out[i]);
+        }
+    }
+
+    size_t n = spsc_ring_pop_batch(&ring, out, 4);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_UINT32(next_out++, out[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(next_in, next_out);
+    TEST_ASSERT_EQUAL_UINT32(0, spsc_ring_pop_batch(&ring, out, 4));
+}
@@ -0,0 +1,52 @@
+// tests/unit/test_task_profiler.c
+#include "unity.h"
+#include <string.h>
+#include "task_profiler.h"
+
+void test_task_profiler_busiest_skips_idle_tasks(void) {
+    task_profile_t profile = {0};
+    profile.task_count = 3;
+    strcpy(profile.tasks[0].name, "IDLE0");
+    profile.tasks[0].cpu_permille = 900;
+    strcpy(profile.tasks[1].name, "sensor_task");
+    profile.tasks[1].cpu_permille = 40;
+    strcpy(profile.tasks[2].name, "publish_task");
+    profile.tasks[2].cpu_permille = 60;
+
+    TEST_ASSERT_EQUAL_STRING("publish_task", task_profiler_busiest(&profile)->name);
+
+    profile.task_count = 1;
+    TEST_ASSERT_NULL(task_profiler_busiest(&profile));
+}
+
+void test_task_profiler_json_is_compact(void) {
+    task_profile_t profile = {0};
+    profile.interval_ms = 10000;
+    profile.heap_free = 1000;
+    profile.heap_min_free = 900;
+    profile.heap_largest_block = 600;
+    profile.heap_fragmentation = 40;
+    profile.task_count = 1;
+    strcpy(profile.tasks[0].name, "output_task");
+    profile.tasks[0].priority = 10;
+    profile.tasks[0].cpu_permille = 12;
+    profile.tasks[0].stack_free = 1840;
+
+    char buffer[256];
+    size_t len = task_profiler_to_json(&profile, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"tasks\",\"interval_ms\":10000,"
+                             "\"heap\":{\"free\":1000,\"min\":900,\"largest\":600,\"frag\":40},"
+                             "\"tasks\":[[\"output_task\",10,12,1840]],\"skipped\":0}", buffer);
+    TEST_ASSERT_EQUAL_UINT32(strlen(buffer), len);
+
+    TEST_ASSERT_EQUAL_UINT32(0, task_profiler_to_json(&profile, buffer, 32));
+}
+
+void test_task_profiler_sample_reports_heap(void) {
+    static task_profile_t profile;
+    TEST_ASSERT_EQUAL_INT(APP_OK, task_profiler_sample(&profile));
+    TEST_ASSERT_TRUE(profile.heap_free > 0);
+    TEST_ASSERT_TRUE(profile.heap_largest_block <= profile.heap_free);
+    TEST_ASSERT_TRUE(profile.heap_fragmentation <= 100);
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM, task_profiler_sample(NULL));
+}
@@ -0,0 +1,48 @@
+// tests/unit/test_telemetry_binary.c
+#include "unity.h"
+#include "telemetry_binary.h"
+
+void test_telemetry_binary_round_trip(void) {
+    telemetry_binary_reading_t in[3] = {
+        { .sensor_id = 0, .timestamp_ms = 1000,  .temperature = 25.3f, .humidity = 60.1f },
+        { .sensor_id = 1, .timestamp_ms = 6000,  .temperature = 25.4f, .humidity = 60.0f },
+        { .sensor_id = 0, .timestamp_ms = 11000, .temperature = -3.0f, .humidity = 59.9f },
+    };
+    telemetry_binary_reading_t out[3];
+    uint8_t buf[TELEMETRY_BINARY_MAX_SIZE(3)];
+
+    int len = telemetry_binary_encode(in, 3, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(19, len);
+    TEST_ASSERT_EQUAL_HEX8(TELEMETRY_BINARY_VERSION, buf[0]);
+
+    TEST_ASSERT_EQUAL_INT(3, telemetry_binary_decode(buf, len, out, 3));
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_UINT8(in[i].sensor_id, out[i].sensor_id);
+        TEST_ASSERT_EQUAL_UINT64(in[i].timestamp_ms, out[i].timestamp_ms);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, in[i].temperature, out[i].temperature);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, in[i].humidity, out[i].humidity);
+    }
+}
+
+void test_telemetry_binary_rejects_bad_frames(void) {
+    const uint8_t bad_version[] = { 0x03, 0x00, 0x00, 0x00 };
+    const uint8_t truncated[] = { TELEMETRY_BINARY_VERSION, 0xE8 };
+    telemetry_binary_reading_t out[1];
+
+    TEST_ASSERT_EQUAL_INT(TELEMETRY_BINARY_ERR_VERSION,
+        telemetry_binary_decode(bad_version, sizeof(bad_version), out, 1));
+    TEST_ASSERT_EQUAL_INT(TELEMETRY_BINARY_ERR_MALFORMED,
+        telemetry_binary_decode(truncated, sizeof(truncated), out, 1));
+}
+
+void test_telemetry_binary_decodes_v1_frames(void) {
+    // ts=1000, t=25.3, h=60.1 without sensor ID
+    const uint8_t v1[] = { TELEMETRY_BINARY_VERSION_V1, 0xE8, 0x07, 0xFA, 0x03, 0xB2, 0x09 };
+    telemetry_binary_reading_t out[1];
+
+    TEST_ASSERT_EQUAL_INT(1, telemetry_binary_decode(v1, sizeof(v1), out, 1));
+    TEST_ASSERT_EQUAL_UINT8(0, out[0].sensor_id);
+    TEST_ASSERT_EQUAL_UINT64(1000, out[0].timestamp_ms);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 25.3f, out[0].temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 60.1f, out[0].humidity);
+}
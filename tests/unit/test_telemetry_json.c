@@ -0,0 +1,100 @@
+// tests/unit/test_telemetry_json.c
+#include "unity.h"
+#include "telemetry_json.h"
+#include <string.h>
+#include <math.h>
+
+void test_telemetry_json_encode_reading(void) {
+    char buf[64];
+    telemetry_json_writer_t w;
+    sensor_data_t reading = { .sensor_id = 2, .temperature = 25.44f, .humidity = 60.05f, .timestamp_ms = 1000 };
+
+    telemetry_json_init(&w, buf, sizeof(buf));
+    telemetry_json_write_reading(&w, &reading);
+
+    TEST_ASSERT_EQUAL_INT(strlen("{\"id\":2,\"ts\":1000,\"t\":25.4,\"h\":60.1}"), telemetry_json_finish(&w));
+    TEST_ASSERT_EQUAL_STRING("{\"id\":2,\"ts\":1000,\"t\":25.4,\"h\":60.1}", buf);
+}
+
+void test_telemetry_json_encode_overflow(void) {
+    char buf[8];
+    telemetry_json_writer_t w;
+    sensor_data_t reading = { .temperature = -5.0f, .humidity = 40.0f, .timestamp_ms = 1 };
+
+    telemetry_json_init(&w, buf, sizeof(buf));
+    telemetry_json_write_reading(&w, &reading);
+
+    TEST_ASSERT_EQUAL_INT(0, telemetry_json_finish(&w));
+}
+
+void test_telemetry_json_encode_non_finite_as_null(void) {
+    char buf[64];
+    telemetry_json_writer_t w;
+    sensor_data_t reading = { .sensor_id = 1, .temperature = NAN, .humidity = 1e12f, .timestamp_ms = 5 };
+
+    telemetry_json_init(&w, buf, sizeof(buf));
+    telemetry_json_write_reading(&w, &reading);
+    telemetry_json_finish(&w);
+
+    TEST_ASSERT_EQUAL_STRING("{\"id\":1,\"ts\":5,\"t\":null,\"h\":null}", buf);
+}
+
+void test_telemetry_json_decode_command(void) {
+    const char *json = "{ \"id\": [1, {\"x\": null}], \"value\": 128, \"type\": \"fan\" }";
+    telemetry_command_t cmd;
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, telemetry_json_decode_command(json, strlen(json), &cmd));
+    TEST_ASSERT_EQUAL_INT(3, cmd.type_len);
+    TEST_ASSERT_EQUAL_MEMORY("fan", cmd.type, 3);
+    TEST_ASSERT_EQUAL_INT(128, cmd.value);
+}
+
+void test_telemetry_json_decode_channel_and_changes(void) {
+    const char *single = "{\"type\": \"output\", \"channel\": 2, \"value\": 200}";
+    const char *group = "{\"type\": \"outputs\", \"changes\": [[0, 1], [1, 128], [2, 128]]}";
+    const char *bad_pair = "{\"type\": \"outputs\", \"changes\": [[0, 1], [1]]}";
+    telemetry_command_t cmd;
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, telemetry_json_decode_command(single, strlen(single), &cmd));
+    TEST_ASSERT_EQUAL_INT(2, cmd.channel);
+    TEST_ASSERT_EQUAL_INT(200, cmd.value);
+    TEST_ASSERT_EQUAL_INT(0, cmd.change_count);
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, telemetry_json_decode_command(group, strlen(group), &cmd));
+    TEST_ASSERT_EQUAL_INT(3, cmd.change_count);
+    TEST_ASSERT_EQUAL_INT(1, cmd.changes[1].channel);
+    TEST_ASSERT_EQUAL_INT(128, cmd.changes[1].value);
+    TEST_ASSERT_EQUAL_INT(0, cmd.value);
+
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_VALUE,
+        telemetry_json_decode_command(bad_pair, strlen(bad_pair), &cmd));
+}
+
+void test_telemetry_json_decode_time_range(void) {
+    const char *json = "{\"type\": \"history\", \"value\": 1, \"from\": 3600, \"to\": 7200}";
+    const char *open_end = "{\"type\": \"history\", \"value\": 1, \"from\": 60}";
+    telemetry_command_t cmd;
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, telemetry_json_decode_command(json, strlen(json), &cmd));
+    TEST_ASSERT_EQUAL_INT(3600, cmd.from);
+    TEST_ASSERT_EQUAL_INT(7200, cmd.to);
+
+    TEST_ASSERT_EQUAL_INT(APP_OK, telemetry_json_decode_command(open_end, strlen(open_end), &cmd));
+    TEST_ASSERT_EQUAL_INT(60, cmd.from);
+    TEST_ASSERT_EQUAL_INT(0, cmd.to);
+}
+
+void test_telemetry_json_decode_rejects_bad_input(void) {
+    const char *truncated = "{\"type\":\"relay\",\"value\":1";
+    const char *missing_value = "{\"type\":\"relay\"}";
+    const char trailing_escape[] = { '{', '"', 't', '\\' };
+    telemetry_command_t cmd;
+
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM,
+        telemetry_json_decode_command(trailing_escape, sizeof(trailing_escape), &cmd));
+
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_PARAM,
+        telemetry_json_decode_command(truncated, strlen(truncated), &cmd));
+    TEST_ASSERT_EQUAL_INT(APP_ERR_INVALID_VALUE,
+        telemetry_json_decode_command(missing_value, strlen(missing_value), &cmd));
+}
@@ -0,0 +1,105 @@
+// tests/unit/test_timer_wheel.c
+#include "unity.h"
+#include "timer_wheel.h"
+
+static int g_fired;
+static uint64_t g_fired_at;
+static timer_wheel_t g_wheel;
+
+static void count_cb(timer_wheel_timer_t *timer, void *arg) {
+    (void)timer;
+    (void)arg;
+    g_fired++;
+    g_fired_at = g_wheel.now;
+}
+
+void test_timer_wheel_fires_on_tick(void) {
+    timer_wheel_timer_t short_timer = {0};
+    timer_wheel_timer_t long_timer = {0};
+    timer_wheel_init(&g_wheel, 1000);
+    g_fired = 0;
+
+    timer_wheel_schedule(&g_wheel, &short_timer, 5, count_cb, NULL);
+    // Same slot as short_timer, several revolutions later
+    timer_wheel_schedule(&g_wheel, &long_timer, 5 + 3 * TIMER_WHEEL_SLOTS, count_cb, NULL);
+    TEST_ASSERT_EQUAL_INT(2, g_wheel.pending);
+
+    TEST_ASSERT_EQUAL_INT(0, timer_wheel_advance(&g_wheel, 1004));
+    TEST_ASSERT_EQUAL_INT(1, timer_wheel_advance(&g_wheel, 1005));
+    TEST_ASSERT_EQUAL_INT(1005, g_fired_at);
+    TEST_ASSERT_FALSE(timer_wheel_is_pending(&short_timer));
+    TEST_ASSERT_TRUE(timer_wheel_is_pending(&long_timer));
+
+    for (uint64_t tick = 1006; tick < 1005 + 3 * TIMER_WHEEL_SLOTS; tick++) {
+        timer_wheel_advance(&g_wheel, tick);
+    }
+    TEST_ASSERT_EQUAL_INT(1, g_fired);
+    timer_wheel_advance(&g_wheel, 1005 + 3 * TIMER_WHEEL_SLOTS);
+    TEST_ASSERT_EQUAL_INT(2, g_fired);
+    TEST_ASSERT_EQUAL_INT(0, g_wheel.pending);
+}
+
+void test_timer_wheel_cancel_and_catch_up(void) {
+    timer_wheel_timer_t timers[4] = {0};
+    timer_wheel_init(&g_wheel, 0);
+    g_fired = 0;
+
+    for (int i = 0; i < 4; i++) {
+        timer_wheel_schedule(&g_wheel, &timers[i], 10 + 100 * i, count_cb, NULL);
+    }
+    TEST_ASSERT_TRUE(timer_wheel_cancel(&g_wheel, &timers[1]));
+    TEST_ASSERT_FALSE(timer_wheel_cancel(&g_wheel, &timers[1]));
+
+    // Late tick source: one jump past several revolutions fires the rest once
+    TEST_ASSERT_EQUAL_INT(3, timer_wheel_advance(&g_wheel, 10 * TIMER_WHEEL_SLOTS));
+    TEST_ASSERT_EQUAL_INT(0, g_wheel.pending);
+    TEST_ASSERT_EQUAL_INT(0, timer_wheel_advance(&g_wheel, 10 * TIMER_WHEEL_SLOTS));
+}
+
+static void rearm_cb(timer_wheel_timer_t *timer, void *arg) {
+    timer_wheel_timer_t *victim = (timer_wheel_timer_t *)arg;
+    g_fired++;
+    timer_wheel_cancel(&g_wheel, victim);
+    timer_wheel_schedule(&g_wheel, timer, 0, count_cb, NULL);
+}
+
+void test_timer_wheel_callback_reschedules_and_cancels(void) {
+    timer_wheel_timer_t first = {0};
+    timer_wheel_timer_t victim = {0};
+    timer_wheel_init(&g_wheel, 0);
+    g_fired = 0;
+
+    // Both in the slot being visited, the first one cancels the second
+    timer_wheel_schedule(&g_wheel, &victim, 3, count_cb, NULL);
+    timer_wheel_schedule(&g_wheel, &first, 3, rearm_cb, &victim);
+
+    TEST_ASSERT_EQUAL_INT(1, timer_wheel_advance(&g_wheel, 3));
+    TEST_ASSERT_FALSE(timer_wheel_is_pending(&victim));
+    TEST_ASSERT_TRUE(timer_wheel_is_pending(&first));
+
+    // Rescheduled with 0 ticks: due on the next tick
+    TEST_ASSERT_EQUAL_INT(1, timer_wheel_advance(&g_wheel, 4));
+    TEST_ASSERT_EQUAL_INT(2, g_fired);
+}
+
+void test_timer_wheel_next_expiry(void) {
+    timer_wheel_timer_t later = {0};
+    timer_wheel_timer_t sooner = {0};
+    uint64_t expires = 0;
+    timer_wheel_init(&g_wheel, 100);
+
+    TEST_ASSERT_FALSE(timer_wheel_next_expiry(&g_wheel, &expires));
+
+    // Earliest by tick, not by slot: the later timer sits in a lower slot
+    timer_wheel_schedule(&g_wheel, &later, 2 * TIMER_WHEEL_SLOTS - 90, count_cb, NULL);
+    timer_wheel_schedule(&g_wheel, &sooner, 20, count_cb, NULL);
+    TEST_ASSERT_TRUE(timer_wheel_next_expiry(&g_wheel, &expires));
+    TEST_ASSERT_EQUAL_UINT64(120, expires);
+
+    timer_wheel_advance(&g_wheel, 120);
+    TEST_ASSERT_TRUE(timer_wheel_next_expiry(&g_wheel, &expires));
+    TEST_ASSERT_EQUAL_UINT64(100 + 2 * TIMER_WHEEL_SLOTS - 90, expires);
+
+    timer_wheel_cancel(&g_wheel, &later);
+    TEST_ASSERT_FALSE(timer_wheel_next_expiry(&g_wheel, &expires));
+}
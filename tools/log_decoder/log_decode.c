@@ -0,0 +1,113 @@
+/**
+ * @file log_decode.c
+ * @brief Command-line decoder for the binary deferred-log stream
+ * @version 2.0
+ *
+ * Reads the raw console stream from stdin and prints every log frame as
+ * an ESP-IDF style line ("I (1234) TAG: message"). Bytes outside frames
+ * (ESP_LOGx output, boot messages) are copied through unchanged.
+ *
+ * Attached after boot, records print as unknown until the device resends
+ * its FORMAT frames (every DEFAULT_LOG_RESYNC_INTERVAL_MS, one minute).
+ *
+ * Usage:
+ *   cat /dev/ttyUSB0 | log_decode
+ *   log_decode < capture.bin
+ */
+
+#include "log_binary.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DECODE_MAX_FORMATS  4096
+#define DECODE_BUFFER_SIZE  (4 * LOG_BINARY_MAX_FRAME)
+#define DECODE_LINE_MAX     1024
+
+typedef struct {
+    char *tag;              // NULL = ID not defined yet
+    char *fmt;
+    uint8_t level;
+} decode_format_t;
+
+static decode_format_t g_formats[DECODE_MAX_FORMATS];
+
+static void print_line(uint8_t level, uint32_t time_ms, const char *tag, const char *message)
+{
+    printf("%c (%lu) %s: %s\n", log_binary_level_char(level), (unsigned long)time_ms, tag, message);
+}
+
+static void handle_frame(const log_binary_frame_t *frame)
+{
+    char line[DECODE_LINE_MAX];
+    decode_format_t *format = (frame->id < DECODE_MAX_FORMATS) ? &g_formats[frame->id] : NULL;
+
+    switch (frame->type) {
+        case LOG_BINARY_FRAME_FORMAT:
+            if (format) {
+                free(format->tag);
+                free(format->fmt);
+                format->tag = strdup(frame->tag);
+                format->fmt = strdup(frame->text);
+                format->level = frame->level;
+            }
+            break;
+        case LOG_BINARY_FRAME_RECORD:
+            if (!format || !format->tag) {
+                fprintf(stderr, "record for unknown format %u (decoder attached late?)\n", frame->id);
+                break;
+            }
+            log_binary_render(format->fmt, frame->args, frame->argc, line, sizeof(line));
+            print_line(format->level, frame->time_ms, format->tag, line);
+            break;
+        case LOG_BINARY_FRAME_TEXT:
+            print_line(frame->level, frame->time_ms, frame->tag, frame->text);
+            break;
+        case LOG_BINARY_FRAME_DROPPED:
+            printf("W LOG: %lu log records dropped (ring full)\n", (unsigned long)frame->dropped);
+            break;
+        default:
+            break;
+    }
+}
+
+int main(void)
+{
+    static uint8_t buf[DECODE_BUFFER_SIZE];
+    size_t len = 0;
+    size_t n;
+
+    while ((n = fread(buf + len, 1, sizeof(buf) - len, stdin)) > 0 || len > 0) {
+        len += n;
+        bool at_eof = (n == 0);
+        size_t pos = 0;
+
+        while (pos < len) {
+            if (buf[pos] != LOG_BINARY_SYNC) {
+                putchar(buf[pos++]);
+                continue;
+            }
+
+            log_binary_frame_t frame;
+            int used = log_binary_decode(buf + pos, len - pos, &frame);
+            if (used > 0) {
+                handle_frame(&frame);
+                pos += (size_t)used;
+            } else if (used == LOG_BINARY_ERR_INCOMPLETE && !at_eof) {
+                break;
+            } else {
+                putchar(buf[pos++]);
+            }
+        }
+
+        memmove(buf, buf + pos, len - pos);
+        len -= pos;
+        if (at_eof) {
+            break;
+        }
+    }
+
+    fflush(stdout);
+    return 0;
+}
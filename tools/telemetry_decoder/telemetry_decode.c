@@ -0,0 +1,79 @@
+/**
+ * @file telemetry_decode.c
+ * @brief Command-line decoder for binary telemetry frames
+ * @version 2.0
+ *
+ * Reads one raw frame from stdin (or a hex string argument) and prints
+ * one JSON object per reading. The frame is read as is: a frame may end
+ * in 0x0a, so a trailing newline is not stripped (mosquitto_sub needs -N).
+ *
+ * Usage:
+ *   mosquitto_sub -t room_1/sensors -C 1 -N | telemetry_decode
+ *   telemetry_decode 01e807fa03b209
+ */
+
+#include "telemetry_binary.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DECODE_MAX_FRAME    4096
+#define DECODE_MAX_READINGS 256
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static int parse_hex(const char *hex, uint8_t *buf, size_t size)
+{
+    size_t n = strlen(hex);
+    if (n % 2 != 0 || n / 2 > size) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < n / 2; i++) {
+        int hi = hex_value(hex[2 * i]);
+        int lo = hex_value(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return -1;
+        }
+        buf[i] = (uint8_t)((hi << 4) | lo);
+    }
+
+    return (int)(n / 2);
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t frame[DECODE_MAX_FRAME];
+    static telemetry_binary_reading_t readings[DECODE_MAX_READINGS];
+    int len;
+
+    if (argc > 1) {
+        len = parse_hex(argv[1], frame, sizeof(frame));
+        if (len < 0) {
+            fprintf(stderr, "invalid hex frame\n");
+            return 2;
+        }
+    } else {
+        len = (int)fread(frame, 1, sizeof(frame), stdin);
+    }
+
+    int count = telemetry_binary_decode(frame, (size_t)len, readings, DECODE_MAX_READINGS);
+    if (count < 0) {
+        fprintf(stderr, "decode failed: %d\n", count);
+        return 1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        printf("{\"id\":%u,\"ts\":%llu,\"t\":%.1f,\"h\":%.1f}\n",
+               readings[i].sensor_id,
+               (unsigned long long)readings[i].timestamp_ms,
+               readings[i].temperature, readings[i].humidity);
+    }
+
+    return 0;
+}